@@ -0,0 +1,59 @@
+#ifndef _AFFINE_H
+#define _AFFINE_H
+
+#include <cstddef>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+// Matriz de uma transformação afim, guardada como as três primeiras LINHAS
+// da matriz 4x4 correspondente (a quarta linha é sempre [0 0 0 1]):
+//
+//       [ m[0][0] m[0][1] m[0][2] m[0][3] ]
+//   M = [ m[1][0] m[1][1] m[1][2] m[1][3] ]
+//       [ m[2][0] m[2][1] m[2][2] m[2][3] ]
+//       [   0       0       0       1     ]
+//
+// Cada linha ocupa 16 bytes alinhados, de modo que é lida e escrita com uma
+// única instrução SSE/NEON. Composições de translações, rotações e escalas
+// são sempre afins, e fazê-las em 3x4 evita as multiplicações pela última
+// linha das matrizes 4x4.
+struct alignas(16) Affine
+{
+    float m[3][4];
+};
+
+Affine Affine_Identity();
+Affine Affine_Translate(float tx, float ty, float tz);
+Affine Affine_Scale(float sx, float sy, float sz);
+Affine Affine_Rotate_X(float angle);
+Affine Affine_Rotate_Y(float angle);
+Affine Affine_Rotate_Z(float angle);
+Affine Affine_Rotate(float angle, const glm::vec3 &axis); // "axis" não precisa estar normalizado
+
+// Composição direta T * Ry(yaw) * Rx(pitch) * Rz(roll) * S, sem multiplicar
+// as matrizes de cada transformação.
+Affine Affine_TRS(const glm::vec3 &translation, float yaw, float pitch, float roll, const glm::vec3 &scale);
+
+// Produto a*b.
+Affine Affine_Multiply(const Affine &a, const Affine &b);
+
+// Inversa de uma matriz afim (que precisa ser invertível): a parte 3x3 é
+// invertida pelos produtos vetoriais das suas linhas e a translação é
+// levada de volta por ela, sem a inversão de uma 4x4 geral.
+Affine Affine_Inverse(const Affine &a);
+
+glm::vec3 Affine_TransformPoint(const Affine &a, const glm::vec3 &point);
+
+// Matrizes de muitas instâncias de uma vez: out[i] = T(translation[i]) *
+// rotation * S(scale[i]), com a mesma rotação (ou qualquer parte 3x3) para
+// todas e uma escala uniforme para cada uma.
+void Affine_TRSBatch(const Affine &rotation, const glm::vec3* translation, const float* scale, Affine* out, size_t count);
+
+// out[i] = parent * local[i]
+void Affine_MultiplyBatch(const Affine &parent, const Affine* local, Affine* out, size_t count);
+
+glm::mat4 Affine_ToMat4(const Affine &a);
+Affine    Affine_FromMat4(const glm::mat4 &m); // Ignora a última linha de "m"
+
+#endif // _AFFINE_H
@@ -0,0 +1,15 @@
+#ifndef _BENCHMARKS_H
+#define _BENCHMARKS_H
+
+// Microbenchmarks executados pela linha de comando, sem abrir a janela:
+//
+//     ./main --bench colisoes
+//     ./main --bench todos
+//
+// Cada benchmark compara a implementação otimizada com a original, confere
+// se os resultados são iguais e imprime o tempo de cada uma. Retorna o código
+// de saída do programa (diferente de zero se algum resultado divergir ou se o
+// nome não existir).
+int Benchmarks_Run(const char* name);
+
+#endif // _BENCHMARKS_H
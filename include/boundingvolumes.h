@@ -0,0 +1,63 @@
+#ifndef _BOUNDINGVOLUMES_H
+#define _BOUNDINGVOLUMES_H
+
+#include <cstddef>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#define KDOP_AXES 7 // Direções do k-DOP: 3 eixos e 4 diagonais (14 faces)
+
+struct BoundingSphere
+{
+    glm::vec3 center;
+    float     radius;
+};
+
+// Caixa orientada: centro, três eixos unitários e metade do tamanho em cada
+// eixo. Os eixos são ortogonais, exceto depois de uma transformação com
+// escala não uniforme.
+struct OrientedBox
+{
+    glm::vec3 center;
+    glm::vec3 axes[3];
+    glm::vec3 half_size;
+};
+
+// k-DOP de 14 faces: o intervalo das projeções dos vértices em cada uma das
+// direções Kdop_Axis(0..KDOP_AXES-1). As três primeiras são X, Y e Z, então
+// os três primeiros intervalos formam a AABB.
+struct Kdop
+{
+    float min[KDOP_AXES];
+    float max[KDOP_AXES];
+};
+
+// Volumes envolventes de um objeto, no espaço do modelo
+struct BoundingVolumes
+{
+    glm::vec3      aabb_min;
+    glm::vec3      aabb_max;
+    BoundingSphere sphere; // Menor esfera que contém todos os vértices
+    OrientedBox    obb;    // Caixa orientada pelas direções principais dos vértices
+    Kdop           kdop;
+};
+
+// Calcula os volumes de "count" vértices, com "stride" floats entre vértices
+// consecutivos.
+void BoundingVolumes_Compute(BoundingVolumes* volumes, const float* positions, size_t count, int stride);
+
+glm::vec3 Kdop_Axis(int axis);
+
+// Volumes levados para o mundo pela matriz de modelagem "model", que pode
+// conter escalas não uniformes (a esfera usa a maior delas).
+BoundingSphere BoundingSphere_Transform(const BoundingSphere &sphere, const glm::mat4 &model);
+OrientedBox    OrientedBox_Transform(const OrientedBox &box, const glm::mat4 &model);
+
+// Maior distância com sinal de um ponto da caixa ao plano a*x+b*y+c*z+d = 0,
+// com (a,b,c) normalizado: negativa se a caixa está inteiramente atrás do
+// plano.
+float OrientedBox_PlaneDistance(const OrientedBox &box, const glm::vec4 &plane);
+
+#endif // _BOUNDINGVOLUMES_H
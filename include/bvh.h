@@ -0,0 +1,81 @@
+#ifndef _BVH_H
+#define _BVH_H
+
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#define BVH_MAX_LEAF_ITEMS 4   // Folhas com até este número de itens não são divididas
+#define BVH_SAH_BINS       12  // Número de intervalos avaliados em cada eixo pela heurística SAH
+
+// Nó da hierarquia, com 32 bytes. Os nós ficam em um único vetor, em
+// profundidade: o filho esquerdo de um nó interno é sempre o nó seguinte, e
+// apenas o índice do direito é guardado.
+struct BvhNode
+{
+    glm::vec3 min;
+    int       first; // Folha: primeiro item em Bvh::items. Nó interno: índice do filho direito
+    glm::vec3 max;
+    int       count; // Número de itens da folha (0 em nós internos)
+};
+
+// Caixa alinhada aos eixos de um objeto, com um tipo e um índice definidos
+// por quem a inseriu (ex.: árvore número 42).
+struct BvhItem
+{
+    glm::vec3 min;
+    int       type;
+    glm::vec3 max;
+    int       index;
+    int       id;      // Valor retornado por Bvh_Add()
+    bool      enabled; // Itens desabilitados (ex.: árvores cortadas) são ignorados pelas consultas
+};
+
+// Hierarquia de volumes envolventes (BVH) estática sobre caixas de objetos,
+// construída com a heurística de área de superfície (SAH), para consultas de
+// raios e segmentos. Depois de Bvh_Build() os itens ficam em "items" na ordem
+// das folhas, e "item_position" dá a posição de cada id.
+struct Bvh
+{
+    std::vector<BvhNode> nodes;
+    std::vector<BvhItem> items;
+    std::vector<int>     item_position;
+};
+
+struct BvhHit
+{
+    int   id;
+    int   type;
+    int   index;
+    float distance; // Distância da origem do raio até a entrada na caixa
+};
+
+void Bvh_Clear(Bvh* bvh);
+
+// Insere uma caixa e retorna o seu id. Só tem efeito nas consultas depois da
+// próxima chamada de Bvh_Build().
+int Bvh_Add(Bvh* bvh, int type, int index, const glm::vec3 &min, const glm::vec3 &max);
+
+// Insere a caixa que envolve a caixa [min, max] de um modelo transformada pela
+// matriz de modelagem "model".
+int Bvh_AddTransformed(Bvh* bvh, int type, int index, const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model);
+
+void Bvh_Build(Bvh* bvh);
+
+void Bvh_SetEnabled(Bvh* bvh, int id, bool enabled);
+
+// Item mais próximo atingido pelo raio que parte de "origin" na direção
+// "direction" (normalizada), até a distância "max_distance". Retorna false se
+// nenhum item for atingido.
+bool Bvh_Raycast(const Bvh* bvh, const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, BvhHit* hit);
+
+// Item mais próximo de "a" atingido pelo segmento de "a" até "b".
+bool Bvh_Segment(const Bvh* bvh, const glm::vec3 &a, const glm::vec3 &b, BvhHit* hit);
+
+// Itens cujas caixas tocam a caixa [min, max]. As posições dos itens em
+// bvh->items são escritas em "items", até "max_items" delas; retorna o número
+// total de itens encontrados, que pode ser maior do que "max_items".
+int Bvh_Overlap(const Bvh* bvh, const glm::vec3 &min, const glm::vec3 &max, int* items, int max_items);
+
+#endif // _BVH_H
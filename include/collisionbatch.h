@@ -0,0 +1,60 @@
+#ifndef _COLLISIONBATCH_H
+#define _COLLISIONBATCH_H
+
+#include <vector>
+#include <stdint.h>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// Os vetores dos lotes têm sempre um múltiplo deste número de posições (a
+// maior largura SIMD usada, AVX-512), preenchidas no final com objetos que
+// nunca colidem. Assim os laços SIMD não precisam tratar o resto.
+#define COLLISION_BATCH_WIDTH 16
+
+// Lote de esferas em estrutura de vetores (SoA): um vetor por componente,
+// para que um único registrador SIMD contenha a mesma coordenada de várias
+// esferas.
+struct CollisionSpheres
+{
+    int                count;
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    std::vector<float> radius_sq; // Raio ao quadrado
+};
+
+// Lote de caixas alinhadas aos eixos no plano XZ, com a mesma semântica de
+// pointCubeCollision() (a altura é ignorada).
+struct CollisionBoxes
+{
+    int                count;
+    std::vector<float> min_x;
+    std::vector<float> min_z;
+    std::vector<float> max_x;
+    std::vector<float> max_z;
+};
+
+void CollisionSpheres_Clear(CollisionSpheres* spheres);
+void CollisionSpheres_Add(CollisionSpheres* spheres, const glm::vec3 &center, float radius);
+
+void CollisionBoxes_Clear(CollisionBoxes* boxes);
+void CollisionBoxes_Add(CollisionBoxes* boxes, const glm::vec2 &min, const glm::vec2 &max);
+
+// Número de palavras de 32 bits da máscara de resultados de um lote com
+// "count" objetos.
+int CollisionBatch_MaskWords(int count);
+
+// Testa um ponto contra todas as esferas do lote, como pointSphereCollision(),
+// mas comparando distâncias ao quadrado. O bit i da máscara (bit i%32 da
+// palavra i/32) indica colisão com a esfera i. Retorna o número de colisões.
+// Não aloca memória: "hit_mask" deve ter CollisionBatch_MaskWords() palavras.
+int Collision_PointSpheres(const CollisionSpheres* spheres, const glm::vec4 &point, uint32_t* hit_mask);
+
+// Testa uma caixa quadrada centrada no ponto, com meia largura "margin",
+// contra todas as caixas do lote. Com margin = 0 é o teste de
+// pointCubeCollision(); com margin > 0, o de cubeCubeCollision().
+int Collision_PointBoxes(const CollisionBoxes* boxes, const glm::vec4 &point, float margin, uint32_t* hit_mask);
+
+#endif // _COLLISIONBATCH_H
@@ -1,17 +1,28 @@
-#include <string>
-#include <glad/glad.h>
-
-struct SceneObject
-{
-    std::string  name;        // Nome do objeto
-    size_t       first_index; // ndice do primeiro vrtice dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
-    size_t       num_indices; // Nmero de ndices do objeto dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
-    GLenum       rendering_mode; // Modo de rasterizao (GL_TRIANGLES, GL_TRIANGLE_STRIP, etc.)
-    GLuint       vertex_array_object_id; // ID do VAO onde esto armazenados os atributos do modelo
-    glm::vec3    bbox_min; // Axis-Aligned Bounding Box do objeto
-    glm::vec3    bbox_max;
-};
-
-bool pointSphereCollision(glm::vec4 point, glm::vec3 sphere, float radius);
-bool pointCubeCollision(glm::vec4 point, SceneObject object, glm::vec3 position, float scale, float small_value);
-bool cubeCubeCollision(glm::vec4 point, SceneObject object, glm::vec3 position, float scale);
+#ifndef _COLLISIONS_H
+#define _COLLISIONS_H
+
+#include <string>
+#include <glad/glad.h>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "boundingvolumes.h"
+
+struct SceneObject
+{
+    std::string  name;        // Nome do objeto
+    size_t       first_index; // Índice do primeiro vértice dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
+    size_t       num_indices; // Número de índices do objeto dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
+    GLenum       rendering_mode; // Modo de rasterização (GL_TRIANGLES, GL_TRIANGLE_STRIP, etc.)
+    GLuint       vertex_array_object_id; // ID do VAO onde estão armazenados os atributos do modelo
+    glm::vec3    bbox_min; // Axis-Aligned Bounding Box do objeto
+    glm::vec3    bbox_max;
+    BoundingSphere bsphere; // Menor esfera envolvente
+    OrientedBox    obb;     // Caixa orientada envolvente
+    Kdop           kdop;    // k-DOP envolvente, com 14 faces
+};
+
+bool pointSphereCollision(glm::vec4 point, glm::vec3 sphere, float radius);
+bool pointCubeCollision(glm::vec4 point, const SceneObject &object, glm::vec3 position, float scale, float small_value);
+
+#endif // _COLLISIONS_H
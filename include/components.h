@@ -0,0 +1,82 @@
+#ifndef _COMPONENTS_H
+#define _COMPONENTS_H
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "collisions.h"
+#include "ecs.h"
+
+// Componentes das entidades do jogo (veja ecs.h). Cada sistema de main.cpp
+// percorre os arquétipos que têm os componentes de que precisa.
+#define COMPONENT_TRANSFORM 0 // TransformComponent
+#define COMPONENT_RENDER    1 // RenderComponent
+#define COMPONENT_COLLIDER  2 // ColliderComponent
+#define COMPONENT_SOLID     3 // Marcação: bloqueia o jogador
+#define COMPONENT_CHOPPABLE 4 // Marcação: pode ser cortada com o machado
+#define COMPONENT_FELLED    5 // FelledComponent
+#define COMPONENT_MOTION    6 // MotionComponent
+#define COMPONENT_PLAYER    7 // PlayerComponent
+#define COMPONENT_QUEST     8 // QuestComponent
+
+// Objeto colocado no mundo por um nó da hierarquia de transformações
+struct TransformComponent
+{
+    glm::vec3 position; // Translação do nó
+    float     scale;
+    int       node;
+};
+
+// Como o objeto entra na lista de desenho (veja DrawList_Add())
+struct RenderComponent
+{
+    const SceneObject* object;
+    int                object_id;
+    int                layer;
+    bool               dynamic;
+    glm::vec2          wind; // Fase e amplitude do balanço com o vento
+};
+
+// Colisor estático do objeto
+struct ColliderComponent
+{
+    int collider; // Posição em static_colliders
+    int target;   // Item na BVH da mira
+};
+
+// Árvore cortada: o nó passa a posicionar o toco
+struct FelledComponent
+{
+    glm::vec2 trunk; // Ponto do corte no plano XZ
+};
+
+// Movimento no plano XZ. A altura vem do terreno.
+struct MotionComponent
+{
+    glm::vec2 position;
+    glm::vec2 previous; // Posição no início do último passo da simulação, usada para desfazer o movimento em caso de colisão e para interpolar a câmera
+    float     speed;
+};
+
+// Estado do jogador e do machado
+struct PlayerComponent
+{
+    float     eye_height; // Altura dos olhos acima do terreno, com o balanço da caminhada
+    float     walk_time;  // Tempo de jogo, que dá a fase do balanço
+    float     axe_angle;  // Rotação do machado de acordo com a animação
+    float     chop_timer; // Tempo do golpe atual do machado
+    bool      chopping;   // Golpeando uma árvore neste passo
+    bool      can_chop;   // Mirando uma árvore ao alcance do machado
+    EcsEntity target;     // Árvore mirada
+};
+
+// Progresso da Quest do NPC
+struct QuestComponent
+{
+    int  level;    // Nível do jogo (ao total são 3)
+    int  felled;   // Árvores cortadas no nível atual
+    bool near_npc; // Perto o suficiente para conversar com o NPC
+    bool accepted;
+};
+
+#endif // _COMPONENTS_H
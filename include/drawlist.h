@@ -0,0 +1,59 @@
+#ifndef _DRAWLIST_H
+#define _DRAWLIST_H
+
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+
+#include "collisions.h"
+#include "jobs.h"
+
+// Camadas de ordenação: objetos da camada de fundo (ex.: o chão, que cobre
+// quase toda a tela mas fica atrás de todo o resto) são desenhados depois dos
+// demais objetos opacos.
+#define DRAW_LAYER_DEFAULT    0
+#define DRAW_LAYER_BACKGROUND 1
+
+// Uma chamada de desenho de um objeto opaco.
+struct DrawItem
+{
+    const SceneObject* object;    // Objeto em g_VirtualScene
+    glm::mat4          model;     // Matriz de modelagem
+    int                object_id; // Valor de "object_id" em shader_fragment.glsl
+    int                layer;     // Camada de ordenação (DRAW_LAYER_*)
+    bool               dynamic;   // Objeto que se move ou muda (não entra no cache de sombras)
+    glm::vec2          wind;      // Fase e amplitude do balanço do vento (veja shader_vertex.glsl); amplitude 0 não balança
+    float              depth;     // Distância até a câmera, calculada em DrawList_SortFrontToBack()
+};
+
+struct DrawList
+{
+    std::vector<DrawItem>      items;
+    std::vector<unsigned char> visible; // Resultado do teste de cada item em DrawList_CullFrustum()
+};
+
+void DrawList_Clear(DrawList* list);
+void DrawList_Add(DrawList* list, const SceneObject* object, const glm::mat4 &model, int object_id, int layer = DRAW_LAYER_DEFAULT, bool dynamic = false,
+                  const glm::vec2 &wind = glm::vec2(0.0f));
+
+// Acrescenta "count" itens ainda não preenchidos e retorna a posição do
+// primeiro. Cada item é preenchido com DrawList_Set(), que pode ser chamada
+// por várias threads ao mesmo tempo para itens diferentes.
+int DrawList_Extend(DrawList* list, int count);
+void DrawList_Set(DrawList* list, int index, const SceneObject* object, const glm::mat4 &model, int object_id, int layer, bool dynamic,
+                  const glm::vec2 &wind);
+
+// Remove os itens que estão inteiramente fora do frustum da câmera definido
+// pela matriz projection*view. Retorna o número de itens removidos. Os itens
+// são testados em paralelo pelas tarefas de "jobs", se não for NULL.
+int DrawList_CullFrustum(DrawList* list, const glm::mat4 &projection_view, JobSystem* jobs = NULL);
+
+// Ordena os itens da frente para trás em relação à câmera definida pela
+// matriz "view", usando o centro da esfera envolvente de cada objeto. Desenhar os objetos
+// mais próximos primeiro faz com que o teste de profundidade descarte os
+// fragmentos ocultos antes do fragment shader. As distâncias são calculadas
+// em paralelo pelas tarefas de "jobs", se não for NULL.
+void DrawList_SortFrontToBack(DrawList* list, const glm::mat4 &view, JobSystem* jobs = NULL);
+
+#endif // _DRAWLIST_H
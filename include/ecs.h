@@ -0,0 +1,108 @@
+#ifndef _ECS_H
+#define _ECS_H
+
+#include <cstddef>
+#include <vector>
+
+// Sistema de entidades e componentes (ECS) com armazenamento por arquétipo.
+//
+// Cada entidade é só um identificador; os seus dados ficam em componentes,
+// registrados por número (0 a ECS_MAX_COMPONENTS-1) com o tamanho da sua
+// struct. As entidades com o mesmo conjunto de componentes formam um
+// arquétipo, que guarda cada componente em um vetor contíguo próprio (SoA
+// entre componentes): um sistema que precisa de dois componentes percorre,
+// em cada arquétipo que os tem, dois vetores lado a lado, sem ponteiros de
+// uma entidade para outra. Remover uma entidade move a última do arquétipo
+// para o seu lugar, então os vetores nunca têm buracos.
+//
+// Os componentes são copiados com memcpy ao mudar de arquétipo: devem ser
+// structs simples, sem construtores nem destrutores. Componentes de tamanho
+// zero servem de marcação (ex.: "sólido") e não ocupam memória.
+//
+// Criar, remover ou mudar os componentes de uma entidade pode realocar os
+// vetores: os ponteiros de Ecs_Column() e Ecs_Get() só valem até a próxima
+// dessas operações.
+
+#define ECS_MAX_COMPONENTS 32
+#define ECS_BIT(component) (1u << (component))
+
+typedef unsigned int EcsMask; // Conjunto de componentes, um bit por componente
+
+// Referência a uma entidade. O índice é reaproveitado depois que a entidade
+// é removida, mas a geração muda, então uma referência antiga deixa de ser
+// válida em vez de apontar para outra entidade.
+struct EcsEntity
+{
+    unsigned int index;
+    unsigned int generation;
+};
+
+struct EcsArchetype
+{
+    EcsMask                    mask;
+    int                        count;
+    std::vector<EcsEntity>     entities;                    // Entidade de cada linha
+    std::vector<unsigned char> columns[ECS_MAX_COMPONENTS]; // Só os componentes de "mask" são usados
+};
+
+// Onde está cada entidade, pelo índice
+struct EcsRecord
+{
+    unsigned int generation;
+    int          archetype; // -1 se o índice está livre
+    int          row;
+};
+
+struct EcsWorld
+{
+    size_t                    component_size[ECS_MAX_COMPONENTS];
+    std::vector<EcsArchetype> archetypes;
+    std::vector<EcsRecord>    records;
+    std::vector<unsigned int> free_indices;
+};
+
+void Ecs_Init(EcsWorld* world);
+void Ecs_RegisterComponent(EcsWorld* world, int component, size_t size);
+
+// Cria uma entidade com os componentes de "mask", zerados
+EcsEntity Ecs_Create(EcsWorld* world, EcsMask mask);
+void Ecs_Destroy(EcsWorld* world, EcsEntity entity);
+bool Ecs_IsAlive(const EcsWorld* world, EcsEntity entity);
+
+// Entidade viva que usa o índice, ou uma entidade inválida (ex.: quando só o
+// índice foi guardado, como nos colisores)
+EcsEntity Ecs_FromIndex(const EcsWorld* world, unsigned int index);
+
+EcsMask Ecs_Mask(const EcsWorld* world, EcsEntity entity);
+
+// Adiciona e remove componentes, movendo a entidade para o arquétipo do novo
+// conjunto. Os componentes mantidos são copiados e os novos são zerados.
+void Ecs_SetMask(EcsWorld* world, EcsEntity entity, EcsMask mask);
+
+// Reserva espaço para "count" entidades a mais com os componentes de "mask"
+void Ecs_Reserve(EcsWorld* world, EcsMask mask, int count);
+
+// Componente de uma entidade, ou NULL se ela não o tem. Componentes de
+// marcação não têm dados: use Ecs_Mask() para saber se a entidade os tem.
+void* Ecs_Get(EcsWorld* world, EcsEntity entity, int component);
+
+template <typename T>
+T* Ecs_Get(EcsWorld* world, EcsEntity entity, int component)
+{
+    return (T*)Ecs_Get(world, entity, component);
+}
+
+// Vetor de um componente de um arquétipo, com archetype->count elementos
+template <typename T>
+T* Ecs_Column(EcsArchetype* archetype, int component)
+{
+    return (T*)archetype->columns[component].data();
+}
+
+// Arquétipo com todos os componentes de "required" (e talvez outros)
+inline bool Ecs_Matches(const EcsArchetype &archetype, EcsMask required)
+{
+    return (archetype.mask & required) == required;
+}
+
+#endif // _ECS_H
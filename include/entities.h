@@ -0,0 +1,24 @@
+#ifndef _ENTITIES_H
+#define _ENTITIES_H
+
+#include <vector>
+
+// Objetos do mapa de um mesmo tipo (ex.: todas as árvores) em SoA: cada
+// atributo fica em um vetor contíguo próprio, com uma posição por objeto, e o
+// número de objetos é definido em tempo de execução (veja sceneconfig.h). Os
+// laços de desenho e de colisão percorrem os vetores em ordem.
+struct EntityArrays
+{
+    int                count;
+    std::vector<float> x, z;  // Translação no plano XZ
+    std::vector<float> y;     // Altura do terreno sob o objeto (veja terrain.h)
+    std::vector<float> scale;
+    std::vector<int>   type;  // Modelo usado por cada objeto (ex.: qual das decorações)
+    std::vector<int>   node;  // Nó na hierarquia de transformações
+};
+
+// Troca o número de objetos. Os novos começam na origem, com escala 1, tipo 0
+// e sem nó.
+void EntityArrays_Resize(EntityArrays* entities, int count);
+
+#endif // _ENTITIES_H
@@ -0,0 +1,71 @@
+#ifndef _FRAMEPACING_H
+#define _FRAMEPACING_H
+
+// Ritmo dos quadros: limite de quadros por segundo, sincronização vertical e
+// estatísticas da variação do tempo de quadro ("jitter").
+//
+// O limitador dorme até pouco antes do início do próximo quadro e espera o
+// restante em "spin": o sleep do sistema operacional pode acordar alguns
+// milissegundos depois do pedido (no Windows, até 15 ms), e a margem de spin
+// acompanha o maior atraso observado. Assim a thread do quadro não ocupa um
+// núcleo inteiro e o quadro ainda começa na hora certa.
+//
+// Com a thread de renderização, a sincronização vertical faz a troca dos
+// buffers esperar pelo monitor; a thread do quadro, que nunca está mais de um
+// quadro à frente (veja framepacket.h), acompanha esse ritmo.
+
+// Número de quadros considerados nas estatísticas
+#define FRAMEPACING_HISTORY 120
+
+#define VSYNC_OFF      0
+#define VSYNC_ON       1
+#define VSYNC_ADAPTIVE 2 // Sincroniza, mas não espera o próximo retraço se o quadro atrasou
+
+struct FramePacer
+{
+    double target_rate;    // Quadros por segundo; zero desliga o limitador
+    int    vsync;          // VSYNC_*
+    int    swap_interval;  // Valor para glfwSwapInterval(): -1 é a sincronização adaptativa
+
+    double next_frame;     // Quando o próximo quadro pode começar (ms, veja FramePacing_Now())
+    double last_frame;     // Quando o quadro atual começou
+    double sleep_error_ms; // Maior atraso recente do sleep, a margem de spin
+
+    // Tempo entre o início de quadros consecutivos, nos últimos quadros
+    double history[FRAMEPACING_HISTORY];
+    int    history_count, history_next;
+    double sleep_ms;       // Tempo dormindo por quadro (média móvel)
+    double spin_ms;        // Tempo em spin por quadro (média móvel)
+};
+
+struct FramePacingStats
+{
+    double frame_ms;  // Média do tempo de quadro
+    double jitter_ms; // Desvio padrão do tempo de quadro
+    double min_ms, max_ms;
+    double sleep_ms, spin_ms;
+};
+
+// Escolhe o intervalo da troca de buffers; deve ser chamada com o contexto
+// OpenGL ativo na thread atual. A sincronização adaptativa depende das
+// extensões "swap_control_tear"; sem elas, a sincronização é a comum.
+void FramePacing_Init(FramePacer* pacer, double target_rate, int vsync);
+
+// Aplica o intervalo escolhido ao contexto ativo na thread atual
+void FramePacing_ApplySwapInterval(const FramePacer* pacer);
+
+// Espera até o início do próximo quadro, segundo "target_rate", e registra o
+// tempo do quadro que terminou. Um quadro atrasado não é compensado
+// encurtando os seguintes.
+void FramePacing_Wait(FramePacer* pacer);
+
+void FramePacing_Stats(const FramePacer* pacer, FramePacingStats* stats);
+
+// Nome da opção de sincronização ("off", "on" ou "adaptive") para VSYNC_*;
+// retorna -1 para um nome inválido
+int FramePacing_ParseVsync(const char* name);
+
+// Relógio do limitador, em milissegundos
+double FramePacing_Now();
+
+#endif // _FRAMEPACING_H
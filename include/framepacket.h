@@ -0,0 +1,133 @@
+#ifndef _FRAMEPACKET_H
+#define _FRAMEPACKET_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "drawlist.h"
+#include "lights.h"
+#include "shadows.h"
+
+// Número de pacotes: um sendo montado, um pronto e um sendo desenhado
+#define FRAME_PACKETS 3
+
+// Texto do HUD, em "normalized device coordinates"
+struct FrameText
+{
+    std::string text;
+    float       x, y, scale;
+};
+
+// Tudo o que a thread de renderização precisa para desenhar um quadro. O
+// pacote é montado pela thread do quadro e não muda mais depois de entregue
+// (FrameQueue_Submit()): a renderização não lê o estado do jogo.
+struct FramePacket
+{
+    long long              frame;      // Número do quadro
+    double                 input_time; // Quando a entrada do usuário deste quadro foi lida (veja FrameQueue_Now())
+    float                  time;       // Tempo de jogo, para as animações dos shaders
+
+    // Câmera
+    glm::mat4              view;
+    glm::mat4              projection;
+    float                  field_of_view;
+    float                  aspect;
+    float                  near_distance; // Distâncias positivas até o near e o far plane
+    float                  far_distance;
+    int                    framebuffer_width, framebuffer_height;
+    int                    window_width, window_height;
+
+    // Luzes
+    glm::vec3              sun_direction;
+    std::vector<PointLight> lights;
+
+    // Objetos opacos: todos (para as sombras, que também precisam dos objetos
+    // fora da tela) e os visíveis, já ordenados da frente para trás
+    DrawList               casters;
+    DrawList               visible;
+    int                    scene_version; // Versão dos objetos estáticos (veja ShadowCascades_Update())
+    bool                   depth_prepass;
+    bool                   reload_shaders; // Recarregar os shaders, na thread que tem o contexto OpenGL
+
+    // Textos, na ordem em que são desenhados. Só os "num_texts" primeiros
+    // valem; os demais são mantidos para reaproveitar as strings.
+    std::vector<FrameText> texts;
+    int                    num_texts;
+};
+
+// Esvazia as listas do pacote para montar um novo quadro
+void FramePacket_Clear(FramePacket* packet);
+void FramePacket_AddText(FramePacket* packet, const char* text, float x, float y, float scale = 1.0f);
+
+// Resultados da renderização, devolvidos à thread do quadro para o HUD. Eles
+// se referem a um quadro anterior ao que está sendo montado.
+struct RenderStats
+{
+    unsigned int shaded_fragments;                // Fragmentos que passaram no teste de profundidade
+    float        shadow_splits[SHADOW_CASCADES];
+    int          shadow_draws[SHADOW_CASCADES];
+    int          shadow_static_renders[SHADOW_CASCADES];
+
+    long long    frames;         // Pacotes desenhados
+    double       render_ms;      // Tempo da thread de renderização por quadro (média móvel)
+    double       latency_ms;     // Da leitura da entrada até a troca dos buffers (média móvel)
+    double       max_latency_ms; // Maior latência no último segundo
+};
+
+// Fila de pacotes com três buffers entre a thread do quadro, que monta os
+// pacotes, e a de renderização, a única que usa o contexto OpenGL. Assim a
+// montagem do quadro N+1 acontece enquanto o quadro N é enviado para a GPU.
+//
+// A thread do quadro espera em FrameQueue_BeginWrite() enquanto houver um
+// pacote pronto ainda não desenhado, de modo que ela nunca está mais de um
+// quadro à frente e a entrada do usuário é lida o mais tarde possível.
+//
+// Sem thread, FrameQueue_Submit() desenha o pacote imediatamente.
+struct FrameQueue
+{
+    FramePacket packets[FRAME_PACKETS];
+    int         writing, ready, reading; // Papel de cada pacote
+    bool        has_ready;               // O pacote "ready" ainda não foi desenhado
+
+    std::function<void(const FramePacket*, RenderStats*)> render;
+    std::function<void(bool)> context;   // Liga (true) e desliga (false) o contexto OpenGL na thread atual
+
+    bool                    threaded;
+    bool                    running;
+    std::thread             thread;
+    std::mutex              mutex;
+    std::condition_variable wake;
+
+    RenderStats             stats;       // Lido e escrito com o mutex
+    double                  max_latency_start;
+};
+
+// "render" desenha um pacote e preenche as estatísticas da GPU
+void FrameQueue_Init(FrameQueue* queue, const std::function<void(const FramePacket*, RenderStats*)> &render);
+
+// Com "threaded", o contexto OpenGL é desligado da thread atual e passa para
+// a thread de renderização, através da função "context".
+void FrameQueue_Start(FrameQueue* queue, bool threaded, const std::function<void(bool)> &context);
+
+// Desenha o último pacote enviado, termina a thread de renderização e
+// devolve o contexto à thread atual
+void FrameQueue_Stop(FrameQueue* queue);
+
+// Pacote a montar; espera enquanto o anterior não começou a ser desenhado
+FramePacket* FrameQueue_BeginWrite(FrameQueue* queue);
+void FrameQueue_Submit(FrameQueue* queue);
+
+void FrameQueue_Stats(FrameQueue* queue, RenderStats* stats);
+
+// Relógio das latências, em milissegundos
+double FrameQueue_Now();
+
+#endif // _FRAMEPACKET_H
@@ -0,0 +1,54 @@
+#ifndef _HEADLESS_H
+#define _HEADLESS_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+// Renderização sem janela, para testes e benchmarks em máquinas sem servidor
+// X nem GPU (ex.: Mesa llvmpipe):
+//
+//     ./main --headless 600 --headless-size 1920x1080 --headless-image quadro.ppm
+//
+// O contexto OpenGL 3.3 é criado com EGL, sem superfície ("surfaceless"), e
+// os quadros são desenhados em um framebuffer próprio com o tamanho pedido. A
+// libEGL é carregada em tempo de execução, então o jogo continua rodando em
+// máquinas sem ela; fora do Linux o modo não está disponível.
+struct HeadlessContext
+{
+    void*  library;  // libEGL
+    void*  display;  // EGLDisplay
+    void*  context;  // EGLContext
+
+    int    width, height;
+    GLuint framebuffer, color, depth;
+
+    // Duração de cada quadro, da troca anterior até a atual, em milissegundos
+    std::vector<double> frame_ms;
+    double              last_frame;
+};
+
+// Cria o contexto, o torna atual na thread que chama e carrega as funções
+// OpenGL. Retorna false (e avisa o motivo) se não for possível.
+bool Headless_Init(HeadlessContext* headless, int width, int height);
+void Headless_Shutdown(HeadlessContext* headless);
+
+// Liga (true) ou desliga (false) o contexto da thread atual
+void Headless_MakeCurrent(HeadlessContext* headless, bool attach);
+
+// Começa a medir o tempo de quadro a partir de agora; chamada logo antes do
+// primeiro quadro, para que a carga da cena não entre no primeiro tempo
+void Headless_StartTiming(HeadlessContext* headless);
+
+// Fim do quadro, no lugar da troca de buffers: espera a GPU terminar, para
+// que o tempo medido inclua a renderização, e registra a duração do quadro
+void Headless_EndFrame(HeadlessContext* headless);
+
+// Imprime o tempo de quadro médio, os percentis e o máximo. O primeiro
+// quadro, que inclui a compilação dos shaders pelo driver, é mostrado à parte.
+void Headless_PrintStats(const HeadlessContext* headless);
+
+// Grava o último quadro desenhado em um arquivo PPM
+bool Headless_SaveImage(HeadlessContext* headless, const char* filename);
+
+#endif // _HEADLESS_H
@@ -0,0 +1,105 @@
+#ifndef _JOBS_H
+#define _JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sistema de tarefas ("jobs") com roubo de trabalho ("work stealing").
+//
+// Cada thread do sistema tem a sua fila de tarefas. A thread dona empilha e
+// desempilha pelo fim da fila (a tarefa mais recente, cujos dados ainda estão
+// no cache); uma thread sem trabalho rouba pelo início da fila de outra (a
+// tarefa mais antiga, em geral a maior parte do trabalho que falta). Threads
+// sem trabalho em nenhuma fila dormem até uma nova tarefa ser enfileirada.
+//
+// A thread que chama Jobs_Init() é a thread 0 do sistema. Outras threads (ex.:
+// a da simulação) também podem enfileirar tarefas e esperar por elas: elas
+// usam uma fila compartilhada, da qual todas as threads roubam.
+//
+// Dependências são expressas com contadores: cada tarefa enfileirada com um
+// contador o incrementa, e o decrementa ao terminar. Jobs_Wait() não bloqueia
+// a thread: enquanto o contador não chega a zero, ela executa outras tarefas.
+// Assim uma tarefa pode enfileirar outras e esperar por elas.
+
+// Executa os itens [begin, end) de um trabalho
+typedef void (*JobFunction)(void* data, int begin, int end);
+
+struct JobCounter
+{
+    std::atomic<int> pending;
+
+    JobCounter() : pending(0) {}
+};
+
+struct Job
+{
+    JobFunction function;
+    void*       data;
+    int         begin, end;
+    JobCounter* counter;
+    const char* name;     // Nome mostrado pelo profiler (veja Profiler_RecordJob())
+};
+
+struct JobQueue
+{
+    std::mutex      mutex;
+    std::deque<Job> jobs;
+};
+
+struct JobSystem
+{
+    int                      num_threads; // Contando a thread que chamou Jobs_Init()
+    std::vector<std::thread> workers;
+    std::vector<JobQueue>    queues;      // Uma por thread, mais a compartilhada no final
+
+    std::mutex               sleep_mutex;
+    std::condition_variable  wake;
+    std::atomic<int>         queued;      // Tarefas nas filas, para as threads dormirem sem perder avisos
+    bool                     running;
+
+    std::atomic<int>         steals;      // Tarefas roubadas de outra fila desde Jobs_ResetStats()
+    std::atomic<int>         executed;
+};
+
+// Cria as threads do sistema. Com "num_threads" igual a zero, usa o número de
+// núcleos disponíveis; com 1, todas as tarefas executam na thread que espera.
+void Jobs_Init(JobSystem* system, int num_threads = 0);
+
+// Termina as threads. Não deve haver tarefas pendentes.
+void Jobs_Shutdown(JobSystem* system);
+
+// Enfileira uma tarefa na fila da thread atual
+void Jobs_Run(JobSystem* system, const Job &job);
+
+// Divide os itens [0, count) em tarefas de até "grain" itens e as enfileira.
+// Com "system" igual a NULL, ou com uma única tarefa, executa tudo na thread
+// atual antes de retornar.
+void Jobs_Dispatch(JobSystem* system, const char* name, int count, int grain, JobFunction function, void* data, JobCounter* counter);
+
+// Executa tarefas até o contador chegar a zero
+void Jobs_Wait(JobSystem* system, JobCounter* counter);
+
+void Jobs_ResetStats(JobSystem* system);
+
+template <typename F>
+void Jobs_Thunk(void* data, int begin, int end)
+{
+    (*(const F*)data)(begin, end);
+}
+
+// Executa function(begin, end) para intervalos que cobrem [0, count), em
+// paralelo, e espera todos terminarem. A função não pode escrever em dados
+// compartilhados entre intervalos diferentes.
+template <typename F>
+void Jobs_ParallelFor(JobSystem* system, const char* name, int count, int grain, const F &function)
+{
+    JobCounter counter;
+    Jobs_Dispatch(system, name, count, grain, &Jobs_Thunk<F>, (void*)&function, &counter);
+    Jobs_Wait(system, &counter);
+}
+
+#endif // _JOBS_H
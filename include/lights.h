@@ -0,0 +1,77 @@
+#ifndef _LIGHTS_H
+#define _LIGHTS_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "jobs.h"
+
+// Dimensões da grade de clusters. O frustum de visualização é dividido em
+// CLUSTER_GRID_X x CLUSTER_GRID_Y blocos na tela e CLUSTER_GRID_Z fatias de
+// profundidade, espaçadas exponencialmente entre o near e o far plane.
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define CLUSTER_COUNT  (CLUSTER_GRID_X*CLUSTER_GRID_Y*CLUSTER_GRID_Z)
+
+// Fonte de luz pontual (fogueiras, lanternas, tochas). A contribuição da luz
+// vai a zero na distância "radius".
+struct PointLight
+{
+    glm::vec3 position;  // Posição em coordenadas globais
+    float     radius;    // Alcance da luz
+    glm::vec3 color;
+    float     intensity;
+};
+
+// Listas de luzes por cluster, montadas na CPU e enviadas para a GPU em
+// "texture buffers" lidos por shader_fragment.glsl.
+struct LightClusters
+{
+    // Projeção usada para montar a grade (distâncias positivas)
+    float field_of_view, aspect, near_distance, far_distance;
+
+    // AABB de cada cluster no sistema de coordenadas da câmera
+    std::vector<glm::vec3> cluster_min;
+    std::vector<glm::vec3> cluster_max;
+
+    // Luzes no sistema de coordenadas da câmera: (x, y, z, raio)
+    std::vector<glm::vec4> view_lights;
+
+    // Dados enviados para a GPU
+    std::vector<GLuint> cluster_grid;  // (início, quantidade) em light_indices, por cluster
+    std::vector<GLuint> light_indices; // Índices das luzes de todos os clusters
+    std::vector<float>  light_data;    // 8 floats por luz: posição e raio, cor * intensidade
+
+    // Uma lista de índices por grupo de fatias de profundidade, montada por
+    // uma tarefa; concatenadas em light_indices ao final
+    int num_groups;
+    std::vector< std::vector<GLuint> > group_indices;
+
+    GLuint grid_buffer,  grid_texture;
+    GLuint index_buffer, index_texture;
+    GLuint light_buffer, light_texture;
+};
+
+// Cria os buffers na GPU. Com "num_groups" igual a zero, usa um grupo de
+// fatias por núcleo disponível (limitado a 8).
+void LightClusters_Init(LightClusters* clusters, int num_groups = 0);
+
+// Recalcula as AABBs dos clusters, caso a projeção tenha mudado.
+void LightClusters_SetProjection(LightClusters* clusters, float field_of_view, float aspect, float near_distance, float far_distance);
+
+// Monta as listas de luzes de cada cluster para a câmera "view". Cada grupo de
+// fatias de profundidade é montado por uma tarefa de "jobs" (ou em sequência,
+// se for NULL).
+void LightClusters_Build(LightClusters* clusters, const std::vector<PointLight> &lights, const glm::mat4 &view, JobSystem* jobs = NULL);
+
+// Envia as listas para a GPU e liga os texture buffers nas unidades de
+// textura "first_unit", "first_unit+1" e "first_unit+2".
+void LightClusters_Upload(LightClusters* clusters, GLuint first_unit);
+
+#endif // _LIGHTS_H
@@ -0,0 +1,64 @@
+#ifndef _MESHCOLLISION_H
+#define _MESHCOLLISION_H
+
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "bvh.h"
+
+#define MESH_COLLISION_MAX_CANDIDATES 512 // Triângulos por consulta guardados na pilha; acima disso, em um vetor da thread
+
+// Malha de triângulos para colisão, no espaço do modelo, com uma BVH sobre as
+// caixas dos triângulos (o "index" de cada item é o número do triângulo).
+struct CollisionMesh
+{
+    std::vector<glm::vec3> vertices; // Três vértices por triângulo
+    Bvh                    bvh;
+};
+
+// Cápsula: todos os pontos a no máximo "radius" do segmento de "a" até "b"
+struct CollisionCapsule
+{
+    glm::vec3 a;
+    glm::vec3 b;
+    float     radius;
+};
+
+struct CollisionContact
+{
+    glm::vec3 normal; // Direção, no mundo, em que a cápsula deve ser empurrada para sair da malha
+    float     depth;  // Penetração ao longo de "normal"
+};
+
+// Uma malha colocada no mundo. A matriz de modelagem deve ser composta apenas
+// de translações, rotações e de uma escala uniforme "scale", para que a
+// cápsula continue sendo uma cápsula no espaço do modelo.
+struct CollisionInstance
+{
+    int                  type;  // Tipo e índice definidos por quem criou a instância (ex.: árvore número 42)
+    int                  index;
+    const CollisionMesh* mesh;
+    glm::mat4            model;
+    glm::mat4            inverse_model;
+    float                scale;
+    glm::vec3            min;   // Caixa da instância no mundo
+    glm::vec3            max;
+};
+
+// Constrói a malha a partir de "count" vértices (três por triângulo), com
+// "stride" floats entre vértices consecutivos.
+void CollisionMesh_Build(CollisionMesh* mesh, const float* positions, size_t count, int stride);
+
+void CollisionInstance_Init(CollisionInstance* instance, int type, int index, const CollisionMesh* mesh, const glm::mat4 &model, float scale);
+
+// Contato mais profundo entre a cápsula (no mundo) e a malha. Retorna false se
+// elas não se tocam.
+bool Collision_CapsuleMesh(const CollisionInstance* instance, const CollisionCapsule &capsule, CollisionContact* contact);
+
+// Primeiro triângulo da malha atingido pelo segmento de "a" até "b" (no
+// mundo). Retorna em "t" a fração do segmento, em [0, 1], até o ponto atingido.
+bool Collision_SegmentMesh(const CollisionInstance* instance, const glm::vec3 &a, const glm::vec3 &b, float* t);
+
+#endif // _MESHCOLLISION_H
@@ -0,0 +1,95 @@
+#ifndef _PLACEMENT_H
+#define _PLACEMENT_H
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Gerador de números pseudoaleatórios (xorshift64*). Ao contrário de rand(),
+// cada gerador tem o seu próprio estado, e a mesma semente gera sempre a
+// mesma sequência em qualquer plataforma.
+struct PlacementRandom
+{
+    unsigned long long state;
+};
+
+void PlacementRandom_Seed(PlacementRandom* random, unsigned int seed);
+unsigned int PlacementRandom_Next(PlacementRandom* random);
+
+// Número em [min, max)
+float PlacementRandom_Float(PlacementRandom* random, float min, float max);
+
+// Círculo onde nenhum objeto pode ser colocado (ex.: em volta do NPC)
+struct PlacementExclusion
+{
+    glm::vec2 center;
+    float     radius;
+};
+
+// Região de posicionamento: o anel entre "inner_radius" e "outer_radius" em
+// volta de "center", menos os círculos de exclusão. Só o centro dos objetos
+// precisa estar no anel; das exclusões o objeto inteiro fica de fora.
+//
+// Se "bounds_max" for maior que "bounds_min", o objeto inteiro também precisa
+// estar dentro deste retângulo. Regiões vizinhas que dividem um lado (ex.:
+// pedaços do mundo gerados separadamente) nunca têm objetos sobrepostos.
+struct PlacementRegion
+{
+    glm::vec2                 center;
+    float                     inner_radius;
+    float                     outer_radius;
+    const PlacementExclusion* exclusions;
+    int                       num_exclusions;
+    glm::vec2                 bounds_min;
+    glm::vec2                 bounds_max;
+};
+
+bool PlacementRegion_Contains(const PlacementRegion &region, float x, float z, float radius);
+
+// Objetos posicionados no plano XZ, cada um um círculo que não pode
+// sobrepor nenhum outro (amostragem de Poisson-disk).
+//
+// Uma grade uniforme guarda em cada célula uma lista encadeada dos objetos
+// cujo centro está nela, de modo que testar se um novo objeto cabe só olha
+// as células a até "raio + max_radius" dele, não importa quantos objetos já
+// foram colocados. Várias chamadas de posicionamento podem usar a mesma
+// grade, e os objetos de tipos diferentes (árvores, troncos, plantas) também
+// não se sobrepõem entre si.
+struct Placement
+{
+    float              cell_size;
+    glm::vec2          origin;     // Canto mínimo da grade
+    int                width;      // Número de células em X
+    int                height;     // Número de células em Z
+    std::vector<int>   cell_first; // Primeiro objeto de cada célula, ou -1
+    std::vector<int>   next;       // Próximo objeto da mesma célula, ou -1
+    std::vector<float> x, z;       // Centro de cada objeto
+    std::vector<float> radius;
+    float              max_radius; // Maior raio já inserido
+};
+
+// Prepara uma grade vazia cobrindo o retângulo [min, max]. Objetos fora dele
+// nunca cabem. A célula deve ter mais ou menos o diâmetro dos objetos.
+void Placement_Init(Placement* placement, const glm::vec2 &min, const glm::vec2 &max, float cell_size);
+
+bool Placement_Fits(const Placement* placement, float x, float z, float radius);
+
+// Insere o objeto sem testar se ele cabe e retorna o seu índice
+int Placement_Insert(Placement* placement, float x, float z, float radius);
+
+// Coloca até "count" objetos de raio "radius" em posições uniformemente
+// distribuídas na região, descartando as que não cabem. Depois de
+// "max_attempts" tentativas seguidas sem sucesso a região é considerada
+// cheia. Retorna quantos foram colocados: são os últimos de placement->x/z.
+int Placement_Scatter(Placement* placement, PlacementRandom* random, const PlacementRegion &region,
+                      float radius, int count, int max_attempts = 1000);
+
+// Preenche a região com objetos de raio "radius" até não caber mais nenhum
+// (ou até "max_count"), com a variante do algoritmo de Bridson que gera a
+// amostragem mais densa: novos objetos são tentados em volta dos já
+// colocados, logo além da distância mínima, em ângulos igualmente espaçados a
+// partir de um ângulo aleatório. Retorna quantos foram colocados.
+int Placement_Fill(Placement* placement, PlacementRandom* random, const PlacementRegion &region,
+                   float radius, int max_count);
+
+#endif // _PLACEMENT_H
@@ -0,0 +1,69 @@
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Número de quadros em que as queries de tempo da GPU ficam "em voo" antes de
+// serem lidas. Assim o resultado é lido sem bloquear a CPU.
+#define PROFILER_FRAMES 3
+
+// Trecho medido do quadro. Os tempos são médias móveis exponenciais, em
+// milissegundos.
+struct ProfilerScope
+{
+    std::string name;
+    double      cpu_ms;
+    double      gpu_ms;
+    int         last_frame; // Último quadro em que o trecho foi executado
+
+    double      cpu_start;
+    bool        gpu;                         // Se o trecho já foi aberto na thread do contexto OpenGL
+    int         slot;                        // Par de queries em uso
+    GLuint      queries[PROFILER_FRAMES][2]; // Timestamps de início e fim, por quadro
+    bool        issued[PROFILER_FRAMES];
+};
+
+// Tempo de CPU das tarefas do sistema de tarefas com um mesmo nome (veja
+// jobs.h), somado em todas as threads. Os valores são médias móveis por quadro.
+struct ProfilerJob
+{
+    std::string name;
+    double      cpu_ms;     // Soma dos tempos das tarefas no quadro
+    double      max_ms;     // Tarefa mais longa do quadro
+    double      jobs;       // Número de tarefas por quadro
+    int         last_frame;
+
+    // Acumulados do quadro atual, incorporados às médias em Profiler_BeginFrame()
+    double      frame_ms;
+    double      frame_max_ms;
+    int         frame_jobs;
+};
+
+// Cria um trecho na primeira chamada de Profiler_Begin() com o seu nome. Os
+// trechos podem ser aninhados e podem ser abertos em mais de uma thread (ex.:
+// a do quadro e a de renderização), mas cada um deve ser fechado na thread
+// que o abriu. Só os trechos da thread indicada por Profiler_SetGpuThread(),
+// que possui o contexto OpenGL, medem também o tempo da GPU.
+void Profiler_SetGpuThread();
+void Profiler_BeginFrame();
+void Profiler_Begin(const char* name);
+void Profiler_End();
+
+// Cópia dos trechos medidos até agora, na ordem em que foram executados pela
+// primeira vez.
+void Profiler_CopyScopes(std::vector<ProfilerScope>* scopes);
+
+// Registra a execução de uma tarefa. Ao contrário das funções acima, pode ser
+// chamada de qualquer thread.
+void Profiler_RecordJob(const char* name, double cpu_ms);
+
+// Cópia das tarefas registradas até agora
+void Profiler_CopyJobs(std::vector<ProfilerJob>* jobs);
+
+// Número do quadro atual (incrementado por Profiler_BeginFrame()).
+int Profiler_Frame();
+
+#endif // _PROFILER_H
@@ -0,0 +1,107 @@
+#ifndef _SAVEGAME_H
+#define _SAVEGAME_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Jogo salvo: o estado que muda durante o jogo (jogador, Quest e árvores
+// cortadas). O mapa em si não é salvo, já que é gerado de novo a partir da
+// semente; o arquivo guarda a semente e o número de árvores para ser
+// recusado em outro mapa.
+//
+// Formato (versão SAVEGAME_VERSION, inteiros little-endian):
+//
+//     cabeçalho  SAVEGAME_HEADER_SIZE bytes: identificador, versão, tamanho
+//                do cabeçalho, mapa, jogador, Quest, número de árvores
+//                cortadas, tamanho do resto do arquivo e checksum (FNV-1a)
+//                do arquivo inteiro, calculado com o próprio campo zerado
+//     bitset     um bit por árvore (cortada ou não), em palavras de 64 bits
+//     troncos    ponto do corte de cada árvore cortada, na ordem das árvores:
+//                diferença em milímetros para o ponto anterior, em X e em Z,
+//                em varints com zigzag (1 a 5 bytes cada)
+//
+// Versões futuras podem aumentar o cabeçalho: o tamanho gravado nele diz
+// onde começa o bitset. Na versão 1 o checksum cobria só o resto do arquivo.
+#define SAVEGAME_MAGIC          0x524D4254u // "TBMR"
+#define SAVEGAME_VERSION        2
+#define SAVEGAME_HEADER_SIZE    48
+#define SAVEGAME_POSITION_SCALE 1000.0f     // Unidades por metro dos troncos (milímetros)
+#define SAVEGAME_QUEST_LEVELS   5           // Níveis da Quest, de 0 a 4 (veja QuestSystem())
+
+// Ponto do corte de uma árvore cortada
+struct SaveGameTrunk
+{
+    int       tree;     // Posição da árvore na ordem em que foram criadas
+    glm::vec2 position;
+};
+
+struct SaveGame
+{
+    unsigned int seed;          // Mapa ao qual o jogo pertence
+    int          tree_count;
+
+    glm::vec2    player_position;
+    int          quest_level;
+    int          quest_felled;
+    bool         quest_accepted;
+
+    std::vector<unsigned long long> felled; // Bitset com as árvores cortadas
+    std::vector<SaveGameTrunk>      trunks; // Em qualquer ordem ao salvar; em ordem de árvore ao carregar
+};
+
+// Jogo vazio, sem árvores cortadas, para um mapa com "tree_count" árvores
+void SaveGame_Init(SaveGame* save, unsigned int seed, int tree_count);
+
+// Marca a árvore como cortada no ponto "trunk"
+void SaveGame_SetFelled(SaveGame* save, int tree, const glm::vec2 &trunk);
+bool SaveGame_IsFelled(const SaveGame* save, int tree);
+
+// Converte para o formato do arquivo e de volta. SaveGame_Decode() retorna
+// false se os bytes não são um jogo salvo válido desta versão ou anterior,
+// inclusive se o jogador ou a Quest têm valores impossíveis.
+void SaveGame_Encode(const SaveGame* save, std::vector<unsigned char>* bytes);
+bool SaveGame_Decode(SaveGame* save, const unsigned char* bytes, size_t size);
+
+// Lê um arquivo mapeando-o na memória (mmap), sem copiá-lo para um buffer
+bool SaveGame_Load(SaveGame* save, const char* filename);
+
+// Grava um arquivo de uma vez. O arquivo é escrito com outro nome e depois
+// renomeado, então um jogo salvo antigo nunca fica pela metade. "written"
+// (se não for NULL) recebe o tamanho do arquivo.
+bool SaveGame_Write(const SaveGame* save, const char* filename, size_t* written = NULL);
+
+// Gravação em outra thread: o quadro só entrega o estado já copiado, e a
+// conversão e a escrita no disco acontecem fora dele.
+struct SaveWriter
+{
+    std::string             filename;
+    std::thread             thread;
+    std::mutex              mutex;
+    std::condition_variable wake;
+    bool                    running;
+    bool                    has_pending;
+    SaveGame                pending;     // Próximo estado a gravar
+
+    // Estatísticas, lidas com o mutex
+    int                     writes;
+    int                     failures;
+    size_t                  last_bytes;  // Tamanho do último arquivo gravado
+    double                  last_ms;     // Tempo da última conversão e escrita
+};
+
+void SaveWriter_Start(SaveWriter* writer, const char* filename);
+
+// Entrega um estado para ser gravado. O conteúdo de "save" é trocado, sem
+// cópia, pelo de um estado antigo. Se a gravação anterior ainda não começou,
+// ela é substituída por esta.
+void SaveWriter_Submit(SaveWriter* writer, SaveGame* save);
+
+// Espera a gravação pendente (se houver) e termina a thread
+void SaveWriter_Stop(SaveWriter* writer);
+
+#endif // _SAVEGAME_H
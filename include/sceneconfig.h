@@ -0,0 +1,44 @@
+#ifndef _SCENECONFIG_H
+#define _SCENECONFIG_H
+
+// Tamanho e semente do mapa, definidos em tempo de execução.
+//
+// Os valores padrão podem ser trocados por um arquivo de configuração, com
+// uma opção "nome = valor" por linha ("#" começa um comentário), e depois
+// pela linha de comando, com "--nome valor":
+//
+//     ./main --config ../../data/scene.cfg --trees 100000 --forest_radius 2000
+//     ./main --streaming 1 --stream_radius 400
+//
+// As opções são os campos abaixo. Quantidades que não couberem na área da
+// floresta são reduzidas no posicionamento.
+struct SceneConfig
+{
+    int          trees;         // Árvores na floresta
+    int          decorations;   // Plantas
+    int          rocks;         // Pedras da montanha em volta do mapa
+    int          logs;          // Troncos caídos
+    int          lanterns;      // Lanternas (luzes pontuais) espalhadas pela floresta
+    unsigned int seed;          // Semente do posicionamento
+    float        forest_radius; // Raio da floresta (mais de 50 m); a montanha e o chão acompanham
+
+    // Com "streaming" diferente de zero não há montanha: fora do raio da
+    // floresta o mundo é dividido em pedaços gerados à medida que o jogador
+    // se aproxima (veja worldstream.h), com a mesma densidade de árvores e
+    // plantas
+    int          streaming;
+    float        stream_radius;   // Distância até a qual os pedaços são carregados
+    int          chunk_budget_mb; // Memória máxima dos pedaços carregados, pelo menos 1 MB
+};
+
+void SceneConfig_Defaults(SceneConfig* config);
+
+// Lê as opções de um arquivo. Retorna false se ele não puder ser aberto; as
+// linhas inválidas são avisadas e ignoradas.
+bool SceneConfig_Load(SceneConfig* config, const char* filename);
+
+// Aplica "--config arquivo" e depois as opções "--nome valor" da linha de
+// comando. Argumentos desconhecidos (ex.: "--sim-thread") são ignorados.
+void SceneConfig_ParseArguments(SceneConfig* config, int argc, char* argv[]);
+
+#endif // _SCENECONFIG_H
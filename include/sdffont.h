@@ -0,0 +1,47 @@
+#ifndef _SDFFONT_H
+#define _SDFFONT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Glifo do atlas de campo de distância com sinal (SDF). As medidas estão em
+// pixels da fonte original e já incluem a margem ("spread") do campo.
+struct SdfGlyph
+{
+    uint32_t codepoint;
+    float    offset_x, offset_y; // Canto superior esquerdo do quad em relação à origem (baseline)
+    float    width, height;      // Tamanho do quad
+    float    advance_x;
+    float    kerning;
+    float    s0, t0, s1, t1;     // Coordenadas de textura do glifo no atlas
+};
+
+// Fonte SDF gerada em tempo de execução a partir do atlas bitmap de
+// "dejavufont.h". Um único atlas serve para qualquer escala de texto.
+struct SdfFont
+{
+    int                        tex_width, tex_height;
+    std::vector<unsigned char> tex_data; // Um canal (GL_R8); 0.5 = contorno do glifo
+    float                      height;   // Altura da linha em pixels da fonte
+    float                      spread;   // Alcance do campo de distância em pixels da fonte
+    std::vector<SdfGlyph>      glyphs;
+    int                        latin1_index[256]; // Índice em glyphs[] por codepoint Latin-1 (-1 se não existir)
+
+    const SdfGlyph* Find(uint32_t codepoint) const;
+};
+
+// Gera o atlas SDF, incluindo as letras acentuadas do Latin-1 (compostas a
+// partir das letras base e dos acentos ASCII). "texels_per_pixel" define a
+// resolução do atlas em relação à fonte original.
+void SdfFont_Build(SdfFont* font, int texels_per_pixel = 3);
+
+// Decodifica o codepoint UTF-8 que começa em str[i] e avança "i". Sequências
+// inválidas retornam U+FFFD.
+uint32_t UTF8_Decode(const std::string &str, size_t &i);
+
+// Número de codepoints de uma string UTF-8.
+size_t UTF8_Length(const std::string &str);
+
+#endif // _SDFFONT_H
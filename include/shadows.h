@@ -0,0 +1,74 @@
+#ifndef _SHADOWS_H
+#define _SHADOWS_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "drawlist.h"
+
+#define SHADOW_CASCADES      4
+#define SHADOW_CACHED_FIRST  2        // Cascatas a partir desta guardam a parte estática em cache
+#define SHADOW_MAP_SIZE      2048     // Resolução de cada cascata
+#define SHADOW_DISTANCE      160.0f   // Distância até onde há sombras
+#define SHADOW_DEPTH_RANGE   400.0f   // Profundidade do volume de cada cascata, nos dois sentidos da luz
+
+// Shadow maps em cascata para a luz direcional (sol).
+//
+// As cascatas próximas (0 até SHADOW_CACHED_FIRST-1) seguem o frustum da
+// câmera e são redesenhadas a cada quadro. As distantes são centradas na
+// câmera e só se movem em passos grandes: a parte estática da cena
+// (pedras, decorações, árvores não cortadas) é desenhada uma vez em um cache e
+// reaproveitada até que a luz, o conjunto de objetos estáticos ou o passo da
+// cascata mudem. A cada quadro o cache é copiado para a cascata e apenas os
+// objetos dinâmicos (galinhas, machado, árvores cortadas) são desenhados.
+// Os objetos balançados pelo vento entram no cache parados, na posição de
+// repouso, já que o balanço é da ordem de um texel dessas cascatas.
+struct ShadowCascades
+{
+    glm::vec3 light_direction;                    // Sentido do ponto para o sol
+    glm::mat4 light_view;
+    float     splits[SHADOW_CASCADES];            // Distância final de cada cascata
+    glm::mat4 light_projection[SHADOW_CASCADES];
+    glm::mat4 shadow_matrix[SHADOW_CASCADES];     // Coordenadas globais -> coordenadas de textura do shadow map
+    glm::vec2 center[SHADOW_CASCADES];            // Centro da cascata no sistema de coordenadas da luz
+    float     radius[SHADOW_CASCADES];            // Meia largura da cascata
+    float     texel_size[SHADOW_CASCADES];        // Tamanho de um texel em coordenadas globais
+
+    // Estado do cache das cascatas distantes
+    bool      cache_valid[SHADOW_CASCADES];
+    int       static_version;
+    int       static_renders[SHADOW_CASCADES];    // Quantas vezes a parte estática foi desenhada
+    int       draws[SHADOW_CASCADES];             // Objetos desenhados no último quadro
+
+    // Esfera envolvente de cada item da lista de desenho, no sistema de
+    // coordenadas da luz, usada para descartar objetos fora de cada cascata
+    std::vector<glm::vec4> caster_spheres;
+
+    GLuint    depth_texture;   // GL_TEXTURE_2D_ARRAY com uma camada por cascata
+    GLuint    static_texture;  // Cache da parte estática das cascatas distantes
+    GLuint    framebuffer;
+    GLuint    static_framebuffer;
+};
+
+void ShadowCascades_Init(ShadowCascades* shadows);
+
+// Calcula as divisões e as matrizes das cascatas para a câmera atual e
+// invalida o cache quando necessário. "static_version" deve mudar sempre que
+// o conjunto de objetos estáticos mudar.
+void ShadowCascades_Update(ShadowCascades* shadows, const glm::vec3 &light_direction, const glm::mat4 &camera_view,
+                           float field_of_view, float aspect, float near_distance, int static_version);
+
+// Desenha os shadow maps com o programa de GPU atualmente em uso, cujas
+// variáveis "model", "wind", "view" e "projection" são dadas. Objetos da camada
+// DRAW_LAYER_BACKGROUND (o chão) não projetam sombras. Ao final, o
+// framebuffer padrão volta a ser usado, mas o viewport não é restaurado.
+void ShadowCascades_Render(ShadowCascades* shadows, const DrawList &list,
+                           GLint model_uniform, GLint wind_uniform, GLint view_uniform, GLint projection_uniform);
+
+#endif // _SHADOWS_H
@@ -0,0 +1,56 @@
+#ifndef _SIMULATION_H
+#define _SIMULATION_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#define SIMULATION_RATE      120.0  // Passos da simulação por segundo
+#define SIMULATION_MAX_STEPS 30     // Passos no máximo por quadro (0,25 s); o resto do atraso é descartado
+
+// Simulação em passo fixo, separada do desenho.
+//
+// A função "update" avança o estado do jogo em exatamente "step" segundos, de
+// modo que o resultado não depende da taxa de quadros. Sem thread, cada
+// quadro chama Simulation_Advance() com a duração do quadro, que é acumulada e
+// consumida em passos inteiros. Com thread, os passos são executados por uma
+// thread própria, no seu relógio.
+//
+// Em ambos os casos "update" é chamada com o mutex da simulação travado. A
+// thread de desenho deve travá-lo (Simulation_Lock()) enquanto lê ou altera o
+// estado compartilhado com "update", e pode interpolar entre o estado do
+// passo anterior e o do atual usando Simulation_Alpha().
+struct Simulation
+{
+    double                     step;        // Duração de um passo, em segundos
+    double                     accumulator; // Tempo ainda não simulado (sem thread)
+    long                       steps;       // Número de passos executados
+    std::function<void(float)> update;
+
+    bool                       threaded;
+    double                     last_step_time; // Relógio do último passo (com thread)
+    std::atomic<bool>          running;
+    std::thread                thread;
+    std::mutex                 mutex;
+};
+
+void Simulation_Init(Simulation* simulation, double rate, const std::function<void(float)> &update);
+
+// Com "threaded", cria a thread da simulação; caso contrário os passos são
+// executados dentro de Simulation_Advance().
+void Simulation_Start(Simulation* simulation, bool threaded);
+void Simulation_Stop(Simulation* simulation);
+
+// Avança a simulação pelo tempo de um quadro. Com thread não faz nada.
+void Simulation_Advance(Simulation* simulation, double frame_time);
+
+// Fração de passo, em [0, 1], decorrida desde o último passo: 0 corresponde ao
+// estado do passo anterior e 1 ao do último passo. Deve ser chamada com o
+// mutex travado.
+double Simulation_Alpha(Simulation* simulation);
+
+void Simulation_Lock(Simulation* simulation);
+void Simulation_Unlock(Simulation* simulation);
+
+#endif // _SIMULATION_H
@@ -0,0 +1,53 @@
+#ifndef _SPATIALGRID_H
+#define _SPATIALGRID_H
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Número máximo de células da grade. Se a área ocupada pelos itens exigir
+// mais células, o tamanho da célula é aumentado.
+#define SPATIAL_GRID_MAX_CELLS (1 << 20)
+
+// Item da grade: um retângulo no plano XZ, com um tipo e um índice definidos
+// por quem o inseriu (ex.: árvore número 42).
+struct GridItem
+{
+    int       type;
+    int       index;
+    glm::vec2 min;   // Canto mínimo (x, z)
+    glm::vec2 max;   // Canto máximo (x, z)
+};
+
+// Grade uniforme estática sobre o plano XZ do mundo.
+//
+// Os itens são inseridos uma vez, depois do posicionamento dos objetos, e
+// SpatialGrid_Build() monta para cada célula a lista dos itens cujo retângulo
+// a toca. As listas ficam contíguas em "cell_items", e "cell_start" indica
+// onde começa a lista de cada célula. Uma consulta por ponto apenas lê a lista
+// da célula que o contém, então o custo não depende do número de itens.
+struct SpatialGrid
+{
+    float                 cell_size;
+    glm::vec2             origin;     // Canto mínimo da grade
+    int                   width;      // Número de células em X
+    int                   height;     // Número de células em Z
+    std::vector<GridItem> items;
+    std::vector<int>      cell_start; // width*height+1 posições em cell_items
+    std::vector<int>      cell_items; // Índices em items, agrupados por célula
+};
+
+void SpatialGrid_Init(SpatialGrid* grid, float cell_size);
+
+// Insere um item e retorna o seu índice em grid->items. Só tem efeito nas
+// consultas depois da próxima chamada de SpatialGrid_Build().
+int SpatialGrid_Add(SpatialGrid* grid, int type, int index, const glm::vec2 &min, const glm::vec2 &max);
+
+void SpatialGrid_Build(SpatialGrid* grid);
+
+// Retorna os índices (em grid->items) dos itens cujo retângulo pode conter o
+// ponto (x, z), e o seu número em "count". Os retângulos ainda devem ser
+// testados: a célula pode ser maior que eles.
+const int* SpatialGrid_Query(const SpatialGrid* grid, float x, float z, int* count);
+
+#endif // _SPATIALGRID_H
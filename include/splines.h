@@ -0,0 +1,76 @@
+#ifndef _SPLINES_H
+#define _SPLINES_H
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// Tipos de curva
+#define SPLINE_BEZIER      0 // Cúbicas de Bézier encadeadas: pontos 0-3, 3-6, 6-9, ...
+#define SPLINE_CATMULL_ROM 1 // Catmull-Rom: a curva passa por todos os pontos
+
+// Modos de percorrer o caminho
+#define SPLINE_ONCE      0 // Para no final
+#define SPLINE_LOOP      1 // Volta ao início ao chegar no final
+#define SPLINE_PING_PONG 2 // Ida e volta
+
+#define SPLINE_SAMPLES_PER_SEGMENT 32 // Amostras da tabela de comprimento de arco por segmento
+
+// Caminho formado por segmentos cúbicos.
+//
+// Cada segmento é guardado na base de potências, p(u) = c0 + c1*u + c2*u^2 +
+// c3*u^3 com u em [0, 1], de modo que avaliar a curva custa três
+// multiplicações e somas por coordenada, sem pow(). O parâmetro global vai de
+// 0 a num_segments (segmento = parte inteira, u = parte fracionária).
+//
+// Como o parâmetro não é proporcional à distância percorrida, a tabela
+// "table_parameter" guarda o parâmetro em distâncias igualmente espaçadas
+// ao longo da curva: a posição a uma distância "s" do início é encontrada
+// com uma interpolação entre duas entradas vizinhas, sem busca, e objetos
+// que avançam a mesma distância a cada quadro andam com velocidade
+// constante.
+struct SplinePath
+{
+    int                type;
+    int                num_segments;
+    std::vector<float> cx, cy, cz;      // c0..c3 de cada segmento, em SoA: cx[4*segmento + k]
+    std::vector<float> table_parameter; // Parâmetro global nas distâncias i*length/(tamanho-1)
+    float              length;          // Comprimento aproximado do caminho
+};
+
+// Monta o caminho a partir dos pontos de controle. Para SPLINE_BEZIER são
+// 3*n+1 pontos; para SPLINE_CATMULL_ROM, pelo menos 2. Um caminho fechado
+// ("closed", só para Catmull-Rom) liga o último ponto ao primeiro, para ser
+// percorrido com SPLINE_LOOP sem saltos.
+void SplinePath_Build(SplinePath* path, int type, const glm::vec3* points, int count, bool closed = false);
+
+// Posição (e, se "tangent" não for NULL, a derivada) no parâmetro global;
+// zero em um caminho sem segmentos
+glm::vec3 SplinePath_Evaluate(const SplinePath* path, float parameter, glm::vec3* tangent = NULL);
+
+// Posição a uma distância "distance" (limitada a [0, length]) do início
+glm::vec3 SplinePath_PositionAt(const SplinePath* path, float distance, glm::vec3* tangent = NULL);
+
+// Muitos agentes percorrendo o mesmo caminho, em SoA: cada vetor tem uma
+// posição por agente.
+struct SplineAgents
+{
+    const SplinePath*  path;
+    int                mode;       // SPLINE_ONCE, SPLINE_LOOP ou SPLINE_PING_PONG
+    std::vector<float> distance;   // Distância até o início do caminho, em [0, length]
+    std::vector<float> speed;      // Metros por segundo; negativa enquanto volta pelo caminho
+    std::vector<float> x, y, z;    // Posições calculadas por SplineAgents_Advance()
+    std::vector<float> heading_x;  // Direção do movimento (derivada da curva com o sinal da
+    std::vector<float> heading_z;  // velocidade) no plano XZ, não normalizada
+};
+
+void SplineAgents_Init(SplineAgents* agents, const SplinePath* path, int mode);
+
+// Adiciona um agente e retorna o seu índice
+int SplineAgents_Add(SplineAgents* agents, float distance, float speed);
+
+// Avança todos os agentes "dt" segundos e calcula as suas posições. Usa SSE
+// de quatro em quatro agentes quando disponível.
+void SplineAgents_Advance(SplineAgents* agents, float dt);
+
+#endif // _SPLINES_H
@@ -0,0 +1,79 @@
+#ifndef _TERRAIN_H
+#define _TERRAIN_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/mat4x4.hpp>
+
+#include "collisions.h"
+
+// Geomipmapping: o terreno é desenhado em pedaços quadrados de
+// TERRAIN_PATCH_QUADS x TERRAIN_PATCH_QUADS quadrados do mapa de alturas. Os
+// pedaços mais distantes usam um nível mais grosso, que pula vértices: o
+// nível n usa um a cada 2^n vértices em cada direção.
+#define TERRAIN_PATCH_QUADS 32
+#define TERRAIN_LODS        5
+
+// Lados de um pedaço vizinhos a um pedaço de nível mais grosso. Nesses lados
+// os vértices ímpares são puxados para o vértice par anterior, de modo que a
+// borda fica igual à do vizinho e não aparecem frestas entre os dois.
+#define TERRAIN_STITCH_MIN_X 1
+#define TERRAIN_STITCH_MAX_X 2
+#define TERRAIN_STITCH_MIN_Z 4
+#define TERRAIN_STITCH_MAX_Z 8
+#define TERRAIN_STITCHES     16
+
+// Terreno definido por um mapa de alturas que se repete em X e em Z, então
+// cobre um mundo sem limites com memória fixa.
+//
+// As alturas ficam também em uma textura, lida pelo vertex shader: todos os
+// pedaços usam a mesma malha plana (uma grade de vértices com coordenadas
+// inteiras em X e Z), deslocada pela matriz de modelagem e com a altura de
+// cada vértice buscada na textura. O custo do desenho depende só de quantos
+// pedaços estão em volta da câmera, não do tamanho do mundo.
+struct Terrain
+{
+    int                size;        // Amostras em cada direção (potência de 2)
+    float              spacing;     // Distância entre amostras vizinhas, em metros
+    std::vector<float> heights;     // size*size alturas, linha a linha em Z
+    float              min_height;
+    float              max_height;
+
+    // Malha e textura na GPU (veja Terrain_Upload())
+    GLuint             heightmap_texture;
+    SceneObject        patch_objects[TERRAIN_LODS][TERRAIN_STITCHES]; // Índices de cada nível e combinação de lados costurados
+};
+
+// Pedaço do terreno escolhido para ser desenhado
+struct TerrainPatch
+{
+    int       px, pz;    // Coordenadas na grade de pedaços
+    int       lod;       // Nível de detalhe
+    int       stitch;    // Lados costurados (TERRAIN_STITCH_*)
+    glm::mat4 model;     // Translação até o canto do pedaço e escala pelo espaçamento
+};
+
+// Gera as alturas com ruído de valor em várias oitavas, repetindo a cada
+// size*spacing metros. Dentro de "flat_radius" da origem o terreno é plano, e
+// a altura cresce suavemente até "amplitude" nos "falloff" metros seguintes.
+void Terrain_Generate(Terrain* terrain, int size, float spacing, float amplitude, float flat_radius, float falloff, unsigned int seed);
+
+// Altura no ponto (x, z), interpolada bilinearmente entre as quatro amostras
+// em volta
+float Terrain_Height(const Terrain* terrain, float x, float z);
+
+// Cria a textura de alturas (associada à unidade de textura "texture_unit")
+// e a malha dos pedaços, com os índices de todos os níveis e costuras
+void Terrain_Upload(Terrain* terrain, GLuint texture_unit);
+
+// Escolhe os pedaços a até "view_radius" de (x, z). O nível de cada pedaço
+// dobra a cada vez que a distância passa de "lod_distance" vezes uma potência
+// de 2, e é ajustado para que vizinhos difiram em no máximo um nível.
+// Retorna o número de pedaços; "lod_counts" (se não for NULL) recebe quantos
+// há em cada nível.
+int Terrain_SelectPatches(const Terrain* terrain, float x, float z, float view_radius, float lod_distance,
+                          std::vector<TerrainPatch>* patches, int* lod_counts = NULL);
+
+#endif // _TERRAIN_H
@@ -0,0 +1,47 @@
+#ifndef _TRANSFORMS_H
+#define _TRANSFORMS_H
+
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "affine.h"
+
+#define TRANSFORM_ROOT -1 // "Pai" dos nós que ficam direto no mundo
+
+// Hierarquia de transformações (grafo de cena).
+//
+// Cada nó tem uma matriz local, relativa ao pai, e guarda a matriz do mundo
+// (pai * local) calculada na última atualização. Os nós ficam em vetores
+// paralelos na ordem em que foram criados e o pai é sempre criado antes do
+// filho, então uma única passada em ordem atualiza os pais antes dos filhos.
+//
+// Trocar a matriz local de um nó apenas o marca como "sujo". A atualização
+// começa no primeiro nó sujo e recalcula só os nós sujos e os descendentes
+// dos que mudaram; se nada mudou ela não faz nada. Por isso os nós que se
+// movem com frequência devem ser criados por último.
+struct TransformTree
+{
+    std::vector<int>           parent;
+    std::vector<Affine>        local;
+    std::vector<Affine>        world;
+    std::vector<glm::mat4>     world_matrix; // "world" em glm::mat4, pronta para a lista de desenho
+    std::vector<unsigned char> dirty;        // Matriz local trocada desde a última atualização
+    std::vector<unsigned char> changed;      // Matriz do mundo recalculada na última atualização
+    int                        first_dirty;  // Primeiro nó sujo (ou o número de nós, se nenhum)
+};
+
+void Transforms_Clear(TransformTree* tree);
+
+// Cria um nó filho de "parent" (ou TRANSFORM_ROOT) e retorna o seu índice.
+int Transforms_Add(TransformTree* tree, int parent, const Affine &local);
+
+// Troca a matriz local do nó. Não faz nada se ela for igual à atual, então
+// pode ser chamada a cada quadro mesmo para objetos que quase nunca se movem.
+void Transforms_SetLocal(TransformTree* tree, int node, const Affine &local);
+
+// Recalcula as matrizes do mundo que mudaram e retorna quantas foram
+// recalculadas.
+int Transforms_Update(TransformTree* tree);
+
+#endif // _TRANSFORMS_H
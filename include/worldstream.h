@@ -0,0 +1,96 @@
+#ifndef _WORLDSTREAM_H
+#define _WORLDSTREAM_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "entities.h"
+#include "meshcollision.h"
+#include "spatialgrid.h"
+
+// Pedaço quadrado do mundo, gerado por inteiro a partir da semente do mundo e
+// das suas coordenadas: o mesmo pedaço gerado de novo depois de descartado é
+// idêntico.
+struct WorldChunk
+{
+    int                            cx, cz;         // Coordenadas na grade de pedaços
+    EntityArrays                   trees;          // "node" não é usado: as matrizes ficam nos colisores
+    EntityArrays                   decorations;
+    std::vector<glm::mat4>         decoration_matrices;
+    std::vector<CollisionInstance> colliders;      // Um por árvore, na mesma ordem
+    SpatialGrid                    collision_grid; // Colisores do pedaço, como a grade dos colisores estáticos
+    size_t                         bytes;          // Memória ocupada, calculada depois da geração
+    double                         request_time;   // Quando o pedaço foi pedido (ms)
+    double                         load_ms;        // Tempo do pedido até o pedaço ficar pronto
+};
+
+// Mundo dividido em pedaços, gerados em uma thread própria à medida que o
+// jogador se aproxima e descartados quando ele se afasta.
+//
+// WorldStream_Update() é chamada a cada quadro com a posição do jogador: pede
+// os pedaços que faltam dentro de "load_radius", do mais próximo para o mais
+// distante, recebe os que ficaram prontos e descarta os que estão além de
+// "unload_radius". Se a memória dos pedaços passar de "budget_bytes", os mais
+// distantes são descartados primeiro, e novos pedidos só são feitos enquanto
+// houver espaço.
+//
+// O mapa "resident" só é alterado dentro de WorldStream_Update(), então quem
+// o lê em outra thread (ex.: as colisões na thread da simulação) precisa
+// apenas não ler ao mesmo tempo que ela é chamada.
+struct WorldStream
+{
+    float                              chunk_size;
+    float                              load_radius;
+    float                              unload_radius;
+    size_t                             budget_bytes;
+    unsigned int                       seed;
+    std::function<void(WorldChunk*)>   generate;      // Preenche um pedaço (chamada na thread de geração)
+
+    std::map<long long, WorldChunk*>   resident;      // Pedaços prontos, pela chave de WorldStream_Key()
+    std::map<long long, WorldChunk*>   pending;       // Pedidos ainda não prontos
+    size_t                             resident_bytes;
+    size_t                             last_chunk_bytes; // Tamanho do último pedaço pronto; zero antes do primeiro
+
+    // Compartilhados com a thread de geração
+    std::deque<WorldChunk*>            requests;      // Ordenados do mais próximo para o mais distante
+    std::vector<WorldChunk*>           completed;
+    std::mutex                         mutex;
+    std::condition_variable            wake;
+    std::thread                        thread;
+    bool                               running;
+
+    // Métricas
+    long long                          loads;
+    long long                          evictions;
+    double                             total_load_ms;
+    double                             max_load_ms;
+};
+
+// Inicia a thread de geração
+void WorldStream_Start(WorldStream* stream, float chunk_size, float load_radius, size_t budget_bytes,
+                       unsigned int seed, const std::function<void(WorldChunk*)> &generate);
+
+// Termina a thread e descarta todos os pedaços
+void WorldStream_Stop(WorldStream* stream);
+
+// Atualiza os pedaços em volta de (x, z). Retorna true se algum pedaço foi
+// carregado ou descartado.
+bool WorldStream_Update(WorldStream* stream, float x, float z);
+
+long long WorldStream_Key(int cx, int cz);
+
+// Pedaço pronto que contém o ponto (x, z) deslocado de (dx, dz) pedaços, ou NULL
+const WorldChunk* WorldStream_Find(const WorldStream* stream, float x, float z, int dx = 0, int dz = 0);
+
+// Semente para gerar um pedaço: depende só da semente do mundo e das
+// coordenadas do pedaço
+unsigned int WorldStream_ChunkSeed(unsigned int seed, int cx, int cz);
+
+#endif // _WORLDSTREAM_H
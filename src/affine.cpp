@@ -0,0 +1,233 @@
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AFFINE_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AFFINE_NEON
+#endif
+
+#include <glm/glm.hpp>
+
+#include "affine.h"
+
+static Affine Affine_Rows(float m00, float m01, float m02, float m03,
+                          float m10, float m11, float m12, float m13,
+                          float m20, float m21, float m22, float m23)
+{
+    Affine a;
+    a.m[0][0] = m00; a.m[0][1] = m01; a.m[0][2] = m02; a.m[0][3] = m03;
+    a.m[1][0] = m10; a.m[1][1] = m11; a.m[1][2] = m12; a.m[1][3] = m13;
+    a.m[2][0] = m20; a.m[2][1] = m21; a.m[2][2] = m22; a.m[2][3] = m23;
+    return a;
+}
+
+Affine Affine_Identity()
+{
+    return Affine_Rows(1.0f, 0.0f, 0.0f, 0.0f,
+                       0.0f, 1.0f, 0.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f, 0.0f);
+}
+
+Affine Affine_Translate(float tx, float ty, float tz)
+{
+    return Affine_Rows(1.0f, 0.0f, 0.0f, tx,
+                       0.0f, 1.0f, 0.0f, ty,
+                       0.0f, 0.0f, 1.0f, tz);
+}
+
+Affine Affine_Scale(float sx, float sy, float sz)
+{
+    return Affine_Rows(sx,   0.0f, 0.0f, 0.0f,
+                       0.0f, sy,   0.0f, 0.0f,
+                       0.0f, 0.0f, sz,   0.0f);
+}
+
+Affine Affine_Rotate_X(float angle)
+{
+    float c = cosf(angle);
+    float s = sinf(angle);
+    return Affine_Rows(1.0f, 0.0f, 0.0f, 0.0f,
+                       0.0f, c,    -s,   0.0f,
+                       0.0f, s,    c,    0.0f);
+}
+
+Affine Affine_Rotate_Y(float angle)
+{
+    float c = cosf(angle);
+    float s = sinf(angle);
+    return Affine_Rows(c,    0.0f, s,    0.0f,
+                       0.0f, 1.0f, 0.0f, 0.0f,
+                       -s,   0.0f, c,    0.0f);
+}
+
+Affine Affine_Rotate_Z(float angle)
+{
+    float c = cosf(angle);
+    float s = sinf(angle);
+    return Affine_Rows(c,    -s,   0.0f, 0.0f,
+                       s,    c,    0.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f, 0.0f);
+}
+
+Affine Affine_Rotate(float angle, const glm::vec3 &axis)
+{
+    // Fórmula de Rodrigues
+    float c = cosf(angle);
+    float s = sinf(angle);
+    glm::vec3 v = glm::normalize(axis);
+    return Affine_Rows(v.x*v.x*(1.0f-c)+c,     v.x*v.y*(1.0f-c)-v.z*s, v.x*v.z*(1.0f-c)+v.y*s, 0.0f,
+                       v.x*v.y*(1.0f-c)+v.z*s, v.y*v.y*(1.0f-c)+c,     v.y*v.z*(1.0f-c)-v.x*s, 0.0f,
+                       v.x*v.z*(1.0f-c)-v.y*s, v.y*v.z*(1.0f-c)+v.x*s, v.z*v.z*(1.0f-c)+c,     0.0f);
+}
+
+Affine Affine_TRS(const glm::vec3 &translation, float yaw, float pitch, float roll, const glm::vec3 &scale)
+{
+    float cy = cosf(yaw),   sy = sinf(yaw);
+    float cp = cosf(pitch), sp = sinf(pitch);
+    float cr = cosf(roll),  sr = sinf(roll);
+
+    // Ry*Rx*Rz multiplicadas simbolicamente; a escala multiplica as colunas
+    return Affine_Rows((cy*cr + sy*sp*sr)*scale.x, (sy*sp*cr - cy*sr)*scale.y, sy*cp*scale.z, translation.x,
+                       (cp*sr)*scale.x,            (cp*cr)*scale.y,            -sp*scale.z,   translation.y,
+                       (cy*sp*sr - sy*cr)*scale.x, (sy*sr + cy*sp*cr)*scale.y, cy*cp*scale.z, translation.z);
+}
+
+Affine Affine_Multiply(const Affine &a, const Affine &b)
+{
+    Affine r;
+
+    // Cada linha do resultado é uma combinação das linhas de "b", com os
+    // coeficientes da linha de "a"; a translação de "a" soma apenas na
+    // última coluna (a quarta linha de "b" é [0 0 0 1])
+#if defined(AFFINE_SSE)
+    __m128 b0 = _mm_loadu_ps(b.m[0]);
+    __m128 b1 = _mm_loadu_ps(b.m[1]);
+    __m128 b2 = _mm_loadu_ps(b.m[2]);
+    for (int i = 0; i < 3; ++i)
+    {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a.m[i][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[i][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[i][2]), b2));
+        row = _mm_add_ps(row, _mm_set_ps(a.m[i][3], 0.0f, 0.0f, 0.0f));
+        _mm_storeu_ps(r.m[i], row);
+    }
+#elif defined(AFFINE_NEON)
+    float32x4_t b0 = vld1q_f32(b.m[0]);
+    float32x4_t b1 = vld1q_f32(b.m[1]);
+    float32x4_t b2 = vld1q_f32(b.m[2]);
+    for (int i = 0; i < 3; ++i)
+    {
+        float32x4_t row = vmulq_n_f32(b0, a.m[i][0]);
+        row = vmlaq_n_f32(row, b1, a.m[i][1]);
+        row = vmlaq_n_f32(row, b2, a.m[i][2]);
+        vst1q_f32(r.m[i], row);
+        r.m[i][3] += a.m[i][3];
+    }
+#else
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            r.m[i][j] = a.m[i][0]*b.m[0][j] + a.m[i][1]*b.m[1][j] + a.m[i][2]*b.m[2][j];
+        r.m[i][3] += a.m[i][3];
+    }
+#endif
+
+    return r;
+}
+
+Affine Affine_Inverse(const Affine &a)
+{
+    glm::vec3 r0 = glm::vec3(a.m[0][0], a.m[0][1], a.m[0][2]);
+    glm::vec3 r1 = glm::vec3(a.m[1][0], a.m[1][1], a.m[1][2]);
+    glm::vec3 r2 = glm::vec3(a.m[2][0], a.m[2][1], a.m[2][2]);
+
+    // As colunas da inversa da parte 3x3 são os produtos vetoriais das suas
+    // linhas, divididos pelo determinante
+    glm::vec3 c0 = glm::cross(r1, r2);
+    glm::vec3 c1 = glm::cross(r2, r0);
+    glm::vec3 c2 = glm::cross(r0, r1);
+    float inverse_det = 1.0f / glm::dot(r0, c0);
+    c0 *= inverse_det;
+    c1 *= inverse_det;
+    c2 *= inverse_det;
+
+    glm::vec3 t = glm::vec3(a.m[0][3], a.m[1][3], a.m[2][3]);
+    return Affine_Rows(c0.x, c1.x, c2.x, -(c0.x*t.x + c1.x*t.y + c2.x*t.z),
+                       c0.y, c1.y, c2.y, -(c0.y*t.x + c1.y*t.y + c2.y*t.z),
+                       c0.z, c1.z, c2.z, -(c0.z*t.x + c1.z*t.y + c2.z*t.z));
+}
+
+glm::vec3 Affine_TransformPoint(const Affine &a, const glm::vec3 &p)
+{
+    return glm::vec3(a.m[0][0]*p.x + a.m[0][1]*p.y + a.m[0][2]*p.z + a.m[0][3],
+                     a.m[1][0]*p.x + a.m[1][1]*p.y + a.m[1][2]*p.z + a.m[1][3],
+                     a.m[2][0]*p.x + a.m[2][1]*p.y + a.m[2][2]*p.z + a.m[2][3]);
+}
+
+void Affine_TRSBatch(const Affine &rotation, const glm::vec3* translation, const float* scale, Affine* out, size_t count)
+{
+#if defined(AFFINE_SSE)
+    // A parte 3x3 de cada linha é a da rotação vezes a escala; a translação
+    // entra na quarta coluna, zerada na rotação por uma máscara
+    const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    __m128 r0 = _mm_and_ps(_mm_loadu_ps(rotation.m[0]), mask);
+    __m128 r1 = _mm_and_ps(_mm_loadu_ps(rotation.m[1]), mask);
+    __m128 r2 = _mm_and_ps(_mm_loadu_ps(rotation.m[2]), mask);
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m128 s = _mm_set1_ps(scale[i]);
+        _mm_storeu_ps(out[i].m[0], _mm_add_ps(_mm_mul_ps(r0, s), _mm_set_ps(translation[i].x, 0.0f, 0.0f, 0.0f)));
+        _mm_storeu_ps(out[i].m[1], _mm_add_ps(_mm_mul_ps(r1, s), _mm_set_ps(translation[i].y, 0.0f, 0.0f, 0.0f)));
+        _mm_storeu_ps(out[i].m[2], _mm_add_ps(_mm_mul_ps(r2, s), _mm_set_ps(translation[i].z, 0.0f, 0.0f, 0.0f)));
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (int row = 0; row < 3; ++row)
+            for (int col = 0; col < 3; ++col)
+                out[i].m[row][col] = rotation.m[row][col] * scale[i];
+        out[i].m[0][3] = translation[i].x;
+        out[i].m[1][3] = translation[i].y;
+        out[i].m[2][3] = translation[i].z;
+    }
+#endif
+}
+
+void Affine_MultiplyBatch(const Affine &parent, const Affine* local, Affine* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        out[i] = Affine_Multiply(parent, local[i]);
+}
+
+glm::mat4 Affine_ToMat4(const Affine &a)
+{
+    // glm::mat4 é guardada por colunas: a transposta das linhas, com a
+    // quarta linha [0 0 0 1]
+#if defined(AFFINE_SSE)
+    glm::mat4 r;
+    __m128 c0 = _mm_loadu_ps(a.m[0]);
+    __m128 c1 = _mm_loadu_ps(a.m[1]);
+    __m128 c2 = _mm_loadu_ps(a.m[2]);
+    __m128 c3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(&r[0][0], c0);
+    _mm_storeu_ps(&r[1][0], c1);
+    _mm_storeu_ps(&r[2][0], c2);
+    _mm_storeu_ps(&r[3][0], c3);
+    return r;
+#else
+    return glm::mat4(a.m[0][0], a.m[1][0], a.m[2][0], 0.0f,
+                     a.m[0][1], a.m[1][1], a.m[2][1], 0.0f,
+                     a.m[0][2], a.m[1][2], a.m[2][2], 0.0f,
+                     a.m[0][3], a.m[1][3], a.m[2][3], 1.0f);
+#endif
+}
+
+Affine Affine_FromMat4(const glm::mat4 &m)
+{
+    return Affine_Rows(m[0][0], m[1][0], m[2][0], m[3][0],
+                       m[0][1], m[1][1], m[2][1], m[3][1],
+                       m[0][2], m[1][2], m[2][2], m[3][2]);
+}
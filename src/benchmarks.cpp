@@ -0,0 +1,1027 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmarks.h"
+#include "affine.h"
+#include "splines.h"
+#include "placement.h"
+#include "collisions.h"
+#include "collisionbatch.h"
+#include "bvh.h"
+#include "meshcollision.h"
+#include "savegame.h"
+#include "drawlist.h"
+#include "jobs.h"
+
+// Impede que o compilador descarte os resultados dos laços medidos
+static volatile int g_BenchmarkSink;
+
+static double Benchmark_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void Benchmark_Report(const char* name, double ms, long long tests, long long hits)
+{
+    printf("  %-34s %9.2f ms  %7.3f ns/teste  %lld colisões\n", name, ms, ms * 1.0e6 / tests, hits);
+}
+
+static bool Benchmark_Check(long long expected, long long hits)
+{
+    if (expected == hits)
+        return true;
+    printf("  ERRO: esperava %lld colisões, obteve %lld\n", expected, hits);
+    return false;
+}
+
+// Versão de pointCubeCollision() com o objeto passado por valor, como era
+// antes: cada chamada copia o SceneObject, incluindo o std::string do nome.
+__attribute__((noinline))
+static bool PointCubeCollisionByValue(glm::vec4 point, SceneObject object, glm::vec3 position, float scale, float small_value)
+{
+    return pointCubeCollision(point, object, position, scale, small_value);
+}
+
+// Teste escalar equivalente a Collision_PointBoxes() para a caixa "i"
+static bool PointBoxMargin(const glm::vec4 &point, const CollisionBoxes &boxes, int i, float margin)
+{
+    return point.x - margin <= boxes.max_x[i] && point.x + margin >= boxes.min_x[i] &&
+           point.z - margin <= boxes.max_z[i] && point.z + margin >= boxes.min_z[i];
+}
+
+// Testes de colisão de um ponto contra muitos objetos: funções de
+// collisions.cpp (um objeto por chamada) contra os lotes SIMD de
+// collisionbatch.cpp (todos os objetos de uma vez, resultado em máscara).
+static bool Benchmark_Collisions()
+{
+    const int num_objects = 100000;
+    const int num_queries = 200;
+    const long long num_tests = (long long)num_objects * num_queries;
+    bool ok = true;
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+
+    std::vector<glm::vec4> queries(num_queries);
+    for (int q = 0; q < num_queries; ++q)
+        queries[q] = glm::vec4(coordinate(random), 2.5f, coordinate(random), 1.0f);
+
+    std::vector<uint32_t> hit_mask(CollisionBatch_MaskWords(num_objects));
+
+    printf("Colisões: %d objetos, %d pontos, %s\n", num_objects, num_queries,
+#if defined(__AVX512F__)
+           "AVX-512"
+#elif defined(__AVX__)
+           "AVX"
+#elif defined(__SSE2__)
+           "SSE2"
+#else
+           "sem SIMD"
+#endif
+           );
+
+    // Ponto-esfera
+    std::vector<glm::vec3> centers(num_objects);
+    std::vector<float> radii(num_objects);
+    CollisionSpheres spheres;
+    CollisionSpheres_Clear(&spheres);
+    for (int i = 0; i < num_objects; ++i)
+    {
+        centers[i] = glm::vec3(coordinate(random), 0.0f, coordinate(random));
+        radii[i] = size(random) * 2.0f;
+        CollisionSpheres_Add(&spheres, centers[i], radii[i]);
+    }
+
+    long long hits = 0;
+    double start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        for (int i = 0; i < num_objects; ++i)
+            hits += pointSphereCollision(queries[q], centers[i], radii[i]);
+    Benchmark_Report("pointSphereCollision", Benchmark_Now() - start, num_tests, hits);
+    long long expected = hits;
+
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        hits += Collision_PointSpheres(&spheres, queries[q], hit_mask.data());
+    Benchmark_Report("Collision_PointSpheres", Benchmark_Now() - start, num_tests, hits);
+    ok = Benchmark_Check(expected, hits) && ok;
+
+    // Ponto-cubo, com o mesmo objeto (e nome) das árvores do jogo
+    SceneObject tree;
+    tree.name = "Tree_Spruce_small_01_Cylinder.016";
+    tree.first_index = tree.num_indices = 0;
+    tree.rendering_mode = 0;
+    tree.vertex_array_object_id = 0;
+    tree.bbox_min = glm::vec3(-4.5f, 0.0f, -4.5f);
+    tree.bbox_max = glm::vec3( 4.5f, 9.0f,  4.5f);
+    const float small_value = 3.5f;
+
+    std::vector<glm::vec3> positions(num_objects);
+    std::vector<float> scales(num_objects);
+    CollisionBoxes boxes;
+    CollisionBoxes_Clear(&boxes);
+    for (int i = 0; i < num_objects; ++i)
+    {
+        positions[i] = glm::vec3(coordinate(random), 0.0f, coordinate(random));
+        scales[i] = size(random);
+        glm::vec2 position = glm::vec2(positions[i].x, positions[i].z);
+        CollisionBoxes_Add(&boxes, (glm::vec2(tree.bbox_min.x, tree.bbox_min.z) + small_value) * scales[i] + position,
+                                   (glm::vec2(tree.bbox_max.x, tree.bbox_max.z) - small_value) * scales[i] + position);
+    }
+
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        for (int i = 0; i < num_objects; ++i)
+            hits += PointCubeCollisionByValue(queries[q], tree, positions[i], scales[i], small_value);
+    Benchmark_Report("pointCubeCollision (por valor)", Benchmark_Now() - start, num_tests, hits);
+    expected = hits;
+
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        for (int i = 0; i < num_objects; ++i)
+            hits += pointCubeCollision(queries[q], tree, positions[i], scales[i], small_value);
+    Benchmark_Report("pointCubeCollision", Benchmark_Now() - start, num_tests, hits);
+    ok = Benchmark_Check(expected, hits) && ok;
+
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        hits += Collision_PointBoxes(&boxes, queries[q], 0.0f, hit_mask.data());
+    Benchmark_Report("Collision_PointBoxes", Benchmark_Now() - start, num_tests, hits);
+    ok = Benchmark_Check(expected, hits) && ok;
+
+    // Caixa de 0,3 m em volta do ponto (como a antiga caixa do jogador)
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        for (int i = 0; i < num_objects; ++i)
+            hits += PointBoxMargin(queries[q], boxes, i, 0.15f);
+    Benchmark_Report("caixa com margem (escalar)", Benchmark_Now() - start, num_tests, hits);
+    expected = hits;
+
+    hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        hits += Collision_PointBoxes(&boxes, queries[q], 0.15f, hit_mask.data());
+    Benchmark_Report("Collision_PointBoxes (margem)", Benchmark_Now() - start, num_tests, hits);
+    ok = Benchmark_Check(expected, hits) && ok;
+
+    g_BenchmarkSink = (int)hit_mask[0];
+    return ok;
+}
+
+// Força bruta: testa o raio contra todas as caixas
+static bool Benchmark_RaycastBruteForce(const Bvh* bvh, const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, BvhHit* hit)
+{
+    bool found = false;
+    for (size_t i = 0; i < bvh->items.size(); ++i)
+    {
+        const BvhItem &item = bvh->items[i];
+        glm::vec3 t1 = (item.min - origin) / direction;
+        glm::vec3 t2 = (item.max - origin) / direction;
+        glm::vec3 t_near = glm::min(t1, t2);
+        glm::vec3 t_far = glm::max(t1, t2);
+        float t_min = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+        float t_max = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance));
+        if (t_min <= t_max && (!found || t_min < hit->distance))
+        {
+            found = true;
+            hit->id = item.id;
+            hit->distance = t_min;
+        }
+    }
+    return found;
+}
+
+// Raios e segmentos aleatórios contra uma BVH de caixas espalhadas como as
+// árvores do mapa, comparados com o teste contra todas as caixas.
+static bool Benchmark_Bvh()
+{
+    const int num_boxes = 100000;
+    const int num_rays = 2000000;
+    const int num_checked = 2000; // Raios conferidos com a força bruta
+    const float max_distance = 200.0f;
+    bool ok = true;
+
+    std::mt19937 random(4321);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    Bvh bvh;
+    Bvh_Clear(&bvh);
+    for (int i = 0; i < num_boxes; ++i)
+    {
+        glm::vec3 base = glm::vec3(coordinate(random), 0.0f, coordinate(random));
+        float half_width = size(random);
+        Bvh_Add(&bvh, 0, i, base - glm::vec3(half_width, 0.0f, half_width), base + glm::vec3(half_width, 5.0f * half_width, half_width));
+    }
+
+    double start = Benchmark_Now();
+    Bvh_Build(&bvh);
+    printf("BVH: %d caixas, %zu nós, construída em %.2f ms\n", num_boxes, bvh.nodes.size(), Benchmark_Now() - start);
+
+    std::vector<glm::vec3> origins(num_rays);
+    std::vector<glm::vec3> directions(num_rays);
+    for (int r = 0; r < num_rays; ++r)
+    {
+        origins[r] = glm::vec3(coordinate(random), 2.5f + 5.0f * unit(random), coordinate(random));
+        glm::vec3 direction;
+        do {
+            direction = glm::vec3(unit(random), 0.3f * unit(random), unit(random));
+        } while (glm::length(direction) < 0.1f);
+        directions[r] = glm::normalize(direction);
+    }
+
+    BvhHit hit, expected_hit;
+    long long hits = 0;
+    start = Benchmark_Now();
+    for (int r = 0; r < num_rays; ++r)
+        hits += Bvh_Raycast(&bvh, origins[r], directions[r], max_distance, &hit);
+    double ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %7.1f ns/raio  %.2f Mraios/s  %lld acertos\n", "Bvh_Raycast", ms, ms * 1.0e6 / num_rays, num_rays / (ms * 1000.0), hits);
+
+    start = Benchmark_Now();
+    hits = 0;
+    for (int r = 0; r < num_rays; ++r)
+        hits += Bvh_Segment(&bvh, origins[r], origins[r] + directions[r] * 10.0f, &hit);
+    ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %7.1f ns/seg.  %.2f Mseg./s  %lld acertos\n", "Bvh_Segment (10 m)", ms, ms * 1.0e6 / num_rays, num_rays / (ms * 1000.0), hits);
+
+    int mismatches = 0;
+    start = Benchmark_Now();
+    for (int r = 0; r < num_checked; ++r)
+    {
+        bool found = Benchmark_RaycastBruteForce(&bvh, origins[r], directions[r], max_distance, &expected_hit);
+        bool found_bvh = Bvh_Raycast(&bvh, origins[r], directions[r], max_distance, &hit);
+        if (found != found_bvh || (found && fabs(hit.distance - expected_hit.distance) > 1.0e-4f))
+            mismatches += 1;
+    }
+    ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %7.1f ns/raio  (%d raios)\n", "força bruta", ms, ms * 1.0e6 / num_checked, num_checked);
+
+    if (mismatches > 0)
+    {
+        printf("  ERRO: %d de %d raios com resultado diferente da força bruta\n", mismatches, num_checked);
+        ok = false;
+    }
+
+    return ok;
+}
+
+// Cápsulas do tamanho da do jogador em volta de uma malha irregular parecida
+// com um tronco (e com tantos triângulos quanto a árvore gigante), comparadas
+// com o teste contra cada triângulo isoladamente.
+static bool Benchmark_Meshes()
+{
+    const int num_segments = 48;
+    const int num_rings = 25;
+    const int num_queries = 1000000;
+    const int num_checked = 2000; // Cápsulas conferidas com a força bruta
+    bool ok = true;
+
+    std::mt19937 random(2468);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Tronco de 10 m de altura com raio variando entre ~1 e ~3 m
+    std::vector<glm::vec3> grid((num_rings + 1) * (num_segments + 1));
+    for (int ring = 0; ring <= num_rings; ++ring)
+        for (int segment = 0; segment <= num_segments; ++segment)
+        {
+            float angle = 2.0f * 3.14159265f * segment / num_segments;
+            float height = 10.0f * ring / num_rings;
+            float radius = 2.0f + 0.6f * sinf(3.0f * angle + height) + 0.4f * cosf(1.7f * height);
+            grid[ring * (num_segments + 1) + segment] = glm::vec3(radius * cosf(angle), height, radius * sinf(angle));
+        }
+
+    std::vector<float> positions;
+    for (int ring = 0; ring < num_rings; ++ring)
+        for (int segment = 0; segment < num_segments; ++segment)
+        {
+            int i = ring * (num_segments + 1) + segment;
+            int corners[6] = {i, i + num_segments + 1, i + 1, i + 1, i + num_segments + 1, i + num_segments + 2};
+            for (int c = 0; c < 6; ++c)
+            {
+                positions.push_back(grid[corners[c]].x);
+                positions.push_back(grid[corners[c]].y);
+                positions.push_back(grid[corners[c]].z);
+                positions.push_back(1.0f);
+            }
+        }
+    int num_vertices = (int)positions.size() / 4;
+
+    glm::mat4 model = glm::mat4(1.0f);
+    model[0][0] = model[1][1] = model[2][2] = 1.5f;
+    model[3] = glm::vec4(10.0f, 0.0f, -5.0f, 1.0f);
+
+    CollisionMesh mesh;
+    double start = Benchmark_Now();
+    CollisionMesh_Build(&mesh, positions.data(), num_vertices, 4);
+    printf("Malha: %d triângulos, %zu nós, construída em %.2f ms\n", num_vertices / 3, mesh.bvh.nodes.size(), Benchmark_Now() - start);
+
+    CollisionInstance instance;
+    CollisionInstance_Init(&instance, 0, 0, &mesh, model, 1.5f);
+
+    // Força bruta: uma malha com um único triângulo para cada triângulo
+    std::vector<CollisionMesh> triangles(num_vertices / 3);
+    std::vector<CollisionInstance> triangle_instances(num_vertices / 3);
+    for (int t = 0; t < num_vertices / 3; ++t)
+    {
+        CollisionMesh_Build(&triangles[t], positions.data() + 12 * t, 3, 4);
+        CollisionInstance_Init(&triangle_instances[t], 0, t, &triangles[t], model, 1.5f);
+    }
+
+    // Cápsulas verticais de 0,4 m de raio em volta da superfície
+    std::vector<CollisionCapsule> capsules(num_queries);
+    for (int q = 0; q < num_queries; ++q)
+    {
+        float angle = 2.0f * 3.14159265f * unit(random);
+        float distance = 1.0f + 5.0f * unit(random);
+        glm::vec3 base = glm::vec3(10.0f + distance * cosf(angle), 0.7f + 12.0f * unit(random), -5.0f + distance * sinf(angle));
+        capsules[q].a = base;
+        capsules[q].b = base + glm::vec3(0.0f, 1.8f, 0.0f);
+        capsules[q].radius = 0.4f;
+    }
+
+    // As primeiras atravessam o tronco inteiro, com bem mais do que
+    // MESH_COLLISION_MAX_CANDIDATES triângulos em volta
+    for (int q = 0; q < 10; ++q)
+    {
+        capsules[q].a = glm::vec3(10.0f + 0.3f * q, 1.0f, -5.0f);
+        capsules[q].b = capsules[q].a + glm::vec3(0.0f, 12.0f, 0.0f);
+        capsules[q].radius = 2.5f;
+    }
+
+    CollisionContact contact, expected_contact;
+    long long hits = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_queries; ++q)
+        hits += Collision_CapsuleMesh(&instance, capsules[q], &contact);
+    double ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %7.1f ns/cápsula  %lld contatos\n", "Collision_CapsuleMesh", ms, ms * 1.0e6 / num_queries, hits);
+
+    int mismatches = 0;
+    start = Benchmark_Now();
+    for (int q = 0; q < num_checked; ++q)
+    {
+        float expected_depth = 0.0f;
+        for (size_t t = 0; t < triangle_instances.size(); ++t)
+            if (Collision_CapsuleMesh(&triangle_instances[t], capsules[q], &expected_contact))
+                expected_depth = std::max(expected_depth, expected_contact.depth);
+
+        float depth = Collision_CapsuleMesh(&instance, capsules[q], &contact) ? contact.depth : 0.0f;
+        if (fabs(depth - expected_depth) > 1.0e-4f)
+            mismatches += 1;
+    }
+    ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %7.1f ns/cápsula  (%d cápsulas)\n", "força bruta", ms, ms * 1.0e6 / num_checked, num_checked);
+
+    if (mismatches > 0)
+    {
+        printf("  ERRO: %d de %d cápsulas com resultado diferente da força bruta\n", mismatches, num_checked);
+        ok = false;
+    }
+
+    return ok;
+}
+
+// Maior diferença relativa entre os coeficientes de uma matriz afim e de uma 4x4
+static float Benchmark_MatrixError(const Affine &a, const glm::mat4 &m)
+{
+    glm::mat4 converted = Affine_ToMat4(a);
+    float error = 0.0f;
+    for (int col = 0; col < 4; ++col)
+        for (int row = 0; row < 4; ++row)
+            error = std::max(error, (float)(fabs(converted[col][row] - m[col][row]) / std::max(1.0, fabs(m[col][row]))));
+    return error;
+}
+
+// Matrizes de modelagem das instâncias (translação * rotação * escala, como
+// as das árvores e do machado), montadas com as 4x4 da GLM e com as afins,
+// que também são conferidas com as da GLM.
+static bool Benchmark_Matrices()
+{
+    const int num_instances = 4096;
+    const int num_rounds = 500;
+    const float max_error = 1.0e-4f;
+    bool ok = true;
+
+    std::mt19937 random(1357);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+    std::uniform_real_distribution<float> size(0.5f, 1.3f);
+
+    std::vector<glm::vec3> translations(num_instances);
+    std::vector<glm::vec3> angles(num_instances);
+    std::vector<float> scales(num_instances);
+    for (int i = 0; i < num_instances; ++i)
+    {
+        translations[i] = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+        angles[i] = glm::vec3(angle(random), angle(random), angle(random));
+        scales[i] = size(random);
+    }
+
+    // Conferência com a GLM
+    float error = 0.0f;
+    for (int i = 0; i < num_instances; ++i)
+    {
+        const glm::vec3 &t = translations[i];
+        const glm::vec3 &r = angles[i];
+        glm::vec3 s = glm::vec3(scales[i], 2.0f * scales[i], 0.5f * scales[i]);
+        glm::mat4 expected = glm::translate(glm::mat4(1.0f), t)
+                           * glm::rotate(glm::mat4(1.0f), r.x, glm::vec3(0.0f, 1.0f, 0.0f))
+                           * glm::rotate(glm::mat4(1.0f), r.y, glm::vec3(1.0f, 0.0f, 0.0f))
+                           * glm::rotate(glm::mat4(1.0f), r.z, glm::vec3(0.0f, 0.0f, 1.0f))
+                           * glm::scale(glm::mat4(1.0f), s);
+        Affine trs = Affine_TRS(t, r.x, r.y, r.z, s);
+        error = std::max(error, Benchmark_MatrixError(trs, expected));
+        error = std::max(error, Benchmark_MatrixError(Affine_Inverse(trs), glm::inverse(expected)));
+        error = std::max(error, Benchmark_MatrixError(Affine_FromMat4(expected), expected));
+
+        glm::mat4 chain = glm::translate(glm::mat4(1.0f), t)
+                        * glm::rotate(glm::mat4(1.0f), r.x, glm::vec3(1.0f, 0.0f, 0.0f))
+                        * glm::rotate(glm::mat4(1.0f), r.y, r)
+                        * glm::scale(glm::mat4(1.0f), s);
+        Affine affine_chain = Affine_Multiply(Affine_Multiply(Affine_Multiply(Affine_Translate(t.x, t.y, t.z), Affine_Rotate_X(r.x)),
+                                                              Affine_Rotate(r.y, r)),
+                                              Affine_Scale(s.x, s.y, s.z));
+        error = std::max(error, Benchmark_MatrixError(affine_chain, chain));
+
+        glm::vec3 point = glm::vec3(expected * glm::vec4(r, 1.0f));
+        error = std::max(error, glm::length(Affine_TransformPoint(trs, r) - point) / 100.0f);
+    }
+
+    Affine wind = Affine_Rotate_X(0.005f);
+    std::vector<Affine> models(num_instances);
+    Affine_TRSBatch(wind, translations.data(), scales.data(), models.data(), num_instances);
+    for (int i = 0; i < num_instances; ++i)
+    {
+        glm::mat4 expected = glm::translate(glm::mat4(1.0f), translations[i])
+                           * glm::rotate(glm::mat4(1.0f), 0.005f, glm::vec3(1.0f, 0.0f, 0.0f))
+                           * glm::scale(glm::mat4(1.0f), glm::vec3(scales[i]));
+        error = std::max(error, Benchmark_MatrixError(models[i], expected));
+    }
+
+    printf("Matrizes: %d instâncias, maior erro relativo à GLM %.2g\n", num_instances, error);
+    if (!(error <= max_error))
+    {
+        printf("  ERRO: erro acima de %.2g\n", max_error);
+        ok = false;
+    }
+
+    // Tempos: cada rodada monta as matrizes de todas as instâncias
+    std::vector<glm::mat4> glm_models(num_instances);
+    double start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        for (int i = 0; i < num_instances; ++i)
+            glm_models[i] = glm::translate(glm::mat4(1.0f), translations[i])
+                          * glm::rotate(glm::mat4(1.0f), angles[i].x, glm::vec3(0.0f, 1.0f, 0.0f))
+                          * glm::rotate(glm::mat4(1.0f), angles[i].y, glm::vec3(1.0f, 0.0f, 0.0f))
+                          * glm::rotate(glm::mat4(1.0f), angles[i].z, glm::vec3(0.0f, 0.0f, 1.0f))
+                          * glm::scale(glm::mat4(1.0f), glm::vec3(scales[i]));
+    double ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)glm_models[num_instances / 2][3][0];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "GLM T*Ry*Rx*Rz*S (4x4)", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        for (int i = 0; i < num_instances; ++i)
+            models[i] = Affine_TRS(translations[i], angles[i].x, angles[i].y, angles[i].z, glm::vec3(scales[i]));
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)models[num_instances / 2].m[0][3];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "Affine_TRS", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    glm::mat4 glm_wind = glm::rotate(glm::mat4(1.0f), 0.005f, glm::vec3(1.0f, 0.0f, 0.0f));
+    start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        for (int i = 0; i < num_instances; ++i)
+            glm_models[i] = glm::translate(glm::mat4(1.0f), translations[i]) * glm_wind * glm::scale(glm::mat4(1.0f), glm::vec3(scales[i]));
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)glm_models[num_instances / 2][3][0];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "GLM T*R*S (4x4)", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        Affine_TRSBatch(wind, translations.data(), scales.data(), models.data(), num_instances);
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)models[num_instances / 2].m[0][3];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "Affine_TRSBatch", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        for (int i = 0; i < num_instances; ++i)
+            glm_models[i] = glm::inverse(glm_models[i]);
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)glm_models[num_instances / 2][3][0];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "glm::inverse (4x4)", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    start = Benchmark_Now();
+    for (int round = 0; round < num_rounds; ++round)
+        for (int i = 0; i < num_instances; ++i)
+            models[i] = Affine_Inverse(models[i]);
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)models[num_instances / 2].m[0][3];
+    printf("  %-34s %9.2f ms  %7.1f ns/matriz\n", "Affine_Inverse", ms, ms * 1.0e6 / (num_rounds * num_instances));
+
+    return ok;
+}
+
+// Curva de Bézier como era calculada para as galinhas, com pow() em cada termo
+static glm::vec3 Benchmark_PowBezier(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float t)
+{
+    float x = pow(1-t,3)*p0.x + 3*t*pow(1-t,2)*p1.x + 3*pow(t,2)*(1-t)*p2.x + pow(t,3)*p3.x;
+    float z = pow(1-t,3)*p0.y + 3*t*pow(1-t,2)*p1.y + 3*pow(t,2)*(1-t)*p2.y + pow(t,3)*p3.y;
+    return glm::vec3(x, 0.0f, z);
+}
+
+// Agentes andando em caminhos Catmull-Rom (fechado, em laço) e Bézier (ida e
+// volta). Confere as posições calculadas em lote com SplinePath_PositionAt(),
+// a volta/reflexão nas pontas e a velocidade constante ao longo da curva.
+static bool Benchmark_Splines()
+{
+    const int num_agents = 10000;
+    const int num_frames = 1000;
+    const float frame_dt = 1.0f / 60.0f;
+    bool ok = true;
+
+    std::mt19937 random(9753);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Laço irregular em volta da origem
+    std::vector<glm::vec3> loop_points;
+    for (int i = 0; i < 16; ++i)
+    {
+        float angle = 2.0f * 3.14159265f * i / 16;
+        float radius = 40.0f + 15.0f * unit(random);
+        loop_points.push_back(glm::vec3(radius * cosf(angle), 2.0f * unit(random), radius * sinf(angle)));
+    }
+    SplinePath loop;
+    SplinePath_Build(&loop, SPLINE_CATMULL_ROM, loop_points.data(), (int)loop_points.size(), true);
+
+    // Caminho das galinhas
+    glm::vec2 p0 = glm::vec2(-22.66f, -18.40f), p1 = glm::vec2(-6.60f, -23.68f);
+    glm::vec2 p2 = glm::vec2(8.76f, -17.90f),   p3 = glm::vec2(16.43f, -9.21f);
+    glm::vec3 chicken_points[4] = {glm::vec3(p0.x, 0.0f, p0.y), glm::vec3(p1.x, 0.0f, p1.y),
+                                   glm::vec3(p2.x, 0.0f, p2.y), glm::vec3(p3.x, 0.0f, p3.y)};
+    SplinePath bezier;
+    SplinePath_Build(&bezier, SPLINE_BEZIER, chicken_points, 4);
+
+    printf("Splines: laço de %.1f m (%d segmentos), Bézier de %.1f m, %d agentes\n",
+           loop.length, loop.num_segments, bezier.length, num_agents);
+
+    SplineAgents agents[2];
+    SplineAgents_Init(&agents[0], &loop, SPLINE_LOOP);
+    SplineAgents_Init(&agents[1], &bezier, SPLINE_PING_PONG);
+    for (int a = 0; a < 2; ++a)
+        for (int i = 0; i < num_agents; ++i)
+        {
+            float speed = 1.0f + 9.0f * unit(random);
+            SplineAgents_Add(&agents[a], agents[a].path->length * unit(random), unit(random) < 0.5f ? -speed : speed);
+        }
+
+    // Um passo conferido com a versão escalar, agente por agente
+    float max_error = 0.0f;
+    int wrap_errors = 0;
+    for (int a = 0; a < 2; ++a)
+    {
+        SplineAgents &group = agents[a];
+        float length = group.path->length;
+        float dt = 0.5f; // Passo longo, para que muitos agentes passem das pontas
+        std::vector<float> distance = group.distance;
+        std::vector<float> speed = group.speed;
+        SplineAgents_Advance(&group, dt);
+
+        for (int i = 0; i < num_agents; ++i)
+        {
+            float expected = distance[i] + speed[i] * dt;
+            float expected_speed = speed[i];
+            if (group.mode == SPLINE_LOOP)
+                expected -= length * floorf(expected / length);
+            else if (expected > length || expected < 0.0f)
+            {
+                expected = expected > length ? 2.0f * length - expected : -expected;
+                expected_speed = -expected_speed;
+            }
+            if (fabs(group.distance[i] - expected) > 1.0e-3f || group.speed[i] != expected_speed)
+                wrap_errors += 1;
+
+            glm::vec3 tangent;
+            glm::vec3 position = SplinePath_PositionAt(group.path, group.distance[i], &tangent);
+            max_error = std::max(max_error, glm::length(position - glm::vec3(group.x[i], group.y[i], group.z[i])));
+            if ((tangent.x * group.heading_x[i] + tangent.z * group.heading_z[i]) * group.speed[i] < 0.0f)
+                wrap_errors += 1; // Direção contrária ao movimento
+        }
+    }
+    printf("  maior diferença do lote para a versão escalar: %.2g m\n", max_error);
+    if (max_error > 1.0e-3f || wrap_errors > 0)
+    {
+        printf("  ERRO: %d agentes com distância, sentido ou direção errados\n", wrap_errors);
+        ok = false;
+    }
+
+    // Velocidade ao longo da curva: distância percorrida em passos iguais,
+    // em relação à média, com o parâmetro "t" e com a tabela
+    const int num_steps = 500;
+    float min_t = 1.0e9f, max_t = 0.0f, min_s = 1.0e9f, max_s = 0.0f;
+    for (int k = 0; k < num_steps; ++k)
+    {
+        float t_step = glm::length(Benchmark_PowBezier(p0, p1, p2, p3, (k + 1.0f) / num_steps) - Benchmark_PowBezier(p0, p1, p2, p3, (float)k / num_steps));
+        float s_step = glm::length(SplinePath_PositionAt(&bezier, bezier.length * (k + 1.0f) / num_steps) - SplinePath_PositionAt(&bezier, bezier.length * k / num_steps));
+        min_t = std::min(min_t, t_step); max_t = std::max(max_t, t_step);
+        min_s = std::min(min_s, s_step); max_s = std::max(max_s, s_step);
+    }
+    float mean = bezier.length / num_steps;
+    printf("  velocidade na Bézier: parâmetro t %.0f%% a %.0f%%, comprimento de arco %.1f%% a %.1f%% da média\n",
+           100.0f * min_t / mean, 100.0f * max_t / mean, 100.0f * min_s / mean, 100.0f * max_s / mean);
+    if (max_s / mean > 1.01f || min_s / mean < 0.99f)
+    {
+        printf("  ERRO: velocidade não constante\n");
+        ok = false;
+    }
+
+    // Tempos: cada quadro avança todos os agentes das duas curvas
+    std::vector<float> t(num_agents);
+    for (int i = 0; i < num_agents; ++i)
+        t[i] = unit(random);
+    float sum = 0.0f;
+    double start = Benchmark_Now();
+    for (int frame = 0; frame < num_frames; ++frame)
+        for (int i = 0; i < num_agents; ++i)
+        {
+            t[i] += 0.001f;
+            if (t[i] >= 1.0f)
+                t[i] = 0.0f;
+            sum += Benchmark_PowBezier(p0, p1, p2, p3, t[i]).x;
+        }
+    double ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)sum;
+    printf("  %-34s %9.2f ms  %7.1f ns/agente\n", "Bézier com pow() (original)", ms, ms * 1.0e6 / ((double)num_frames * num_agents));
+
+    start = Benchmark_Now();
+    for (int frame = 0; frame < num_frames; ++frame)
+        for (int a = 0; a < 2; ++a)
+            for (int i = 0; i < num_agents; ++i)
+                sum += SplinePath_PositionAt(agents[a].path, agents[a].distance[i] + frame * frame_dt).x;
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)sum;
+    printf("  %-34s %9.2f ms  %7.1f ns/agente\n", "SplinePath_PositionAt", ms, ms * 1.0e6 / (2.0 * num_frames * num_agents));
+
+    start = Benchmark_Now();
+    for (int frame = 0; frame < num_frames; ++frame)
+        for (int a = 0; a < 2; ++a)
+            SplineAgents_Advance(&agents[a], frame_dt);
+    ms = Benchmark_Now() - start;
+    g_BenchmarkSink = (int)agents[0].x[num_agents / 2];
+    printf("  %-34s %9.2f ms  %7.1f ns/agente\n", "SplineAgents_Advance", ms, ms * 1.0e6 / (2.0 * num_frames * num_agents));
+
+    return ok;
+}
+
+// Conta os objetos que sobrepõem algum dos anteriores, inserindo-os um a um
+// em uma grade nova
+static int Benchmark_CountOverlaps(const std::vector<float> &x, const std::vector<float> &z, float radius, float extent)
+{
+    Placement check;
+    Placement_Init(&check, glm::vec2(-extent), glm::vec2(extent), 2.0f * radius);
+    int overlaps = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        if (!Placement_Fits(&check, x[i], z[i], radius))
+            overlaps += 1;
+        Placement_Insert(&check, x[i], z[i], radius);
+    }
+    return overlaps;
+}
+
+static bool Benchmark_Placement()
+{
+    const int num_objects = 100000;
+    const float radius = 0.5f;
+    const unsigned int seed = 20240611;
+    bool ok = true;
+
+    PlacementExclusion exclusions[2] = {{glm::vec2(-4.0f, -10.0f), 3.0f}, {glm::vec2(0.0f, 0.0f), 20.0f}};
+    PlacementRegion scatter_region = {glm::vec2(0.0f), 50.0f, 600.0f, exclusions, 2};
+    PlacementRegion fill_region = {glm::vec2(0.0f), 50.0f, 250.0f, exclusions, 2};
+
+    printf("Posicionamento: %d objetos de raio %.1f m\n", num_objects, radius);
+
+    // Laço original: rand() com rejeição por pow(), sem testar sobreposição
+    // (posições inteiras em um quadrado de 500 m)
+    std::vector<float> original_x(num_objects), original_z(num_objects);
+    double start = Benchmark_Now();
+    for (int i = 0; i < num_objects; ++i)
+    {
+        float random_x, random_z;
+        do{
+            random_x = rand() % 500 - 250;
+            random_z = rand() % 500 - 250;
+        }while((pow(random_x,2) + pow(random_z,2) <= pow(50,2)) ||
+               (pow(random_x,2) + pow(random_z,2) >= pow(250,2)));
+        original_x[i] = random_x;
+        original_z[i] = random_z;
+    }
+    double ms = Benchmark_Now() - start;
+    int overlaps = Benchmark_CountOverlaps(original_x, original_z, radius, 600.0f);
+    printf("  %-34s %9.2f ms  %7.1f ns/objeto  %d sobrepostos\n", "rand() e pow() (original)", ms, ms * 1.0e6 / num_objects, overlaps);
+
+    // Posições uniformes sem sobreposição
+    Placement scatter;
+    PlacementRandom random;
+    PlacementRandom_Seed(&random, seed);
+    start = Benchmark_Now();
+    Placement_Init(&scatter, glm::vec2(-600.0f), glm::vec2(600.0f), 2.0f * radius);
+    int scattered = Placement_Scatter(&scatter, &random, scatter_region, radius, num_objects);
+    ms = Benchmark_Now() - start;
+    overlaps = Benchmark_CountOverlaps(scatter.x, scatter.z, radius, 600.0f);
+    printf("  %-34s %9.2f ms  %7.1f ns/objeto  %d sobrepostos\n", "Placement_Scatter", ms, ms * 1.0e6 / scattered, overlaps);
+    if (scattered != num_objects || overlaps != 0)
+    {
+        printf("  ERRO: %d objetos colocados, %d sobrepostos\n", scattered, overlaps);
+        ok = false;
+    }
+
+    // Preenchimento máximo do anel
+    Placement fill;
+    PlacementRandom_Seed(&random, seed);
+    start = Benchmark_Now();
+    Placement_Init(&fill, glm::vec2(-250.0f), glm::vec2(250.0f), 2.0f * radius);
+    int filled = Placement_Fill(&fill, &random, fill_region, radius, 1 << 30);
+    ms = Benchmark_Now() - start;
+    overlaps = Benchmark_CountOverlaps(fill.x, fill.z, radius, 250.0f);
+    printf("  %-34s %9.2f ms  %7.1f ns/objeto  %d sobrepostos (%d objetos)\n", "Placement_Fill", ms, ms * 1.0e6 / filled, overlaps, filled);
+    if (filled < num_objects || overlaps != 0)
+    {
+        printf("  ERRO: %d objetos colocados, %d sobrepostos\n", filled, overlaps);
+        ok = false;
+    }
+
+    // Todos dentro da região
+    int outside = 0;
+    for (int i = 0; i < scattered; ++i)
+        outside += !PlacementRegion_Contains(scatter_region, scatter.x[i], scatter.z[i], radius);
+    for (int i = 0; i < filled; ++i)
+        outside += !PlacementRegion_Contains(fill_region, fill.x[i], fill.z[i], radius);
+
+    // A mesma semente gera as mesmas posições; outra semente, outras
+    Placement again;
+    PlacementRandom_Seed(&random, seed);
+    Placement_Init(&again, glm::vec2(-250.0f), glm::vec2(250.0f), 2.0f * radius);
+    Placement_Fill(&again, &random, fill_region, radius, 1 << 30);
+    bool same = again.x == fill.x && again.z == fill.z;
+    PlacementRandom_Seed(&random, seed + 1);
+    Placement_Init(&again, glm::vec2(-250.0f), glm::vec2(250.0f), 2.0f * radius);
+    Placement_Fill(&again, &random, fill_region, radius, 1 << 30);
+    bool different = again.x != fill.x;
+    printf("  fora da região: %d, mesma semente reproduz: %s, outra semente muda: %s\n",
+           outside, same ? "sim" : "não", different ? "sim" : "não");
+    if (outside > 0 || !same || !different)
+    {
+        printf("  ERRO: posicionamento fora da região ou não reproduzível\n");
+        ok = false;
+    }
+
+    return ok;
+}
+
+static bool Benchmark_SaveGame()
+{
+    const int num_trees = 1000000;
+    const int num_felled = 100000;
+    const char* filename = "benchmark.sav";
+    bool ok = true;
+
+    printf("Jogo salvo: %d árvores, %d cortadas\n", num_trees, num_felled);
+
+    // Árvores cortadas em posições aleatórias de um mundo de 2 km
+    std::mt19937 generator(20240611);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    std::vector<unsigned char> broke_tree(num_trees, 0);
+    std::vector<glm::vec2> trunk_pos(num_trees, glm::vec2(0.0f));
+    SaveGame save;
+    SaveGame_Init(&save, 2023, num_trees);
+    for (int i = 0; i < num_felled; ++i)
+    {
+        int tree = (int)(generator() % num_trees);
+        if (broke_tree[tree])
+            continue;
+        broke_tree[tree] = 1;
+        trunk_pos[tree] = glm::vec2(coordinate(generator), coordinate(generator));
+        SaveGame_SetFelled(&save, tree, trunk_pos[tree]);
+    }
+    save.player_position = glm::vec2(3.77f, -26.03f);
+    save.quest_level = 2;
+
+    // Formato ingênuo: os vetores do jogo gravados como estão (um byte por
+    // árvore e a posição de todas as árvores, cortadas ou não)
+    double start = Benchmark_Now();
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("  ERRO: não foi possível criar \"%s\"\n", filename);
+        return false;
+    }
+    fwrite(broke_tree.data(), 1, broke_tree.size(), file);
+    fwrite(trunk_pos.data(), sizeof(glm::vec2), trunk_pos.size(), file);
+    fclose(file);
+    double ms = Benchmark_Now() - start;
+    size_t raw_bytes = broke_tree.size() + trunk_pos.size() * sizeof(glm::vec2);
+    printf("  %-34s %9.2f ms  %9.1f KB\n", "vetores brutos (gravar)", ms, raw_bytes / 1024.0);
+
+    size_t bytes = 0;
+    start = Benchmark_Now();
+    bool written = SaveGame_Write(&save, filename, &bytes);
+    ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms  %9.1f KB\n", "SaveGame_Write", ms, bytes / 1024.0);
+
+    SaveGame loaded;
+    start = Benchmark_Now();
+    bool read = SaveGame_Load(&loaded, filename);
+    ms = Benchmark_Now() - start;
+    printf("  %-34s %9.2f ms\n", "SaveGame_Load (mmap)", ms);
+    remove(filename);
+
+    // Os mesmos bits e os troncos a menos de um milímetro
+    int wrong = 0;
+    if (read)
+    {
+        for (int i = 0; i < num_trees; ++i)
+            wrong += SaveGame_IsFelled(&loaded, i) != (broke_tree[i] != 0);
+        for (size_t t = 0; t < loaded.trunks.size(); ++t)
+            wrong += glm::length(loaded.trunks[t].position - trunk_pos[loaded.trunks[t].tree]) > 1.0f / SAVEGAME_POSITION_SCALE;
+        wrong += loaded.trunks.size() != save.trunks.size() || loaded.quest_level != save.quest_level || loaded.player_position != save.player_position;
+    }
+    printf("  ida e volta: %d diferenças\n", wrong);
+    if (!written || !read || wrong > 0)
+    {
+        printf("  ERRO: o jogo salvo não foi lido de volta igual\n");
+        ok = false;
+    }
+
+    // Um byte trocado no meio do arquivo ou no cabeçalho (o nível da Quest)
+    // é detectado pelo checksum
+    std::vector<unsigned char> encoded;
+    SaveGame_Encode(&save, &encoded);
+    size_t corrupted[2] = {encoded.size() / 2, 24};
+    for (int c = 0; c < 2; ++c)
+    {
+        std::vector<unsigned char> damaged = encoded;
+        damaged[corrupted[c]] ^= 0x10;
+        if (SaveGame_Decode(&loaded, damaged.data(), damaged.size()))
+        {
+            printf("  ERRO: arquivo corrompido aceito (byte %d)\n", (int)corrupted[c]);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+// Frustum culling e ordenação de uma lista de desenho grande: em sequência
+// (sem sistema de tarefas) e divididos entre as threads do sistema de
+// tarefas. Os itens visíveis e a ordem devem ser os mesmos.
+static bool Benchmark_Jobs()
+{
+    const int num_items = 200000;
+    const int num_frames = 20;
+    bool ok = true;
+
+    // Pelo menos duas threads, para que o roubo de tarefas seja exercitado
+    // mesmo em uma máquina de um núcleo
+    JobSystem jobs;
+    Jobs_Init(&jobs, std::max(2, (int)std::thread::hardware_concurrency()));
+    printf("Tarefas: lista de desenho com %d itens, %d threads\n", num_items, jobs.num_threads);
+
+    // Um cubo unitário espalhado por um mundo de 2 km, visto do centro
+    float cube[8][3];
+    for (int v = 0; v < 8; ++v)
+    {
+        cube[v][0] = (v & 1) ? 0.5f : -0.5f;
+        cube[v][1] = (v & 2) ? 0.5f : -0.5f;
+        cube[v][2] = (v & 4) ? 0.5f : -0.5f;
+    }
+    BoundingVolumes volumes;
+    BoundingVolumes_Compute(&volumes, &cube[0][0], 8, 3);
+    SceneObject object;
+    object.bsphere = volumes.sphere;
+    object.obb = volumes.obb;
+
+    std::mt19937 generator(20240612);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    DrawList source;
+    for (int i = 0; i < num_items; ++i)
+    {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(coordinate(generator), 0.0f, coordinate(generator)));
+        DrawList_Add(&source, &object, model, i);
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f, 2.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(3.141592f / 3.0f, 16.0f / 9.0f, 0.1f, 400.0f);
+
+    DrawList lists[2];
+    double ms[2] = {0.0, 0.0};
+    int culled[2] = {0, 0};
+    const char* names[2] = {"em sequência", "com tarefas"};
+    for (int variant = 0; variant < 2; ++variant)
+    {
+        JobSystem* system = variant == 0 ? NULL : &jobs;
+        for (int frame = 0; frame < num_frames; ++frame)
+        {
+            lists[variant].items = source.items;
+            double start = Benchmark_Now();
+            culled[variant] = DrawList_CullFrustum(&lists[variant], projection * view, system);
+            DrawList_SortFrontToBack(&lists[variant], view, system);
+            ms[variant] += Benchmark_Now() - start;
+        }
+        printf("  %-34s %9.2f ms/quadro  %d visíveis\n", names[variant], ms[variant] / num_frames, num_items - culled[variant]);
+    }
+    printf("  tarefas executadas: %d, roubadas: %d\n", jobs.executed.load(), jobs.steals.load());
+
+    int wrong = culled[0] != culled[1];
+    for (size_t i = 0; !wrong && i < lists[0].items.size(); ++i)
+        wrong += lists[0].items[i].object_id != lists[1].items[i].object_id;
+    if (wrong)
+    {
+        printf("  ERRO: as listas com e sem tarefas são diferentes\n");
+        ok = false;
+    }
+
+    // Dependências: cada tarefa externa enfileira e espera tarefas internas
+    std::atomic<long long> sum(0);
+    Jobs_ParallelFor(&jobs, "externa", 64, 1, [&](int begin, int end){
+        for (int outer = begin; outer < end; ++outer)
+            Jobs_ParallelFor(&jobs, "interna", 1000, 100, [&](int b, int e){
+                for (int inner = b; inner < e; ++inner)
+                    sum += inner;
+            });
+    });
+    if (sum != 64LL * 999 * 1000 / 2)
+    {
+        printf("  ERRO: tarefas aninhadas somaram %lld\n", sum.load());
+        ok = false;
+    }
+
+    Jobs_Shutdown(&jobs);
+    return ok;
+}
+
+struct Benchmark
+{
+    const char* name;
+    bool (*run)();
+};
+
+static const Benchmark g_Benchmarks[] = {
+    {"colisoes", Benchmark_Collisions},
+    {"bvh",      Benchmark_Bvh},
+    {"malhas",   Benchmark_Meshes},
+    {"matrizes", Benchmark_Matrices},
+    {"splines",  Benchmark_Splines},
+    {"posicionamento", Benchmark_Placement},
+    {"salvamento", Benchmark_SaveGame},
+    {"tarefas", Benchmark_Jobs},
+};
+
+int Benchmarks_Run(const char* name)
+{
+    int num_benchmarks = sizeof(g_Benchmarks) / sizeof(g_Benchmarks[0]);
+    bool all = strcmp(name, "todos") == 0;
+    bool found = false;
+    bool ok = true;
+
+    for (int i = 0; i < num_benchmarks; ++i)
+    {
+        if (all || strcmp(name, g_Benchmarks[i].name) == 0)
+        {
+            found = true;
+            ok = g_Benchmarks[i].run() && ok;
+        }
+    }
+
+    if (!found)
+    {
+        fprintf(stderr, "Benchmark desconhecido: \"%s\". Opções:", name);
+        for (int i = 0; i < num_benchmarks; ++i)
+            fprintf(stderr, " %s", g_Benchmarks[i].name);
+        fprintf(stderr, " todos\n");
+        return 1;
+    }
+
+    return ok ? 0 : 1;
+}
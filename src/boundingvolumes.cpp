@@ -0,0 +1,323 @@
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "boundingvolumes.h"
+
+// Tolerância relativa do teste "ponto dentro da esfera", para que erros de
+// arredondamento não façam o algoritmo recomeçar com pontos da borda
+#define SPHERE_TOLERANCE 1e-5f
+
+glm::vec3 Kdop_Axis(int axis)
+{
+    static const glm::vec3 axes[KDOP_AXES] = {
+        glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+        glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 1.0f, -1.0f), glm::vec3(1.0f, -1.0f, 1.0f), glm::vec3(-1.0f, 1.0f, 1.0f)
+    };
+    return axes[axis];
+}
+
+static bool SphereContains(const BoundingSphere &sphere, const glm::vec3 &point)
+{
+    glm::vec3 d = point - sphere.center;
+    float limit = sphere.radius * (1.0f + SPHERE_TOLERANCE) + SPHERE_TOLERANCE;
+    return glm::dot(d, d) <= limit * limit;
+}
+
+static BoundingSphere SphereFrom2(const glm::vec3 &a, const glm::vec3 &b)
+{
+    BoundingSphere sphere;
+    sphere.center = (a + b) * 0.5f;
+    sphere.radius = glm::length(b - a) * 0.5f;
+    return sphere;
+}
+
+// Menor esfera com os três pontos na borda: a do círculo que passa por eles
+static BoundingSphere SphereFrom3(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 n = glm::cross(ab, ac);
+    float denom = 2.0f * glm::dot(n, n);
+
+    if (denom <= FLT_EPSILON * glm::dot(ab, ab) * glm::dot(ac, ac))
+    {
+        // Pontos colineares: esfera do par mais distante
+        BoundingSphere s1 = SphereFrom2(a, b), s2 = SphereFrom2(a, c), s3 = SphereFrom2(b, c);
+        if (s1.radius >= s2.radius && s1.radius >= s3.radius)
+            return s1;
+        return (s2.radius >= s3.radius) ? s2 : s3;
+    }
+
+    glm::vec3 offset = (glm::cross(n, ab) * glm::dot(ac, ac) + glm::cross(ac, n) * glm::dot(ab, ab)) / denom;
+    BoundingSphere sphere;
+    sphere.center = a + offset;
+    sphere.radius = glm::length(offset);
+    return sphere;
+}
+
+// Menor esfera com os quatro pontos na borda: a esfera circunscrita
+static BoundingSphere SphereFrom4(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &d)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ad = d - a;
+
+    // O centro "a + x" é equidistante dos quatro pontos: 2*dot(x, ab) = |ab|²
+    // e o mesmo para ac e ad. As linhas de "system" são ab, ac e ad.
+    glm::mat3 system = glm::transpose(glm::mat3(ab, ac, ad));
+    float det = glm::determinant(system);
+    float scale = glm::length(ab) * glm::length(ac) * glm::length(ad);
+
+    if (std::fabs(det) <= FLT_EPSILON * scale)
+    {
+        // Pontos coplanares: a menor das esferas de três pontos que contém o quarto
+        const glm::vec3* points[4] = {&a, &b, &c, &d};
+        BoundingSphere best;
+        best.radius = FLT_MAX;
+        for (int skip = 0; skip < 4; ++skip)
+        {
+            const glm::vec3* p[3];
+            for (int i = 0, n = 0; i < 4; ++i)
+                if (i != skip)
+                    p[n++] = points[i];
+            BoundingSphere sphere = SphereFrom3(*p[0], *p[1], *p[2]);
+            if (sphere.radius < best.radius && SphereContains(sphere, *points[skip]))
+                best = sphere;
+        }
+        if (best.radius == FLT_MAX)
+            best = SphereFrom3(a, b, c);
+        return best;
+    }
+
+    glm::vec3 offset = glm::inverse(system) * (0.5f * glm::vec3(glm::dot(ab, ab), glm::dot(ac, ac), glm::dot(ad, ad)));
+    BoundingSphere sphere;
+    sphere.center = a + offset;
+    sphere.radius = glm::length(offset);
+    return sphere;
+}
+
+// Menor esfera envolvente pelo algoritmo incremental aleatório de Welzl, na
+// forma iterativa: cada ponto fora da esfera atual passa a estar na borda da
+// nova esfera. Com os pontos em ordem aleatória, o custo esperado é linear.
+static BoundingSphere MinimalSphere(std::vector<glm::vec3> &points)
+{
+    std::mt19937 random(12345);
+    std::shuffle(points.begin(), points.end(), random);
+
+    BoundingSphere sphere;
+    sphere.center = points[0];
+    sphere.radius = 0.0f;
+
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        if (SphereContains(sphere, points[i]))
+            continue;
+
+        sphere.center = points[i];
+        sphere.radius = 0.0f;
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (SphereContains(sphere, points[j]))
+                continue;
+
+            sphere = SphereFrom2(points[i], points[j]);
+            for (size_t k = 0; k < j; ++k)
+            {
+                if (SphereContains(sphere, points[k]))
+                    continue;
+
+                sphere = SphereFrom3(points[i], points[j], points[k]);
+                for (size_t l = 0; l < k; ++l)
+                    if (!SphereContains(sphere, points[l]))
+                        sphere = SphereFrom4(points[i], points[j], points[k], points[l]);
+            }
+        }
+    }
+
+    // Garante que nenhum ponto ficou de fora por causa da tolerância
+    float radius_sq = 0.0f;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        glm::vec3 d = points[i] - sphere.center;
+        radius_sq = std::max(radius_sq, glm::dot(d, d));
+    }
+    sphere.radius = std::sqrt(radius_sq);
+    return sphere;
+}
+
+// Autovetores de uma matriz simétrica 3x3 pelo método de Jacobi: rotações
+// sucessivas zeram os elementos fora da diagonal.
+static glm::mat3 EigenVectors(glm::mat3 a)
+{
+    glm::mat3 vectors = glm::mat3(1.0f);
+
+    for (int sweep = 0; sweep < 16; ++sweep)
+    {
+        float off = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+        if (off <= 1e-12f * (a[0][0]*a[0][0] + a[1][1]*a[1][1] + a[2][2]*a[2][2]))
+            break;
+
+        for (int p = 0; p < 2; ++p)
+            for (int q = p + 1; q < 3; ++q)
+            {
+                if (std::fabs(a[p][q]) <= 1e-20f)
+                    continue;
+
+                float theta = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+                float t = (theta >= 0.0f ? 1.0f : -1.0f) / (std::fabs(theta) + std::sqrt(theta*theta + 1.0f));
+                float c = 1.0f / std::sqrt(t*t + 1.0f);
+                float s = t * c;
+
+                // a = Jᵀ a J, com J a rotação no plano (p, q)
+                glm::mat3 rotation = glm::mat3(1.0f);
+                rotation[p][p] = c;  rotation[q][q] = c;
+                rotation[q][p] = s;  rotation[p][q] = -s;
+                a = glm::transpose(rotation) * a * rotation;
+                vectors = vectors * rotation;
+            }
+    }
+
+    return vectors;
+}
+
+// Caixa orientada pelas direções principais (PCA) dos pontos, ou a AABB se
+// ela tiver volume menor.
+static OrientedBox PrincipalBox(const std::vector<glm::vec3> &points, const glm::vec3 &aabb_min, const glm::vec3 &aabb_max)
+{
+    glm::vec3 mean = glm::vec3(0.0f);
+    for (size_t i = 0; i < points.size(); ++i)
+        mean += points[i];
+    mean /= (float)points.size();
+
+    glm::mat3 covariance = glm::mat3(0.0f);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        glm::vec3 d = points[i] - mean;
+        covariance += glm::outerProduct(d, d);
+    }
+
+    glm::mat3 vectors = EigenVectors(covariance);
+    glm::vec3 axes[3] = {glm::normalize(vectors[0]), glm::normalize(vectors[1]), glm::vec3(0.0f)};
+    axes[1] = glm::normalize(axes[1] - axes[0] * glm::dot(axes[0], axes[1]));
+    axes[2] = glm::cross(axes[0], axes[1]);
+
+    glm::vec3 low = glm::vec3(FLT_MAX), high = glm::vec3(-FLT_MAX);
+    for (size_t i = 0; i < points.size(); ++i)
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float projection = glm::dot(points[i], axes[axis]);
+            low[axis] = std::min(low[axis], projection);
+            high[axis] = std::max(high[axis], projection);
+        }
+
+    OrientedBox box;
+    glm::vec3 size = high - low;
+    glm::vec3 aabb_size = aabb_max - aabb_min;
+    if (size.x * size.y * size.z < aabb_size.x * aabb_size.y * aabb_size.z)
+    {
+        glm::vec3 middle = (low + high) * 0.5f;
+        box.center = axes[0] * middle.x + axes[1] * middle.y + axes[2] * middle.z;
+        box.axes[0] = axes[0];
+        box.axes[1] = axes[1];
+        box.axes[2] = axes[2];
+        box.half_size = size * 0.5f;
+    }
+    else
+    {
+        box.center = (aabb_min + aabb_max) * 0.5f;
+        box.axes[0] = glm::vec3(1.0f, 0.0f, 0.0f);
+        box.axes[1] = glm::vec3(0.0f, 1.0f, 0.0f);
+        box.axes[2] = glm::vec3(0.0f, 0.0f, 1.0f);
+        box.half_size = aabb_size * 0.5f;
+    }
+    return box;
+}
+
+static bool ComparePoints(const glm::vec3 &a, const glm::vec3 &b)
+{
+    if (a.x != b.x) return a.x < b.x;
+    if (a.y != b.y) return a.y < b.y;
+    return a.z < b.z;
+}
+
+void BoundingVolumes_Compute(BoundingVolumes* volumes, const float* positions, size_t count, int stride)
+{
+    // Os vértices das malhas se repetem em cada triângulo que os usa: os
+    // volumes são calculados sobre os pontos distintos
+    std::vector<glm::vec3> points(count);
+    for (size_t i = 0; i < count; ++i)
+        points[i] = glm::vec3(positions[stride*i + 0], positions[stride*i + 1], positions[stride*i + 2]);
+    std::sort(points.begin(), points.end(), ComparePoints);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    if (points.empty())
+    {
+        volumes->aabb_min = volumes->aabb_max = glm::vec3(0.0f);
+        volumes->sphere.center = glm::vec3(0.0f);
+        volumes->sphere.radius = 0.0f;
+        volumes->obb.center = glm::vec3(0.0f);
+        volumes->obb.axes[0] = glm::vec3(1.0f, 0.0f, 0.0f);
+        volumes->obb.axes[1] = glm::vec3(0.0f, 1.0f, 0.0f);
+        volumes->obb.axes[2] = glm::vec3(0.0f, 0.0f, 1.0f);
+        volumes->obb.half_size = glm::vec3(0.0f);
+        for (int axis = 0; axis < KDOP_AXES; ++axis)
+            volumes->kdop.min[axis] = volumes->kdop.max[axis] = 0.0f;
+        return;
+    }
+
+    for (int axis = 0; axis < KDOP_AXES; ++axis)
+    {
+        volumes->kdop.min[axis] = FLT_MAX;
+        volumes->kdop.max[axis] = -FLT_MAX;
+    }
+    for (size_t i = 0; i < points.size(); ++i)
+        for (int axis = 0; axis < KDOP_AXES; ++axis)
+        {
+            float projection = glm::dot(points[i], Kdop_Axis(axis));
+            volumes->kdop.min[axis] = std::min(volumes->kdop.min[axis], projection);
+            volumes->kdop.max[axis] = std::max(volumes->kdop.max[axis], projection);
+        }
+
+    volumes->aabb_min = glm::vec3(volumes->kdop.min[0], volumes->kdop.min[1], volumes->kdop.min[2]);
+    volumes->aabb_max = glm::vec3(volumes->kdop.max[0], volumes->kdop.max[1], volumes->kdop.max[2]);
+    volumes->obb = PrincipalBox(points, volumes->aabb_min, volumes->aabb_max);
+    volumes->sphere = MinimalSphere(points);
+}
+
+BoundingSphere BoundingSphere_Transform(const BoundingSphere &sphere, const glm::mat4 &model)
+{
+    float scale = std::max(glm::length(glm::vec3(model[0])),
+                  std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+    BoundingSphere result;
+    result.center = glm::vec3(model * glm::vec4(sphere.center, 1.0f));
+    result.radius = sphere.radius * scale;
+    return result;
+}
+
+OrientedBox OrientedBox_Transform(const OrientedBox &box, const glm::mat4 &model)
+{
+    OrientedBox result;
+    result.center = glm::vec3(model * glm::vec4(box.center, 1.0f));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        glm::vec3 half_axis = glm::vec3(model * glm::vec4(box.axes[axis] * box.half_size[axis], 0.0f));
+        result.half_size[axis] = glm::length(half_axis);
+        result.axes[axis] = (result.half_size[axis] > 0.0f) ? half_axis / result.half_size[axis] : box.axes[axis];
+    }
+    return result;
+}
+
+float OrientedBox_PlaneDistance(const OrientedBox &box, const glm::vec4 &plane)
+{
+    glm::vec3 normal = glm::vec3(plane);
+    float radius = std::fabs(glm::dot(normal, box.axes[0])) * box.half_size.x
+                 + std::fabs(glm::dot(normal, box.axes[1])) * box.half_size.y
+                 + std::fabs(glm::dot(normal, box.axes[2])) * box.half_size.z;
+    return glm::dot(normal, box.center) + plane.w + radius;
+}
@@ -0,0 +1,366 @@
+#include <cassert>
+#include <cfloat>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "bvh.h"
+
+// Profundidade máxima da pilha de nós durante as consultas. Uma hierarquia
+// construída com SAH sobre até milhões de itens fica bem abaixo disto.
+#define BVH_STACK_SIZE 64
+
+// Profundidade máxima da hierarquia. Cada nível visitado deixa no máximo um
+// nó a mais na pilha, então as consultas nunca passam de BVH_STACK_SIZE.
+// Em distribuições degeneradas, que chegariam mais fundo, os itens restantes
+// ficam em uma única folha.
+#define BVH_MAX_DEPTH (BVH_STACK_SIZE - 2)
+
+void Bvh_Clear(Bvh* bvh)
+{
+    bvh->nodes.clear();
+    bvh->items.clear();
+    bvh->item_position.clear();
+}
+
+int Bvh_Add(Bvh* bvh, int type, int index, const glm::vec3 &min, const glm::vec3 &max)
+{
+    BvhItem item;
+    item.min = min;
+    item.max = max;
+    item.type = type;
+    item.index = index;
+    item.id = (int)bvh->items.size();
+    item.enabled = true;
+
+    bvh->items.push_back(item);
+    bvh->item_position.push_back(item.id);
+    return item.id;
+}
+
+int Bvh_AddTransformed(Bvh* bvh, int type, int index, const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model)
+{
+    glm::vec3 world_min = glm::vec3(FLT_MAX);
+    glm::vec3 world_max = glm::vec3(-FLT_MAX);
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec4 point = glm::vec4((corner & 1) ? max.x : min.x,
+                                    (corner & 2) ? max.y : min.y,
+                                    (corner & 4) ? max.z : min.z, 1.0f);
+        glm::vec3 world = glm::vec3(model * point);
+        world_min = glm::min(world_min, world);
+        world_max = glm::max(world_max, world);
+    }
+
+    return Bvh_Add(bvh, type, index, world_min, world_max);
+}
+
+static float Bvh_HalfArea(const glm::vec3 &min, const glm::vec3 &max)
+{
+    glm::vec3 d = max - min;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+struct BvhBin
+{
+    glm::vec3 min;
+    glm::vec3 max;
+    int       count;
+};
+
+static int Bvh_BuildNode(Bvh* bvh, int first, int count, int depth)
+{
+    int node_index = (int)bvh->nodes.size();
+    bvh->nodes.push_back(BvhNode());
+
+    // Caixa do nó e caixa dos centros dos itens
+    glm::vec3 bounds_min = glm::vec3(FLT_MAX),   bounds_max = glm::vec3(-FLT_MAX);
+    glm::vec3 centroid_min = glm::vec3(FLT_MAX), centroid_max = glm::vec3(-FLT_MAX);
+    for (int i = first; i < first + count; ++i)
+    {
+        const BvhItem &item = bvh->items[i];
+        glm::vec3 centroid = (item.min + item.max) * 0.5f;
+        bounds_min = glm::min(bounds_min, item.min);
+        bounds_max = glm::max(bounds_max, item.max);
+        centroid_min = glm::min(centroid_min, centroid);
+        centroid_max = glm::max(centroid_max, centroid);
+    }
+
+    bvh->nodes[node_index].min = bounds_min;
+    bvh->nodes[node_index].max = bounds_max;
+    bvh->nodes[node_index].first = first;
+    bvh->nodes[node_index].count = count;
+
+    if (count <= BVH_MAX_LEAF_ITEMS || depth >= BVH_MAX_DEPTH)
+        return node_index;
+
+    // Escolhe o eixo e o plano de divisão de menor custo segundo a SAH:
+    // área de cada lado vezes o número de itens do lado. Os centros são
+    // distribuídos em BVH_SAH_BINS intervalos por eixo, e apenas os planos
+    // entre intervalos são avaliados.
+    float best_cost = FLT_MAX;
+    int best_axis = -1;
+    int best_split = 0;
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float extent = centroid_max[axis] - centroid_min[axis];
+        if (extent <= 0.0f)
+            continue;
+
+        BvhBin bins[BVH_SAH_BINS];
+        for (int b = 0; b < BVH_SAH_BINS; ++b)
+        {
+            bins[b].min = glm::vec3(FLT_MAX);
+            bins[b].max = glm::vec3(-FLT_MAX);
+            bins[b].count = 0;
+        }
+
+        float scale = BVH_SAH_BINS / extent;
+        for (int i = first; i < first + count; ++i)
+        {
+            const BvhItem &item = bvh->items[i];
+            float centroid = (item.min[axis] + item.max[axis]) * 0.5f;
+            int b = std::min(BVH_SAH_BINS - 1, (int)((centroid - centroid_min[axis]) * scale));
+            bins[b].min = glm::min(bins[b].min, item.min);
+            bins[b].max = glm::max(bins[b].max, item.max);
+            bins[b].count += 1;
+        }
+
+        // Custo do lado esquerdo de cada plano, acumulado da esquerda para a direita
+        float left_cost[BVH_SAH_BINS];
+        glm::vec3 left_min = glm::vec3(FLT_MAX), left_max = glm::vec3(-FLT_MAX);
+        int left_count = 0;
+        for (int b = 0; b < BVH_SAH_BINS - 1; ++b)
+        {
+            left_min = glm::min(left_min, bins[b].min);
+            left_max = glm::max(left_max, bins[b].max);
+            left_count += bins[b].count;
+            left_cost[b] = left_count ? Bvh_HalfArea(left_min, left_max) * left_count : 0.0f;
+        }
+
+        glm::vec3 right_min = glm::vec3(FLT_MAX), right_max = glm::vec3(-FLT_MAX);
+        int right_count = 0;
+        for (int b = BVH_SAH_BINS - 1; b > 0; --b)
+        {
+            right_min = glm::min(right_min, bins[b].min);
+            right_max = glm::max(right_max, bins[b].max);
+            right_count += bins[b].count;
+
+            float cost = left_cost[b - 1] + (right_count ? Bvh_HalfArea(right_min, right_max) * right_count : 0.0f);
+            if (right_count > 0 && right_count < count && cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = b;
+            }
+        }
+    }
+
+    // Todos os centros coincidem: não há como dividir
+    if (best_axis < 0)
+        return node_index;
+
+    // Se testar todos os itens custa menos do que descer mais um nível,
+    // mantém a folha (desde que não fique grande demais)
+    float leaf_cost = Bvh_HalfArea(bounds_min, bounds_max) * count;
+    float split_cost = Bvh_HalfArea(bounds_min, bounds_max) + best_cost;
+    if (leaf_cost <= split_cost && count <= 4 * BVH_MAX_LEAF_ITEMS)
+        return node_index;
+
+    float extent = centroid_max[best_axis] - centroid_min[best_axis];
+    float scale = BVH_SAH_BINS / extent;
+    float origin = centroid_min[best_axis];
+    BvhItem* middle = std::partition(bvh->items.data() + first, bvh->items.data() + first + count,
+                                     [=](const BvhItem &item) {
+                                         float centroid = (item.min[best_axis] + item.max[best_axis]) * 0.5f;
+                                         return std::min(BVH_SAH_BINS - 1, (int)((centroid - origin) * scale)) < best_split;
+                                     });
+    int left_count = (int)(middle - (bvh->items.data() + first));
+
+    // O filho esquerdo é sempre o nó seguinte
+    Bvh_BuildNode(bvh, first, left_count, depth + 1);
+    int right = Bvh_BuildNode(bvh, first + left_count, count - left_count, depth + 1);
+
+    bvh->nodes[node_index].first = right;
+    bvh->nodes[node_index].count = 0;
+    return node_index;
+}
+
+void Bvh_Build(Bvh* bvh)
+{
+    bvh->nodes.clear();
+    if (bvh->items.empty())
+        return;
+
+    bvh->nodes.reserve(2 * bvh->items.size() / BVH_MAX_LEAF_ITEMS + 1);
+    Bvh_BuildNode(bvh, 0, (int)bvh->items.size(), 0);
+
+    for (size_t i = 0; i < bvh->items.size(); ++i)
+        bvh->item_position[bvh->items[i].id] = (int)i;
+}
+
+void Bvh_SetEnabled(Bvh* bvh, int id, bool enabled)
+{
+    bvh->items[bvh->item_position[id]].enabled = enabled;
+}
+
+// Teste raio-caixa pelo método dos "slabs". Retorna a distância de entrada
+// na caixa (0 se a origem está dentro dela) em "t_entry".
+static inline bool Bvh_RayBox(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &origin,
+                              const glm::vec3 &inverse_direction, float max_distance, float* t_entry)
+{
+    float tx1 = (min.x - origin.x) * inverse_direction.x, tx2 = (max.x - origin.x) * inverse_direction.x;
+    float ty1 = (min.y - origin.y) * inverse_direction.y, ty2 = (max.y - origin.y) * inverse_direction.y;
+    float tz1 = (min.z - origin.z) * inverse_direction.z, tz2 = (max.z - origin.z) * inverse_direction.z;
+
+    float t_min = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+    float t_max = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), max_distance));
+
+    *t_entry = t_min;
+    return t_min <= t_max;
+}
+
+bool Bvh_Raycast(const Bvh* bvh, const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, BvhHit* hit)
+{
+    if (bvh->nodes.empty())
+        return false;
+
+    glm::vec3 inverse_direction = 1.0f / direction;
+    float best = max_distance;
+    int best_item = -1;
+
+    // Pilha de nós a visitar, com a distância de entrada em cada um
+    int   stack[BVH_STACK_SIZE];
+    float stack_distance[BVH_STACK_SIZE];
+    int   top = 0;
+
+    float t;
+    if (!Bvh_RayBox(bvh->nodes[0].min, bvh->nodes[0].max, origin, inverse_direction, best, &t))
+        return false;
+    stack[top] = 0;
+    stack_distance[top++] = t;
+
+    while (top > 0)
+    {
+        --top;
+        if (stack_distance[top] > best)
+            continue; // Já há um item atingido antes deste nó
+
+        const BvhNode &node = bvh->nodes[stack[top]];
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                const BvhItem &item = bvh->items[i];
+                if (item.enabled && Bvh_RayBox(item.min, item.max, origin, inverse_direction, best, &t) && t < best)
+                {
+                    best = t;
+                    best_item = i;
+                }
+            }
+            continue;
+        }
+
+        // Empilha o filho mais distante primeiro, para visitar o mais
+        // próximo antes e descartar o outro se possível
+        int left = stack[top] + 1;
+        int right = node.first;
+        float t_left, t_right;
+        bool hit_left  = Bvh_RayBox(bvh->nodes[left].min,  bvh->nodes[left].max,  origin, inverse_direction, best, &t_left);
+        bool hit_right = Bvh_RayBox(bvh->nodes[right].min, bvh->nodes[right].max, origin, inverse_direction, best, &t_right);
+
+        assert(top + 2 <= BVH_STACK_SIZE);
+        if (hit_left && hit_right)
+        {
+            if (t_left > t_right)
+            {
+                std::swap(left, right);
+                std::swap(t_left, t_right);
+            }
+            stack[top] = right;
+            stack_distance[top++] = t_right;
+            stack[top] = left;
+            stack_distance[top++] = t_left;
+        }
+        else if (hit_left)
+        {
+            stack[top] = left;
+            stack_distance[top++] = t_left;
+        }
+        else if (hit_right)
+        {
+            stack[top] = right;
+            stack_distance[top++] = t_right;
+        }
+    }
+
+    if (best_item < 0)
+        return false;
+
+    const BvhItem &item = bvh->items[best_item];
+    hit->id = item.id;
+    hit->type = item.type;
+    hit->index = item.index;
+    hit->distance = best;
+    return true;
+}
+
+bool Bvh_Segment(const Bvh* bvh, const glm::vec3 &a, const glm::vec3 &b, BvhHit* hit)
+{
+    float length = glm::length(b - a);
+    if (length <= 0.0f)
+        return false;
+    return Bvh_Raycast(bvh, a, (b - a) / length, length, hit);
+}
+
+static inline bool Bvh_BoxBox(const glm::vec3 &min_a, const glm::vec3 &max_a, const glm::vec3 &min_b, const glm::vec3 &max_b)
+{
+    return min_a.x <= max_b.x && max_a.x >= min_b.x &&
+           min_a.y <= max_b.y && max_a.y >= min_b.y &&
+           min_a.z <= max_b.z && max_a.z >= min_b.z;
+}
+
+int Bvh_Overlap(const Bvh* bvh, const glm::vec3 &min, const glm::vec3 &max, int* items, int max_items)
+{
+    if (bvh->nodes.empty() || !Bvh_BoxBox(bvh->nodes[0].min, bvh->nodes[0].max, min, max))
+        return 0;
+
+    int count = 0;
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        int node_index = stack[--top];
+        const BvhNode &node = bvh->nodes[node_index];
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                const BvhItem &item = bvh->items[i];
+                if (item.enabled && Bvh_BoxBox(item.min, item.max, min, max))
+                {
+                    if (count < max_items)
+                        items[count] = i;
+                    count += 1;
+                }
+            }
+            continue;
+        }
+
+        int left = node_index + 1;
+        int right = node.first;
+        assert(top + 2 <= BVH_STACK_SIZE);
+        if (Bvh_BoxBox(bvh->nodes[left].min, bvh->nodes[left].max, min, max))
+            stack[top++] = left;
+        if (Bvh_BoxBox(bvh->nodes[right].min, bvh->nodes[right].max, min, max))
+            stack[top++] = right;
+    }
+
+    return count;
+}
@@ -0,0 +1,220 @@
+#include <cstring>
+#include <cfloat>
+
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "collisionbatch.h"
+
+// Valores das posições de preenchimento, que nunca colidem: o centro fica tão
+// longe que a distância ao quadrado é infinita, e as caixas são vazias.
+#define COLLISION_FAR FLT_MAX
+
+static int CollisionBatch_Padded(int count)
+{
+    return (count + COLLISION_BATCH_WIDTH - 1) / COLLISION_BATCH_WIDTH * COLLISION_BATCH_WIDTH;
+}
+
+int CollisionBatch_MaskWords(int count)
+{
+    return (CollisionBatch_Padded(count) + 31) / 32;
+}
+
+// Escreve os bits de colisão dos objetos [first, first+largura SIMD) na
+// máscara. A largura SIMD divide 32, então os bits nunca cruzam palavras.
+static inline int CollisionBatch_StoreMask(uint32_t* hit_mask, int first, uint32_t bits)
+{
+    hit_mask[first / 32] |= bits << (first % 32);
+    return __builtin_popcount(bits);
+}
+
+void CollisionSpheres_Clear(CollisionSpheres* spheres)
+{
+    spheres->count = 0;
+    spheres->center_x.clear();
+    spheres->center_y.clear();
+    spheres->center_z.clear();
+    spheres->radius_sq.clear();
+}
+
+void CollisionSpheres_Add(CollisionSpheres* spheres, const glm::vec3 &center, float radius)
+{
+    if (spheres->count == (int)spheres->center_x.size())
+    {
+        int padded = spheres->count + COLLISION_BATCH_WIDTH;
+        spheres->center_x.resize(padded, COLLISION_FAR);
+        spheres->center_y.resize(padded, COLLISION_FAR);
+        spheres->center_z.resize(padded, COLLISION_FAR);
+        spheres->radius_sq.resize(padded, 0.0f);
+    }
+
+    int i = spheres->count++;
+    spheres->center_x[i] = center.x;
+    spheres->center_y[i] = center.y;
+    spheres->center_z[i] = center.z;
+    spheres->radius_sq[i] = radius * radius;
+}
+
+void CollisionBoxes_Clear(CollisionBoxes* boxes)
+{
+    boxes->count = 0;
+    boxes->min_x.clear();
+    boxes->min_z.clear();
+    boxes->max_x.clear();
+    boxes->max_z.clear();
+}
+
+void CollisionBoxes_Add(CollisionBoxes* boxes, const glm::vec2 &min, const glm::vec2 &max)
+{
+    if (boxes->count == (int)boxes->min_x.size())
+    {
+        int padded = boxes->count + COLLISION_BATCH_WIDTH;
+        boxes->min_x.resize(padded,  COLLISION_FAR);
+        boxes->min_z.resize(padded,  COLLISION_FAR);
+        boxes->max_x.resize(padded, -COLLISION_FAR);
+        boxes->max_z.resize(padded, -COLLISION_FAR);
+    }
+
+    int i = boxes->count++;
+    boxes->min_x[i] = min.x;
+    boxes->min_z[i] = min.y;
+    boxes->max_x[i] = max.x;
+    boxes->max_z[i] = max.y;
+}
+
+int Collision_PointSpheres(const CollisionSpheres* spheres, const glm::vec4 &point, uint32_t* hit_mask)
+{
+    int padded = CollisionBatch_Padded(spheres->count);
+    memset(hit_mask, 0, CollisionBatch_MaskWords(spheres->count) * sizeof(uint32_t));
+    if (spheres->count == 0)
+        return 0;
+
+    const float* center_x = spheres->center_x.data();
+    const float* center_y = spheres->center_y.data();
+    const float* center_z = spheres->center_z.data();
+    const float* radius_sq = spheres->radius_sq.data();
+    int hits = 0;
+
+#if defined(__AVX512F__)
+    __m512 px = _mm512_set1_ps(point.x);
+    __m512 py = _mm512_set1_ps(point.y);
+    __m512 pz = _mm512_set1_ps(point.z);
+    for (int i = 0; i < padded; i += 16)
+    {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(center_x + i), px);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(center_y + i), py);
+        __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(center_z + i), pz);
+        __m512 distance_sq = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)), _mm512_mul_ps(dz, dz));
+        __mmask16 bits = _mm512_cmp_ps_mask(distance_sq, _mm512_loadu_ps(radius_sq + i), _CMP_LT_OQ);
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#elif defined(__AVX__)
+    __m256 px = _mm256_set1_ps(point.x);
+    __m256 py = _mm256_set1_ps(point.y);
+    __m256 pz = _mm256_set1_ps(point.z);
+    for (int i = 0; i < padded; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(center_x + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(center_y + i), py);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(center_z + i), pz);
+        __m256 distance_sq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(distance_sq, _mm256_loadu_ps(radius_sq + i), _CMP_LT_OQ));
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#elif defined(__SSE2__)
+    __m128 px = _mm_set1_ps(point.x);
+    __m128 py = _mm_set1_ps(point.y);
+    __m128 pz = _mm_set1_ps(point.z);
+    for (int i = 0; i < padded; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(center_x + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(center_y + i), py);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(center_z + i), pz);
+        __m128 distance_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int bits = _mm_movemask_ps(_mm_cmplt_ps(distance_sq, _mm_loadu_ps(radius_sq + i)));
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#else
+    // Sem SIMD (ex.: ARM): o laço sem desvios ainda pode ser vetorizado pelo compilador
+    for (int i = 0; i < padded; ++i)
+    {
+        float dx = center_x[i] - point.x;
+        float dy = center_y[i] - point.y;
+        float dz = center_z[i] - point.z;
+        uint32_t bit = (dx*dx + dy*dy + dz*dz < radius_sq[i]) ? 1u : 0u;
+        hits += CollisionBatch_StoreMask(hit_mask, i, bit);
+    }
+#endif
+
+    return hits;
+}
+
+int Collision_PointBoxes(const CollisionBoxes* boxes, const glm::vec4 &point, float margin, uint32_t* hit_mask)
+{
+    int padded = CollisionBatch_Padded(boxes->count);
+    memset(hit_mask, 0, CollisionBatch_MaskWords(boxes->count) * sizeof(uint32_t));
+    if (boxes->count == 0)
+        return 0;
+
+    const float* min_x = boxes->min_x.data();
+    const float* min_z = boxes->min_z.data();
+    const float* max_x = boxes->max_x.data();
+    const float* max_z = boxes->max_z.data();
+    int hits = 0;
+
+    // A caixa do ponto toca a caixa do lote se (p - margin <= max) e
+    // (p + margin >= min), em X e em Z
+    float low_x  = point.x - margin;
+    float high_x = point.x + margin;
+    float low_z  = point.z - margin;
+    float high_z = point.z + margin;
+
+#if defined(__AVX512F__)
+    __m512 lx = _mm512_set1_ps(low_x),  hx = _mm512_set1_ps(high_x);
+    __m512 lz = _mm512_set1_ps(low_z),  hz = _mm512_set1_ps(high_z);
+    for (int i = 0; i < padded; i += 16)
+    {
+        __mmask16 bits = _mm512_cmp_ps_mask(lx, _mm512_loadu_ps(max_x + i), _CMP_LE_OQ);
+        bits = _mm512_mask_cmp_ps_mask(bits, hx, _mm512_loadu_ps(min_x + i), _CMP_GE_OQ);
+        bits = _mm512_mask_cmp_ps_mask(bits, lz, _mm512_loadu_ps(max_z + i), _CMP_LE_OQ);
+        bits = _mm512_mask_cmp_ps_mask(bits, hz, _mm512_loadu_ps(min_z + i), _CMP_GE_OQ);
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#elif defined(__AVX__)
+    __m256 lx = _mm256_set1_ps(low_x),  hx = _mm256_set1_ps(high_x);
+    __m256 lz = _mm256_set1_ps(low_z),  hz = _mm256_set1_ps(high_z);
+    for (int i = 0; i < padded; i += 8)
+    {
+        __m256 inside_x = _mm256_and_ps(_mm256_cmp_ps(lx, _mm256_loadu_ps(max_x + i), _CMP_LE_OQ),
+                                        _mm256_cmp_ps(hx, _mm256_loadu_ps(min_x + i), _CMP_GE_OQ));
+        __m256 inside_z = _mm256_and_ps(_mm256_cmp_ps(lz, _mm256_loadu_ps(max_z + i), _CMP_LE_OQ),
+                                        _mm256_cmp_ps(hz, _mm256_loadu_ps(min_z + i), _CMP_GE_OQ));
+        int bits = _mm256_movemask_ps(_mm256_and_ps(inside_x, inside_z));
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#elif defined(__SSE2__)
+    __m128 lx = _mm_set1_ps(low_x),  hx = _mm_set1_ps(high_x);
+    __m128 lz = _mm_set1_ps(low_z),  hz = _mm_set1_ps(high_z);
+    for (int i = 0; i < padded; i += 4)
+    {
+        __m128 inside_x = _mm_and_ps(_mm_cmple_ps(lx, _mm_loadu_ps(max_x + i)),
+                                     _mm_cmpge_ps(hx, _mm_loadu_ps(min_x + i)));
+        __m128 inside_z = _mm_and_ps(_mm_cmple_ps(lz, _mm_loadu_ps(max_z + i)),
+                                     _mm_cmpge_ps(hz, _mm_loadu_ps(min_z + i)));
+        int bits = _mm_movemask_ps(_mm_and_ps(inside_x, inside_z));
+        hits += CollisionBatch_StoreMask(hit_mask, i, bits);
+    }
+#else
+    for (int i = 0; i < padded; ++i)
+    {
+        uint32_t bit = (low_x <= max_x[i] && high_x >= min_x[i] &&
+                        low_z <= max_z[i] && high_z >= min_z[i]) ? 1u : 0u;
+        hits += CollisionBatch_StoreMask(hit_mask, i, bit);
+    }
+#endif
+
+    return hits;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/vec4.hpp>
+
+#include "drawlist.h"
+
+void DrawList_Clear(DrawList* list)
+{
+    list->items.clear();
+}
+
+void DrawList_Add(DrawList* list, const SceneObject* object, const glm::mat4 &model, int object_id, int layer, bool dynamic,
+                  const glm::vec2 &wind)
+{
+    DrawList_Set(list, DrawList_Extend(list, 1), object, model, object_id, layer, dynamic, wind);
+}
+
+int DrawList_Extend(DrawList* list, int count)
+{
+    int first = (int)list->items.size();
+    list->items.resize(first + count);
+    return first;
+}
+
+void DrawList_Set(DrawList* list, int index, const SceneObject* object, const glm::mat4 &model, int object_id, int layer, bool dynamic,
+                  const glm::vec2 &wind)
+{
+    DrawItem &item = list->items[index];
+    item.object = object;
+    item.model = model;
+    item.object_id = object_id;
+    item.layer = layer;
+    item.dynamic = dynamic;
+    item.wind = wind;
+    item.depth = 0.0f;
+}
+
+static bool CompareFrontToBack(const DrawItem &a, const DrawItem &b)
+{
+    if (a.layer != b.layer)
+        return a.layer < b.layer;
+    return a.depth < b.depth;
+}
+
+// Itens por tarefa nos laços paralelos da lista
+#define DRAWLIST_GRAIN 512
+
+void DrawList_SortFrontToBack(DrawList* list, const glm::mat4 &view, JobSystem* jobs)
+{
+    DrawItem* items = list->items.data();
+    Jobs_ParallelFor(jobs, "Lista: distâncias", (int)list->items.size(), DRAWLIST_GRAIN, [items, &view](int begin, int end){
+        for (int i = begin; i < end; ++i)
+        {
+            DrawItem &item = items[i];
+            // A câmera olha para -z no seu sistema de coordenadas
+            glm::vec4 center_view = view * (item.model * glm::vec4(item.object->bsphere.center, 1.0f));
+            item.depth = -center_view.z;
+        }
+    });
+
+    std::sort(list->items.begin(), list->items.end(), CompareFrontToBack);
+}
+
+int DrawList_CullFrustum(DrawList* list, const glm::mat4 &projection_view, JobSystem* jobs)
+{
+    // Planos do frustum extraídos da matriz projection*view (Gribb e
+    // Hartmann), com as normais apontando para dentro
+    glm::mat4 m = glm::transpose(projection_view);
+    glm::vec4 planes[6] = {m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]};
+    for (int p = 0; p < 6; ++p)
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+
+    // Os testes são independentes e cada tarefa escreve só os resultados dos
+    // seus itens; a compactação da lista, que depende da ordem, fica depois
+    const DrawItem* items = list->items.data();
+    list->visible.resize(list->items.size());
+    unsigned char* visible = list->visible.data();
+    Jobs_ParallelFor(jobs, "Lista: frustum culling", (int)list->items.size(), DRAWLIST_GRAIN, [&](int begin, int end){
+        for (int i = begin; i < end; ++i)
+        {
+            const DrawItem &item = items[i];
+
+            // Primeiro a esfera, o teste mais barato; a caixa orientada, mais
+            // justa, só é testada quando a esfera cruza algum plano
+            BoundingSphere sphere = BoundingSphere_Transform(item.object->bsphere, item.model);
+            bool inside = true;
+            bool crossing = false;
+            for (int p = 0; p < 6 && inside; ++p)
+            {
+                float distance = glm::dot(glm::vec3(planes[p]), sphere.center) + planes[p].w;
+                if (distance < -sphere.radius)
+                    inside = false;
+                else if (distance < sphere.radius)
+                    crossing = true;
+            }
+
+            if (inside && crossing)
+            {
+                OrientedBox box = OrientedBox_Transform(item.object->obb, item.model);
+                for (int p = 0; p < 6 && inside; ++p)
+                    if (OrientedBox_PlaneDistance(box, planes[p]) < 0.0f)
+                        inside = false;
+            }
+
+            visible[i] = inside;
+        }
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < list->items.size(); ++i)
+        if (visible[i])
+            list->items[kept++] = list->items[i];
+
+    int culled = (int)(list->items.size() - kept);
+    list->items.resize(kept);
+    return culled;
+}
@@ -0,0 +1,175 @@
+#include <cstring>
+
+#include "ecs.h"
+
+void Ecs_Init(EcsWorld* world)
+{
+    for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+        world->component_size[c] = 0;
+    world->archetypes.clear();
+    world->records.clear();
+    world->free_indices.clear();
+}
+
+void Ecs_RegisterComponent(EcsWorld* world, int component, size_t size)
+{
+    world->component_size[component] = size;
+}
+
+// Arquétipo com exatamente os componentes de "mask", criado se não existe.
+// Retorna o índice, já que criar um arquétipo pode realocar o vetor.
+static int Ecs_FindArchetype(EcsWorld* world, EcsMask mask)
+{
+    for (size_t i = 0; i < world->archetypes.size(); ++i)
+        if (world->archetypes[i].mask == mask)
+            return (int)i;
+
+    world->archetypes.push_back(EcsArchetype());
+    world->archetypes.back().mask = mask;
+    world->archetypes.back().count = 0;
+    return (int)world->archetypes.size() - 1;
+}
+
+// Acrescenta uma linha zerada ao arquétipo e retorna o seu número
+static int Ecs_AddRow(EcsWorld* world, EcsArchetype* archetype, EcsEntity entity)
+{
+    int row = archetype->count;
+    archetype->count += 1;
+    archetype->entities.push_back(entity);
+    for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+        if (archetype->mask & ECS_BIT(c))
+            archetype->columns[c].resize(archetype->count * world->component_size[c], 0);
+    return row;
+}
+
+// Remove uma linha, movendo a última para o seu lugar
+static void Ecs_RemoveRow(EcsWorld* world, EcsArchetype* archetype, int row)
+{
+    int last = archetype->count - 1;
+    if (row != last)
+    {
+        for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+        {
+            size_t size = world->component_size[c];
+            if ((archetype->mask & ECS_BIT(c)) && size > 0)
+                memcpy(&archetype->columns[c][row * size], &archetype->columns[c][last * size], size);
+        }
+        archetype->entities[row] = archetype->entities[last];
+        world->records[archetype->entities[row].index].row = row;
+    }
+
+    archetype->count = last;
+    archetype->entities.pop_back();
+    for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+        if (archetype->mask & ECS_BIT(c))
+            archetype->columns[c].resize(archetype->count * world->component_size[c]);
+}
+
+EcsEntity Ecs_Create(EcsWorld* world, EcsMask mask)
+{
+    EcsEntity entity;
+    if (!world->free_indices.empty())
+    {
+        entity.index = world->free_indices.back();
+        world->free_indices.pop_back();
+    }
+    else
+    {
+        entity.index = (unsigned int)world->records.size();
+        EcsRecord record = {0, -1, -1};
+        world->records.push_back(record);
+    }
+    entity.generation = world->records[entity.index].generation;
+
+    int archetype = Ecs_FindArchetype(world, mask);
+    EcsRecord* record = &world->records[entity.index];
+    record->archetype = archetype;
+    record->row = Ecs_AddRow(world, &world->archetypes[archetype], entity);
+    return entity;
+}
+
+bool Ecs_IsAlive(const EcsWorld* world, EcsEntity entity)
+{
+    return entity.index < world->records.size()
+        && world->records[entity.index].archetype >= 0
+        && world->records[entity.index].generation == entity.generation;
+}
+
+void Ecs_Destroy(EcsWorld* world, EcsEntity entity)
+{
+    if (!Ecs_IsAlive(world, entity))
+        return;
+
+    EcsRecord* record = &world->records[entity.index];
+    Ecs_RemoveRow(world, &world->archetypes[record->archetype], record->row);
+
+    record = &world->records[entity.index];
+    record->archetype = -1;
+    record->row = -1;
+    record->generation += 1;
+    world->free_indices.push_back(entity.index);
+}
+
+EcsEntity Ecs_FromIndex(const EcsWorld* world, unsigned int index)
+{
+    EcsEntity entity = {index, 0};
+    if (index < world->records.size())
+        entity.generation = world->records[index].generation;
+    else
+        entity.index = (unsigned int)-1;
+    return entity;
+}
+
+EcsMask Ecs_Mask(const EcsWorld* world, EcsEntity entity)
+{
+    if (!Ecs_IsAlive(world, entity))
+        return 0;
+    return world->archetypes[world->records[entity.index].archetype].mask;
+}
+
+void Ecs_SetMask(EcsWorld* world, EcsEntity entity, EcsMask mask)
+{
+    if (!Ecs_IsAlive(world, entity))
+        return;
+
+    EcsRecord record = world->records[entity.index];
+    if (world->archetypes[record.archetype].mask == mask)
+        return;
+
+    int target = Ecs_FindArchetype(world, mask);
+    EcsArchetype* from = &world->archetypes[record.archetype];
+    EcsArchetype* to = &world->archetypes[target];
+
+    int row = Ecs_AddRow(world, to, entity);
+    for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+    {
+        size_t size = world->component_size[c];
+        if ((from->mask & to->mask & ECS_BIT(c)) && size > 0)
+            memcpy(&to->columns[c][row * size], &from->columns[c][record.row * size], size);
+    }
+    Ecs_RemoveRow(world, from, record.row);
+
+    world->records[entity.index].archetype = target;
+    world->records[entity.index].row = row;
+}
+
+void Ecs_Reserve(EcsWorld* world, EcsMask mask, int count)
+{
+    EcsArchetype* archetype = &world->archetypes[Ecs_FindArchetype(world, mask)];
+    archetype->entities.reserve(archetype->count + count);
+    for (int c = 0; c < ECS_MAX_COMPONENTS; ++c)
+        if (mask & ECS_BIT(c))
+            archetype->columns[c].reserve((archetype->count + count) * world->component_size[c]);
+}
+
+void* Ecs_Get(EcsWorld* world, EcsEntity entity, int component)
+{
+    if (!Ecs_IsAlive(world, entity))
+        return NULL;
+
+    const EcsRecord &record = world->records[entity.index];
+    EcsArchetype* archetype = &world->archetypes[record.archetype];
+    if (!(archetype->mask & ECS_BIT(component)) || world->component_size[component] == 0)
+        return NULL;
+    return &archetype->columns[component][record.row * world->component_size[component]];
+}
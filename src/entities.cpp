@@ -0,0 +1,12 @@
+#include "entities.h"
+
+void EntityArrays_Resize(EntityArrays* entities, int count)
+{
+    entities->count = count;
+    entities->x.resize(count, 0.0f);
+    entities->z.resize(count, 0.0f);
+    entities->y.resize(count, 0.0f);
+    entities->scale.resize(count, 1.0f);
+    entities->type.resize(count, 0);
+    entities->node.resize(count, -1);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "framepacing.h"
+
+// Peso da amostra mais recente nas médias móveis
+#define FRAMEPACING_SMOOTHING 0.1
+
+// Fração do maior atraso do sleep mantida a cada quadro, para que a margem
+// de spin diminua se o sistema voltar a acordar a thread na hora
+#define FRAMEPACING_SLEEP_ERROR_DECAY 0.99
+
+// Margem mínima de spin, em milissegundos
+#define FRAMEPACING_MIN_SPIN_MS 0.5
+
+double FramePacing_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacing_Init(FramePacer* pacer, double target_rate, int vsync)
+{
+    pacer->target_rate = std::max(0.0, target_rate);
+    pacer->vsync = vsync;
+
+    if (vsync == VSYNC_OFF)
+        pacer->swap_interval = 0;
+    else if (vsync == VSYNC_ADAPTIVE && (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear")))
+        pacer->swap_interval = -1;
+    else
+        pacer->swap_interval = 1;
+
+    pacer->next_frame = pacer->last_frame = FramePacing_Now();
+    pacer->sleep_error_ms = 1.0;
+    pacer->history_count = pacer->history_next = 0;
+    pacer->sleep_ms = pacer->spin_ms = 0.0;
+}
+
+void FramePacing_ApplySwapInterval(const FramePacer* pacer)
+{
+    glfwSwapInterval(pacer->swap_interval);
+}
+
+void FramePacing_Wait(FramePacer* pacer)
+{
+    double now = FramePacing_Now();
+    double slept = 0.0, spun = 0.0;
+
+    if (pacer->target_rate > 0.0)
+    {
+        double period = 1000.0 / pacer->target_rate;
+        pacer->next_frame += period;
+
+        // Atrasado: recomeça a contagem a partir de agora, em vez de encurtar
+        // os quadros seguintes para recuperar o atraso
+        if (now > pacer->next_frame)
+            pacer->next_frame = now;
+
+        double margin = std::max(pacer->sleep_error_ms, FRAMEPACING_MIN_SPIN_MS);
+        double sleep = pacer->next_frame - now - margin;
+        if (sleep > 0.0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(sleep));
+            double woke = FramePacing_Now();
+            slept = woke - now;
+            pacer->sleep_error_ms = std::max(slept - sleep, pacer->sleep_error_ms * FRAMEPACING_SLEEP_ERROR_DECAY);
+            now = woke;
+        }
+
+        double spin_start = now;
+        while (now < pacer->next_frame)
+        {
+            std::this_thread::yield();
+            now = FramePacing_Now();
+        }
+        spun = now - spin_start;
+    }
+    else
+    {
+        pacer->next_frame = now;
+    }
+
+    pacer->history[pacer->history_next] = now - pacer->last_frame;
+    pacer->history_next = (pacer->history_next + 1) % FRAMEPACING_HISTORY;
+    pacer->history_count = std::min(pacer->history_count + 1, FRAMEPACING_HISTORY);
+    pacer->last_frame = now;
+
+    pacer->sleep_ms += (slept - pacer->sleep_ms) * FRAMEPACING_SMOOTHING;
+    pacer->spin_ms += (spun - pacer->spin_ms) * FRAMEPACING_SMOOTHING;
+}
+
+void FramePacing_Stats(const FramePacer* pacer, FramePacingStats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->sleep_ms = pacer->sleep_ms;
+    stats->spin_ms = pacer->spin_ms;
+
+    int count = pacer->history_count;
+    if (count == 0)
+        return;
+
+    double sum = 0.0;
+    stats->min_ms = stats->max_ms = pacer->history[0];
+    for (int i = 0; i < count; ++i)
+    {
+        sum += pacer->history[i];
+        stats->min_ms = std::min(stats->min_ms, pacer->history[i]);
+        stats->max_ms = std::max(stats->max_ms, pacer->history[i]);
+    }
+    stats->frame_ms = sum / count;
+
+    double variance = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        double difference = pacer->history[i] - stats->frame_ms;
+        variance += difference * difference;
+    }
+    stats->jitter_ms = std::sqrt(variance / count);
+}
+
+int FramePacing_ParseVsync(const char* name)
+{
+    if (strcmp(name, "off") == 0)
+        return VSYNC_OFF;
+    if (strcmp(name, "on") == 0)
+        return VSYNC_ON;
+    if (strcmp(name, "adaptive") == 0)
+        return VSYNC_ADAPTIVE;
+    return -1;
+}
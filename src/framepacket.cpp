@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "framepacket.h"
+
+// Peso da amostra mais recente nas médias móveis das estatísticas
+#define FRAMEQUEUE_SMOOTHING 0.1
+
+double FrameQueue_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacket_Clear(FramePacket* packet)
+{
+    packet->lights.clear();
+    DrawList_Clear(&packet->casters);
+    DrawList_Clear(&packet->visible);
+    packet->reload_shaders = false;
+    packet->num_texts = 0;
+}
+
+void FramePacket_AddText(FramePacket* packet, const char* text, float x, float y, float scale)
+{
+    if (packet->num_texts == (int)packet->texts.size())
+        packet->texts.push_back(FrameText());
+
+    FrameText &item = packet->texts[packet->num_texts++];
+    item.text = text;
+    item.x = x;
+    item.y = y;
+    item.scale = scale;
+}
+
+void FrameQueue_Init(FrameQueue* queue, const std::function<void(const FramePacket*, RenderStats*)> &render)
+{
+    for (int i = 0; i < FRAME_PACKETS; ++i)
+    {
+        queue->packets[i].frame = -1;
+        FramePacket_Clear(&queue->packets[i]);
+    }
+    queue->writing = 0;
+    queue->ready = 1;
+    queue->reading = 2;
+    queue->has_ready = false;
+    queue->render = render;
+    queue->threaded = false;
+    queue->running = false;
+
+    RenderStats &stats = queue->stats;
+    stats.shaded_fragments = 0;
+    for (int c = 0; c < SHADOW_CASCADES; ++c)
+    {
+        stats.shadow_splits[c] = 0.0f;
+        stats.shadow_draws[c] = stats.shadow_static_renders[c] = 0;
+    }
+    stats.frames = 0;
+    stats.render_ms = stats.latency_ms = stats.max_latency_ms = 0.0;
+    queue->max_latency_start = FrameQueue_Now();
+}
+
+// Desenha um pacote e atualiza as estatísticas. A latência vai até o retorno
+// de "render", que termina com a troca dos buffers.
+static void FrameQueue_Render(FrameQueue* queue, const FramePacket* packet)
+{
+    RenderStats stats;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        stats = queue->stats;
+    }
+
+    double start = FrameQueue_Now();
+    queue->render(packet, &stats);
+    double end = FrameQueue_Now();
+
+    double latency = end - packet->input_time;
+    stats.frames += 1;
+    stats.render_ms += (end - start - stats.render_ms) * FRAMEQUEUE_SMOOTHING;
+    stats.latency_ms += (latency - stats.latency_ms) * FRAMEQUEUE_SMOOTHING;
+
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (end - queue->max_latency_start > 1000.0)
+    {
+        stats.max_latency_ms = 0.0;
+        queue->max_latency_start = end;
+    }
+    stats.max_latency_ms = std::max(stats.max_latency_ms, latency);
+    queue->stats = stats;
+}
+
+static void FrameQueue_Thread(FrameQueue* queue)
+{
+    queue->context(true);
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->wake.wait(lock, [queue]{ return !queue->running || queue->has_ready; });
+
+            // Ao parar, o último pacote enviado ainda é desenhado
+            if (!queue->has_ready)
+                break;
+
+            // O pacote pronto passa a ser o desenhado; o desenhado antes fica
+            // livre para a thread do quadro
+            std::swap(queue->ready, queue->reading);
+            queue->has_ready = false;
+        }
+        queue->wake.notify_all();
+
+        FrameQueue_Render(queue, &queue->packets[queue->reading]);
+    }
+
+    queue->context(false);
+}
+
+void FrameQueue_Start(FrameQueue* queue, bool threaded, const std::function<void(bool)> &context)
+{
+    queue->threaded = threaded;
+    queue->context = context;
+
+    if (threaded)
+    {
+        queue->running = true;
+        queue->context(false);
+        queue->thread = std::thread(FrameQueue_Thread, queue);
+    }
+}
+
+void FrameQueue_Stop(FrameQueue* queue)
+{
+    if (!queue->threaded || !queue->running)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->running = false;
+    }
+    queue->wake.notify_all();
+    queue->thread.join();
+    queue->context(true);
+}
+
+FramePacket* FrameQueue_BeginWrite(FrameQueue* queue)
+{
+    if (queue->threaded)
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        queue->wake.wait(lock, [queue]{ return !queue->running || !queue->has_ready; });
+    }
+    return &queue->packets[queue->writing];
+}
+
+void FrameQueue_Submit(FrameQueue* queue)
+{
+    if (!queue->threaded)
+    {
+        FrameQueue_Render(queue, &queue->packets[queue->writing]);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        std::swap(queue->writing, queue->ready);
+        queue->has_ready = true;
+    }
+    queue->wake.notify_all();
+}
+
+void FrameQueue_Stats(FrameQueue* queue, RenderStats* stats)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    *stats = queue->stats;
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#endif
+
+#include "headless.h"
+
+// Tipos e constantes da EGL usados aqui, de EGL/egl.h e EGL/eglext.h, para
+// não depender dos headers na compilação
+typedef void*        EGLDisplay;
+typedef void*        EGLConfig;
+typedef void*        EGLContext;
+typedef void*        EGLSurface;
+typedef int          EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+
+#define EGL_NONE                            0x3038
+#define EGL_SURFACE_TYPE                    0x3033
+#define EGL_RENDERABLE_TYPE                 0x3040
+#define EGL_OPENGL_BIT                      0x0008
+#define EGL_OPENGL_API                      0x30A2
+#define EGL_CONTEXT_MAJOR_VERSION           0x3098
+#define EGL_CONTEXT_MINOR_VERSION           0x30FB
+#define EGL_CONTEXT_OPENGL_PROFILE_MASK     0x30FD
+#define EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT 0x0001
+#define EGL_PLATFORM_SURFACELESS_MESA       0x31DD
+
+typedef EGLDisplay (*EglGetDisplay)(void* native_display);
+typedef EGLDisplay (*EglGetPlatformDisplay)(EGLenum platform, void* native_display, const EGLint* attributes);
+typedef EGLBoolean (*EglInitialize)(EGLDisplay display, EGLint* major, EGLint* minor);
+typedef EGLBoolean (*EglTerminate)(EGLDisplay display);
+typedef EGLBoolean (*EglChooseConfig)(EGLDisplay display, const EGLint* attributes, EGLConfig* configs, EGLint size, EGLint* count);
+typedef EGLBoolean (*EglBindAPI)(EGLenum api);
+typedef EGLContext (*EglCreateContext)(EGLDisplay display, EGLConfig config, EGLContext share, const EGLint* attributes);
+typedef EGLBoolean (*EglDestroyContext)(EGLDisplay display, EGLContext context);
+typedef EGLBoolean (*EglMakeCurrent)(EGLDisplay display, EGLSurface draw, EGLSurface read, EGLContext context);
+typedef void*      (*EglGetProcAddress)(const char* name);
+
+static EglMakeCurrent    g_EglMakeCurrent;
+static EglGetProcAddress g_EglGetProcAddress;
+
+static double Headless_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void* Headless_GetProcAddress(const char* name)
+{
+    return g_EglGetProcAddress(name);
+}
+
+// Cria o display e o contexto EGL e o torna atual, sem superfície
+static bool Headless_CreateContext(HeadlessContext* headless)
+{
+#ifdef __linux__
+    headless->library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (!headless->library)
+    {
+        fprintf(stderr, "Headless: não foi possível carregar a libEGL (%s)\n", dlerror());
+        return false;
+    }
+
+    #define HEADLESS_EGL_FUNCTION(type, name) type name = (type)dlsym(headless->library, #name)
+    HEADLESS_EGL_FUNCTION(EglGetDisplay, eglGetDisplay);
+    HEADLESS_EGL_FUNCTION(EglInitialize, eglInitialize);
+    HEADLESS_EGL_FUNCTION(EglChooseConfig, eglChooseConfig);
+    HEADLESS_EGL_FUNCTION(EglBindAPI, eglBindAPI);
+    HEADLESS_EGL_FUNCTION(EglCreateContext, eglCreateContext);
+    HEADLESS_EGL_FUNCTION(EglMakeCurrent, eglMakeCurrent);
+    HEADLESS_EGL_FUNCTION(EglGetProcAddress, eglGetProcAddress);
+    #undef HEADLESS_EGL_FUNCTION
+    if (!eglGetDisplay || !eglInitialize || !eglChooseConfig || !eglBindAPI || !eglCreateContext || !eglMakeCurrent || !eglGetProcAddress)
+    {
+        fprintf(stderr, "Headless: libEGL incompleta\n");
+        return false;
+    }
+    g_EglMakeCurrent = eglMakeCurrent;
+    g_EglGetProcAddress = eglGetProcAddress;
+
+    // Na Mesa, a plataforma "surfaceless" não precisa de servidor X nem de
+    // GPU; nos outros drivers, o display padrão
+    EglGetPlatformDisplay get_platform_display = (EglGetPlatformDisplay)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = NULL;
+    if (get_platform_display)
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, NULL, NULL);
+    if (!display)
+        display = eglGetDisplay(NULL);
+
+    EGLint major, minor;
+    if (!display || !eglInitialize(display, &major, &minor))
+    {
+        fprintf(stderr, "Headless: eglInitialize() falhou\n");
+        return false;
+    }
+    headless->display = display;
+
+    // Sem superfícies: os quadros vão para um framebuffer do próprio contexto
+    const EGLint config_attributes[] = {
+        EGL_SURFACE_TYPE, 0,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint num_configs = 0;
+    if (!eglChooseConfig(display, config_attributes, &config, 1, &num_configs) || num_configs == 0)
+    {
+        fprintf(stderr, "Headless: nenhuma configuração EGL com OpenGL\n");
+        return false;
+    }
+
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    eglBindAPI(EGL_OPENGL_API);
+    headless->context = eglCreateContext(display, config, NULL, context_attributes);
+    if (!headless->context)
+    {
+        fprintf(stderr, "Headless: não foi possível criar um contexto OpenGL 3.3\n");
+        return false;
+    }
+
+    if (!eglMakeCurrent(display, NULL, NULL, headless->context))
+    {
+        fprintf(stderr, "Headless: o driver não aceita contexto sem superfície\n");
+        return false;
+    }
+
+    printf("Headless: EGL %d.%d\n", major, minor);
+    return true;
+#else
+    (void)headless;
+    fprintf(stderr, "Headless: disponível apenas no Linux\n");
+    return false;
+#endif
+}
+
+bool Headless_Init(HeadlessContext* headless, int width, int height)
+{
+    headless->library = headless->display = headless->context = NULL;
+    headless->width = width;
+    headless->height = height;
+    headless->framebuffer = headless->color = headless->depth = 0;
+    headless->frame_ms.clear();
+
+    if (!Headless_CreateContext(headless))
+    {
+        Headless_Shutdown(headless);
+        return false;
+    }
+
+    gladLoadGLLoader((GLADloadproc) Headless_GetProcAddress);
+
+    glGenRenderbuffers(1, &headless->color);
+    glBindRenderbuffer(GL_RENDERBUFFER, headless->color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &headless->depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, headless->depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &headless->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, headless->framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, headless->color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, headless->depth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        fprintf(stderr, "Headless: framebuffer %dx%d incompleto\n", width, height);
+        Headless_Shutdown(headless);
+        return false;
+    }
+
+    printf("Headless: %s, %dx%d\n", (const char*)glGetString(GL_RENDERER), width, height);
+    headless->last_frame = Headless_Now();
+    return true;
+}
+
+void Headless_StartTiming(HeadlessContext* headless)
+{
+    headless->frame_ms.clear();
+    headless->last_frame = Headless_Now();
+}
+
+void Headless_Shutdown(HeadlessContext* headless)
+{
+#ifdef __linux__
+    if (headless->context)
+    {
+        if (headless->framebuffer)
+        {
+            glDeleteFramebuffers(1, &headless->framebuffer);
+            glDeleteRenderbuffers(1, &headless->color);
+            glDeleteRenderbuffers(1, &headless->depth);
+        }
+        g_EglMakeCurrent(headless->display, NULL, NULL, NULL);
+        ((EglDestroyContext)dlsym(headless->library, "eglDestroyContext"))(headless->display, headless->context);
+    }
+    if (headless->display)
+        ((EglTerminate)dlsym(headless->library, "eglTerminate"))(headless->display);
+    if (headless->library)
+        dlclose(headless->library);
+#endif
+    headless->library = headless->display = headless->context = NULL;
+    headless->framebuffer = headless->color = headless->depth = 0;
+}
+
+void Headless_MakeCurrent(HeadlessContext* headless, bool attach)
+{
+    g_EglMakeCurrent(headless->display, NULL, NULL, attach ? headless->context : NULL);
+}
+
+void Headless_EndFrame(HeadlessContext* headless)
+{
+    glFinish();
+
+    double now = Headless_Now();
+    headless->frame_ms.push_back(now - headless->last_frame);
+    headless->last_frame = now;
+}
+
+void Headless_PrintStats(const HeadlessContext* headless)
+{
+    if (headless->frame_ms.empty())
+        return;
+
+    printf("Headless: primeiro quadro em %.1f ms\n", headless->frame_ms[0]);
+    if (headless->frame_ms.size() < 2)
+        return;
+
+    std::vector<double> sorted(headless->frame_ms.begin() + 1, headless->frame_ms.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (size_t i = 0; i < sorted.size(); ++i)
+        total += sorted[i];
+    double mean = total / sorted.size();
+
+    #define HEADLESS_PERCENTILE(p) sorted[std::min(sorted.size() - 1, (size_t)((p) / 100.0 * sorted.size()))]
+    printf("Headless: %d quadros em %.1f ms: %.2f ms/quadro (%.1f fps), mediana %.2f ms, p95 %.2f ms, p99 %.2f ms, máx. %.2f ms\n",
+           (int)sorted.size(), total, mean, 1000.0 / mean,
+           HEADLESS_PERCENTILE(50), HEADLESS_PERCENTILE(95), HEADLESS_PERCENTILE(99), sorted.back());
+    #undef HEADLESS_PERCENTILE
+}
+
+bool Headless_SaveImage(HeadlessContext* headless, const char* filename)
+{
+    int width = headless->width, height = headless->height;
+    std::vector<unsigned char> pixels(width * height * 3);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, headless->framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Headless: não foi possível gravar \"%s\"\n", filename);
+        return false;
+    }
+
+    // As linhas do OpenGL começam por baixo; as do PPM, por cima
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int y = height - 1; y >= 0; --y)
+        fwrite(&pixels[y * width * 3], 1, width * 3, file);
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <chrono>
+
+#include "jobs.h"
+#include "profiler.h"
+
+// Fila da thread atual no sistema; -1 para threads que não pertencem a ele,
+// que usam a fila compartilhada
+static thread_local int t_JobQueue = -1;
+
+static double Jobs_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int Jobs_CurrentQueue(const JobSystem* system)
+{
+    return t_JobQueue >= 0 ? t_JobQueue : system->num_threads;
+}
+
+static void Jobs_Execute(JobSystem* system, const Job &job)
+{
+    double start = Jobs_Now();
+    job.function(job.data, job.begin, job.end);
+    Profiler_RecordJob(job.name, Jobs_Now() - start);
+
+    if (system)
+        system->executed.fetch_add(1, std::memory_order_relaxed);
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+// Tira uma tarefa do fim da própria fila ou, se ela está vazia, do início da
+// fila de outra thread
+static bool Jobs_Pop(JobSystem* system, int own, Job* job)
+{
+    int num_queues = (int)system->queues.size();
+    for (int i = 0; i < num_queues; ++i)
+    {
+        int q = (own + i) % num_queues;
+        JobQueue &queue = system->queues[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        if (i == 0)
+        {
+            *job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            *job = queue.jobs.front();
+            queue.jobs.pop_front();
+            system->steals.fetch_add(1, std::memory_order_relaxed);
+        }
+        system->queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+static void Jobs_WorkerLoop(JobSystem* system, int index)
+{
+    t_JobQueue = index;
+    for (;;)
+    {
+        Job job;
+        if (Jobs_Pop(system, index, &job))
+        {
+            Jobs_Execute(system, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(system->sleep_mutex);
+        system->wake.wait(lock, [system]{ return !system->running || system->queued.load() > 0; });
+        if (!system->running)
+            return;
+    }
+}
+
+void Jobs_Init(JobSystem* system, int num_threads)
+{
+    if (num_threads <= 0)
+        num_threads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    system->num_threads = num_threads;
+    std::vector<JobQueue>(num_threads + 1).swap(system->queues);
+    system->queued = 0;
+    system->running = true;
+    Jobs_ResetStats(system);
+
+    t_JobQueue = 0;
+    for (int t = 1; t < num_threads; ++t)
+        system->workers.push_back(std::thread(Jobs_WorkerLoop, system, t));
+}
+
+void Jobs_Shutdown(JobSystem* system)
+{
+    {
+        std::lock_guard<std::mutex> lock(system->sleep_mutex);
+        system->running = false;
+    }
+    system->wake.notify_all();
+
+    for (size_t t = 0; t < system->workers.size(); ++t)
+        system->workers[t].join();
+    system->workers.clear();
+    t_JobQueue = -1;
+}
+
+void Jobs_Run(JobSystem* system, const Job &job)
+{
+    job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    JobQueue &queue = system->queues[Jobs_CurrentQueue(system)];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    system->queued.fetch_add(1);
+
+    // O mutex garante que uma thread que acabou de ver as filas vazias já
+    // está esperando quando o aviso é dado
+    if (system->num_threads > 1)
+    {
+        { std::lock_guard<std::mutex> lock(system->sleep_mutex); }
+        system->wake.notify_all();
+    }
+}
+
+void Jobs_Dispatch(JobSystem* system, const char* name, int count, int grain, JobFunction function, void* data, JobCounter* counter)
+{
+    if (count <= 0)
+        return;
+    grain = std::max(1, grain);
+
+    Job job;
+    job.function = function;
+    job.data = data;
+    job.counter = counter;
+    job.name = name;
+
+    // Sem outras threads para ajudar, dividir só acrescentaria custo
+    if (!system || system->num_threads == 1 || count <= grain)
+    {
+        job.begin = 0;
+        job.end = count;
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+        Jobs_Execute(system, job);
+        return;
+    }
+
+    // As tarefas são enfileiradas da última para a primeira: a thread atual
+    // começa pelo início do intervalo e as outras roubam do final
+    for (int end = count; end > 0; end -= grain)
+    {
+        job.begin = std::max(0, end - grain);
+        job.end = end;
+        Jobs_Run(system, job);
+    }
+}
+
+void Jobs_Wait(JobSystem* system, JobCounter* counter)
+{
+    while (counter->pending.load(std::memory_order_acquire) > 0)
+    {
+        Job job;
+        if (Jobs_Pop(system, Jobs_CurrentQueue(system), &job))
+            Jobs_Execute(system, job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void Jobs_ResetStats(JobSystem* system)
+{
+    system->steals = 0;
+    system->executed = 0;
+}
@@ -0,0 +1,240 @@
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <algorithm>
+
+#include <glm/vec4.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "lights.h"
+
+// Distância até a câmera do início da fatia de profundidade "slice".
+static float SliceDistance(const LightClusters* clusters, int slice)
+{
+    float ratio = clusters->far_distance / clusters->near_distance;
+    return clusters->near_distance * std::pow(ratio, (float)slice / CLUSTER_GRID_Z);
+}
+
+static int ClusterIndex(int x, int y, int z)
+{
+    return x + CLUSTER_GRID_X*(y + CLUSTER_GRID_Y*z);
+}
+
+void LightClusters_Init(LightClusters* clusters, int num_groups)
+{
+    if (num_groups <= 0)
+        num_groups = std::min(8, std::max(1, (int)std::thread::hardware_concurrency()));
+
+    clusters->num_groups = num_groups;
+    clusters->group_indices.resize(num_groups);
+    clusters->field_of_view = clusters->aspect = 0.0f;
+    clusters->near_distance = clusters->far_distance = 0.0f;
+    clusters->cluster_min.resize(CLUSTER_COUNT);
+    clusters->cluster_max.resize(CLUSTER_COUNT);
+    clusters->cluster_grid.assign(2*CLUSTER_COUNT, 0);
+
+    // Cada lista é um "buffer object" lido no shader através de um texture buffer
+    glGenBuffers(1, &clusters->grid_buffer);
+    glGenBuffers(1, &clusters->index_buffer);
+    glGenBuffers(1, &clusters->light_buffer);
+    glGenTextures(1, &clusters->grid_texture);
+    glGenTextures(1, &clusters->index_texture);
+    glGenTextures(1, &clusters->light_texture);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->grid_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 2*CLUSTER_COUNT*sizeof(GLuint), NULL, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->grid_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, clusters->grid_buffer);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->index_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(GLuint), NULL, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->index_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, clusters->index_buffer);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->light_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 8*sizeof(float), NULL, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->light_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, clusters->light_buffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters_SetProjection(LightClusters* clusters, float field_of_view, float aspect, float near_distance, float far_distance)
+{
+    if (clusters->field_of_view == field_of_view && clusters->aspect == aspect &&
+        clusters->near_distance == near_distance && clusters->far_distance == far_distance)
+        return;
+
+    clusters->field_of_view = field_of_view;
+    clusters->aspect = aspect;
+    clusters->near_distance = near_distance;
+    clusters->far_distance = far_distance;
+
+    // Meia altura e meia largura do frustum a uma distância unitária da câmera
+    float t = std::tan(field_of_view / 2.0f);
+    float r = t * aspect;
+
+    for (int z = 0; z < CLUSTER_GRID_Z; ++z)
+    {
+        float d0 = SliceDistance(clusters, z);
+        float d1 = SliceDistance(clusters, z + 1);
+
+        for (int y = 0; y < CLUSTER_GRID_Y; ++y)
+        {
+            // Limites do bloco em "normalized device coordinates"
+            float y0 = -1.0f + 2.0f*y/CLUSTER_GRID_Y;
+            float y1 = -1.0f + 2.0f*(y + 1)/CLUSTER_GRID_Y;
+
+            for (int x = 0; x < CLUSTER_GRID_X; ++x)
+            {
+                float x0 = -1.0f + 2.0f*x/CLUSTER_GRID_X;
+                float x1 = -1.0f + 2.0f*(x + 1)/CLUSTER_GRID_X;
+
+                // AABB dos 8 cantos do cluster. A câmera olha para -z.
+                glm::vec3 bmin( std::numeric_limits<float>::max());
+                glm::vec3 bmax(-std::numeric_limits<float>::max());
+                float depths[2] = {d0, d1};
+                for (int k = 0; k < 2; ++k)
+                {
+                    float d = depths[k];
+                    glm::vec3 corners[4] = {glm::vec3(x0*r*d, y0*t*d, -d), glm::vec3(x1*r*d, y0*t*d, -d),
+                                            glm::vec3(x0*r*d, y1*t*d, -d), glm::vec3(x1*r*d, y1*t*d, -d)};
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        bmin = glm::min(bmin, corners[c]);
+                        bmax = glm::max(bmax, corners[c]);
+                    }
+                }
+
+                clusters->cluster_min[ClusterIndex(x, y, z)] = bmin;
+                clusters->cluster_max[ClusterIndex(x, y, z)] = bmax;
+            }
+        }
+    }
+}
+
+// Monta as listas das fatias z = group, group + num_groups, ... Os inícios
+// gravados em cluster_grid são relativos à lista do próprio grupo.
+static void BuildSlices(LightClusters* clusters, int group)
+{
+    const std::vector<glm::vec4> &view_lights = clusters->view_lights;
+    std::vector<GLuint> &out = clusters->group_indices[group];
+    out.clear();
+
+    std::vector<GLuint> candidates;
+    candidates.reserve(view_lights.size());
+
+    for (int z = group; z < CLUSTER_GRID_Z; z += clusters->num_groups)
+    {
+        float d0 = SliceDistance(clusters, z);
+        float d1 = SliceDistance(clusters, z + 1);
+
+        // Luzes cuja esfera intercepta a fatia de profundidade
+        candidates.clear();
+        for (size_t i = 0; i < view_lights.size(); ++i)
+        {
+            float depth = -view_lights[i].z;
+            float radius = view_lights[i].w;
+            if (depth + radius >= d0 && depth - radius <= d1)
+                candidates.push_back((GLuint)i);
+        }
+
+        for (int y = 0; y < CLUSTER_GRID_Y; ++y)
+        {
+            for (int x = 0; x < CLUSTER_GRID_X; ++x)
+            {
+                int cluster = ClusterIndex(x, y, z);
+                const glm::vec3 &bmin = clusters->cluster_min[cluster];
+                const glm::vec3 &bmax = clusters->cluster_max[cluster];
+
+                GLuint first = (GLuint)out.size();
+
+                // Teste esfera-AABB: distância da luz ao ponto mais próximo da caixa
+                for (size_t c = 0; c < candidates.size(); ++c)
+                {
+                    const glm::vec4 &light = view_lights[candidates[c]];
+                    glm::vec3 center(light.x, light.y, light.z);
+                    glm::vec3 delta = glm::clamp(center, bmin, bmax) - center;
+                    if (glm::dot(delta, delta) <= light.w*light.w)
+                        out.push_back(candidates[c]);
+                }
+
+                clusters->cluster_grid[2*cluster + 0] = first;
+                clusters->cluster_grid[2*cluster + 1] = (GLuint)out.size() - first;
+            }
+        }
+    }
+}
+
+void LightClusters_Build(LightClusters* clusters, const std::vector<PointLight> &lights, const glm::mat4 &view, JobSystem* jobs)
+{
+    clusters->view_lights.resize(lights.size());
+    clusters->light_data.resize(8*lights.size());
+
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        const PointLight &light = lights[i];
+        glm::vec4 p = view * glm::vec4(light.position, 1.0f);
+        clusters->view_lights[i] = glm::vec4(p.x, p.y, p.z, light.radius);
+
+        float* data = &clusters->light_data[8*i];
+        data[0] = light.position.x;
+        data[1] = light.position.y;
+        data[2] = light.position.z;
+        data[3] = light.radius;
+        data[4] = light.color.r * light.intensity;
+        data[5] = light.color.g * light.intensity;
+        data[6] = light.color.b * light.intensity;
+        data[7] = 0.0f;
+    }
+
+    // Uma tarefa por grupo de fatias
+    Jobs_ParallelFor(jobs, "Clusters de luz", clusters->num_groups, 1, [clusters](int begin, int end){
+        for (int group = begin; group < end; ++group)
+            BuildSlices(clusters, group);
+    });
+
+    // Concatena as listas dos grupos e torna os inícios absolutos
+    std::vector<GLuint> base(clusters->num_groups);
+    clusters->light_indices.clear();
+    for (int t = 0; t < clusters->num_groups; ++t)
+    {
+        base[t] = (GLuint)clusters->light_indices.size();
+        const std::vector<GLuint> &indices = clusters->group_indices[t];
+        clusters->light_indices.insert(clusters->light_indices.end(), indices.begin(), indices.end());
+    }
+
+    for (int z = 0; z < CLUSTER_GRID_Z; ++z)
+    {
+        GLuint offset = base[z % clusters->num_groups];
+        for (int i = 0; i < CLUSTER_GRID_X*CLUSTER_GRID_Y; ++i)
+            clusters->cluster_grid[2*(z*CLUSTER_GRID_X*CLUSTER_GRID_Y + i)] += offset;
+    }
+}
+
+void LightClusters_Upload(LightClusters* clusters, GLuint first_unit)
+{
+    // Buffers vazios não podem ser associados a um texture buffer
+    if (clusters->light_indices.empty())
+        clusters->light_indices.push_back(0);
+    if (clusters->light_data.empty())
+        clusters->light_data.assign(8, 0.0f);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->grid_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, clusters->cluster_grid.size()*sizeof(GLuint), clusters->cluster_grid.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->index_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, clusters->light_indices.size()*sizeof(GLuint), clusters->light_indices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->light_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, clusters->light_data.size()*sizeof(float), clusters->light_data.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0 + first_unit + 0);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->grid_texture);
+    glActiveTexture(GL_TEXTURE0 + first_unit + 1);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->index_texture);
+    glActiveTexture(GL_TEXTURE0 + first_unit + 2);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->light_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -1,1609 +1,2862 @@
-//      Universidade Federal do Rio Grande do Sul
-//              Instituto de Informática
-//        Departamento de Informática Aplicada
-//
-//     INF01047 Fundamentos de Computação Gráfica
-//                Prof. Eduardo Gastal
-//
-// TRABALHO FINAL - FUNDAMENTOS DE COMPUTAÇÃO GRÁFICA
-
-// Bibliotecas e Headers
-#include <cmath>
-#include <cstdio>
-#include <cstdlib>
-
-#include <map>
-#include <stack>
-#include <string>
-#include <vector>
-#include <limits>
-#include <fstream>
-#include <sstream>
-#include <stdexcept>
-#include <algorithm>
-#include <windows.h>
-#include <math.h>
-
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
-#include <glm/mat4x4.hpp>
-#include <glm/vec4.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include <tiny_obj_loader.h>
-#include <stb_image.h>
-
-#include "utils.h"
-#include "matrices.h"
-#include "collisions.h"
-
-// Definições
-#define default_speed      5.50f // Velocidade padrão do jogador
-#define sensitivity        0.50f // Sensibilidade do mouse
-#define delay_cut_tree     3.0f  // Delay para cortar a árvore
-#define n_trees            250   // Número de árvores geradas no mapa
-#define tree_types         1     // Tipos de árvore (objetos lidos)
-#define n_decoration       400   // Número de decorações (plantas) geradas no mapa
-#define decoration_types   4     // Tipos de decorações (objetos lidos)
-#define n_rocks            200   // Número de pedras para compor a montanha
-#define rock_types         7     // Tipos de pedras (objetos lidos)
-
-// IDs das Texturas
-#define TERRAIN 0
-#define TREES 1
-#define MOUNTAINS 2
-#define CHARACTER 3
-#define CHARACTER_CAPA 4
-#define AXE 5
-#define BIGTREE 6
-#define CHICKEN_LEG 7
-#define CHICKEN_BODY 8
-#define CHICKEN_EYE 9
-#define CHICKEN_COMB 10
-
-// Outras definições
-#define M_PI 3.14159265358979323846
-
-// Estrutura que representa um modelo geométrico carregado a partir de um arquivo .obj
-struct ObjModel
-{
-    tinyobj::attrib_t                 attrib;
-    std::vector<tinyobj::shape_t>     shapes;
-    std::vector<tinyobj::material_t>  materials;
-
-    // Este construtor lê o modelo de um arquivo utilizando a biblioteca tinyobjloader.
-    // Veja: https://github.com/syoyo/tinyobjloader
-    ObjModel(const char* filename, const char* basepath = NULL, bool triangulate = true)
-    {
-        printf("Carregando modelo \"%s\"... ", filename);
-
-        std::string err;
-        bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &err, filename, basepath, triangulate);
-
-        if (!err.empty())
-            fprintf(stderr, "\n%s\n", err.c_str());
-
-        if (!ret)
-            throw std::runtime_error("Erro ao carregar modelo.");
-
-        printf("OK.\n");
-    }
-};
-
-// Definição das funções
-void BuildTrianglesAndAddToVirtualScene(ObjModel*); // Constrói representação de um ObjModel como malha de triângulos para renderização
-void ComputeNormals(ObjModel* model); // Computa normais de um ObjModel, caso não existam.
-void LoadShadersFromFiles(); // Carrega os shaders de vértice e fragmento, criando um programa de GPU
-void LoadTextureImage(const char* filename, int mode_id=GL_CLAMP_TO_EDGE); // Função que carrega imagens de textura
-void DrawVirtualObject(const char* object_name, int ind_type=0); // Desenha um objeto armazenado em g_VirtualScene
-GLuint LoadShader_Vertex(const char* filename);   // Carrega um vertex shader
-GLuint LoadShader_Fragment(const char* filename); // Carrega um fragment shader
-void LoadShader(const char* filename, GLuint shader_id); // Função utilizada pelas duas acima
-GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id); // Cria um programa de GPU
-
-glm::vec4 getUserInput(GLFWwindow* window, float x, float y, float z);
-void getAllObjectsInFile(const char* filename);
-glm::vec3 get2DBezierCurve(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float t);
-glm::vec3 get3DBezierCurve(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, float t);
-
-void TextRendering_Init();
-float TextRendering_LineHeight(GLFWwindow* window);
-float TextRendering_CharWidth(GLFWwindow* window);
-void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f);
-void TextRendering_ShowFramesPerSecond(GLFWwindow* window);
-
-void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
-void ErrorCallback(int error, const char* description);
-void CursorPosCallback(GLFWwindow* window, double xpos, double ypos);
-
-// Variáveis globais
-std::map<std::string, SceneObject> g_VirtualScene; // Cena virtual (dicionário).
-std::stack<glm::mat4>  g_MatrixStack; // Pilha que guardará as matrizes de modelagem.
-
-float g_ScreenRatio = 1.0f; // Razão de proporção da janela (largura/altura). Veja função FramebufferSizeCallback().
-
-bool g_LeftMouseButtonPressed = true;
-bool g_RightMouseButtonPressed = false; // Análogo para botão direito do mouse
-bool g_MiddleMouseButtonPressed = false; // Análogo para botão do meio do mouse
-
-// Variáveis que definem a câmera em coordenadas esféricas
-float g_CameraTheta = -12.63;  // Ângulo no plano ZX em relação ao eixo Z
-float g_CameraPhi =  0.06;     // Ângulo em relação ao eixo Y
-float g_CameraDistance = 2.0f; // Distância da câmera para a origem
-float r, x, y, z;
-
-// Variáveis que definem um programa de GPU (shaders). Veja função LoadShadersFromFiles().
-GLuint vertex_shader_id;
-GLuint fragment_shader_id;
-GLuint program_id = 0;
-GLint model_uniform;
-GLint view_uniform;
-GLint projection_uniform;
-GLint object_id_uniform;
-GLint bbox_min_uniform;
-GLint bbox_max_uniform;
-
-GLuint g_NumLoadedTextures = 0; // Número de texturas carregadas pela função LoadTextureImage()
-
-float player_speed = default_speed;
-
-// Animação baseada no tempo
-float dt = 0;
-float dt1 = 0;
-float dt0 = 0;
-
-// Posição do jogador
-float x1 = 3.77f;
-float y1 = 2.50f;
-float z1 = -26.03f;
-
-// Posição do jogador em caso de colisão
-float prev_x1 = x1;
-float prev_y1 = y1;
-float prev_z1 = z1;
-
-// Árvores e machado
-float axe_angle = 0.0f;       // Rotação do machado de acordo com a animação
-float timer = 0.0f;
-bool can_chop = false;        // Variável alterada quando há colisão com uma árvore
-int choppable = 999;          // Índice da árvore sendo cortada
-int broken_trees = 0;
-bool broke_tree[n_trees];     // Estado da árvore (se cortada ou não)
-glm::vec2 trunk_pos[n_trees]; // Posição do tronco da árvore cortada
-char delay_left[30] = "";
-
-// NPC e início do jogo
-bool collided_with_npc = false;
-bool accepted_quest = false;
-bool start_game = false;
-
-// Leitura dos objetos de um .obj
-char obj_names[100][50]={};
-int sizeObjModels = 0;
-
-int main(int argc, char* argv[])
-{
-    // Inicializamos a biblioteca GLFW
-    int success = glfwInit();
-    if (!success)
-    {
-        fprintf(stderr, "ERROR: glfwInit() failed.\n");
-        std::exit(EXIT_FAILURE);
-    }
-
-    // Definimos o callback para impressão de erros da GLFW no terminal
-    glfwSetErrorCallback(ErrorCallback);
-
-    // Pedimos para utilizar OpenGL versão 3.3 (ou superior)
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-
-    #ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    #endif
-
-    // Pedimos para utilizar o perfil "core", isto é, utilizaremos somente as
-    // funções modernas de OpenGL.
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Criamos uma janela do sistema operacional, com 800 colunas e 600 linhas
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Timberman", NULL, NULL);
-    if (!window)
-    {
-        glfwTerminate();
-        fprintf(stderr, "ERROR: glfwCreateWindow() failed.\n");
-        std::exit(EXIT_FAILURE);
-    }
-
-    // Muda o ícone da janela
-    // FONTE: https://stackoverflow.com/questions/44321902/glfw-setwindowicon
-    GLFWimage images[1];
-    images[0].pixels = stbi_load("../../data/textures/icon.png", &images[0].width, &images[0].height, 0, 4);
-    glfwSetWindowIcon(window, 1, images);
-    stbi_image_free(images[0].pixels);
-
-    // Definimos a função de callback que será chamada sempre que o usuário
-    // movimentar o cursor do mouse...
-    glfwSetCursorPosCallback(window, CursorPosCallback);
-
-    // Desabilita o ícone do cursor e mantém ele na janela caso saia
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-    // Indicamos que as chamadas OpenGL deverão renderizar nesta janela
-    glfwMakeContextCurrent(window);
-
-    // Carregamento de todas funções definidas por OpenGL 3.3, utilizando a biblioteca GLAD.
-    gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
-
-    // Definimos a função de callback que será chamada sempre que a janela for redimensionada
-    glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
-    FramebufferSizeCallback(window, 800, 600); // Forçamos a chamada do callback acima, para definir g_ScreenRatio.
-
-    // Carregamos os shaders de vértices e de fragmentos que serão utilizados
-    // para renderização. Veja slides 180-200 do documento Aula_03_Rendering_Pipeline_Grafico.pdf.
-    LoadShadersFromFiles();
-
-    // Carrega as texturas
-    LoadTextureImage("../../data/textures/texture_gradient.png");
-    LoadTextureImage("../../data/textures/low_poly_stones_color_palette.png");
-    LoadTextureImage("../../data/textures/axe.png"); // Textura criada pelo grupo
-    LoadTextureImage("../../data/textures/bigtree.png");
-    LoadTextureImage("../../data/textures/character.png"); // Textura criada pelo grupo
-    LoadTextureImage("../../data/textures/capa.png"); // Textura criada pelo grupo
-
-    // Carrega modelo com o set das árvores, troncos e plano do chão
-    ObjModel scene("../../data/forest_nature_set_all_in.obj");
-    ComputeNormals(&scene);
-    BuildTrianglesAndAddToVirtualScene(&scene);
-
-    // Carrega os modelos das pedras da montanha
-    const char* filename[rock_types] = {"../../data/stone_1.obj",
-                                        "../../data/stone_with_moss_2.obj",
-                                        "../../data/stone_3.obj",
-                                        "../../data/stone_4.obj",
-                                        "../../data/stone_with_moss_5.obj",
-                                        "../../data/stone_6.obj",
-                                        "../../data/stone_7.obj"};
-    for(int i=0; i<rock_types; i++){
-        ObjModel mountain(filename[i]);
-        ComputeNormals(&mountain);
-        BuildTrianglesAndAddToVirtualScene(&mountain);
-
-        getAllObjectsInFile(filename[i]);
-    }
-
-    // Carrega o modelo do NPC (cavaleiro)
-    ObjModel character("../../data/character.obj");
-    ComputeNormals(&character);
-    BuildTrianglesAndAddToVirtualScene(&character);
-
-    // Carrega o modelo do machado
-    ObjModel axe("../../data/axe.obj");
-    ComputeNormals(&axe);
-    BuildTrianglesAndAddToVirtualScene(&axe);
-
-    // Carrega o modelo da árvore gigante
-    ObjModel bigtree("../../data/bigtree.obj");
-    ComputeNormals(&bigtree);
-    BuildTrianglesAndAddToVirtualScene(&bigtree);
-
-    // Carrega o modelo das galinhas
-    ObjModel chicks("../../data/littlechicks.obj");
-    ComputeNormals(&chicks);
-    BuildTrianglesAndAddToVirtualScene(&chicks);
-
-    TextRendering_Init(); // Inicializamos o código para renderização de texto.
-
-    glEnable(GL_DEPTH_TEST); // Habilitamos o Z-buffer. Veja slides 104-116 do documento Aula_09_Projecoes.pdf.
-
-    // Habilitamos o Backface Culling. Veja slides 23-34 do documento Aula_13_Clipping_and_Culling.pdf.
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-
-    // Nomes dos objetos das árvores
-    const char* tree_names[tree_types] = {"Tree_Spruce_small_01_Cylinder.016"};
-
-    // Nomes dos objetos das decorações
-    const char* decoration_names[decoration_types] = {"Grass_bush_high_01_Plane.002", "Grass_bush_low_01_Plane.005",
-                                                      "Flower_bush_white_Plane.023",  "Flower_bush_red_Plane.031"};
-
-    // Vetores de posição das árvores, decorações, pedras e troncos
-    glm::vec3 tree_position[n_trees];
-    glm::vec3 decoration_position[n_decoration];
-    glm::vec3 rock_position[n_rocks];
-    glm::vec3 log_position[n_rocks];
-
-    // Vetores de escaladas árvores e pedras
-    float tree_scale[n_trees];
-    float rock_scale[n_rocks];
-
-    // Randomização
-    float random_x, random_z;
-
-    // Randomiza posições e escala das árvores
-    // Obs.: não verifica se estão muito perto ou dentro de outras
-    for(int i=0; i<n_trees; i++){
-        do{
-            random_x = rand() % 500 - 100;
-            random_z = rand() % 500 - 100;
-        }while((pow(random_x,2) + pow(random_z,2) <= pow(50,2)) ||
-               (pow(random_x,2) + pow(random_z,2) >= pow(150,2)));
-
-        tree_position[i].x = random_x;
-        tree_position[i].z = random_z;
-
-        tree_scale[i] = (rand() % 80)/100.0 + 0.5;
-
-        broke_tree[i] = false;
-    }
-
-    // Randomiza posições das decorações
-    // Obs.: não verifica se estão muito perto ou dentro de outras
-    for(int i=0; i<n_decoration; i++){
-        do{
-            random_x = rand() % 500 - 250;
-            random_z = rand() % 500 - 250;
-        }while((pow(random_x,2) + pow(random_z,2) <= pow(40,2)) ||
-               (pow(random_x,2) + pow(random_z,2) >= pow(150,2)));
-
-        decoration_position[i].x = random_x;
-        decoration_position[i].z = random_z;
-    }
-
-    // Randomiza posições e escala das pedras
-    // Obs.: não verifica se estão muito perto ou dentro de outras
-    for(int i=0; i<n_rocks; i++){
-        do{
-            random_x = rand() % 500 - 250;
-            random_z = rand() % 500 - 250;
-        }while((pow(random_x,2) + pow(random_z,2) <= pow(240,2)) ||
-               (pow(random_x,2) + pow(random_z,2) >= pow(280,2)));
-
-        rock_position[i].x = random_x;
-        rock_position[i].z = random_z;
-
-        rock_scale[i] = ((rand() % 50)/100.0 + 0.8)*40.0;
-    }
-
-    // Randomiza posições dos troncos
-    // Obs.: não verifica se estão muito perto ou dentro de outros
-    for(int i=0; i<10; i++){
-        do{
-            random_x = rand() % 500 - 250;
-            random_z = rand() % 500 - 250;
-        }while((pow(random_x,2) + pow(random_z,2) <= pow(50,2)) ||
-               (pow(random_x,2) + pow(random_z,2) >= pow(150,2)));
-
-        log_position[i].x = random_x;
-        log_position[i].z = random_z;
-    }
-
-    // Inicializando os valores da posição da câmera e do up_vector para a câmera look-at
-    glm::vec4 camera_position_c =  glm::vec4(62.26f, 15.0f, -49.71f, 1.0f); // Início da curva de bezier da câmera look-at
-    glm::vec4 camera_view_vector = glm::vec4(x1, 2.5f, z1, 1.0f) - glm::vec4(62.26f, 15.0f, -49.71f, 1.0f);
-    glm::vec4 camera_up_vector =   glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
-
-    // Definição das esferas da colisão com a árvore
-    int n_spheres = 10;
-    glm::vec3 tree_spheres[n_spheres] = {glm::vec3(-9.10, 2.50, -7.91),
-                                         glm::vec3(-3.59, 2.50, -7.60),
-                                         glm::vec3(1.02, 2.50, -5.68),
-                                         glm::vec3(3.75, 2.50, -5.08),
-                                         glm::vec3(2.76, 2.50, -1.09),
-                                         glm::vec3(5.68, 2.50, 3.07),
-                                         glm::vec3(1.81, 2.50, 3.25),
-                                         glm::vec3(-5.05, 2.50, 5.33),
-                                         glm::vec3(-9.95, 2.50, 6.65),
-                                         glm::vec3(-5.37, 2.50, -1.88)};
-
-    // Curvas de Bezier
-    glm::vec2 p0, p1, p2, p3; // Pontos de controle da curva das galinhas (4 pontos = cúbica)
-    p0 = glm::vec2(-22.66f, -18.40f);
-    p1 = glm::vec2(-6.60f, -23.68f);
-    p2 = glm::vec2(8.76f, -17.90f);
-    p3 = glm::vec2(16.43f, -9.21f);
-    glm::vec3 bezier_obj, bezier_camera; // Posição na Curva de Bezier das galinhas e da câmera
-    float t = 0.0; // Parâmetro "t" do cálculo da curva de bezier
-    bool turn_1 = false;
-    int dir = 0;
-
-    int level = 0; // Nível do jogo (ao total são 3)
-
-    // Texto do monólogo com o NPC
-    char const* monolog_text[15] = {"Ola caro lenhador, o inverno esta se aproximando",
-                                    "e os moradores de uma vila proxima daqui precisam de madeira para se aquecerem.",
-                                    "Caso deseje nos ajudar a coleta-las, pressione [Y].",
-
-                                    "Certo, muito obrigado!",
-                                    "Voce pode comecar coletando a madeira de 3 arvores.",
-                                    "Estarei aqui te esperando!",
-
-                                    "Nos ficamos muito gratos pela sua ajuda!",
-                                    "Porem, precisaremos de mais um pouco de madeira.",
-                                    "Precisaremos da madeira de mais 5 arvores.",
-
-                                    "Temos alguns moradores novos na nossa vila, entao",
-                                    "precisaremos de mais madeira. Poderia nos",
-                                    "ajudar coletando a madeira de mais 10 arvores?",
-
-                                    "Muito obrigado pela sua ajuda!",
-                                    "Com certeza as madeiras coletadas por voce",
-                                    "ajudarao a nos aquecer no proximo inverno."};
-
-    bool camera_type = false; // Altera câmera entre look-at e livre
-
-    char broken[20] = "0"; // Display do contador de árvores quebradas
-
-    // Ficamos em loop, renderizando, até que o usuário feche a janela
-    while ((!glfwWindowShouldClose(window))||(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS))
-    {
-        float lineheight = TextRendering_LineHeight(window);
-        float charwidth = TextRendering_CharWidth(window);
-
-        // Curva de Bezier das galinhas
-        // Quando atingir o final da curva, altera os pontos de controle para fazer o caminho contrário
-        if((turn_1) && (t >= 1.0)){
-            p0 = glm::vec2(-22.66f, -18.40f);
-            p1 = glm::vec2(-6.60f, -23.68f);
-            p2 = glm::vec2(8.76f, -17.90f);
-            p3 = glm::vec2(16.43f, -9.21f);
-
-            if((bezier_obj.x >= 16.43f) && (bezier_obj.z >= -9.21f)){
-                turn_1 = false;
-                t = 0;
-                dir = 0;
-            }
-        }
-        else if((!turn_1) && (t >= 1.0)){
-            p0 = glm::vec2(16.43f, -9.21f);
-            p1 = glm::vec2(8.76f, -17.90f);
-            p2 = glm::vec2(-6.60f, -23.68f);
-            p3 = glm::vec2(-22.66f, -18.40f);
-
-            if((bezier_obj.x <= -22.66f) && (bezier_obj.z >= -18.40f)){
-                turn_1 = true;
-                t = 0;
-                dir = 1;
-            }
-        }
-
-        bezier_obj = get2DBezierCurve(p0, p1, p2, p3, t);
-
-        glClearColor(0.433, 0.773, 0.984, 1.0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glUseProgram(program_id);
-
-        // Atualiza o "passo" anterior do jogador, para caso haja colisão
-        prev_x1 = x1;
-        prev_z1 = z1;
-
-        // Câmera
-        r = g_CameraDistance;
-        y = r*sin(g_CameraPhi);
-        z = r*cos(g_CameraPhi)*cos(g_CameraTheta);
-        x = r*cos(g_CameraPhi)*sin(g_CameraTheta);
-
-        // Animação baseada no tempo
-        dt1 = glfwGetTime();
-        dt = dt1 - dt0;
-
-        // Aguarda o usuário iniciar o jogo pressionando ENTER
-        if(start_game){
-            t += dt*0.1;
-
-            if(!camera_type){
-                // Câmera look-at da "cut-scene"
-                // Curva de Bezier para a câmera
-                bezier_camera = get3DBezierCurve(glm::vec3(62.26f, 15.0f, -49.71f),
-                                                 glm::vec3(37.03f, 7.0f,  -40.22f),
-                                                 glm::vec3(12.83f, 5.0f,  -34.03f),
-                                                 glm::vec3(x1,     2.5f,     z1-1), t);
-
-                camera_position_c = glm::vec4(bezier_camera.x, bezier_camera.y, bezier_camera.z, 1.0f);
-                camera_view_vector = glm::vec4(x1, 2.5f, z1, 1.0f) - glm::vec4(bezier_camera.x, bezier_camera.y, bezier_camera.z, 1.0f);
-
-                if(t >= 1.0){
-                    camera_type = true;
-
-                    g_CameraTheta = -12.63;
-                    g_CameraPhi =  0.06;
-                }
-            }
-            else{
-                // Câmera livre
-                camera_position_c = getUserInput(window, x, y, z);
-                camera_view_vector = glm::vec4(x, -y, z, 0.0f);
-            }
-        }
-        else{
-            getUserInput(window, x, y, z);
-        }
-
-        glm::mat4 view = Matrix_Camera_View(camera_position_c,
-                                            camera_view_vector,
-                                            camera_up_vector);
-
-        glm::mat4 projection;
-
-        float nearplane = -0.1f;  // Posição do "near plane"
-        float farplane  = -400.0f; // Posição do "far plane"
-
-        // Projeção Perspectiva.
-        float field_of_view = 3.141592 / 3.0f;
-        projection = Matrix_Perspective(field_of_view, g_ScreenRatio, nearplane, farplane);
-
-        glUniformMatrix4fv(view_uniform       , 1 , GL_FALSE , glm::value_ptr(view));
-        glUniformMatrix4fv(projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
-
-        glm::mat4 model = Matrix_Identity(); // Transformação identidade de modelagem
-
-        // Desenha o plano do chão
-        model = Matrix_Translate(0.0f,0.0f,0.0f)
-              * Matrix_Scale(8.0f,1.0f,8.0f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, TERRAIN);
-        DrawVirtualObject("SimpleGround_Plane.024");
-
-        // Desenha as árvores de acordo com os vetores de posição e escala randomizados
-        int current_i = 0;
-        int i;
-        int amount = int(n_trees/tree_types);
-
-        for(int j=0; j<tree_types; j++){
-            for(i=current_i; i<(current_i)+amount; i++){
-                if(!broke_tree[i]){
-                    // Se a árvore não foi cortada ainda
-                    // Desenha a árvore
-                    model = Matrix_Translate(tree_position[i].x, -0.1f, tree_position[i].z)
-                          * Matrix_Rotate_X(sin(2*dt1)*0.005) // Simula vento batendo nas árvores
-                          * Matrix_Scale(tree_scale[i], tree_scale[i], tree_scale[i]);
-                    glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-                    glUniform1i(object_id_uniform, TREES);
-                    DrawVirtualObject(tree_names[j]);
-
-                    // Colisão ponto-cubo entre câmera (jogador) e árvores
-                    if(pointCubeCollision(camera_position_c,
-                                          g_VirtualScene[tree_names[j]],
-                                          tree_position[i],
-                                          tree_scale[i],
-                                          3.5f)){
-
-                        x1 = prev_x1;
-                        z1 = prev_z1;
-                    }
-
-                    if(pointCubeCollision(camera_position_c,
-                                          g_VirtualScene[tree_names[j]],
-                                          tree_position[i],
-                                          tree_scale[i],
-                                          3.2f)){
-
-                        can_chop = true;
-                        choppable = i;
-                    }
-                }
-                else{
-                    // Se a árvore já foi cortada
-                    // Desenha o tronco cortado
-                    model = Matrix_Translate(trunk_pos[i].x+(21.0f*tree_scale[i]), -0.1f, trunk_pos[i].y)
-                          * Matrix_Scale(tree_scale[i], tree_scale[i], tree_scale[i]);
-                    glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-                    glUniform1i(object_id_uniform, TREES);
-                    DrawVirtualObject("Stump_average_low_Cube.014");
-                }
-            }
-
-            current_i = i;
-        }
-
-        // Desenha as decorações de acordo com os vetores de posição e escala randomizados
-        current_i = 0;
-        amount = int(n_decoration/decoration_types);
-
-        for(int j=0; j<decoration_types; j++){
-            for(i=current_i; i<(current_i)+amount; i++){
-                model = Matrix_Translate(decoration_position[i].x, 0.0f, decoration_position[i].z);
-
-                glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-                glUniform1i(object_id_uniform, TREES);
-                DrawVirtualObject(decoration_names[j]);
-            }
-
-            current_i = i;
-        }
-
-        // Desenha as pedras de acordo com os vetores de posição e escala randomizados
-        current_i = 0;
-        amount = int(n_rocks/rock_types);
-
-        for(int j=0; j<sizeObjModels; j++){
-            for(i=current_i; i<(current_i)+amount; i++){
-                model = Matrix_Translate(rock_position[i].x, 0.0f, rock_position[i].z)
-                      * Matrix_Scale(rock_scale[i], rock_scale[i], rock_scale[i]);
-                glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-
-                glUniform1i(object_id_uniform, MOUNTAINS);
-                DrawVirtualObject(obj_names[j]);
-
-                // Colisão ponto-esfera entre câmera (jogador) e pedras da montanha
-                if(pointSphereCollision(camera_position_c,
-                                    glm::vec3(rock_position[i].x, 0.0f, rock_position[i].z),
-                                    rock_scale[i]+2.0f)){
-
-                    x1 = prev_x1;
-                    z1 = prev_z1;
-                }
-            }
-
-            current_i = i;
-        }
-
-        // Desenha os troncos de acordo com os vetores de posição e escala randomizados
-        for(i=0; i<10; i++){
-            model = Matrix_Translate(log_position[i].x, -0.1f, log_position[i].z)
-                  * Matrix_Scale(0.8f, 0.8f, 0.8f);
-
-            // Colisão cubo-cubo entre câmera (jogador) e tronco
-            // O cubo do jogador é definido a partir da soma/subtração de uma constante
-            // em relação ao ponto da câmera
-            if(cubeCubeCollision(camera_position_c,
-                                 g_VirtualScene["Log_big_regular_Cylinder.015"],
-                                 log_position[i],
-                                 0.8f)){
-
-                x1 = prev_x1;
-                z1 = prev_z1;
-            }
-
-            glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-            glUniform1i(object_id_uniform, TREES);
-            DrawVirtualObject("Log_big_regular_Cylinder.015");
-        }
-
-        // Desenha a árvore gigante do meio do mapa
-        model = Matrix_Translate(0.0f, 0.0f, 0.0f)
-              * Matrix_Scale(2.0f, 2.0f, 2.0f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, BIGTREE);
-        DrawVirtualObject("fattree_Mesh.003");
-
-        for(int i=0; i<n_spheres; i++){
-            if(pointSphereCollision(camera_position_c,
-                                    tree_spheres[i],
-                                    5.0f)){
-
-                x1 = prev_x1;
-                z1 = prev_z1;
-            }
-        }
-
-        // Desenha a galinha maior
-        model = Matrix_Translate(bezier_obj.x, 0.1f, bezier_obj.z)
-              * Matrix_Rotate_X(sin(8*dt1)*0.05)
-              * Matrix_Rotate_Y((dir*180+180)*M_PI/180.0)
-              * Matrix_Scale(0.03f, 0.03f, 0.03f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, CHICKEN_LEG);
-        DrawVirtualObject("laranja1");
-        glUniform1i(object_id_uniform, CHICKEN_BODY);
-        DrawVirtualObject("branco1");
-        glUniform1i(object_id_uniform, CHICKEN_EYE);
-        DrawVirtualObject("preto1");
-        DrawVirtualObject("preto1_1");
-        glUniform1i(object_id_uniform, CHICKEN_COMB);
-        DrawVirtualObject("vermelho1");
-
-        // Desenha uma galinha menor
-        model = Matrix_Translate(bezier_obj.x + 2.0f + sin(0.5*dt1)*3, 0.1f, bezier_obj.z + 2.0f + sin(0.5*dt1)*3)
-              * Matrix_Rotate_X(sin(8*dt1)*0.05)
-              * Matrix_Rotate_Y((dir*180+180)*M_PI/180.0)
-              * Matrix_Scale(0.03f, 0.03f, 0.03f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, CHICKEN_LEG);
-        DrawVirtualObject("laranja2");
-        glUniform1i(object_id_uniform, CHICKEN_BODY);
-        DrawVirtualObject("branco2");
-        glUniform1i(object_id_uniform, CHICKEN_EYE);
-        DrawVirtualObject("preto2");
-        DrawVirtualObject("preto2_1");
-        glUniform1i(object_id_uniform, CHICKEN_COMB);
-        DrawVirtualObject("vermelho2");
-
-        // Desenha a outra galinha menor
-        model = Matrix_Translate(bezier_obj.x + 0.5f + sin(0.5*dt1)*3, 0.1f, bezier_obj.z + 0.5f + sin(0.5*dt1)*3)
-              * Matrix_Rotate_X(sin(8*dt1)*0.05)
-              * Matrix_Rotate_Y((dir*180+180)*M_PI/180.0)
-              * Matrix_Scale(0.03f, 0.03f, 0.03f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, CHICKEN_LEG);
-        DrawVirtualObject("laranja3");
-        glUniform1i(object_id_uniform, CHICKEN_BODY);
-        DrawVirtualObject("branco3");
-        glUniform1i(object_id_uniform, CHICKEN_EYE);
-        DrawVirtualObject("preto3");
-        DrawVirtualObject("preto3_1");
-        glUniform1i(object_id_uniform, CHICKEN_COMB);
-        DrawVirtualObject("vermelho3");
-
-        // Desenha o machado apenas caso o jogo já tenha começado
-        // Ou seja, quando está na câmera livre
-        if(camera_type){
-            model = Matrix_Translate(x1+x*0.1f, y1-0.65f, z1+z*0.1f)
-                  * Matrix_Rotate_Y(g_CameraTheta + 90*M_PI/180.0)
-                  * Matrix_Rotate_X(-20*M_PI/180.0)
-                  * Matrix_Rotate_Z(axe_angle*M_PI/180.0)
-                  * Matrix_Scale(0.002f, 0.002f, 0.002f);
-            glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-            glUniform1i(object_id_uniform, AXE);
-            DrawVirtualObject("Cube");
-            DrawVirtualObject("Plane");
-            DrawVirtualObject("Cube.001");
-        }
-
-        // Desenha o NPC (cavaleiro)
-        model = Matrix_Translate(-4.0f, 0.0f, -10.0f)
-              * Matrix_Rotate_Y(180*M_PI/180.0)
-              * Matrix_Scale(6.8f, 6.8f, 6.8f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, CHARACTER);
-        DrawVirtualObject("knight");
-        model = Matrix_Translate(-4.0f, 0.0f, -10.02f)
-              * Matrix_Rotate_Y(180*M_PI/180.0)
-              * Matrix_Rotate_X(sin(2*dt1)*0.005)
-              * Matrix_Scale(6.8f, 6.8f, 6.8f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(object_id_uniform, CHARACTER_CAPA);
-        DrawVirtualObject("capa");
-
-        // Colisão ponto-esfera entre câmera (jogador) e NPC
-        if(pointSphereCollision(camera_position_c,
-                                glm::vec3(3.04f, 2.5f, -10.26f),
-                                2.0f)){
-
-            x1 = prev_x1;
-            z1 = prev_z1;
-        }
-
-        // Outra colisão para verificar se o jogador está próximo o suficiente
-        // para mostrar as mensagens relativas a Quest
-        if(pointSphereCollision(camera_position_c,
-                                glm::vec3(3.04f, 2.5f, -10.26f),
-                                7.7f)){
-
-            // Mensagem da Quest
-            TextRendering_PrintString(window, monolog_text[0+(level*3)], 0.0f-strlen(monolog_text[0+(level*3)])*charwidth*1.2f/2, -1.0f+0.05f+0.24f-lineheight*1.2f, 1.2f);
-            TextRendering_PrintString(window, monolog_text[1+(level*3)], 0.0f-strlen(monolog_text[1+(level*3)])*charwidth*1.2f/2, -1.0f+0.05f+0.16f-lineheight*1.2f, 1.2f);
-            TextRendering_PrintString(window, monolog_text[2+(level*3)], 0.0f-strlen(monolog_text[2+(level*3)])*charwidth*1.2f/2, -1.0f+0.05f+0.08f-lineheight*1.2f, 1.2f);
-
-            // Progressão de nível
-            if(level == 0 && accepted_quest){
-                level = 1;
-                broken_trees = 0;
-            }
-            else if(level == 1 && broken_trees >= 3){
-                level = 2;
-                broken_trees = 0;
-            }
-            else if(level == 2 && broken_trees >= 5){
-                level = 3;
-                broken_trees = 0;
-            }
-            else if(level == 3 && broken_trees >= 10){
-                level = 4;
-                broken_trees = 0;
-            }
-        }
-
-        // Quest
-        if(level == 1){
-            TextRendering_PrintString(window, "Quest: cortar 3 arvores", -0.99f, 1.0f-lineheight-0.06f, 1.0f);
-        }
-        else if(level == 2){
-            TextRendering_PrintString(window, "Quest: cortar 5 arvores", -0.99f, 1.0f-lineheight-0.06f, 1.0f);
-        }
-        else if(level == 3){
-            TextRendering_PrintString(window, "Quest: cortar 10 arvores", -0.99f, 1.0f-lineheight-0.06f, 1.0f);
-        }
-
-        // Número de árvores cortadas durante a Quest
-        sprintf(broken,"%d", broken_trees);
-        TextRendering_PrintString(window, "Arvores cortadas: ", -0.99f, 1.0f-lineheight, 1.0f);
-        TextRendering_PrintString(window, broken, -0.99f+strlen("Arvores cortadas: ")*charwidth*1.0f, 1.0f-lineheight-0.0025f, 1.0f);
-
-        // Delay de quebrar a árvore
-        TextRendering_PrintString(window, delay_left, strlen(delay_left)*charwidth*1.0f/2, 0.0f, 1.0f);
-
-        // Enquanto o jogo não começar, mostra uma tela inicial
-        if(!camera_type && !start_game){
-            TextRendering_PrintString(window, "Timberman", 0.0f-strlen("Timberman")*charwidth*1.5f*(abs(sin(dt1))+0.3f)/2, 0.0f+0.01f+lineheight, 1.5f*(abs(sin(dt1))+0.3f));
-            TextRendering_PrintString(window, "Pressione [ENTER] para jogar", 0.0f-strlen("Pressione [ENTER] para jogar")*charwidth*1.5f*(abs(sin(dt1))+0.3f)/2, 0.0f-0.01f-lineheight, 1.5f*(abs(sin(dt1))+0.3f));
-        }
-
-        // FPS
-        TextRendering_ShowFramesPerSecond(window);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-
-        // Atualiza o dt0 com o novo "passo" do glfwGetTime()
-        dt0 = dt1;
-    }
-
-    // Finalizamos o uso dos recursos do sistema operacional
-    glfwTerminate();
-
-    // Fim do programa
-    return 0;
-}
-
-// Cálculo da Curva de Bezier 2D
-glm::vec3 get2DBezierCurve(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float t){
-
-    float x = pow(1-t,3)*p0.x + 3*t*pow(1-t,2)*p1.x + 3*pow(t,2)*(1-t)*p2.x + pow(t,3)*p3.x;
-    float z = pow(1-t,3)*p0.y + 3*t*pow(1-t,2)*p1.y + 3*pow(t,2)*(1-t)*p2.y + pow(t,3)*p3.y;
-
-    return glm::vec3(x, 0.0f, z);
-}
-
-// Cálculo da Curva de Bezier 3D
-glm::vec3 get3DBezierCurve(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, float t){
-
-    float x = pow(1-t,3)*p0.x + 3*t*pow(1-t,2)*p1.x + 3*pow(t,2)*(1-t)*p2.x + pow(t,3)*p3.x;
-    float y = pow(1-t,3)*p0.y + 3*t*pow(1-t,2)*p1.y + 3*pow(t,2)*(1-t)*p2.y + pow(t,3)*p3.y;
-    float z = pow(1-t,3)*p0.z + 3*t*pow(1-t,2)*p1.z + 3*pow(t,2)*(1-t)*p2.z + pow(t,3)*p3.z;
-
-    return glm::vec3(x, y, z);
-}
-
-// Input do usuário e rotações da câmera e de alguns objetos
-glm::vec4 getUserInput(GLFWwindow* window, float x, float y, float z){
-
-    // "Velocidade" da função seno
-    // Usada para calcular o efeito de "Bobbing" da câmera
-    // Enquanto o jogador encontra-se parado, é zero
-    float mov = 0;
-
-    // Movimento para trás
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS){
-        x1 = x1 - (dt*player_speed) * x;
-        z1 = z1 - (dt*player_speed) * z;
-        mov = 6;
-    }
-
-    // Movimento para frente
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS){
-        x1 = x1 + (dt*player_speed) * x;
-        z1 = z1 + (dt*player_speed) * z;
-        mov = 6;
-    }
-
-    // Movimento para direita
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS){
-        x1 = x1 - (dt*player_speed) * z;
-        z1 = z1 + (dt*player_speed) * x;
-        mov = 6;
-    }
-
-    // Movimento para esquerda
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS){
-        x1 = x1 + (dt*player_speed) * z;
-        z1 = z1 - (dt*player_speed) * x;
-        mov = 6;
-    }
-
-    // Início do jogo
-    if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS){
-        start_game = true;
-    }
-
-    // Aceitar Quest
-    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS){
-        accepted_quest = true;
-    }
-
-    // Recarregar os shaders em tempo de execução
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS)
-    {
-        LoadShadersFromFiles();
-        fprintf(stdout,"Shaders recarregados!\n");
-        fflush(stdout);
-    }
-
-    // Animação de cortar a árvore se estiver com o botão esquerdo pressionado
-    // e se estiver colidindo com a árvore
-    sprintf(delay_left, " ");
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && can_chop){
-        axe_angle = sin(8*timer)*20;
-        timer += dt;
-
-        sprintf(delay_left, "%.1fs", (delay_cut_tree - timer));
-
-        if(timer >= delay_cut_tree){
-            broke_tree[choppable] = true;
-            trunk_pos[choppable] = glm::vec2(x1+x, z1+z);
-            broken_trees++;
-            can_chop = false;
-        }
-    }
-    else{
-        // Animação de volta do machado para a posição inicial
-        // Para o machado transicionar suavemente entre a posição "usando" e "parado"
-        if(int(axe_angle) != 0){
-            axe_angle = sin(8*timer)*20;
-            timer += dt;
-        }
-        else{
-            axe_angle = 0;
-            timer = 0;
-            can_chop = false;
-        }
-    }
-
-    // Movimentação de corrida (aumenta a velocidade)
-    if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS){
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS){
-            player_speed = 7.5f;
-            mov = 8;
-        }
-    }
-    else{
-        player_speed = default_speed;
-    }
-
-    // Fechar a tela
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS){
-        glfwSetWindowShouldClose(window, GL_TRUE);
-    }
-
-    // Bobbing da câmera (jogador)
-    y1 = abs(sin(mov*dt1)*0.2)+2.5;
-
-    return glm::vec4(x1, y1, z1, 1.0f);
-}
-
-// Função que carrega uma imagem para ser utilizada como textura
-void LoadTextureImage(const char* filename, int mode_id)
-{
-    printf("Carregando imagem \"%s\"... ", filename);
-
-    // Primeiro fazemos a leitura da imagem do disco
-    stbi_set_flip_vertically_on_load(true);
-    int width;
-    int height;
-    int channels;
-    unsigned char *data = stbi_load(filename, &width, &height, &channels, 3);
-
-    if ( data == NULL )
-    {
-        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename);
-        std::exit(EXIT_FAILURE);
-    }
-
-    printf("OK (%dx%d).\n", width, height);
-
-    // Agora criamos objetos na GPU com OpenGL para armazenar a textura
-    GLuint texture_id;
-    GLuint sampler_id;
-    glGenTextures(1, &texture_id);
-    glGenSamplers(1, &sampler_id);
-
-    // Veja slides 95-96 do documento Aula_20_Mapeamento_de_Texturas.pdf
-    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_S, mode_id);
-    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_T, mode_id);
-
-    // Parâmetros de amostragem da textura.
-    glSamplerParameteri(sampler_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glSamplerParameteri(sampler_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Agora enviamos a imagem lida do disco para a GPU
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
-    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
-
-    GLuint textureunit = g_NumLoadedTextures;
-    glActiveTexture(GL_TEXTURE0 + textureunit);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glBindSampler(textureunit, sampler_id);
-
-    stbi_image_free(data);
-
-    g_NumLoadedTextures += 1;
-}
-
-// Função que desenha um objeto armazenado em g_VirtualScene. Veja definição
-// dos objetos na função BuildTrianglesAndAddToVirtualScene().
-void DrawVirtualObject(const char* object_name, int ind_type)
-{
-    // "Ligamos" o VAO. Informamos que queremos utilizar os atributos de
-    // vértices apontados pelo VAO criado pela função BuildTrianglesAndAddToVirtualScene(). Veja
-    // comentários detalhados dentro da definição de BuildTrianglesAndAddToVirtualScene().
-    glBindVertexArray(g_VirtualScene[object_name].vertex_array_object_id);
-
-    // Setamos as variáveis "bbox_min" e "bbox_max" do fragment shader
-    // com os parâmetros da axis-aligned bounding box (AABB) do modelo.
-    glm::vec3 bbox_min = g_VirtualScene[object_name].bbox_min;
-    glm::vec3 bbox_max = g_VirtualScene[object_name].bbox_max;
-    glUniform4f(bbox_min_uniform, bbox_min.x, bbox_min.y, bbox_min.z, 1.0f);
-    glUniform4f(bbox_max_uniform, bbox_max.x, bbox_max.y, bbox_max.z, 1.0f);
-
-    // Pedimos para a GPU rasterizar os vértices dos eixos XYZ
-    // apontados pelo VAO como linhas. Veja a definição de
-    // g_VirtualScene[""] dentro da função BuildTrianglesAndAddToVirtualScene(), e veja
-    // a documentação da função glDrawElements() em
-    // http://docs.gl/gl3/glDrawElements.
-    glDrawElements(
-        g_VirtualScene[object_name].rendering_mode,
-        g_VirtualScene[object_name].num_indices,
-        GL_UNSIGNED_INT,
-        (void*)(g_VirtualScene[object_name].first_index * sizeof(GLuint))
-    );
-
-    // "Desligamos" o VAO, evitando assim que operações posteriores venham a
-    // alterar o mesmo. Isso evita bugs.
-    glBindVertexArray(ind_type);
-}
-
-void getAllObjectsInFile(const char* filename){
-
-    FILE *f = fopen(filename, "r");
-
-    char aux[30];
-
-    while(fscanf(f, "%s ", aux) != EOF){
-        if(strcmp(aux, "o") == 0){
-            fscanf(f, "%[^\n]", obj_names[sizeObjModels]);
-            //printf("%s\n", obj_names[sizeObjModels]);
-            sizeObjModels++;
-        }
-    }
-
-    fclose(f);
-
-    //printf("Carregou %d objetos.", sizeObjModels-1);
-}
-
-// Função que carrega os shaders de vértices e de fragmentos que serão
-// utilizados para renderização. Veja slides 180-200 do documento Aula_03_Rendering_Pipeline_Grafico.pdf.
-//
-void LoadShadersFromFiles()
-{
-    // Note que o caminho para os arquivos "shader_vertex.glsl" e
-    // "shader_fragment.glsl" estão fixados, sendo que assumimos a existência
-    // da seguinte estrutura no sistema de arquivos:
-    //
-    //    + FCG_Lab_01/
-    //    |
-    //    +--+ bin/
-    //    |  |
-    //    |  +--+ Release/  (ou Debug/ ou Linux/)
-    //    |     |
-    //    |     o-- main.exe
-    //    |
-    //    +--+ src/
-    //       |
-    //       o-- shader_vertex.glsl
-    //       |
-    //       o-- shader_fragment.glsl
-    //
-    vertex_shader_id = LoadShader_Vertex("../../src/shader_vertex.glsl");
-    fragment_shader_id = LoadShader_Fragment("../../src/shader_fragment.glsl");
-
-    // Deletamos o programa de GPU anterior, caso ele exista.
-    if ( program_id != 0 )
-        glDeleteProgram(program_id);
-
-    // Criamos um programa de GPU utilizando os shaders carregados acima.
-    program_id = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
-
-    // Buscamos o endereço das variáveis definidas dentro do Vertex Shader.
-    // Utilizaremos estas variáveis para enviar dados para a placa de vídeo
-    // (GPU)! Veja arquivo "shader_vertex.glsl" e "shader_fragment.glsl".
-    model_uniform           = glGetUniformLocation(program_id, "model"); // Variável da matriz "model"
-    view_uniform            = glGetUniformLocation(program_id, "view"); // Variável da matriz "view" em shader_vertex.glsl
-    projection_uniform      = glGetUniformLocation(program_id, "projection"); // Variável da matriz "projection" em shader_vertex.glsl
-    object_id_uniform       = glGetUniformLocation(program_id, "object_id"); // Variável "object_id" em shader_fragment.glsl
-    bbox_min_uniform        = glGetUniformLocation(program_id, "bbox_min");
-    bbox_max_uniform        = glGetUniformLocation(program_id, "bbox_max");
-
-
-    // Variáveis em "shader_fragment.glsl" para acesso das imagens de textura
-    glUseProgram(program_id);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage0"), 0);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage1"), 1);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage2"), 2);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage3"), 3);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage4"), 4);
-    glUniform1i(glGetUniformLocation(program_id, "TextureImage5"), 5);
-    glUseProgram(0);
-}
-
-// Função que computa as normais de um ObjModel, caso elas não tenham sido
-// especificadas dentro do arquivo ".obj"
-void ComputeNormals(ObjModel* model)
-{
-    if ( !model->attrib.normals.empty() )
-        return;
-
-    // Primeiro computamos as normais para todos os TRIÂNGULOS.
-    // Segundo, computamos as normais dos VÉRTICES através do método proposto
-    // por Gouraud, onde a normal de cada vértice vai ser a média das normais de
-    // todas as faces que compartilham este vértice.
-
-    size_t num_vertices = model->attrib.vertices.size() / 3;
-
-    std::vector<int> num_triangles_per_vertex(num_vertices, 0);
-    std::vector<glm::vec4> vertex_normals(num_vertices, glm::vec4(0.0f,0.0f,0.0f,0.0f));
-
-    for (size_t shape = 0; shape < model->shapes.size(); ++shape)
-    {
-        size_t num_triangles = model->shapes[shape].mesh.num_face_vertices.size();
-
-        for (size_t triangle = 0; triangle < num_triangles; ++triangle)
-        {
-            assert(model->shapes[shape].mesh.num_face_vertices[triangle] == 3);
-
-            glm::vec4  vertices[3];
-            for (size_t vertex = 0; vertex < 3; ++vertex)
-            {
-                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
-                const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
-                const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
-                const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
-                vertices[vertex] = glm::vec4(vx,vy,vz,1.0);
-            }
-
-            const glm::vec4  a = vertices[0];
-            const glm::vec4  b = vertices[1];
-            const glm::vec4  c = vertices[2];
-
-            const glm::vec4  n = crossproduct(b-a,c-a);
-
-            for (size_t vertex = 0; vertex < 3; ++vertex)
-            {
-                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
-                num_triangles_per_vertex[idx.vertex_index] += 1;
-                vertex_normals[idx.vertex_index] += n;
-                model->shapes[shape].mesh.indices[3*triangle + vertex].normal_index = idx.vertex_index;
-            }
-        }
-    }
-
-    model->attrib.normals.resize( 3*num_vertices );
-
-    for (size_t i = 0; i < vertex_normals.size(); ++i)
-    {
-        glm::vec4 n = vertex_normals[i] / (float)num_triangles_per_vertex[i];
-        n /= norm(n);
-        model->attrib.normals[3*i + 0] = n.x;
-        model->attrib.normals[3*i + 1] = n.y;
-        model->attrib.normals[3*i + 2] = n.z;
-    }
-}
-
-// Constrói triângulos para futura renderização a partir de um ObjModel.
-void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
-{
-    GLuint vertex_array_object_id;
-    glGenVertexArrays(1, &vertex_array_object_id);
-    glBindVertexArray(vertex_array_object_id);
-
-    std::vector<GLuint> indices;
-    std::vector<float>  model_coefficients;
-    std::vector<float>  normal_coefficients;
-    std::vector<float>  texture_coefficients;
-
-    for (size_t shape = 0; shape < model->shapes.size(); ++shape)
-    {
-        size_t first_index = indices.size();
-        size_t num_triangles = model->shapes[shape].mesh.num_face_vertices.size();
-
-        const float minval = std::numeric_limits<float>::min();
-        const float maxval = std::numeric_limits<float>::max();
-
-        glm::vec3 bbox_min = glm::vec3(maxval,maxval,maxval);
-        glm::vec3 bbox_max = glm::vec3(minval,minval,minval);
-
-        for (size_t triangle = 0; triangle < num_triangles; ++triangle)
-        {
-            assert(model->shapes[shape].mesh.num_face_vertices[triangle] == 3);
-
-            for (size_t vertex = 0; vertex < 3; ++vertex)
-            {
-                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
-
-                indices.push_back(first_index + 3*triangle + vertex);
-
-                const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
-                const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
-                const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
-                //printf("tri %d vert %d = (%.2f, %.2f, %.2f)\n", (int)triangle, (int)vertex, vx, vy, vz);
-                model_coefficients.push_back( vx ); // X
-                model_coefficients.push_back( vy ); // Y
-                model_coefficients.push_back( vz ); // Z
-                model_coefficients.push_back( 1.0f ); // W
-
-                bbox_min.x = std::min(bbox_min.x, vx);
-                bbox_min.y = std::min(bbox_min.y, vy);
-                bbox_min.z = std::min(bbox_min.z, vz);
-                bbox_max.x = std::max(bbox_max.x, vx);
-                bbox_max.y = std::max(bbox_max.y, vy);
-                bbox_max.z = std::max(bbox_max.z, vz);
-
-                // Inspecionando o código da tinyobjloader, o aluno Bernardo
-                // Sulzbach (2017/1) apontou que a maneira correta de testar se
-                // existem normais e coordenadas de textura no ObjModel é
-                // comparando se o índice retornado é -1. Fazemos isso abaixo.
-
-                if ( idx.normal_index != -1 )
-                {
-                    const float nx = model->attrib.normals[3*idx.normal_index + 0];
-                    const float ny = model->attrib.normals[3*idx.normal_index + 1];
-                    const float nz = model->attrib.normals[3*idx.normal_index + 2];
-                    normal_coefficients.push_back( nx ); // X
-                    normal_coefficients.push_back( ny ); // Y
-                    normal_coefficients.push_back( nz ); // Z
-                    normal_coefficients.push_back( 0.0f ); // W
-                }
-
-                if ( idx.texcoord_index != -1 )
-                {
-                    const float u = model->attrib.texcoords[2*idx.texcoord_index + 0];
-                    const float v = model->attrib.texcoords[2*idx.texcoord_index + 1];
-                    texture_coefficients.push_back( u );
-                    texture_coefficients.push_back( v );
-                }
-            }
-        }
-
-        size_t last_index = indices.size() - 1;
-
-        SceneObject theobject;
-        theobject.name           = model->shapes[shape].name;
-        theobject.first_index    = first_index; // Primeiro índice
-        theobject.num_indices    = last_index - first_index + 1; // Número de indices
-        theobject.rendering_mode = GL_TRIANGLES;       // Índices correspondem ao tipo de rasterização GL_TRIANGLES.
-        theobject.vertex_array_object_id = vertex_array_object_id;
-
-        theobject.bbox_min = bbox_min;
-        theobject.bbox_max = bbox_max;
-
-        g_VirtualScene[model->shapes[shape].name] = theobject;
-    }
-
-    GLuint VBO_model_coefficients_id;
-    glGenBuffers(1, &VBO_model_coefficients_id);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
-    glBufferData(GL_ARRAY_BUFFER, model_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, model_coefficients.size() * sizeof(float), model_coefficients.data());
-    GLuint location = 0; // "(location = 0)" em "shader_vertex.glsl"
-    GLint  number_of_dimensions = 4; // vec4 em "shader_vertex.glsl"
-    glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(location);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    if ( !normal_coefficients.empty() )
-    {
-        GLuint VBO_normal_coefficients_id;
-        glGenBuffers(1, &VBO_normal_coefficients_id);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_normal_coefficients_id);
-        glBufferData(GL_ARRAY_BUFFER, normal_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, normal_coefficients.size() * sizeof(float), normal_coefficients.data());
-        location = 1; // "(location = 1)" em "shader_vertex.glsl"
-        number_of_dimensions = 4; // vec4 em "shader_vertex.glsl"
-        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(location);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
-
-    if ( !texture_coefficients.empty() )
-    {
-        GLuint VBO_texture_coefficients_id;
-        glGenBuffers(1, &VBO_texture_coefficients_id);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_texture_coefficients_id);
-        glBufferData(GL_ARRAY_BUFFER, texture_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, texture_coefficients.size() * sizeof(float), texture_coefficients.data());
-        location = 2; // "(location = 1)" em "shader_vertex.glsl"
-        number_of_dimensions = 2; // vec2 em "shader_vertex.glsl"
-        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(location);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
-
-    GLuint indices_id;
-    glGenBuffers(1, &indices_id);
-
-    // "Ligamos" o buffer. Note que o tipo agora é GL_ELEMENT_ARRAY_BUFFER.
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
-    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // XXX Errado!
-    //
-
-    // "Desligamos" o VAO, evitando assim que operações posteriores venham a
-    // alterar o mesmo. Isso evita bugs.
-    glBindVertexArray(0);
-}
-
-// Carrega um Vertex Shader de um arquivo GLSL. Veja definição de LoadShader() abaixo.
-GLuint LoadShader_Vertex(const char* filename)
-{
-    // Criamos um identificador (ID) para este shader, informando que o mesmo
-    // será aplicado nos vértices.
-    GLuint vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
-
-    // Carregamos e compilamos o shader
-    LoadShader(filename, vertex_shader_id);
-
-    // Retorna o ID gerado acima
-    return vertex_shader_id;
-}
-
-// Carrega um Fragment Shader de um arquivo GLSL . Veja definição de LoadShader() abaixo.
-GLuint LoadShader_Fragment(const char* filename)
-{
-    // Criamos um identificador (ID) para este shader, informando que o mesmo
-    // será aplicado nos fragmentos.
-    GLuint fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
-
-    // Carregamos e compilamos o shader
-    LoadShader(filename, fragment_shader_id);
-
-    // Retorna o ID gerado acima
-    return fragment_shader_id;
-}
-
-// Função auxilar, utilizada pelas duas funções acima. Carrega código de GPU de
-// um arquivo GLSL e faz sua compilação.
-void LoadShader(const char* filename, GLuint shader_id)
-{
-    // Lemos o arquivo de texto indicado pela variável "filename"
-    // e colocamos seu conteúdo em memória, apontado pela variável
-    // "shader_string".
-    std::ifstream file;
-    try {
-        file.exceptions(std::ifstream::failbit);
-        file.open(filename);
-    } catch ( std::exception& e ) {
-        fprintf(stderr, "ERROR: Cannot open file \"%s\".\n", filename);
-        std::exit(EXIT_FAILURE);
-    }
-    std::stringstream shader;
-    shader << file.rdbuf();
-    std::string str = shader.str();
-    const GLchar* shader_string = str.c_str();
-    const GLint   shader_string_length = static_cast<GLint>( str.length() );
-
-    // Define o código do shader GLSL, contido na string "shader_string"
-    glShaderSource(shader_id, 1, &shader_string, &shader_string_length);
-
-    // Compila o código do shader GLSL (em tempo de execução)
-    glCompileShader(shader_id);
-
-    // Verificamos se ocorreu algum erro ou "warning" durante a compilação
-    GLint compiled_ok;
-    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &compiled_ok);
-
-    GLint log_length = 0;
-    glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &log_length);
-
-    // Alocamos memória para guardar o log de compilação.
-    // A chamada "new" em C++ é equivalente ao "malloc()" do C.
-    GLchar* log = new GLchar[log_length];
-    glGetShaderInfoLog(shader_id, log_length, &log_length, log);
-
-    // Imprime no terminal qualquer erro ou "warning" de compilação
-    if ( log_length != 0 )
-    {
-        std::string  output;
-
-        if ( !compiled_ok )
-        {
-            output += "ERROR: OpenGL compilation of \"";
-            output += filename;
-            output += "\" failed.\n";
-            output += "== Start of compilation log\n";
-            output += log;
-            output += "== End of compilation log\n";
-        }
-        else
-        {
-            output += "WARNING: OpenGL compilation of \"";
-            output += filename;
-            output += "\".\n";
-            output += "== Start of compilation log\n";
-            output += log;
-            output += "== End of compilation log\n";
-        }
-
-        fprintf(stderr, "%s", output.c_str());
-    }
-
-    // A chamada "delete" em C++ é equivalente ao "free()" do C
-    delete [] log;
-}
-
-// Esta função cria um programa de GPU, o qual contém obrigatoriamente um
-// Vertex Shader e um Fragment Shader.
-GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id)
-{
-    // Criamos um identificador (ID) para este programa de GPU
-    GLuint program_id = glCreateProgram();
-
-    // Definição dos dois shaders GLSL que devem ser executados pelo programa
-    glAttachShader(program_id, vertex_shader_id);
-    glAttachShader(program_id, fragment_shader_id);
-
-    // Linkagem dos shaders acima ao programa
-    glLinkProgram(program_id);
-
-    // Verificamos se ocorreu algum erro durante a linkagem
-    GLint linked_ok = GL_FALSE;
-    glGetProgramiv(program_id, GL_LINK_STATUS, &linked_ok);
-
-    // Imprime no terminal qualquer erro de linkagem
-    if ( linked_ok == GL_FALSE )
-    {
-        GLint log_length = 0;
-        glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &log_length);
-
-        // Alocamos memória para guardar o log de compilação.
-        // A chamada "new" em C++ é equivalente ao "malloc()" do C.
-        GLchar* log = new GLchar[log_length];
-
-        glGetProgramInfoLog(program_id, log_length, &log_length, log);
-
-        std::string output;
-
-        output += "ERROR: OpenGL linking of program failed.\n";
-        output += "== Start of link log\n";
-        output += log;
-        output += "\n== End of link log\n";
-
-        // A chamada "delete" em C++ é equivalente ao "free()" do C
-        delete [] log;
-
-        fprintf(stderr, "%s", output.c_str());
-    }
-
-    // Os "Shader Objects" podem ser marcados para deleção após serem linkados
-    glDeleteShader(vertex_shader_id);
-    glDeleteShader(fragment_shader_id);
-
-    // Retornamos o ID gerado acima
-    return program_id;
-}
-
-// Definição da função que será chamada sempre que a janela do sistema
-// operacional for redimensionada, por consequência alterando o tamanho do
-// "framebuffer" (região de memória onde são armazenados os pixels da imagem).
-void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
-{
-    // Indicamos que queremos renderizar em toda região do framebuffer. A
-    // função "glViewport" define o mapeamento das "normalized device
-    // coordinates" (NDC) para "pixel coordinates".  Essa é a operação de
-    // "Screen Mapping" ou "Viewport Mapping" vista em aula ({+ViewportMapping2+}).
-    glViewport(0, 0, width, height);
-
-    // Atualizamos também a razão que define a proporção da janela (largura /
-    // altura), a qual será utilizada na definição das matrizes de projeção,
-    // tal que não ocorra distorções durante o processo de "Screen Mapping"
-    // acima, quando NDC é mapeado para coordenadas de pixels. Veja slides 205-215 do documento Aula_09_Projecoes.pdf.
-    //
-    // O cast para float é necessário pois números inteiros são arredondados ao
-    // serem divididos!
-    g_ScreenRatio = (float)width / height;
-}
-
-// Variáveis globais que armazenam a última posição do cursor do mouse, para
-// que possamos calcular quanto que o mouse se movimentou entre dois instantes
-// de tempo. Utilizadas no callback CursorPosCallback() abaixo.
-double g_LastCursorPosX, g_LastCursorPosY;
-
-// Função callback chamada sempre que o usuário movimentar o cursor do mouse em
-// cima da janela OpenGL.
-void CursorPosCallback(GLFWwindow* window, double xpos, double ypos)
-{
-    // Abaixo executamos o seguinte: caso o botão esquerdo do mouse esteja
-    // pressionado, computamos quanto que o mouse se movimento desde o último
-    // instante de tempo, e usamos esta movimentação para atualizar os
-    // parâmetros que definem a posição da câmera dentro da cena virtual.
-    // Assim, temos que o usuário consegue controlar a câmera.
-
-    if (g_LeftMouseButtonPressed)
-    {
-        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
-        float dx = xpos - g_LastCursorPosX;
-        float dy = ypos - g_LastCursorPosY;
-
-        // Atualizamos parâmetros da câmera com os deslocamentos
-        g_CameraTheta -= 0.01f*dx;
-        g_CameraPhi   += 0.01f*dy;
-
-        // Em coordenadas esféricas, o ângulo phi deve ficar entre -pi/2 e +pi/2.
-        float phimax = 3.141592f/2;
-        float phimin = -phimax;
-
-        if (g_CameraPhi > phimax)
-            g_CameraPhi = phimax;
-
-        if (g_CameraPhi < phimin)
-            g_CameraPhi = phimin;
-
-        // Atualizamos as variáveis globais para armazenar a posição atual do
-        // cursor como sendo a última posição conhecida do cursor.
-        g_LastCursorPosX = xpos;
-        g_LastCursorPosY = ypos;
-    }
-
-    if (g_RightMouseButtonPressed)
-    {
-        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
-        //float dx = xpos - g_LastCursorPosX;
-        //float dy = ypos - g_LastCursorPosY;
-
-        // Atualizamos as variáveis globais para armazenar a posição atual do
-        // cursor como sendo a última posição conhecida do cursor.
-        g_LastCursorPosX = xpos;
-        g_LastCursorPosY = ypos;
-    }
-
-    if (g_MiddleMouseButtonPressed)
-    {
-        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
-        //float dx = xpos - g_LastCursorPosX;
-        //float dy = ypos - g_LastCursorPosY;
-
-        // Atualizamos as variáveis globais para armazenar a posição atual do
-        // cursor como sendo a última posição conhecida do cursor.
-        g_LastCursorPosX = xpos;
-        g_LastCursorPosY = ypos;
-    }
-}
-
-// Definimos o callback para impressão de erros da GLFW no terminal
-void ErrorCallback(int error, const char* description)
-{
-    fprintf(stderr, "ERROR: GLFW: %s\n", description);
-}
-
-// Escrevemos na tela o número de quadros renderizados por segundo (frames per
-// second).
-void TextRendering_ShowFramesPerSecond(GLFWwindow* window)
-{
-
-    // Variáveis estáticas (static) mantém seus valores entre chamadas
-    // subsequentes da função!
-    static float old_seconds = (float)glfwGetTime();
-    static int   ellapsed_frames = 0;
-    static char  buffer[20] = "?? fps";
-    static int   numchars = 7;
-
-    ellapsed_frames += 1;
-
-    // Recuperamos o número de segundos que passou desde a execução do programa
-    float seconds = (float)glfwGetTime();
-
-    // Número de segundos desde o último cálculo do fps
-    float ellapsed_seconds = seconds - old_seconds;
-
-    if ( ellapsed_seconds > 1.0f )
-    {
-        numchars = snprintf(buffer, 20, "%.2f fps", ellapsed_frames / ellapsed_seconds);
-
-        old_seconds = seconds;
-        ellapsed_frames = 0;
-    }
-
-    float lineheight = TextRendering_LineHeight(window);
-    float charwidth = TextRendering_CharWidth(window);
-
-    TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-lineheight, 1.0f);
-}
-
-// set makeprg=cd\ ..\ &&\ make\ run\ >/dev/null
-// vim: set spell spelllang=pt_br :
+//      Universidade Federal do Rio Grande do Sul
+//              Instituto de Informática
+//        Departamento de Informática Aplicada
+//
+//     INF01047 Fundamentos de Computação Gráfica
+//                Prof. Eduardo Gastal
+//
+// TRABALHO FINAL - FUNDAMENTOS DE COMPUTAÇÃO GRÁFICA
+
+// Bibliotecas e Headers
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <map>
+#include <stack>
+#include <string>
+#include <vector>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <math.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <tiny_obj_loader.h>
+#include <stb_image.h>
+
+#include "utils.h"
+#include "matrices.h"
+#include "collisions.h"
+#include "sdffont.h"
+#include "drawlist.h"
+#include "lights.h"
+#include "shadows.h"
+#include "profiler.h"
+#include "spatialgrid.h"
+#include "benchmarks.h"
+#include "simulation.h"
+#include "bvh.h"
+#include "meshcollision.h"
+#include "transforms.h"
+#include "splines.h"
+#include "placement.h"
+#include "sceneconfig.h"
+#include "entities.h"
+#include "worldstream.h"
+#include "terrain.h"
+#include "ecs.h"
+#include "components.h"
+#include "savegame.h"
+#include "jobs.h"
+#include "framepacket.h"
+#include "framepacing.h"
+#include "headless.h"
+
+// Definições
+#define default_speed      5.50f // Velocidade padrão do jogador
+#define player_start_x     3.77f  // Posição inicial do jogador
+#define player_start_z     -26.03f
+#define player_eye_height  2.50f  // Altura dos olhos acima do terreno, com o jogador parado
+#define sensitivity        0.50f // Sensibilidade do mouse
+#define delay_cut_tree     3.0f  // Delay para cortar a árvore
+#define chop_reach         2.0f  // Distância máxima até a árvore mirada para cortá-la
+#define player_radius      0.4f  // Raio da cápsula de colisão do jogador
+#define player_step_height 0.3f  // Altura dos obstáculos que o jogador passa por cima
+#define collision_passes   4     // Iterações no máximo para resolver as colisões de um passo
+#define collision_grain    8     // Colisores testados por tarefa
+#define tree_types         1     // Tipos de árvore (objetos lidos)
+#define decoration_types   4     // Tipos de decorações (objetos lidos)
+#define rock_types         7     // Tipos de pedras (objetos lidos)
+#define n_torches          8     // Número de tochas ao redor da árvore gigante
+#define tree_wind          0.005f // Amplitude do balanço das árvores e da capa com o vento
+#define plant_wind         0.06f  // Amplitude do balanço das plantas com o vento
+#define wind_wavelength    0.1f   // Fase do vento por metro: as rajadas atravessam a floresta
+#define world_chunk_size   64.0f  // Lado dos pedaços do mundo gerados sob demanda (veja worldstream.h)
+#define terrain_height     12.0f  // Altura máxima dos morros do terreno
+#define terrain_lod_distance 64.0f // Distância até a qual o terreno é desenhado no nível mais detalhado
+
+// IDs das Texturas
+#define TERRAIN 0
+#define TREES 1
+#define MOUNTAINS 2
+#define CHARACTER 3
+#define CHARACTER_CAPA 4
+#define AXE 5
+#define BIGTREE 6
+#define CHICKEN_LEG 7
+#define CHICKEN_BODY 8
+#define CHICKEN_EYE 9
+#define CHICKEN_COMB 10
+
+// Tipos de colisores na grade espacial
+#define COLLIDER_TREE       0
+#define COLLIDER_ROCK       1
+#define COLLIDER_LOG        2
+#define COLLIDER_BIGTREE    3
+#define COLLIDER_NPC        4
+#define COLLIDER_CHUNK_TREE 5 // Árvore de um pedaço do mundo gerado sob demanda (não pode ser cortada)
+
+// Outras definições
+#define M_PI 3.14159265358979323846
+
+// Estrutura que representa um modelo geométrico carregado a partir de um arquivo .obj
+struct ObjModel
+{
+    tinyobj::attrib_t                 attrib;
+    std::vector<tinyobj::shape_t>     shapes;
+    std::vector<tinyobj::material_t>  materials;
+
+    // Este construtor lê o modelo de um arquivo utilizando a biblioteca tinyobjloader.
+    // Veja: https://github.com/syoyo/tinyobjloader
+    ObjModel(const char* filename, const char* basepath = NULL, bool triangulate = true)
+    {
+        printf("Carregando modelo \"%s\"... ", filename);
+
+        std::string err;
+        bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &err, filename, basepath, triangulate);
+
+        if (!err.empty())
+            fprintf(stderr, "\n%s\n", err.c_str());
+
+        if (!ret)
+            throw std::runtime_error("Erro ao carregar modelo.");
+
+        printf("OK.\n");
+    }
+};
+
+// Definição das funções
+void BuildTrianglesAndAddToVirtualScene(ObjModel*); // Constrói representação de um ObjModel como malha de triângulos para renderização
+void ComputeNormals(ObjModel* model); // Computa normais de um ObjModel, caso não existam.
+void LoadShadersFromFiles(); // Carrega os shaders de vértice e fragmento, criando um programa de GPU
+void LoadTextureImage(const char* filename, int mode_id=GL_CLAMP_TO_EDGE); // Função que carrega imagens de textura
+void DrawVirtualObject(const char* object_name, int ind_type=0); // Desenha um objeto armazenado em g_VirtualScene
+void DrawOpaqueItems(const DrawList &list, bool depth_only); // Desenha os itens de uma lista de desenho já ordenada
+GLuint LoadShader_Vertex(const char* filename);   // Carrega um vertex shader
+GLuint LoadShader_Fragment(const char* filename); // Carrega um fragment shader
+void LoadShader(const char* filename, GLuint shader_id); // Função utilizada pelas duas acima
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id); // Cria um programa de GPU
+
+void getUserInput(GLFWwindow* window, float x, float y, float z);
+EcsEntity SpawnMapObject(EcsWorld* world, EcsMask mask, int node, const glm::vec3 &position, float scale,
+                         const SceneObject* object, int object_id, const glm::vec2 &wind = glm::vec2(0.0f));
+
+// Sistemas: cada um percorre os arquétipos com os componentes de que precisa
+// (veja components.h). Os cinco primeiros formam um passo da simulação.
+struct PlayerInput;
+void MovementSystem(EcsWorld* world, const PlayerInput &input, float step);
+void CollisionSystem(EcsWorld* world, const Terrain* terrain, const SpatialGrid* grid, const std::vector<CollisionInstance> &colliders,
+                     const WorldStream* stream, JobSystem* jobs);
+void ChoppingSystem(EcsWorld* world, const PlayerInput &input, float step, const Terrain* terrain, Bvh* bvh,
+                    const std::vector<CollisionInstance> &colliders, TransformTree* transforms, const SceneObject* stump_object);
+void AnimationSystem(EcsWorld* world, const PlayerInput &input, float step, JobSystem* jobs);
+void QuestSystem(EcsWorld* world, const Terrain* terrain);
+void RenderExtractionSystem(EcsWorld* world, DrawList* list, const std::vector<glm::mat4> &world_matrices, JobSystem* jobs);
+void FellTree(EcsWorld* world, EcsEntity tree, const glm::vec2 &trunk, Bvh* bvh, TransformTree* transforms, const SceneObject* stump_object);
+void SnapshotGame(EcsWorld* world, unsigned int first_tree, SaveGame* save); // Copia o estado do jogo para ser salvo
+void GetPickingRay(GLFWwindow* window, const glm::mat4 &view, const glm::mat4 &projection, glm::vec3* origin, glm::vec3* direction); // Sem janela, pelo centro da tela
+void getFootprint(const char* object_name, glm::vec2* center, float* radius); // Círculo da base do objeto no plano XZ
+void getAllObjectsInFile(const char* filename);
+
+void TextRendering_Init();
+float TextRendering_LineHeight(GLFWwindow* window);
+float TextRendering_LineHeight(int window_width, int window_height);
+float TextRendering_CharWidth(GLFWwindow* window);
+float TextRendering_CharWidth(int window_width, int window_height);
+void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f);
+void TextRendering_ShowFramesPerSecond(FramePacket* packet);
+int  TextRendering_CreateText(); // Cria um texto "retido", cujo layout é mantido entre quadros
+bool TextRendering_UpdateText(GLFWwindow* window, int text_id, const std::string &str, float x, float y, float scale = 1.0f);
+bool TextRendering_UpdateText(int window_width, int window_height, int text_id, const std::string &str, float x, float y, float scale = 1.0f);
+void TextRendering_DrawText(int text_id);
+
+void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
+void ErrorCallback(int error, const char* description);
+void CursorPosCallback(GLFWwindow* window, double xpos, double ypos);
+
+// Variáveis globais
+std::map<std::string, SceneObject> g_VirtualScene; // Cena virtual (dicionário).
+std::map<std::string, CollisionMesh> g_CollisionMeshes; // Malhas de colisão de cada objeto de g_VirtualScene
+std::stack<glm::mat4>  g_MatrixStack; // Pilha que guardará as matrizes de modelagem.
+
+float g_ScreenRatio = 1.0f; // Razão de proporção da janela (largura/altura). Veja função FramebufferSizeCallback().
+
+bool g_LeftMouseButtonPressed = true;
+bool g_RightMouseButtonPressed = false; // Análogo para botão direito do mouse
+bool g_MiddleMouseButtonPressed = false; // Análogo para botão do meio do mouse
+
+// Variáveis que definem a câmera em coordenadas esféricas
+float g_CameraTheta = -12.63;  // Ângulo no plano ZX em relação ao eixo Z
+float g_CameraPhi =  0.06;     // Ângulo em relação ao eixo Y
+float g_CameraDistance = 2.0f; // Distância da câmera para a origem
+float r, x, y, z;
+
+// Variáveis que definem um programa de GPU (shaders). Veja função LoadShadersFromFiles().
+GLuint vertex_shader_id;
+GLuint fragment_shader_id;
+GLuint program_id = 0;
+GLint model_uniform;
+GLint view_uniform;
+GLint projection_uniform;
+GLint object_id_uniform;
+GLint bbox_min_uniform;
+GLint bbox_max_uniform;
+GLint time_uniform;
+GLint wind_uniform;
+GLint cluster_tile_size_uniform;
+GLint cluster_slice_params_uniform;
+GLint light_direction_uniform;
+GLint shadow_matrices_uniform;
+GLint cascade_splits_uniform;
+GLint cascade_texel_size_uniform;
+
+// Programa de GPU do pré-passo de profundidade (apenas posição dos vértices)
+GLuint depth_program_id = 0;
+GLint depth_model_uniform;
+GLint depth_view_uniform;
+GLint depth_projection_uniform;
+GLint depth_time_uniform;
+GLint depth_wind_uniform;
+
+// Pré-passo de profundidade: quando ligado, os objetos opacos são desenhados
+// primeiro apenas no Z-buffer e depois sombreados com glDepthFunc(GL_EQUAL),
+// de forma que cada pixel executa o fragment shader completo uma única vez.
+bool depth_prepass = true;
+bool depth_prepass_key_pressed = false;
+
+// Profiler exibido no HUD ([F3] alterna)
+bool show_profiler = false;
+bool show_profiler_key_pressed = false;
+
+// Salvar o jogo ([F5]), feito no próximo quadro
+bool save_requested = false;
+bool reload_shaders_requested = false; // Tecla R: os shaders são recarregados pela renderização
+bool save_key_pressed = false;
+
+// Incrementado sempre que o conjunto de objetos estáticos muda (ex.: uma
+// árvore é cortada), invalidando o cache das cascatas de sombra distantes
+int static_scene_version = 0;
+
+GLuint g_NumLoadedTextures = 0; // Número de texturas carregadas pela função LoadTextureImage()
+
+// Animação baseada no tempo. Os instantes são double: em float, depois de
+// algumas horas de jogo a precisão do glfwGetTime() ficaria pior que 1 ms.
+float dt = 0;
+double dt1 = 0;
+double dt0 = 0;
+
+// Estado do jogo: o jogador e os objetos do mapa são entidades, com os
+// componentes de components.h. O jogador tem o movimento, o machado e a
+// Quest; as árvores, pedras e troncos têm colisor e o que é desenhado.
+EcsWorld g_World;
+EcsEntity g_Player;
+
+char delay_left[30] = ""; // Tempo que falta para cortar a árvore mirada
+
+// Entrada do jogador, amostrada a cada quadro por getUserInput() e
+// consumida pelos passos da simulação
+struct PlayerInput
+{
+    bool  forward, backward, left, right;
+    bool  run;
+    bool  chop;                   // Botão esquerdo do mouse
+    float view_x, view_y, view_z; // Direção da câmera
+};
+PlayerInput g_PlayerInput = {};
+
+// Início do jogo
+bool start_game = false;
+
+// Leitura dos objetos de um .obj
+char obj_names[100][50]={};
+int sizeObjModels = 0;
+
+int main(int argc, char* argv[])
+{
+    // Executa um benchmark (ex.: "./main --bench colisoes") em vez do jogo
+    if (argc >= 3 && strcmp(argv[1], "--bench") == 0)
+        return Benchmarks_Run(argv[2]);
+
+    // Com "--sim-thread" a simulação roda em uma thread própria, com
+    // "--no-render-thread" o quadro é desenhado na thread principal, com
+    // "--save arquivo" o jogo é salvo em outro arquivo e com "--jobs N" o
+    // sistema de tarefas usa N threads (o padrão é uma por núcleo). Com
+    // "--fps N" os quadros são limitados a N por segundo e "--vsync" escolhe
+    // a sincronização vertical: "off", "on" ou "adaptive" (o padrão; veja
+    // framepacing.h). Com "--headless N" o jogo roda sem janela por N quadros
+    // e termina mostrando os tempos (veja headless.h).
+    bool simulation_thread = false;
+    bool render_thread = true;
+    const char* save_filename = "timberman.sav";
+    int job_threads = 0;
+    double frame_rate = 0.0;
+    int vsync = VSYNC_ADAPTIVE;
+    bool headless = false;
+    long long headless_frames = 0;
+    int headless_width = 1280, headless_height = 720;
+    const char* headless_image = NULL;
+    for (int arg = 1; arg < argc; ++arg){
+        if (strcmp(argv[arg], "--sim-thread") == 0)
+            simulation_thread = true;
+        if (strcmp(argv[arg], "--no-render-thread") == 0)
+            render_thread = false;
+        if (strcmp(argv[arg], "--save") == 0 && arg + 1 < argc)
+            save_filename = argv[++arg];
+        if (strcmp(argv[arg], "--jobs") == 0 && arg + 1 < argc)
+            job_threads = atoi(argv[++arg]);
+        if (strcmp(argv[arg], "--fps") == 0 && arg + 1 < argc)
+            frame_rate = atof(argv[++arg]);
+        if (strcmp(argv[arg], "--vsync") == 0 && arg + 1 < argc){
+            vsync = FramePacing_ParseVsync(argv[++arg]);
+            if (vsync < 0){
+                fprintf(stderr, "Valor inválido para --vsync: \"%s\"\n", argv[arg]);
+                vsync = VSYNC_ADAPTIVE;
+            }
+        }
+        if (strcmp(argv[arg], "--headless") == 0 && arg + 1 < argc){
+            headless = true;
+            headless_frames = atoll(argv[++arg]);
+        }
+        if (strcmp(argv[arg], "--headless-size") == 0 && arg + 1 < argc){
+            if (sscanf(argv[++arg], "%dx%d", &headless_width, &headless_height) != 2 || headless_width <= 0 || headless_height <= 0){
+                fprintf(stderr, "Valor inválido para --headless-size: \"%s\"\n", argv[arg]);
+                headless_width = 1280;
+                headless_height = 720;
+            }
+        }
+        if (strcmp(argv[arg], "--headless-image") == 0 && arg + 1 < argc)
+            headless_image = argv[++arg];
+    }
+
+    // Tamanho do mapa: valores padrão, depois data/scene.cfg (se existir) e
+    // por fim as opções da linha de comando (veja sceneconfig.h)
+    SceneConfig config;
+    SceneConfig_Defaults(&config);
+    SceneConfig_Load(&config, "../../data/scene.cfg");
+    SceneConfig_ParseArguments(&config, argc, argv);
+
+    // Sem janela, o contexto OpenGL é criado pela EGL e os quadros são
+    // desenhados em um framebuffer do tamanho pedido (veja headless.h)
+    GLFWwindow* window = NULL;
+    HeadlessContext offscreen;
+    if (headless)
+    {
+        if (!Headless_Init(&offscreen, headless_width, headless_height))
+            std::exit(EXIT_FAILURE);
+    }
+    else
+    {
+        // Inicializamos a biblioteca GLFW
+        int success = glfwInit();
+        if (!success)
+        {
+            fprintf(stderr, "ERROR: glfwInit() failed.\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        // Definimos o callback para impressão de erros da GLFW no terminal
+        glfwSetErrorCallback(ErrorCallback);
+
+        // Pedimos para utilizar OpenGL versão 3.3 (ou superior)
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+
+        #ifdef __APPLE__
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        #endif
+
+        // Pedimos para utilizar o perfil "core", isto é, utilizaremos somente as
+        // funções modernas de OpenGL.
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        // Criamos uma janela do sistema operacional, com 800 colunas e 600 linhas
+        window = glfwCreateWindow(800, 600, "Timberman", NULL, NULL);
+        if (!window)
+        {
+            glfwTerminate();
+            fprintf(stderr, "ERROR: glfwCreateWindow() failed.\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        // Muda o ícone da janela
+        // FONTE: https://stackoverflow.com/questions/44321902/glfw-setwindowicon
+        GLFWimage images[1];
+        images[0].pixels = stbi_load("../../data/textures/icon.png", &images[0].width, &images[0].height, 0, 4);
+        glfwSetWindowIcon(window, 1, images);
+        stbi_image_free(images[0].pixels);
+
+        // Definimos a função de callback que será chamada sempre que o usuário
+        // movimentar o cursor do mouse...
+        glfwSetCursorPosCallback(window, CursorPosCallback);
+
+        // Desabilita o ícone do cursor e mantém ele na janela caso saia
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+        // Indicamos que as chamadas OpenGL deverão renderizar nesta janela
+        glfwMakeContextCurrent(window);
+
+        // Carregamento de todas funções definidas por OpenGL 3.3, utilizando a biblioteca GLAD.
+        gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+
+        // Definimos a função de callback que será chamada sempre que a janela for redimensionada
+        glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
+    }
+    Profiler_SetGpuThread();
+
+    // Sem sincronização vertical nem limite, o jogo desenharia o mais rápido
+    // possível, ocupando um núcleo inteiro. Sem janela não há monitor com que
+    // sincronizar.
+    FramePacer pacer;
+    FramePacing_Init(&pacer, frame_rate, headless ? VSYNC_OFF : vsync);
+    if (!headless)
+        FramePacing_ApplySwapInterval(&pacer);
+
+    // Forçamos a chamada do callback de redimensionamento, para definir g_ScreenRatio.
+    if (headless)
+        FramebufferSizeCallback(window, headless_width, headless_height);
+    else
+        FramebufferSizeCallback(window, 800, 600);
+
+    // Carregamos os shaders de vértices e de fragmentos que serão utilizados
+    // para renderização. Veja slides 180-200 do documento Aula_03_Rendering_Pipeline_Grafico.pdf.
+    LoadShadersFromFiles();
+
+    // Carrega as texturas
+    LoadTextureImage("../../data/textures/texture_gradient.png");
+    LoadTextureImage("../../data/textures/low_poly_stones_color_palette.png");
+    LoadTextureImage("../../data/textures/axe.png"); // Textura criada pelo grupo
+    LoadTextureImage("../../data/textures/bigtree.png");
+    LoadTextureImage("../../data/textures/character.png"); // Textura criada pelo grupo
+    LoadTextureImage("../../data/textures/capa.png"); // Textura criada pelo grupo
+
+    // Carrega modelo com o set das árvores, troncos e plano do chão
+    ObjModel scene("../../data/forest_nature_set_all_in.obj");
+    ComputeNormals(&scene);
+    BuildTrianglesAndAddToVirtualScene(&scene);
+
+    // Carrega os modelos das pedras da montanha
+    const char* filename[rock_types] = {"../../data/stone_1.obj",
+                                        "../../data/stone_with_moss_2.obj",
+                                        "../../data/stone_3.obj",
+                                        "../../data/stone_4.obj",
+                                        "../../data/stone_with_moss_5.obj",
+                                        "../../data/stone_6.obj",
+                                        "../../data/stone_7.obj"};
+    for(int i=0; i<rock_types; i++){
+        ObjModel mountain(filename[i]);
+        ComputeNormals(&mountain);
+        BuildTrianglesAndAddToVirtualScene(&mountain);
+
+        getAllObjectsInFile(filename[i]);
+    }
+
+    // Carrega o modelo do NPC (cavaleiro)
+    ObjModel character("../../data/character.obj");
+    ComputeNormals(&character);
+    BuildTrianglesAndAddToVirtualScene(&character);
+
+    // Carrega o modelo do machado
+    ObjModel axe("../../data/axe.obj");
+    ComputeNormals(&axe);
+    BuildTrianglesAndAddToVirtualScene(&axe);
+
+    // Carrega o modelo da árvore gigante
+    ObjModel bigtree("../../data/bigtree.obj");
+    ComputeNormals(&bigtree);
+    BuildTrianglesAndAddToVirtualScene(&bigtree);
+
+    // Carrega o modelo das galinhas
+    ObjModel chicks("../../data/littlechicks.obj");
+    ComputeNormals(&chicks);
+    BuildTrianglesAndAddToVirtualScene(&chicks);
+
+    TextRendering_Init(); // Inicializamos o código para renderização de texto.
+
+    glEnable(GL_DEPTH_TEST); // Habilitamos o Z-buffer. Veja slides 104-116 do documento Aula_09_Projecoes.pdf.
+
+    // Habilitamos o Backface Culling. Veja slides 23-34 do documento Aula_13_Clipping_and_Culling.pdf.
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+
+    // Nomes dos objetos das árvores
+    const char* tree_names[tree_types] = {"Tree_Spruce_small_01_Cylinder.016"};
+
+    // Nomes dos objetos das decorações
+    const char* decoration_names[decoration_types] = {"Grass_bush_high_01_Plane.002", "Grass_bush_low_01_Plane.005",
+                                                      "Flower_bush_white_Plane.023",  "Flower_bush_red_Plane.031"};
+
+    // Terreno: um mapa de alturas de 1 km de lado, que se repete, com a
+    // clareira do meio do mapa (NPC, fogueira e árvore gigante) plana. Os
+    // objetos são colocados na altura do terreno sob eles.
+    Terrain terrain;
+    Terrain_Generate(&terrain, 512, 2.0f, terrain_height, 30.0f, 60.0f, config.seed);
+    Terrain_Upload(&terrain, 10);
+
+    // Mundo de entidades, com o jogador na posição inicial
+    Ecs_Init(&g_World);
+    Ecs_RegisterComponent(&g_World, COMPONENT_TRANSFORM, sizeof(TransformComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_RENDER,    sizeof(RenderComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_COLLIDER,  sizeof(ColliderComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_SOLID,     0);
+    Ecs_RegisterComponent(&g_World, COMPONENT_CHOPPABLE, 0);
+    Ecs_RegisterComponent(&g_World, COMPONENT_FELLED,    sizeof(FelledComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_MOTION,    sizeof(MotionComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_PLAYER,    sizeof(PlayerComponent));
+    Ecs_RegisterComponent(&g_World, COMPONENT_QUEST,     sizeof(QuestComponent));
+
+    g_Player = Ecs_Create(&g_World, ECS_BIT(COMPONENT_MOTION) | ECS_BIT(COMPONENT_PLAYER) | ECS_BIT(COMPONENT_QUEST));
+    MotionComponent* player_motion = Ecs_Get<MotionComponent>(&g_World, g_Player, COMPONENT_MOTION);
+    player_motion->position = glm::vec2(player_start_x, player_start_z);
+    player_motion->previous = player_motion->position;
+    player_motion->speed = default_speed;
+    Ecs_Get<PlayerComponent>(&g_World, g_Player, COMPONENT_PLAYER)->eye_height = player_eye_height;
+
+    // Objetos do mapa, com as quantidades da configuração
+    EntityArrays trees, decorations, rocks, logs;
+
+    // Posicionamento procedural: cada objeto ocupa um círculo do tamanho da
+    // sua base que não pode sobrepor os dos outros (veja placement.h). A
+    // mesma semente gera sempre o mesmo mapa.
+    PlacementRandom random;
+    PlacementRandom_Seed(&random, config.seed);
+
+    // Áreas livres em volta do NPC, da fogueira e da posição inicial do
+    // jogador. A montanha fica em um anel logo depois da floresta.
+    float forest_radius = config.forest_radius;
+    float mountain_radius = forest_radius + 130.0f;
+    glm::vec3 campfire_position = glm::vec3(2.0f, 0.0f, -16.0f);
+    PlacementExclusion exclusions[3] = {{glm::vec2(-4.0f, -10.0f), 3.0f},
+                                        {glm::vec2(campfire_position.x, campfire_position.z), 2.0f},
+                                        {glm::vec2(player_start_x, player_start_z), 3.0f}};
+    PlacementRegion forest_region = {glm::vec2(0.0f), 50.0f, forest_radius, exclusions, 3};
+    PlacementRegion decoration_region = {glm::vec2(0.0f), 40.0f, forest_radius, exclusions, 3};
+    PlacementRegion lantern_region = {glm::vec2(0.0f), 20.0f, forest_radius, exclusions, 3};
+    PlacementRegion mountain_region = {glm::vec2(0.0f), mountain_radius - 40.0f, mountain_radius, NULL, 0};
+
+    // Troncos, árvores, lanternas e decorações dividem a mesma grade, então
+    // também não se sobrepõem entre si. Os modelos não estão centrados na
+    // origem: a translação de cada um desloca o centro da sua base para o
+    // ponto escolhido. Se a floresta encher, as quantidades são reduzidas.
+    Placement placement;
+    Placement_Init(&placement, glm::vec2(-forest_radius - 10.0f), glm::vec2(forest_radius + 10.0f), 4.0f);
+    glm::vec2 footprint_center;
+    float footprint_radius;
+    int first;
+
+    getFootprint("Log_big_regular_Cylinder.015", &footprint_center, &footprint_radius);
+    first = (int)placement.x.size();
+    EntityArrays_Resize(&logs, Placement_Scatter(&placement, &random, forest_region, 0.8f*footprint_radius, config.logs));
+    for(int i=0; i<logs.count; i++){
+        logs.scale[i] = 0.8f;
+        logs.x[i] = placement.x[first+i] - logs.scale[i]*footprint_center.x;
+        logs.z[i] = placement.z[first+i] - logs.scale[i]*footprint_center.y;
+        logs.y[i] = Terrain_Height(&terrain, placement.x[first+i], placement.z[first+i]);
+    }
+
+    // As árvores são espaçadas pelo tronco: as copas podem se tocar
+    getFootprint(tree_names[0], &footprint_center, &footprint_radius);
+    first = (int)placement.x.size();
+    EntityArrays_Resize(&trees, Placement_Scatter(&placement, &random, forest_region, 0.5f*footprint_radius*1.3f, config.trees));
+    for(int i=0; i<trees.count; i++){
+        trees.scale[i] = PlacementRandom_Float(&random, 0.5f, 1.3f);
+        trees.x[i] = placement.x[first+i] - trees.scale[i]*footprint_center.x;
+        trees.z[i] = placement.z[first+i] - trees.scale[i]*footprint_center.y;
+        trees.y[i] = Terrain_Height(&terrain, placement.x[first+i], placement.z[first+i]);
+        trees.type[i] = i * tree_types / trees.count;
+    }
+    if(trees.count < config.trees)
+        fprintf(stderr, "Aviso: só couberam %d de %d árvores (aumente forest_radius)\n", trees.count, config.trees);
+
+    // As lanternas (luzes sem modelo) só reservam o seu espaço aqui; as luzes
+    // são criadas abaixo
+    int first_lantern = (int)placement.x.size();
+    int lanterns = Placement_Scatter(&placement, &random, lantern_region, 0.5f, config.lanterns);
+
+    // Todas as decorações usam o raio da maior delas
+    glm::vec2 decoration_center[decoration_types];
+    float decoration_radius = 0.0f;
+    for(int j=0; j<decoration_types; j++){
+        getFootprint(decoration_names[j], &decoration_center[j], &footprint_radius);
+        decoration_radius = std::max(decoration_radius, footprint_radius);
+    }
+    first = (int)placement.x.size();
+    EntityArrays_Resize(&decorations, Placement_Scatter(&placement, &random, decoration_region, decoration_radius, config.decorations));
+    for(int i=0; i<decorations.count; i++){
+        int j = i * decoration_types / decorations.count;
+        decorations.type[i] = j;
+        decorations.x[i] = placement.x[first+i] - decoration_center[j].x;
+        decorations.z[i] = placement.z[first+i] - decoration_center[j].y;
+        decorations.y[i] = Terrain_Height(&terrain, placement.x[first+i], placement.z[first+i]);
+    }
+
+    // As pedras formam a montanha e podem se sobrepor bastante: o raio só
+    // evita que fiquem amontoadas. Com o mundo gerado sob demanda não há
+    // montanha: a floresta continua além dela.
+    Placement mountain;
+    Placement_Init(&mountain, glm::vec2(-mountain_radius - 10.0f), glm::vec2(mountain_radius + 10.0f), 8.0f);
+    EntityArrays_Resize(&rocks, Placement_Scatter(&mountain, &random, mountain_region, 3.0f, config.streaming ? 0 : config.rocks));
+    for(int i=0; i<rocks.count; i++){
+        rocks.x[i] = mountain.x[i];
+        rocks.z[i] = mountain.z[i];
+        rocks.y[i] = Terrain_Height(&terrain, rocks.x[i], rocks.z[i]);
+        rocks.scale[i] = PlacementRandom_Float(&random, 0.8f, 1.3f)*40.0f;
+        rocks.type[i] = i * sizeObjModels / rocks.count;
+    }
+
+    // Luzes pontuais: uma fogueira perto do NPC, tochas ao redor da árvore
+    // gigante e lanternas espalhadas pela floresta
+    glm::vec3 torch_position[n_torches];
+    std::vector<PointLight> point_lights;
+    std::vector<float> light_base_intensity;
+    PointLight light;
+
+    light.position = campfire_position + glm::vec3(0.0f, 0.6f, 0.0f);
+    light.radius = 14.0f;
+    light.color = glm::vec3(1.0f, 0.55f, 0.2f);
+    light.intensity = 6.0f;
+    point_lights.push_back(light);
+
+    for(int i=0; i<n_torches; i++){
+        float angle = 2.0f*M_PI*i/n_torches;
+        torch_position[i] = glm::vec3(14.0f*cos(angle), 0.0f, 14.0f*sin(angle));
+
+        light.position = torch_position[i] + glm::vec3(0.0f, 2.3f, 0.0f);
+        light.radius = 9.0f;
+        light.color = glm::vec3(1.0f, 0.6f, 0.25f);
+        light.intensity = 3.0f;
+        point_lights.push_back(light);
+    }
+
+    for(int i=0; i<lanterns; i++){
+        light.position = glm::vec3(placement.x[first_lantern+i], 0.0f, placement.z[first_lantern+i]);
+        light.position.y = Terrain_Height(&terrain, light.position.x, light.position.z) + 1.5f;
+        light.radius = 7.0f;
+        light.color = glm::vec3(1.0f, 0.85f, 0.5f);
+        light.intensity = 2.0f;
+        point_lights.push_back(light);
+    }
+
+    for(size_t i=0; i<point_lights.size(); i++)
+        light_base_intensity.push_back(point_lights[i].intensity);
+
+    // Tarefas de cada quadro (culling, colisões, animação e montagem da lista
+    // de desenho) divididas entre todos os núcleos. Veja jobs.h.
+    JobSystem jobs;
+    Jobs_Init(&jobs, job_threads);
+
+    LightClusters light_clusters;
+    LightClusters_Init(&light_clusters);
+
+    // Sol (luz direcional) e os seus shadow maps
+    glm::vec3 sun_direction = glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f));
+    ShadowCascades shadows;
+    ShadowCascades_Init(&shadows);
+
+    // Inicializando os valores da posição da câmera e do up_vector para a câmera look-at
+    glm::vec4 camera_position_c =  glm::vec4(62.26f, 15.0f, -49.71f, 1.0f); // Início da curva de bezier da câmera look-at
+    glm::vec4 camera_view_vector = glm::vec4(player_start_x, player_eye_height, player_start_z, 1.0f) - glm::vec4(62.26f, 15.0f, -49.71f, 1.0f);
+    glm::vec4 camera_up_vector =   glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+
+    // Curva de Bezier das galinhas, percorrida em velocidade constante, de
+    // ida e volta
+    glm::vec3 chicken_points[4] = {glm::vec3(-22.66f, 0.0f, -18.40f),
+                                   glm::vec3(-6.60f,  0.0f, -23.68f),
+                                   glm::vec3(8.76f,   0.0f, -17.90f),
+                                   glm::vec3(16.43f,  0.0f, -9.21f)};
+    SplinePath chicken_path;
+    SplinePath_Build(&chicken_path, SPLINE_BEZIER, chicken_points, 4);
+    SplineAgents chickens;
+    SplineAgents_Init(&chickens, &chicken_path, SPLINE_PING_PONG);
+    SplineAgents_Add(&chickens, 0.0f, 0.1f*chicken_path.length); // Percorre a curva em 10 segundos
+    SplineAgents_Advance(&chickens, 0.0f);
+
+    // Curva de Bezier da câmera da "cut-scene", montada quando o jogo começa
+    SplinePath camera_path;
+    float camera_distance = 0.0f; // Distância percorrida na curva da câmera
+    bool camera_path_built = false;
+
+    // Texto do monólogo com o NPC
+    char const* monolog_text[15] = {"Olá caro lenhador, o inverno está se aproximando",
+                                    "e os moradores de uma vila próxima daqui precisam de madeira para se aquecerem.",
+                                    "Caso deseje nos ajudar a coletá-las, pressione [Y].",
+
+                                    "Certo, muito obrigado!",
+                                    "Você pode começar coletando a madeira de 3 árvores.",
+                                    "Estarei aqui te esperando!",
+
+                                    "Nós ficamos muito gratos pela sua ajuda!",
+                                    "Porém, precisaremos de mais um pouco de madeira.",
+                                    "Precisaremos da madeira de mais 5 árvores.",
+
+                                    "Temos alguns moradores novos na nossa vila, então",
+                                    "precisaremos de mais madeira. Poderia nos",
+                                    "ajudar coletando a madeira de mais 10 árvores?",
+
+                                    "Muito obrigado pela sua ajuda!",
+                                    "Com certeza as madeiras coletadas por você",
+                                    "ajudarão a nos aquecer no próximo inverno."};
+
+    bool camera_type = false; // Altera câmera entre look-at e livre
+
+    // Objetos da cena desenhados a cada quadro. As buscas no dicionário
+    // g_VirtualScene são feitas uma única vez aqui, e não a cada desenho.
+    const SceneObject* stump_object = &g_VirtualScene["Stump_average_low_Cube.014"];
+    const SceneObject* log_object = &g_VirtualScene["Log_big_regular_Cylinder.015"];
+    const SceneObject* bigtree_object = &g_VirtualScene["fattree_Mesh.003"];
+    const SceneObject* knight_object = &g_VirtualScene["knight"];
+    const SceneObject* capa_object = &g_VirtualScene["capa"];
+
+    const SceneObject* tree_objects[tree_types];
+    for(int j=0; j<tree_types; j++)
+        tree_objects[j] = &g_VirtualScene[tree_names[j]];
+
+    const SceneObject* decoration_objects[decoration_types];
+    for(int j=0; j<decoration_types; j++)
+        decoration_objects[j] = &g_VirtualScene[decoration_names[j]];
+
+    const SceneObject* rock_objects[100];
+    for(int j=0; j<sizeObjModels; j++)
+        rock_objects[j] = &g_VirtualScene[obj_names[j]];
+
+    // Partes de cada galinha (pernas, corpo, dois olhos e crista)
+    const char* chicken_part_names[3][5] = {{"laranja1", "branco1", "preto1", "preto1_1", "vermelho1"},
+                                            {"laranja2", "branco2", "preto2", "preto2_1", "vermelho2"},
+                                            {"laranja3", "branco3", "preto3", "preto3_1", "vermelho3"}};
+    const int chicken_part_ids[5] = {CHICKEN_LEG, CHICKEN_BODY, CHICKEN_EYE, CHICKEN_EYE, CHICKEN_COMB};
+    const SceneObject* chicken_objects[3][5];
+    for(int c=0; c<3; c++)
+        for(int part=0; part<5; part++)
+            chicken_objects[c][part] = &g_VirtualScene[chicken_part_names[c][part]];
+
+    const SceneObject* axe_objects[3] = {&g_VirtualScene["Cube"], &g_VirtualScene["Plane"], &g_VirtualScene["Cube.001"]};
+
+    // Fogueira (pedras e galhos) e tochas (galhos em pé). Os modelos não estão
+    // centrados na origem do arquivo .obj, então são transladados pelo seu centro.
+    const SceneObject* stones_object = &g_VirtualScene["Stone_group_average_Icosphere.022"];
+    const SceneObject* branch_object = &g_VirtualScene["Branch_average_bare_Cylinder.024"];
+    glm::vec3 stones_center = glm::vec3(-12.23f, 0.0f, 12.09f);
+    glm::vec3 branch_center = glm::vec3(-23.29f, 0.55f, 5.40f);
+
+    // Hierarquia de transformações de todos os objetos desenhados. Os
+    // objetos parados são criados primeiro e os que se movem a cada quadro
+    // por último, já que a atualização começa no primeiro nó que mudou.
+    // Objetos presos a outros são filhos deles: o machado segue a câmera e
+    // as galinhas seguem o ponto da curva de Bézier do bando.
+    TransformTree transforms;
+    Transforms_Clear(&transforms);
+
+    for(int i=0; i<decorations.count; i++)
+        decorations.node[i] = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_Translate(decorations.x[i], decorations.y[i], decorations.z[i]));
+
+    for(int i=0; i<rocks.count; i++)
+        rocks.node[i] = Transforms_Add(&transforms, TRANSFORM_ROOT,
+                                       Affine_TRS(glm::vec3(rocks.x[i], rocks.y[i], rocks.z[i]), 0.0f, 0.0f, 0.0f, glm::vec3(rocks.scale[i])));
+
+    for(int i=0; i<logs.count; i++)
+        logs.node[i] = Transforms_Add(&transforms, TRANSFORM_ROOT,
+                                      Affine_TRS(glm::vec3(logs.x[i], logs.y[i] - 0.1f, logs.z[i]), 0.0f, 0.0f, 0.0f, glm::vec3(logs.scale[i])));
+
+    int bigtree_node = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_Scale(2.0f, 2.0f, 2.0f));
+
+    // Árvores. O balanço com o vento é feito em shader_vertex.glsl, então a
+    // matriz delas não muda.
+    for(int i=0; i<trees.count; i++)
+        trees.node[i] = Transforms_Add(&transforms, TRANSFORM_ROOT,
+                                       Affine_TRS(glm::vec3(trees.x[i], trees.y[i] - 0.1f, trees.z[i]), 0.0f, 0.0f, 0.0f, glm::vec3(trees.scale[i])));
+
+    // Fogueira: as pedras e os galhos são filhos do ponto da fogueira
+    int campfire_node = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_Translate(campfire_position.x, 0.0f, campfire_position.z));
+    int stones_node = Transforms_Add(&transforms, campfire_node,
+                                     Affine_Multiply(Affine_Scale(0.5f, 0.5f, 0.5f),
+                                                     Affine_Translate(-stones_center.x, -stones_center.y, -stones_center.z)));
+    int campfire_branch_nodes[2];
+    for(int i=0; i<2; i++)
+        campfire_branch_nodes[i] = Transforms_Add(&transforms, campfire_node,
+                                                  Affine_Multiply(Affine_TRS(glm::vec3(0.0f, 0.2f, 0.0f), (45.0f + 90.0f*i)*M_PI/180.0, 0.0f, 0.0f, glm::vec3(0.3f)),
+                                                                  Affine_Translate(-branch_center.x, -branch_center.y, -branch_center.z)));
+
+    int torch_nodes[n_torches];
+    for(int i=0; i<n_torches; i++)
+        torch_nodes[i] = Transforms_Add(&transforms, TRANSFORM_ROOT,
+                                        Affine_Multiply(Affine_TRS(glm::vec3(torch_position[i].x, 1.1f, torch_position[i].z), 0.0f, 0.0f, 90*M_PI/180.0, glm::vec3(0.4f)),
+                                                        Affine_Translate(-branch_center.x, -branch_center.y, -branch_center.z)));
+
+    // NPC (cavaleiro) e a sua capa
+    int knight_node = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_TRS(glm::vec3(-4.0f, 0.0f, -10.0f), 180*M_PI/180.0, 0.0f, 0.0f, glm::vec3(6.8f)));
+    int capa_node = Transforms_Add(&transforms, knight_node, Affine_Translate(0.0f, 0.0f, 0.02f/6.8f));
+
+    // Bando de galinhas: a galinha maior fica no ponto da curva e as menores
+    // em volta dela, todas com a mesma rotação
+    int flock_node = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_Identity());
+    int chick_anchor_nodes[2] = {Transforms_Add(&transforms, flock_node, Affine_Identity()),
+                                 Transforms_Add(&transforms, flock_node, Affine_Identity())};
+    int chicken_nodes[3] = {Transforms_Add(&transforms, flock_node, Affine_Identity()),
+                            Transforms_Add(&transforms, chick_anchor_nodes[0], Affine_Identity()),
+                            Transforms_Add(&transforms, chick_anchor_nodes[1], Affine_Identity())};
+
+    // Machado, preso à câmera
+    int camera_node = Transforms_Add(&transforms, TRANSFORM_ROOT, Affine_Identity());
+    int axe_node = Transforms_Add(&transforms, camera_node, Affine_Identity());
+
+    Transforms_Update(&transforms);
+
+    // Objetos do mapa como entidades. As árvores, as pedras, os troncos e a
+    // árvore gigante são sólidos e têm um colisor estático: uma malha de
+    // triângulos de g_CollisionMeshes colocada no mundo com a mesma matriz de
+    // modelagem usada no desenho. O "index" de cada colisor é o índice da
+    // sua entidade.
+    std::vector<CollisionInstance> static_colliders;
+    CollisionInstance instance;
+
+    static_colliders.reserve(trees.count + rocks.count + logs.count + 1);
+
+    auto add_collider = [&](EcsEntity entity, int type, const CollisionMesh* mesh){
+        const TransformComponent* transform = Ecs_Get<TransformComponent>(&g_World, entity, COMPONENT_TRANSFORM);
+        CollisionInstance_Init(&instance, type, (int)entity.index, mesh, transforms.world_matrix[transform->node], transform->scale);
+        Ecs_Get<ColliderComponent>(&g_World, entity, COMPONENT_COLLIDER)->collider = (int)static_colliders.size();
+        static_colliders.push_back(instance);
+    };
+
+    // As malhas de colisão de cada tipo são buscadas uma vez, fora dos laços
+    const CollisionMesh* tree_meshes[tree_types];
+    for(int j=0; j<tree_types; j++)
+        tree_meshes[j] = &g_CollisionMeshes[tree_names[j]];
+    std::vector<const CollisionMesh*> rock_meshes(sizeObjModels);
+    for(int j=0; j<sizeObjModels; j++)
+        rock_meshes[j] = &g_CollisionMeshes[obj_names[j]];
+    const CollisionMesh* log_mesh = &g_CollisionMeshes[log_object->name];
+
+    EcsMask solid_mask = ECS_BIT(COMPONENT_TRANSFORM) | ECS_BIT(COMPONENT_RENDER) | ECS_BIT(COMPONENT_COLLIDER) | ECS_BIT(COMPONENT_SOLID);
+    EcsMask tree_mask = solid_mask | ECS_BIT(COMPONENT_CHOPPABLE);
+    EcsMask decoration_mask = ECS_BIT(COMPONENT_TRANSFORM) | ECS_BIT(COMPONENT_RENDER);
+    EcsEntity entity;
+
+    // As árvores são criadas em sequência, então a posição de cada uma na
+    // ordem do mapa (usada no jogo salvo) é o índice da entidade menos o da
+    // primeira
+    unsigned int first_tree = (unsigned int)g_World.records.size();
+    Ecs_Reserve(&g_World, tree_mask, trees.count);
+    for(int i=0; i<trees.count; i++){
+        entity = SpawnMapObject(&g_World, tree_mask, trees.node[i], glm::vec3(trees.x[i], trees.y[i] - 0.1f, trees.z[i]), trees.scale[i],
+                                tree_objects[trees.type[i]], TREES, glm::vec2(wind_wavelength*(trees.x[i] + trees.z[i]), tree_wind));
+        add_collider(entity, COLLIDER_TREE, tree_meshes[trees.type[i]]);
+    }
+
+    Ecs_Reserve(&g_World, solid_mask, rocks.count + logs.count + 1);
+    for(int i=0; i<rocks.count; i++){
+        entity = SpawnMapObject(&g_World, solid_mask, rocks.node[i], glm::vec3(rocks.x[i], rocks.y[i], rocks.z[i]), rocks.scale[i],
+                                rock_objects[rocks.type[i]], MOUNTAINS);
+        add_collider(entity, COLLIDER_ROCK, rock_meshes[rocks.type[i]]);
+    }
+
+    for(int i=0; i<logs.count; i++){
+        entity = SpawnMapObject(&g_World, solid_mask, logs.node[i], glm::vec3(logs.x[i], logs.y[i] - 0.1f, logs.z[i]), logs.scale[i],
+                                log_object, TREES);
+        add_collider(entity, COLLIDER_LOG, log_mesh);
+    }
+
+    entity = SpawnMapObject(&g_World, solid_mask, bigtree_node, glm::vec3(0.0f), 2.0f, bigtree_object, BIGTREE);
+    add_collider(entity, COLLIDER_BIGTREE, &g_CollisionMeshes[bigtree_object->name]);
+
+    // As decorações (plantas) não bloqueiam o jogador
+    Ecs_Reserve(&g_World, decoration_mask, decorations.count);
+    for(int i=0; i<decorations.count; i++)
+        SpawnMapObject(&g_World, decoration_mask, decorations.node[i], glm::vec3(decorations.x[i], decorations.y[i], decorations.z[i]), 1.0f,
+                       decoration_objects[decorations.type[i]], TREES, glm::vec2(wind_wavelength*(decorations.x[i] + decorations.z[i]), plant_wind));
+
+    // Grade espacial com os colisores estáticos. Cada colisor é inserido com
+    // a sua caixa no plano XZ aumentada pelo raio do jogador, fora da qual a
+    // cápsula do jogador nunca toca a malha; a cada passo só são testados os
+    // colisores da célula em que o jogador está.
+    SpatialGrid collision_grid;
+    SpatialGrid_Init(&collision_grid, 8.0f);
+
+    for(size_t i=0; i<static_colliders.size(); i++){
+        const CollisionInstance &collider = static_colliders[i];
+        SpatialGrid_Add(&collision_grid, collider.type, (int)i,
+                        glm::vec2(collider.min.x, collider.min.z) - player_radius,
+                        glm::vec2(collider.max.x, collider.max.z) + player_radius);
+    }
+
+    SpatialGrid_Build(&collision_grid);
+
+    // Mundo gerado sob demanda além da floresta: pedaços quadrados com árvores
+    // e decorações na mesma densidade da floresta, gerados em outra thread à
+    // medida que o jogador se aproxima (veja worldstream.h). Cada pedaço é
+    // gerado só a partir da semente do mapa e das suas coordenadas, então o
+    // mundo é o mesmo toda vez que o jogador volta a um lugar.
+    WorldStream stream;
+    if(config.streaming){
+        glm::vec2 tree_center;
+        float tree_radius;
+        getFootprint(tree_names[0], &tree_center, &tree_radius);
+        tree_radius *= 0.5f*1.3f;
+
+        float chunk_area = world_chunk_size*world_chunk_size;
+        int chunk_trees = (int)(config.trees / (M_PI*(forest_radius*forest_radius - 50.0f*50.0f)) * chunk_area + 0.5f);
+        int chunk_decorations = (int)(config.decorations / (M_PI*(forest_radius*forest_radius - 40.0f*40.0f)) * chunk_area + 0.5f);
+        unsigned int world_seed = config.seed;
+        const CollisionMesh* chunk_tree_meshes[tree_types];
+        std::copy(tree_meshes, tree_meshes + tree_types, chunk_tree_meshes);
+        const Terrain* chunk_terrain = &terrain; // Só é lido, então pode ser usado pela thread de geração
+
+        WorldStream_Start(&stream, world_chunk_size, config.stream_radius, (size_t)config.chunk_budget_mb*1024*1024, world_seed,
+                          [=](WorldChunk* chunk){
+            PlacementRandom chunk_random;
+            PlacementRandom_Seed(&chunk_random, WorldStream_ChunkSeed(world_seed, chunk->cx, chunk->cz));
+
+            // Os objetos ficam inteiros dentro do pedaço, então pedaços
+            // vizinhos gerados separadamente não se sobrepõem; a floresta
+            // do mapa fica de fora
+            glm::vec2 chunk_min = glm::vec2(chunk->cx, chunk->cz) * world_chunk_size;
+            glm::vec2 chunk_max = chunk_min + world_chunk_size;
+            PlacementExclusion forest = {glm::vec2(0.0f), forest_radius + 10.0f};
+            PlacementRegion chunk_region = {(chunk_min + chunk_max)*0.5f, 0.0f, world_chunk_size*0.75f, &forest, 1, chunk_min, chunk_max};
+
+            Placement chunk_placement;
+            Placement_Init(&chunk_placement, chunk_min, chunk_max, 4.0f);
+            int chunk_first;
+
+            chunk_first = (int)chunk_placement.x.size();
+            EntityArrays_Resize(&chunk->trees, Placement_Scatter(&chunk_placement, &chunk_random, chunk_region, tree_radius, chunk_trees));
+            chunk->colliders.resize(chunk->trees.count);
+            for(int i=0; i<chunk->trees.count; i++){
+                chunk->trees.scale[i] = PlacementRandom_Float(&chunk_random, 0.5f, 1.3f);
+                chunk->trees.x[i] = chunk_placement.x[chunk_first+i] - chunk->trees.scale[i]*tree_center.x;
+                chunk->trees.z[i] = chunk_placement.z[chunk_first+i] - chunk->trees.scale[i]*tree_center.y;
+                chunk->trees.y[i] = Terrain_Height(chunk_terrain, chunk_placement.x[chunk_first+i], chunk_placement.z[chunk_first+i]);
+                chunk->trees.type[i] = i * tree_types / chunk->trees.count;
+
+                // A matriz do colisor é também a usada para desenhar a árvore
+                glm::mat4 model = Affine_ToMat4(Affine_TRS(glm::vec3(chunk->trees.x[i], chunk->trees.y[i] - 0.1f, chunk->trees.z[i]),
+                                                           0.0f, 0.0f, 0.0f, glm::vec3(chunk->trees.scale[i])));
+                CollisionInstance_Init(&chunk->colliders[i], COLLIDER_CHUNK_TREE, i, chunk_tree_meshes[chunk->trees.type[i]],
+                                       model, chunk->trees.scale[i]);
+            }
+
+            chunk_first = (int)chunk_placement.x.size();
+            EntityArrays_Resize(&chunk->decorations, Placement_Scatter(&chunk_placement, &chunk_random, chunk_region, decoration_radius, chunk_decorations));
+            chunk->decoration_matrices.resize(chunk->decorations.count);
+            for(int i=0; i<chunk->decorations.count; i++){
+                int j = i * decoration_types / chunk->decorations.count;
+                chunk->decorations.type[i] = j;
+                chunk->decorations.x[i] = chunk_placement.x[chunk_first+i] - decoration_center[j].x;
+                chunk->decorations.z[i] = chunk_placement.z[chunk_first+i] - decoration_center[j].y;
+                chunk->decorations.y[i] = Terrain_Height(chunk_terrain, chunk_placement.x[chunk_first+i], chunk_placement.z[chunk_first+i]);
+                chunk->decoration_matrices[i] = Affine_ToMat4(Affine_Translate(chunk->decorations.x[i], chunk->decorations.y[i], chunk->decorations.z[i]));
+            }
+
+            SpatialGrid_Init(&chunk->collision_grid, 8.0f);
+            for(int i=0; i<chunk->trees.count; i++){
+                const CollisionInstance &collider = chunk->colliders[i];
+                SpatialGrid_Add(&chunk->collision_grid, collider.type, i,
+                                glm::vec2(collider.min.x, collider.min.z) - player_radius,
+                                glm::vec2(collider.max.x, collider.max.z) + player_radius);
+            }
+            SpatialGrid_Build(&chunk->collision_grid);
+        });
+    }
+
+    // Hierarquia de volumes envolventes (BVH) com as caixas dos objetos
+    // sólidos do mapa, usada para saber para qual árvore o jogador está
+    // mirando e para a seleção de objetos com o mouse. O "index" de cada item
+    // é a posição do colisor em static_colliders. As decorações (plantas)
+    // não bloqueiam a mira e ficam de fora.
+    Bvh target_bvh;
+    Bvh_Clear(&target_bvh);
+
+    for(size_t i=0; i<static_colliders.size(); i++){
+        const CollisionInstance &collider = static_colliders[i];
+        int id = Bvh_Add(&target_bvh, collider.type, (int)i, collider.min, collider.max);
+        Ecs_Get<ColliderComponent>(&g_World, Ecs_FromIndex(&g_World, collider.index), COMPONENT_COLLIDER)->target = id;
+    }
+
+    Bvh_AddTransformed(&target_bvh, COLLIDER_NPC, 0, knight_object->bbox_min, knight_object->bbox_max,
+                       transforms.world_matrix[knight_node]);
+
+    Bvh_Build(&target_bvh);
+
+    // Continua o jogo salvo, se ele for deste mapa (mesma semente e mesmo
+    // número de árvores). Sem janela o jogo salvo não é lido nem gravado,
+    // para que as medições não dependam de uma sessão anterior.
+    SaveGame save;
+    double load_start = FramePacing_Now();
+    if(!headless && SaveGame_Load(&save, save_filename)){
+        if(save.seed != config.seed || save.tree_count != trees.count)
+            fprintf(stderr, "Jogo salvo \"%s\" ignorado: é de outro mapa\n", save_filename);
+        else{
+            player_motion = Ecs_Get<MotionComponent>(&g_World, g_Player, COMPONENT_MOTION);
+            player_motion->position = save.player_position;
+            player_motion->previous = save.player_position;
+
+            QuestComponent* quest = Ecs_Get<QuestComponent>(&g_World, g_Player, COMPONENT_QUEST);
+            quest->level = save.quest_level;
+            quest->felled = save.quest_felled;
+            quest->accepted = save.quest_accepted;
+
+            for(size_t t=0; t<save.trunks.size(); t++)
+                FellTree(&g_World, Ecs_FromIndex(&g_World, first_tree + save.trunks[t].tree), save.trunks[t].position,
+                         &target_bvh, &transforms, stump_object);
+
+            printf("Jogo salvo carregado: %d árvores cortadas, em %.1f ms\n", (int)save.trunks.size(), FramePacing_Now() - load_start);
+        }
+    }
+
+    // O jogo é salvo em outra thread, então salvar não trava o quadro
+    SaveWriter save_writer;
+    SaveWriter_Start(&save_writer, save_filename);
+
+    const char* collider_names[] = {"árvore", "pedra", "tronco", "árvore gigante", "NPC", "árvore distante"};
+
+    // Pedaços do terreno escolhidos a cada quadro, e quantos há de cada nível
+    std::vector<TerrainPatch> terrain_patches;
+    int terrain_lod_counts[TERRAIN_LODS];
+
+    char broken[20] = "0"; // Display do contador de árvores quebradas
+    char fragments_text[80] = "";
+    std::vector<ProfilerScope> profiler_scopes; // Cópias lidas para o HUD
+    std::vector<ProfilerJob> profiler_jobs;
+
+    // Passo da simulação: move o jogador de acordo com a entrada, resolve as
+    // colisões e atualiza o estado do jogo. O desenho usa a posição
+    // interpolada entre o passo anterior e o atual.
+    Simulation simulation;
+    Simulation_Init(&simulation, SIMULATION_RATE, [&](float step){
+        MovementSystem(&g_World, g_PlayerInput, step);
+        CollisionSystem(&g_World, &terrain, &collision_grid, static_colliders, config.streaming ? &stream : NULL, &jobs);
+        ChoppingSystem(&g_World, g_PlayerInput, step, &terrain, &target_bvh, static_colliders, &transforms, stump_object);
+        AnimationSystem(&g_World, g_PlayerInput, step, &jobs);
+        QuestSystem(&g_World, &terrain);
+    });
+    Simulation_Start(&simulation, simulation_thread);
+
+    // Contador de fragmentos que passaram no teste de profundidade durante o
+    // passo de shading. São usadas duas queries alternadas para que o
+    // resultado do quadro anterior seja lido sem bloquear a CPU.
+    GLuint fragment_queries[2];
+    bool fragment_query_issued[2] = {false, false};
+    int fragment_query_index = 0;
+    GLuint shaded_fragments = 0;
+    glGenQueries(2, fragment_queries);
+
+    // Textos do HUD, reaproveitados na ordem dos textos de cada pacote. O
+    // layout de cada um só é refeito quando o seu conteúdo, posição, escala ou
+    // o tamanho da janela mudam.
+    std::vector<int> text_objects;
+
+    // Framebuffer em que os quadros são desenhados: o da janela ou, sem
+    // janela, o criado por Headless_Init()
+    GLuint target_framebuffer = headless ? offscreen.framebuffer : 0;
+
+    // Renderização de um pacote de quadro (veja framepacket.h). Com a thread de
+    // renderização, esta é a única parte do laço que usa o contexto OpenGL, e
+    // ela lê apenas o pacote: nunca o estado do jogo.
+    FrameQueue frame_queue;
+    FrameQueue_Init(&frame_queue, [&](const FramePacket* packet, RenderStats* stats){
+        // Os programas e as posições das variáveis uniformes só mudam aqui,
+        // na thread que os usa
+        if(packet->reload_shaders){
+            LoadShadersFromFiles();
+            fprintf(stdout,"Shaders recarregados!\n");
+            fflush(stdout);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, target_framebuffer);
+        glViewport(0, 0, packet->framebuffer_width, packet->framebuffer_height);
+        glClearColor(0.433, 0.773, 0.984, 1.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glUseProgram(program_id);
+
+        glUniformMatrix4fv(view_uniform       , 1 , GL_FALSE , glm::value_ptr(packet->view));
+        glUniformMatrix4fv(projection_uniform , 1 , GL_FALSE , glm::value_ptr(packet->projection));
+        glUniform1f(time_uniform, packet->time);
+
+        // Monta as listas de luzes de cada cluster do frustum e as envia para a GPU
+        float slice_scale = CLUSTER_GRID_Z / log(packet->far_distance/packet->near_distance);
+        LightClusters_SetProjection(&light_clusters, packet->field_of_view, packet->aspect, packet->near_distance, packet->far_distance);
+        Profiler_Begin("Clusters de luz");
+        LightClusters_Build(&light_clusters, packet->lights, packet->view, &jobs);
+        Profiler_End();
+        LightClusters_Upload(&light_clusters, 6);
+        glUniform2f(cluster_tile_size_uniform, (float)packet->framebuffer_width/CLUSTER_GRID_X, (float)packet->framebuffer_height/CLUSTER_GRID_Y);
+        glUniform2f(cluster_slice_params_uniform, slice_scale, -slice_scale*log(packet->near_distance));
+
+        // Desenha os shadow maps do sol com o programa do pré-passo de profundidade
+        ShadowCascades_Update(&shadows, packet->sun_direction, packet->view, packet->field_of_view, packet->aspect, packet->near_distance, packet->scene_version);
+        glUseProgram(depth_program_id);
+        glUniform1f(depth_time_uniform, packet->time);
+        ShadowCascades_Render(&shadows, packet->casters, depth_model_uniform, depth_wind_uniform, depth_view_uniform, depth_projection_uniform);
+        glBindFramebuffer(GL_FRAMEBUFFER, target_framebuffer);
+        glViewport(0, 0, packet->framebuffer_width, packet->framebuffer_height);
+        glUseProgram(program_id);
+
+        glUniform4f(light_direction_uniform, packet->sun_direction.x, packet->sun_direction.y, packet->sun_direction.z, 0.0f);
+        glUniformMatrix4fv(shadow_matrices_uniform, SHADOW_CASCADES, GL_FALSE, glm::value_ptr(shadows.shadow_matrix[0]));
+        glUniform4fv(cascade_splits_uniform, 1, shadows.splits);
+        glUniform4fv(cascade_texel_size_uniform, 1, shadows.texel_size);
+        glActiveTexture(GL_TEXTURE9);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shadows.depth_texture);
+        glActiveTexture(GL_TEXTURE0);
+
+        // Os objetos visíveis já vêm ordenados da frente para trás
+        if(packet->depth_prepass){
+            Profiler_Begin("Pré-passo de profundidade");
+            // Pré-passo: preenche apenas o Z-buffer, sem escrever cores
+            glUseProgram(depth_program_id);
+            glUniformMatrix4fv(depth_view_uniform       , 1 , GL_FALSE , glm::value_ptr(packet->view));
+            glUniformMatrix4fv(depth_projection_uniform , 1 , GL_FALSE , glm::value_ptr(packet->projection));
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            DrawOpaqueItems(packet->visible, true);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            Profiler_End();
+
+            // Passo de shading: só o fragmento visível de cada pixel passa no teste
+            glUseProgram(program_id);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+
+        // Lê (sem bloquear) o contador do quadro em que esta query foi usada pela última vez
+        if(fragment_query_issued[fragment_query_index]){
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(fragment_queries[fragment_query_index], GL_QUERY_RESULT_AVAILABLE, &available);
+            if(available)
+                glGetQueryObjectuiv(fragment_queries[fragment_query_index], GL_QUERY_RESULT, &shaded_fragments);
+        }
+
+        Profiler_Begin("Objetos opacos");
+        glBeginQuery(GL_SAMPLES_PASSED, fragment_queries[fragment_query_index]);
+        DrawOpaqueItems(packet->visible, false);
+        glEndQuery(GL_SAMPLES_PASSED);
+        Profiler_End();
+        fragment_query_issued[fragment_query_index] = true;
+        fragment_query_index = 1 - fragment_query_index;
+
+        if(packet->depth_prepass){
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+        }
+
+        // Textos do HUD
+        for(int t=0; t<packet->num_texts; t++){
+            if(t == (int)text_objects.size())
+                text_objects.push_back(TextRendering_CreateText());
+            const FrameText &text = packet->texts[t];
+            TextRendering_UpdateText(packet->window_width, packet->window_height, text_objects[t], text.text, text.x, text.y, text.scale);
+            TextRendering_DrawText(text_objects[t]);
+        }
+
+        if(headless)
+            Headless_EndFrame(&offscreen);
+        else
+            glfwSwapBuffers(window);
+
+        // Estatísticas mostradas no HUD de um próximo quadro
+        stats->shaded_fragments = shaded_fragments;
+        for(int c=0; c<SHADOW_CASCADES; c++){
+            stats->shadow_splits[c] = shadows.splits[c];
+            stats->shadow_draws[c] = shadows.draws[c];
+            stats->shadow_static_renders[c] = shadows.static_renders[c];
+        }
+    });
+
+    // Com a thread de renderização, o contexto OpenGL passa para ela
+    FrameQueue_Start(&frame_queue, render_thread, [&](bool attach){
+        if(headless)
+            Headless_MakeCurrent(&offscreen, attach);
+        else
+            glfwMakeContextCurrent(attach ? window : NULL);
+        if(attach){
+            Profiler_SetGpuThread();
+            if(!headless)
+                FramePacing_ApplySwapInterval(&pacer);
+        }
+    });
+
+    // Ficamos em loop, montando um pacote por quadro, até que o usuário feche a
+    // janela ou, sem janela, até o número de quadros pedido
+    long long submitted_frames = 0;
+    if(headless)
+        Headless_StartTiming(&offscreen);
+    while (headless ? submitted_frames < headless_frames : (!glfwWindowShouldClose(window))||(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS))
+    {
+        Profiler_BeginFrame();
+
+        // Espera o pacote anterior começar a ser desenhado antes de ler a
+        // entrada do usuário, para que ela seja a mais recente possível
+        Profiler_Begin("Espera da renderização");
+        FramePacket* packet = FrameQueue_BeginWrite(&frame_queue);
+        Profiler_End();
+        FramePacket_Clear(packet);
+        packet->frame = Profiler_Frame();
+
+        if(headless){
+            packet->framebuffer_width = packet->window_width = headless_width;
+            packet->framebuffer_height = packet->window_height = headless_height;
+        }else{
+            glfwGetFramebufferSize(window, &packet->framebuffer_width, &packet->framebuffer_height);
+            glfwGetWindowSize(window, &packet->window_width, &packet->window_height);
+        }
+        float lineheight = TextRendering_LineHeight(packet->window_width, packet->window_height);
+        float charwidth = TextRendering_CharWidth(packet->window_width, packet->window_height);
+
+        // Câmera
+        r = g_CameraDistance;
+        y = r*sin(g_CameraPhi);
+        z = r*cos(g_CameraPhi)*cos(g_CameraTheta);
+        x = r*cos(g_CameraPhi)*sin(g_CameraTheta);
+
+        // Animação baseada no tempo. Sem janela o tempo de jogo avança um
+        // sexagésimo de segundo por quadro, para que execuções diferentes
+        // desenhem os mesmos quadros.
+        dt1 = headless ? submitted_frames/60.0 : glfwGetTime();
+        dt = (float)(dt1 - dt0);
+
+        // Entrada do usuário. O movimento do jogador, as colisões e o corte
+        // das árvores acontecem nos passos da simulação (veja MovementSystem()).
+        Simulation_Lock(&simulation);
+        if(headless || (start_game && !camera_type))
+            g_PlayerInput = PlayerInput(); // Sem janela ou durante a "cut-scene", sem controle
+        else
+            getUserInput(window, x, y, z);
+        packet->input_time = FrameQueue_Now();
+
+        // Só o estado é copiado aqui; a gravação é feita pela thread do SaveWriter
+        if(save_requested){
+            SaveGame_Init(&save, config.seed, trees.count);
+            SnapshotGame(&g_World, first_tree, &save);
+            SaveWriter_Submit(&save_writer, &save);
+            save_requested = false;
+        }
+        Simulation_Unlock(&simulation);
+
+        Profiler_Begin("Simulação");
+        Simulation_Advance(&simulation, dt);
+        Profiler_End();
+
+        // A partir daqui até a montagem da lista de desenho o estado do jogo é
+        // lido, então a simulação fica travada
+        Simulation_Lock(&simulation);
+
+        // Posição do jogador interpolada entre os dois últimos passos da simulação
+        const MotionComponent* player_motion = Ecs_Get<MotionComponent>(&g_World, g_Player, COMPONENT_MOTION);
+        const PlayerComponent* player = Ecs_Get<PlayerComponent>(&g_World, g_Player, COMPONENT_PLAYER);
+        glm::vec2 player_position = glm::mix(player_motion->previous, player_motion->position, (float)Simulation_Alpha(&simulation));
+
+        // Recebe os pedaços do mundo prontos e pede os que faltam em volta do
+        // jogador. Como os pedaços são objetos estáticos, o cache das sombras
+        // é refeito quando algum deles entra ou sai.
+        if(config.streaming){
+            Profiler_Begin("Pedaços do mundo");
+            if(WorldStream_Update(&stream, player_motion->position.x, player_motion->position.y))
+                static_scene_version++;
+            Profiler_End();
+        }
+
+        // Aguarda o usuário iniciar o jogo pressionando ENTER
+        if(start_game){
+            SplineAgents_Advance(&chickens, dt);
+
+            if(!camera_type){
+                // Câmera look-at da "cut-scene"
+                // Curva de Bezier para a câmera
+                if(!camera_path_built){
+                    glm::vec3 camera_points[4] = {glm::vec3(62.26f, 15.0f, -49.71f),
+                                                  glm::vec3(37.03f, 7.0f,  -40.22f),
+                                                  glm::vec3(12.83f, 5.0f,  -34.03f),
+                                                  glm::vec3(player_motion->position.x, player_eye_height, player_motion->position.y - 1)};
+                    SplinePath_Build(&camera_path, SPLINE_BEZIER, camera_points, 4);
+                    camera_path_built = true;
+                }
+                camera_distance += dt*0.1f*camera_path.length;
+                glm::vec3 camera_point = SplinePath_PositionAt(&camera_path, camera_distance);
+
+                camera_position_c = glm::vec4(camera_point.x, camera_point.y, camera_point.z, 1.0f);
+                camera_view_vector = glm::vec4(player_motion->position.x, player_eye_height, player_motion->position.y, 1.0f) - camera_position_c;
+
+                if(camera_distance >= camera_path.length){
+                    camera_type = true;
+
+                    g_CameraTheta = -12.63;
+                    g_CameraPhi =  0.06;
+                }
+            }
+            else{
+                // Câmera livre
+                camera_position_c = glm::vec4(player_position.x, Terrain_Height(&terrain, player_position.x, player_position.y) + player->eye_height, player_position.y, 1.0f);
+                camera_view_vector = glm::vec4(x, -y, z, 0.0f);
+            }
+        }
+
+        glm::mat4 view = Matrix_Camera_View(camera_position_c,
+                                            camera_view_vector,
+                                            camera_up_vector);
+
+        glm::mat4 projection;
+
+        float nearplane = -0.1f;  // Posição do "near plane"
+        float farplane  = -400.0f; // Posição do "far plane"
+
+        // Projeção Perspectiva.
+        float field_of_view = 3.141592 / 3.0f;
+        projection = Matrix_Perspective(field_of_view, g_ScreenRatio, nearplane, farplane);
+
+        packet->view = view;
+        packet->projection = projection;
+        packet->field_of_view = field_of_view;
+        packet->aspect = g_ScreenRatio;
+        packet->near_distance = -nearplane;
+        packet->far_distance = -farplane;
+        packet->time = (float)dt1;
+        packet->sun_direction = sun_direction;
+
+        // Chamas tremulando: cada luz oscila com uma fase diferente
+        for(size_t i=0; i<point_lights.size(); i++)
+            point_lights[i].intensity = light_base_intensity[i]*(0.85f + 0.1f*sin(9.0f*dt1 + 1.7f*i) + 0.05f*sin(23.0f*dt1 + 0.9f*i));
+        packet->lights = point_lights;
+
+        // Os objetos opacos não são desenhados imediatamente: eles são
+        // acumulados na lista de desenho do pacote, ordenados da frente para
+        // trás e desenhados de uma vez pela renderização. Veja DrawOpaqueItems().
+        DrawList* opaque_list = &packet->casters;
+
+        // Atualiza a hierarquia de transformações: só as matrizes dos objetos
+        // que se moveram desde o último quadro (e dos seus filhos) são
+        // recalculadas
+        Profiler_Begin("Transformações");
+
+        int i;
+
+        // As três galinhas balançam e giram juntas, viradas para a direção do movimento
+        float chicken_yaw = atan2(chickens.heading_z[0], -chickens.heading_x[0]);
+        Affine chicken_rotation = Affine_Multiply(Affine_Rotate_X(sin(8*dt1)*0.05),
+                                                  Affine_TRS(glm::vec3(0.0f), chicken_yaw, 0.0f, 0.0f, glm::vec3(0.03f)));
+        Transforms_SetLocal(&transforms, flock_node, Affine_Translate(chickens.x[0], 0.1f, chickens.z[0]));
+        Transforms_SetLocal(&transforms, chick_anchor_nodes[0], Affine_Translate(2.0f + sin(0.5*dt1)*3, 0.0f, 2.0f + sin(0.5*dt1)*3));
+        Transforms_SetLocal(&transforms, chick_anchor_nodes[1], Affine_Translate(0.5f + sin(0.5*dt1)*3, 0.0f, 0.5f + sin(0.5*dt1)*3));
+        for(int c=0; c<3; c++)
+            Transforms_SetLocal(&transforms, chicken_nodes[c], chicken_rotation);
+
+        // O machado fica à frente e abaixo da câmera, girando com ela
+        Transforms_SetLocal(&transforms, camera_node, Affine_Translate(camera_position_c.x, camera_position_c.y, camera_position_c.z));
+        Transforms_SetLocal(&transforms, axe_node, Affine_TRS(glm::vec3(x*0.1f, -0.65f, z*0.1f),
+                                                              g_CameraTheta + 90*M_PI/180.0, -20*M_PI/180.0, player->axe_angle*M_PI/180.0,
+                                                              glm::vec3(0.002f)));
+
+        int updated_transforms = Transforms_Update(&transforms);
+        const std::vector<glm::mat4> &world = transforms.world_matrix;
+        Profiler_End();
+
+        // Desenha os pedaços do terreno em volta da câmera, até o far plane
+        Profiler_Begin("Terreno");
+        Terrain_SelectPatches(&terrain, camera_position_c.x, camera_position_c.z, -farplane, terrain_lod_distance, &terrain_patches, terrain_lod_counts);
+        for(i=0; i<(int)terrain_patches.size(); i++){
+            const TerrainPatch &patch = terrain_patches[i];
+            DrawList_Add(opaque_list, &terrain.patch_objects[patch.lod][patch.stitch], patch.model, TERRAIN, DRAW_LAYER_BACKGROUND);
+        }
+        Profiler_End();
+
+        // Desenha as árvores (ou os seus tocos), as decorações, as pedras e os
+        // troncos, todos entidades com os componentes de transformação e de
+        // desenho, e a árvore gigante do meio do mapa
+        RenderExtractionSystem(&g_World, opaque_list, world, &jobs);
+
+        // Desenha as árvores e as decorações dos pedaços do mundo carregados
+        if(config.streaming){
+            for(std::map<long long, WorldChunk*>::const_iterator it = stream.resident.begin(); it != stream.resident.end(); ++it){
+                const WorldChunk* chunk = it->second;
+                for(i=0; i<chunk->trees.count; i++){
+                    glm::vec2 wind = glm::vec2(wind_wavelength*(chunk->trees.x[i] + chunk->trees.z[i]), tree_wind);
+                    DrawList_Add(opaque_list, tree_objects[chunk->trees.type[i]], chunk->colliders[i].model, TREES, DRAW_LAYER_DEFAULT, false, wind);
+                }
+                for(i=0; i<chunk->decorations.count; i++){
+                    glm::vec2 wind = glm::vec2(wind_wavelength*(chunk->decorations.x[i] + chunk->decorations.z[i]), plant_wind);
+                    DrawList_Add(opaque_list, decoration_objects[chunk->decorations.type[i]], chunk->decoration_matrices[i], TREES, DRAW_LAYER_DEFAULT, false, wind);
+                }
+            }
+        }
+
+        // Desenha as galinhas
+        for(int c=0; c<3; c++)
+            for(int part=0; part<5; part++)
+                DrawList_Add(opaque_list, chicken_objects[c][part], world[chicken_nodes[c]], chicken_part_ids[part], DRAW_LAYER_DEFAULT, true);
+
+        // Desenha o machado apenas caso o jogo já tenha começado
+        // Ou seja, quando está na câmera livre
+        if(camera_type){
+            for(int part=0; part<3; part++)
+                DrawList_Add(opaque_list, axe_objects[part], world[axe_node], AXE, DRAW_LAYER_DEFAULT, true);
+        }
+
+        // Desenha o NPC (cavaleiro)
+        DrawList_Add(opaque_list, knight_object, world[knight_node], CHARACTER);
+        DrawList_Add(opaque_list, capa_object, world[capa_node], CHARACTER_CAPA, DRAW_LAYER_DEFAULT, true,
+                     glm::vec2(wind_wavelength*(-4.0f - 10.0f), tree_wind));
+
+        // Desenha a fogueira
+        DrawList_Add(opaque_list, stones_object, world[stones_node], TREES);
+        for(i=0; i<2; i++)
+            DrawList_Add(opaque_list, branch_object, world[campfire_branch_nodes[i]], TREES);
+
+        // Desenha as tochas
+        for(i=0; i<n_torches; i++)
+            DrawList_Add(opaque_list, branch_object, world[torch_nodes[i]], TREES);
+
+        packet->scene_version = static_scene_version;
+        Simulation_Unlock(&simulation);
+
+        // Descarta os objetos fora do campo de visão e ordena os demais da
+        // frente para trás. A lista completa fica no pacote para as sombras,
+        // que também precisam dos objetos fora da tela.
+        Profiler_Begin("Culling e ordenação");
+        packet->visible.items = packet->casters.items;
+        int drawn_objects = (int)packet->visible.items.size();
+        int culled_objects = DrawList_CullFrustum(&packet->visible, projection*view, &jobs);
+        DrawList_SortFrontToBack(&packet->visible, view, &jobs);
+        packet->depth_prepass = depth_prepass;
+        packet->reload_shaders = reload_shaders_requested;
+        reload_shaders_requested = false;
+        Profiler_End();
+
+        // Resultados de um quadro já desenhado, para o HUD
+        RenderStats render_stats;
+        FrameQueue_Stats(&frame_queue, &render_stats);
+
+        // Textos que mostram o estado do jogo, lido com a simulação travada
+        Simulation_Lock(&simulation);
+        const QuestComponent* quest = Ecs_Get<QuestComponent>(&g_World, g_Player, COMPONENT_QUEST);
+
+        // Objeto sob o cursor, mostrado pelo profiler
+        char picked_text[80] = "Sob o cursor: nada";
+        if(show_profiler){
+            glm::vec3 pick_origin, pick_direction;
+            BvhHit picked;
+            GetPickingRay(window, view, projection, &pick_origin, &pick_direction);
+            if(Bvh_Raycast(&target_bvh, pick_origin, pick_direction, -farplane, &picked))
+                snprintf(picked_text, 80, "Sob o cursor: %s %d a %.1f m", collider_names[picked.type],
+                         picked.type == COLLIDER_NPC ? 0 : static_colliders[picked.index].index, picked.distance);
+        }
+
+        // Mensagem da Quest, quando o jogador está perto do NPC
+        if(quest->near_npc){
+            for(int line=0; line<3; line++){
+                const char* text = monolog_text[line+(quest->level*3)];
+                FramePacket_AddText(packet, text, 0.0f-UTF8_Length(text)*charwidth*1.2f/2, -1.0f+0.05f+0.24f-0.08f*line-lineheight*1.2f, 1.2f);
+            }
+        }
+
+        // Quest
+        if(quest->level >= 1 && quest->level <= 3){
+            const char* quest_text[3] = {"Quest: cortar 3 árvores", "Quest: cortar 5 árvores", "Quest: cortar 10 árvores"};
+            FramePacket_AddText(packet, quest_text[quest->level-1], -0.99f, 1.0f-lineheight-0.06f, 1.0f);
+        }
+
+        // Número de árvores cortadas durante a Quest
+        sprintf(broken,"%d", quest->felled);
+        FramePacket_AddText(packet, "Árvores cortadas: ", -0.99f, 1.0f-lineheight, 1.0f);
+        FramePacket_AddText(packet, broken, -0.99f+UTF8_Length("Árvores cortadas: ")*charwidth*1.0f, 1.0f-lineheight-0.0025f, 1.0f);
+
+        // Delay de quebrar a árvore
+        FramePacket_AddText(packet, delay_left, UTF8_Length(delay_left)*charwidth*1.0f/2, 0.0f, 1.0f);
+
+        Simulation_Unlock(&simulation);
+
+        // Enquanto o jogo não começar, mostra uma tela inicial
+        // A escala pulsa a cada quadro, então apenas estes textos têm o layout refeito continuamente
+        if(!camera_type && !start_game){
+            float title_scale = 1.5f*(abs(sin(dt1))+0.3f);
+            FramePacket_AddText(packet, "Timberman", 0.0f-UTF8_Length("Timberman")*charwidth*title_scale/2, 0.0f+0.01f+lineheight, title_scale);
+            FramePacket_AddText(packet, "Pressione [ENTER] para jogar", 0.0f-UTF8_Length("Pressione [ENTER] para jogar")*charwidth*title_scale/2, 0.0f-0.01f-lineheight, title_scale);
+        }
+
+        // Fragmentos sombreados no último quadro e estado do pré-passo de profundidade ([P] alterna)
+        snprintf(fragments_text, 80, "Fragmentos: %u  [P] pré-passo: %s", render_stats.shaded_fragments, depth_prepass ? "ligado" : "desligado");
+        FramePacket_AddText(packet, fragments_text, -0.99f, -1.0f+lineheight/2, 1.0f);
+
+        // Profiler: tempo de CPU e GPU de cada trecho do quadro e o custo de cada cascata de sombra
+        if(show_profiler){
+            std::vector<std::string> lines;
+            char line[128];
+            Profiler_CopyScopes(&profiler_scopes);
+            for(size_t s=0; s<profiler_scopes.size(); s++){
+                if(Profiler_Frame() - profiler_scopes[s].last_frame > 60)
+                    continue; // Trecho que não executa há algum tempo (ex.: cache de sombras válido)
+                snprintf(line, 128, "%-26s CPU %6.2f ms  GPU %6.2f ms", profiler_scopes[s].name.c_str(), profiler_scopes[s].cpu_ms, profiler_scopes[s].gpu_ms);
+                lines.push_back(line);
+            }
+
+            // Thread de renderização: tempo por quadro e latência da leitura
+            // da entrada até a troca dos buffers
+            snprintf(line, 128, "Renderização%s: %.2f ms/quadro, latência média %.1f ms, máx. %.1f ms",
+                     render_thread ? " (thread própria)" : "", render_stats.render_ms, render_stats.latency_ms, render_stats.max_latency_ms);
+            lines.push_back(line);
+
+            // Ritmo dos quadros: tempo médio, variação e tempo devolvido ao
+            // sistema pelo limitador
+            FramePacingStats pacing;
+            FramePacing_Stats(&pacer, &pacing);
+            const char* vsync_names[] = {"desligada", "ligada", "adaptativa"};
+            snprintf(line, 128, "Quadro: %.2f ms, desvio %.2f ms, %.2f a %.2f ms; vsync %s",
+                     pacing.frame_ms, pacing.jitter_ms, pacing.min_ms, pacing.max_ms,
+                     pacer.swap_interval < 0 ? vsync_names[VSYNC_ADAPTIVE] : vsync_names[pacer.swap_interval ? VSYNC_ON : VSYNC_OFF]);
+            lines.push_back(line);
+            if(pacer.target_rate > 0.0){
+                snprintf(line, 128, "  limite %.0f fps: %.2f ms dormindo, %.2f ms em spin", pacer.target_rate, pacing.sleep_ms, pacing.spin_ms);
+                lines.push_back(line);
+            }
+
+            // Tarefas: soma dos tempos em todas as threads e a mais longa
+            Profiler_CopyJobs(&profiler_jobs);
+            snprintf(line, 128, "Tarefas: %d threads, %d executadas, %d roubadas", jobs.num_threads, jobs.executed.load(), jobs.steals.load());
+            lines.push_back(line);
+            for(size_t j=0; j<profiler_jobs.size(); j++){
+                if(Profiler_Frame() - profiler_jobs[j].last_frame > 60)
+                    continue;
+                snprintf(line, 128, "  %-24s CPU %6.2f ms em %4.1f, máx. %5.2f ms", profiler_jobs[j].name.c_str(), profiler_jobs[j].cpu_ms, profiler_jobs[j].jobs, profiler_jobs[j].max_ms);
+                lines.push_back(line);
+            }
+            for(int c=0; c<SHADOW_CASCADES; c++){
+                snprintf(line, 128, "Cascata %d: até %.0f m, %d objetos%s", c, render_stats.shadow_splits[c], render_stats.shadow_draws[c],
+                         c >= SHADOW_CACHED_FIRST ? " dinâmicos" : "");
+                lines.push_back(line);
+                if(c >= SHADOW_CACHED_FIRST){
+                    snprintf(line, 128, "  redesenhos do cache estático: %d", render_stats.shadow_static_renders[c]);
+                    lines.push_back(line);
+                }
+            }
+
+            snprintf(line, 128, "Objetos visíveis: %d de %d", drawn_objects - culled_objects, drawn_objects);
+            lines.push_back(line);
+            snprintf(line, 128, "Matrizes recalculadas: %d de %d", updated_transforms, (int)transforms.parent.size());
+            lines.push_back(line);
+            int length = snprintf(line, 128, "Terreno: %d pedaços, por nível:", (int)terrain_patches.size());
+            for(int lod=0; lod<TERRAIN_LODS; lod++)
+                length += snprintf(line + length, 128 - length, " %d", terrain_lod_counts[lod]);
+            lines.push_back(line);
+            if(config.streaming){
+                snprintf(line, 128, "Pedaços do mundo: %d carregados, %d pedidos, %.1f de %d MB",
+                         (int)stream.resident.size(), (int)stream.pending.size(), stream.resident_bytes/(1024.0*1024.0), config.chunk_budget_mb);
+                lines.push_back(line);
+                snprintf(line, 128, "  latência: média %.1f ms, máxima %.1f ms; %lld carregados, %lld descartados",
+                         stream.loads ? stream.total_load_ms/stream.loads : 0.0, stream.max_load_ms, stream.loads, stream.evictions);
+                lines.push_back(line);
+            }
+            {
+                std::lock_guard<std::mutex> lock(save_writer.mutex);
+                snprintf(line, 128, "Jogo salvo [F5]: %d gravações, %.1f KB em %.1f ms", save_writer.writes, save_writer.last_bytes/1024.0, save_writer.last_ms);
+            }
+            lines.push_back(line);
+            lines.push_back(picked_text);
+
+            for(size_t l=0; l<lines.size(); l++)
+                FramePacket_AddText(packet, lines[l].c_str(), -0.99f, 1.0f-(3+l)*lineheight*0.8f, 0.8f);
+        }
+
+        // FPS
+        TextRendering_ShowFramesPerSecond(packet);
+
+        Jobs_ResetStats(&jobs);
+
+        // Entrega o pacote para ser desenhado (sem thread, desenha agora) e
+        // espera a hora do próximo quadro antes de ler os eventos
+        FrameQueue_Submit(&frame_queue);
+        Profiler_Begin("Limite de quadros");
+        FramePacing_Wait(&pacer);
+        Profiler_End();
+        if(!headless)
+            glfwPollEvents();
+        submitted_frames += 1;
+
+        // Atualiza o dt0 com o novo "passo" do glfwGetTime()
+        dt0 = dt1;
+    }
+
+    FrameQueue_Stop(&frame_queue);
+    Simulation_Stop(&simulation);
+    Jobs_Shutdown(&jobs);
+    if(config.streaming)
+        WorldStream_Stop(&stream);
+
+    // Salva o jogo ao sair, esperando a gravação terminar
+    if(!headless){
+        SaveGame_Init(&save, config.seed, trees.count);
+        SnapshotGame(&g_World, first_tree, &save);
+        SaveWriter_Submit(&save_writer, &save);
+    }
+    SaveWriter_Stop(&save_writer);
+
+    // Sem janela, mostra os tempos dos quadros e de cada trecho do último
+    // quadro medido, e grava a imagem final se pedida
+    if(headless){
+        Headless_PrintStats(&offscreen);
+        Profiler_CopyScopes(&profiler_scopes);
+        for(size_t s=0; s<profiler_scopes.size(); s++)
+            printf("  %-26s CPU %6.2f ms  GPU %6.2f ms\n", profiler_scopes[s].name.c_str(), profiler_scopes[s].cpu_ms, profiler_scopes[s].gpu_ms);
+        if(headless_image && Headless_SaveImage(&offscreen, headless_image))
+            printf("Headless: último quadro gravado em \"%s\"\n", headless_image);
+        Headless_Shutdown(&offscreen);
+        return 0;
+    }
+
+    // Finalizamos o uso dos recursos do sistema operacional
+    glfwTerminate();
+
+    // Fim do programa
+    return 0;
+}
+
+// Centro (x, z) e raio do círculo que contém a base de um objeto de
+// g_VirtualScene, na escala 1
+void getFootprint(const char* object_name, glm::vec2* center, float* radius){
+
+    const SceneObject &object = g_VirtualScene[object_name];
+    *center = 0.5f*glm::vec2(object.bbox_min.x + object.bbox_max.x, object.bbox_min.z + object.bbox_max.z);
+    *radius = 0.5f*glm::length(glm::vec2(object.bbox_max.x - object.bbox_min.x, object.bbox_max.z - object.bbox_min.z));
+}
+
+// Input do usuário e rotações da câmera e de alguns objetos
+void getUserInput(GLFWwindow* window, float x, float y, float z){
+
+    // Movimento (aplicado nos passos da simulação, veja MovementSystem())
+    g_PlayerInput.backward = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    g_PlayerInput.forward  = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    g_PlayerInput.right    = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    g_PlayerInput.left     = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    g_PlayerInput.view_x   = x;
+    g_PlayerInput.view_y   = -y;
+    g_PlayerInput.view_z   = z;
+
+    // Início do jogo
+    if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS){
+        start_game = true;
+    }
+
+    // Aceitar Quest
+    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS){
+        Ecs_Get<QuestComponent>(&g_World, g_Player, COMPONENT_QUEST)->accepted = true;
+    }
+
+    // Liga/desliga o pré-passo de profundidade (apenas na transição da tecla)
+    bool prepass_key = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+    if (prepass_key && !depth_prepass_key_pressed){
+        depth_prepass = !depth_prepass;
+    }
+    depth_prepass_key_pressed = prepass_key;
+
+    // Mostra/esconde o profiler
+    bool profiler_key = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (profiler_key && !show_profiler_key_pressed){
+        show_profiler = !show_profiler;
+    }
+    show_profiler_key_pressed = profiler_key;
+
+    // Salva o jogo
+    bool save_key = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+    if (save_key && !save_key_pressed){
+        save_requested = true;
+    }
+    save_key_pressed = save_key;
+
+    // Recarregar os shaders em tempo de execução. A thread do quadro pode não
+    // ter o contexto OpenGL, então o pedido vai no pacote (veja a renderização)
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS)
+        reload_shaders_requested = true;
+
+    // Cortar a árvore com o botão esquerdo
+    g_PlayerInput.chop = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+
+    // Movimentação de corrida (aumenta a velocidade)
+    g_PlayerInput.run = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS && g_PlayerInput.forward;
+
+    // Fechar a tela
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS){
+        glfwSetWindowShouldClose(window, GL_TRUE);
+    }
+}
+
+// Cria um objeto do mapa com os componentes de "mask", que precisam incluir
+// os de transformação e de desenho
+EcsEntity SpawnMapObject(EcsWorld* world, EcsMask mask, int node, const glm::vec3 &position, float scale,
+                         const SceneObject* object, int object_id, const glm::vec2 &wind){
+
+    EcsEntity entity = Ecs_Create(world, mask);
+
+    TransformComponent* transform = Ecs_Get<TransformComponent>(world, entity, COMPONENT_TRANSFORM);
+    transform->position = position;
+    transform->scale = scale;
+    transform->node = node;
+
+    RenderComponent* render = Ecs_Get<RenderComponent>(world, entity, COMPONENT_RENDER);
+    render->object = object;
+    render->object_id = object_id;
+    render->layer = DRAW_LAYER_DEFAULT;
+    render->dynamic = false;
+    render->wind = wind;
+
+    return entity;
+}
+
+// Move o jogador no plano XZ de acordo com a entrada
+void MovementSystem(EcsWorld* world, const PlayerInput &input, float step){
+
+    EcsMask required = ECS_BIT(COMPONENT_MOTION) | ECS_BIT(COMPONENT_PLAYER);
+    glm::vec2 view = glm::vec2(input.view_x, input.view_z);
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, required))
+            continue;
+
+        MotionComponent* motion = Ecs_Column<MotionComponent>(archetype, COMPONENT_MOTION);
+        for(int e=0; e<archetype->count; e++){
+            motion[e].previous = motion[e].position;
+
+            // Movimentação de corrida (aumenta a velocidade)
+            motion[e].speed = input.run ? 7.5f : default_speed;
+            float distance = step*motion[e].speed;
+
+            // Para frente e para trás na direção da câmera, e para os lados
+            // na direção perpendicular a ela
+            if (input.backward)
+                motion[e].position -= distance*view;
+            if (input.forward)
+                motion[e].position += distance*view;
+            if (input.right)
+                motion[e].position += distance*glm::vec2(-view.y, view.x);
+            if (input.left)
+                motion[e].position += distance*glm::vec2(view.y, -view.x);
+        }
+    }
+}
+
+// Colisão da cápsula do jogador com as malhas dos objetos sólidos do mapa e
+// com o NPC
+void CollisionSystem(EcsWorld* world, const Terrain* terrain, const SpatialGrid* grid, const std::vector<CollisionInstance> &colliders,
+                     const WorldStream* stream, JobSystem* jobs){
+
+    EcsMask required = ECS_BIT(COMPONENT_MOTION) | ECS_BIT(COMPONENT_PLAYER);
+
+    // Colisores perto do jogador, testados em paralelo em grupos de
+    // collision_grain; cada tarefa guarda o contato mais profundo do seu grupo
+    std::vector<const CollisionInstance*> candidates;
+    std::vector<CollisionContact> job_deepest;
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, required))
+            continue;
+
+        MotionComponent* motion = Ecs_Column<MotionComponent>(archetype, COMPONENT_MOTION);
+        const PlayerComponent* player = Ecs_Column<PlayerComponent>(archetype, COMPONENT_PLAYER);
+        for(int e=0; e<archetype->count; e++){
+            glm::vec2 &position = motion[e].position;
+
+            // A cada iteração o jogador é empurrado, no plano XZ, para fora do
+            // contato mais profundo; como só a parte do movimento contra a
+            // superfície é desfeita, o jogador desliza ao longo dela. Se o
+            // contato não se resolve, o movimento do passo é desfeito.
+            for(int iteration=0; ; iteration++){
+                CollisionCapsule capsule;
+                float ground = Terrain_Height(terrain, position.x, position.y);
+                capsule.a = glm::vec3(position.x, ground + player_radius + player_step_height, position.y);
+                capsule.b = glm::vec3(position.x, ground + player[e].eye_height, position.y);
+                capsule.radius = player_radius;
+
+                // As árvores cortadas continuam na grade, mas deixam de ser sólidas
+                candidates.clear();
+                int num_colliders;
+                const int* cells = SpatialGrid_Query(grid, position.x, position.y, &num_colliders);
+                for(int c=0; c<num_colliders; c++){
+                    const CollisionInstance &collider = colliders[grid->items[cells[c]].index];
+                    if(Ecs_Mask(world, Ecs_FromIndex(world, collider.index)) & ECS_BIT(COMPONENT_SOLID))
+                        candidates.push_back(&collider);
+                }
+
+                // Árvores dos pedaços gerados sob demanda. Cada pedaço tem a sua
+                // grade; um colisor de um pedaço vizinho pode alcançar o jogador
+                // perto da borda.
+                if(stream){
+                    for(int dz=-1; dz<=1; dz++)
+                        for(int dx=-1; dx<=1; dx++){
+                            const WorldChunk* chunk = WorldStream_Find(stream, position.x, position.y, dx, dz);
+                            if(!chunk)
+                                continue;
+                            cells = SpatialGrid_Query(&chunk->collision_grid, position.x, position.y, &num_colliders);
+                            for(int c=0; c<num_colliders; c++)
+                                candidates.push_back(&chunk->colliders[chunk->collision_grid.items[cells[c]].index]);
+                        }
+                }
+
+                int num_candidates = (int)candidates.size();
+                job_deepest.assign((num_candidates + collision_grain - 1)/collision_grain, CollisionContact());
+                Jobs_ParallelFor(jobs, "Colisões", num_candidates, collision_grain, [&](int begin, int end){
+                    CollisionContact group_deepest = CollisionContact();
+                    for(int c=begin; c<end; c++){
+                        CollisionContact contact;
+                        if(Collision_CapsuleMesh(candidates[c], capsule, &contact) && contact.depth > group_deepest.depth)
+                            group_deepest = contact;
+                    }
+                    job_deepest[begin/collision_grain] = group_deepest;
+                });
+
+                // Os grupos são combinados na ordem dos colisores, então o
+                // resultado não depende de qual thread terminou antes
+                CollisionContact deepest = CollisionContact();
+                for(size_t j=0; j<job_deepest.size(); j++)
+                    if(job_deepest[j].depth > deepest.depth)
+                        deepest = job_deepest[j];
+
+                if(deepest.depth <= 0.0f)
+                    break;
+
+                // Superfícies quase horizontais (ex.: o topo de uma pedra) não
+                // têm como ser evitadas andando no plano XZ
+                glm::vec2 push = glm::vec2(deepest.normal.x, deepest.normal.z);
+                float push_length = glm::length(push);
+                if(iteration == collision_passes || push_length < 0.1f){
+                    position = motion[e].previous;
+                    break;
+                }
+
+                float distance = std::min(deepest.depth/push_length, 2.0f*player_radius) + 0.001f;
+                position += push/push_length*distance;
+            }
+
+            // Colisão ponto-esfera entre o jogador e o NPC
+            glm::vec4 eye = glm::vec4(position.x, Terrain_Height(terrain, position.x, position.y) + player[e].eye_height, position.y, 1.0f);
+            if(pointSphereCollision(eye,
+                                    glm::vec3(3.04f, 2.5f, -10.26f),
+                                    2.0f)){
+
+                position = motion[e].previous;
+            }
+        }
+    }
+}
+
+// Árvore cortada em um passo da simulação
+struct FelledTree
+{
+    EcsEntity tree;
+    glm::vec2 trunk;
+};
+
+// Mira e golpes do machado. A árvore mirada por delay_cut_tree segundos de
+// golpes é cortada: deixa de ser sólida e passa a ser desenhada como um toco.
+void ChoppingSystem(EcsWorld* world, const PlayerInput &input, float step, const Terrain* terrain, Bvh* bvh,
+                    const std::vector<CollisionInstance> &colliders, TransformTree* transforms, const SceneObject* stump_object){
+
+    EcsMask required = ECS_BIT(COMPONENT_MOTION) | ECS_BIT(COMPONENT_PLAYER);
+
+    // Mudar os componentes de uma árvore a move de arquétipo, o que pode
+    // realocar os vetores percorridos abaixo, então as árvores são cortadas
+    // depois
+    std::vector<FelledTree> felled;
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, required))
+            continue;
+
+        const MotionComponent* motion = Ecs_Column<MotionComponent>(archetype, COMPONENT_MOTION);
+        PlayerComponent* player = Ecs_Column<PlayerComponent>(archetype, COMPONENT_PLAYER);
+        QuestComponent* quest = (archetype->mask & ECS_BIT(COMPONENT_QUEST)) ? Ecs_Column<QuestComponent>(archetype, COMPONENT_QUEST) : NULL;
+        for(int e=0; e<archetype->count; e++){
+            glm::vec2 position = motion[e].position;
+
+            // Árvore para a qual o jogador está mirando, se estiver ao alcance do
+            // machado: o primeiro triângulo atingido pelo segmento da mira, entre
+            // os objetos cujas caixas o segmento toca, precisa ser de uma árvore.
+            glm::vec3 aim = glm::vec3(input.view_x, input.view_y, input.view_z);
+            if(glm::length(aim) > 0.0f){
+                glm::vec3 eye = glm::vec3(position.x, Terrain_Height(terrain, position.x, position.y) + player[e].eye_height, position.y);
+                glm::vec3 reach = eye + glm::normalize(aim)*chop_reach;
+
+                // Cabendo no vetor local, os candidatos ficam nele; senão, a
+                // busca é refeita em um vetor que cresce conforme a necessidade
+                static thread_local std::vector<int> many_candidates;
+                int buffer[64];
+                const int* candidates = buffer;
+                int num_candidates = Bvh_Overlap(bvh, glm::min(eye, reach), glm::max(eye, reach), buffer, 64);
+                if(num_candidates > 64){
+                    many_candidates.resize(num_candidates);
+                    Bvh_Overlap(bvh, glm::min(eye, reach), glm::max(eye, reach), many_candidates.data(), num_candidates);
+                    candidates = many_candidates.data();
+                }
+
+                float nearest = 2.0f;
+                const CollisionInstance* target = NULL;
+                for(int c=0; c<num_candidates; c++){
+                    const BvhItem &item = bvh->items[candidates[c]];
+                    if(item.type == COLLIDER_NPC)
+                        continue;
+
+                    float t;
+                    if(Collision_SegmentMesh(&colliders[item.index], eye, reach, &t) && t < nearest){
+                        nearest = t;
+                        target = &colliders[item.index];
+                    }
+                }
+
+                if(target){
+                    EcsEntity entity = Ecs_FromIndex(world, target->index);
+                    if(Ecs_Mask(world, entity) & ECS_BIT(COMPONENT_CHOPPABLE)){
+                        player[e].can_chop = true;
+                        player[e].target = entity;
+                    }
+                }
+            }
+
+            // Golpes enquanto o botão esquerdo está pressionado e há uma
+            // árvore ao alcance
+            sprintf(delay_left, " ");
+            player[e].chopping = input.chop && player[e].can_chop;
+            if(player[e].chopping){
+                player[e].chop_timer += step;
+
+                sprintf(delay_left, "%.1fs", (delay_cut_tree - player[e].chop_timer));
+
+                if(player[e].chop_timer >= delay_cut_tree){
+                    FelledTree tree = {player[e].target, position + glm::vec2(input.view_x, input.view_z)};
+                    felled.push_back(tree);
+                    if(quest)
+                        quest[e].felled++;
+                    player[e].can_chop = false;
+                }
+            }
+        }
+    }
+
+    for(size_t i=0; i<felled.size(); i++)
+        FellTree(world, felled[i].tree, felled[i].trunk, bvh, transforms, stump_object);
+}
+
+// Corta uma árvore no ponto "trunk": ela deixa de ser sólida e de poder ser
+// mirada, e o seu nó passa a posicionar o toco
+void FellTree(EcsWorld* world, EcsEntity tree, const glm::vec2 &trunk, Bvh* bvh, TransformTree* transforms, const SceneObject* stump_object){
+
+    if(!(Ecs_Mask(world, tree) & ECS_BIT(COMPONENT_CHOPPABLE)))
+        return;
+
+    TransformComponent* transform = Ecs_Get<TransformComponent>(world, tree, COMPONENT_TRANSFORM);
+    transform->position = glm::vec3(trunk.x + 21.0f*transform->scale, transform->position.y, trunk.y);
+    Transforms_SetLocal(transforms, transform->node, Affine_TRS(transform->position, 0.0f, 0.0f, 0.0f, glm::vec3(transform->scale)));
+
+    RenderComponent* render = Ecs_Get<RenderComponent>(world, tree, COMPONENT_RENDER);
+    render->object = stump_object;
+    render->dynamic = true;
+    render->wind = glm::vec2(0.0f);
+
+    Bvh_SetEnabled(bvh, Ecs_Get<ColliderComponent>(world, tree, COMPONENT_COLLIDER)->target, false);
+
+    Ecs_SetMask(world, tree, (Ecs_Mask(world, tree) & ~(ECS_BIT(COMPONENT_SOLID) | ECS_BIT(COMPONENT_CHOPPABLE))) | ECS_BIT(COMPONENT_FELLED));
+    Ecs_Get<FelledComponent>(world, tree, COMPONENT_FELLED)->trunk = trunk;
+
+    static_scene_version++;
+}
+
+// Copia para "save" (já iniciado com SaveGame_Init()) a posição do jogador,
+// a Quest e as árvores cortadas. Só os arquétipos de árvores cortadas são
+// percorridos, então o custo não depende do número de árvores em pé.
+void SnapshotGame(EcsWorld* world, unsigned int first_tree, SaveGame* save){
+
+    save->player_position = Ecs_Get<MotionComponent>(world, g_Player, COMPONENT_MOTION)->position;
+
+    const QuestComponent* quest = Ecs_Get<QuestComponent>(world, g_Player, COMPONENT_QUEST);
+    save->quest_level = quest->level;
+    save->quest_felled = quest->felled;
+    save->quest_accepted = quest->accepted;
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, ECS_BIT(COMPONENT_FELLED)))
+            continue;
+
+        const FelledComponent* felled = Ecs_Column<FelledComponent>(archetype, COMPONENT_FELLED);
+        for(int e=0; e<archetype->count; e++)
+            SaveGame_SetFelled(save, (int)(archetype->entities[e].index - first_tree), felled[e].trunk);
+    }
+}
+
+// Animação do machado e balanço ("Bobbing") da câmera ao andar
+void AnimationSystem(EcsWorld* world, const PlayerInput &input, float step, JobSystem* jobs){
+
+    // "Velocidade" da função seno do balanço. Enquanto o jogador encontra-se
+    // parado, é zero.
+    float mov = 0;
+    if (input.backward || input.forward || input.right || input.left)
+        mov = 6;
+    if (input.run)
+        mov = 8;
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, ECS_BIT(COMPONENT_PLAYER)))
+            continue;
+
+        // Cada entidade é animada independentemente das outras
+        PlayerComponent* player = Ecs_Column<PlayerComponent>(archetype, COMPONENT_PLAYER);
+        Jobs_ParallelFor(jobs, "Animação", archetype->count, 256, [&](int begin, int end){
+            for(int e=begin; e<end; e++){
+                // Fora dos golpes, o machado termina o movimento até voltar
+                // suavemente para a posição "parado"
+                if(!player[e].chopping){
+                    if(int(player[e].axe_angle) != 0)
+                        player[e].chop_timer += step;
+                    else{
+                        player[e].chop_timer = 0;
+                        player[e].can_chop = false;
+                    }
+                }
+                player[e].axe_angle = sin(8*player[e].chop_timer)*20;
+
+                player[e].walk_time += step;
+                player[e].eye_height = fabs(sin(mov*player[e].walk_time)*0.2)+player_eye_height;
+            }
+        });
+    }
+}
+
+// Mensagens do NPC e progressão de nível da Quest
+void QuestSystem(EcsWorld* world, const Terrain* terrain){
+
+    EcsMask required = ECS_BIT(COMPONENT_MOTION) | ECS_BIT(COMPONENT_PLAYER) | ECS_BIT(COMPONENT_QUEST);
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, required))
+            continue;
+
+        const MotionComponent* motion = Ecs_Column<MotionComponent>(archetype, COMPONENT_MOTION);
+        const PlayerComponent* player = Ecs_Column<PlayerComponent>(archetype, COMPONENT_PLAYER);
+        QuestComponent* quest = Ecs_Column<QuestComponent>(archetype, COMPONENT_QUEST);
+        for(int e=0; e<archetype->count; e++){
+            glm::vec2 position = motion[e].position;
+            glm::vec4 eye = glm::vec4(position.x, Terrain_Height(terrain, position.x, position.y) + player[e].eye_height, position.y, 1.0f);
+
+            // Outra colisão para verificar se o jogador está próximo o suficiente
+            // para mostrar as mensagens relativas a Quest
+            quest[e].near_npc = pointSphereCollision(eye,
+                                                     glm::vec3(3.04f, 2.5f, -10.26f),
+                                                     7.7f);
+
+            // Progressão de nível
+            if(quest[e].near_npc){
+                if(quest[e].level == 0 && quest[e].accepted){
+                    quest[e].level = 1;
+                    quest[e].felled = 0;
+                }
+                else if(quest[e].level == 1 && quest[e].felled >= 3){
+                    quest[e].level = 2;
+                    quest[e].felled = 0;
+                }
+                else if(quest[e].level == 2 && quest[e].felled >= 5){
+                    quest[e].level = 3;
+                    quest[e].felled = 0;
+                }
+                else if(quest[e].level == 3 && quest[e].felled >= 10){
+                    quest[e].level = 4;
+                    quest[e].felled = 0;
+                }
+            }
+        }
+    }
+}
+
+// Acrescenta à lista de desenho as entidades com os componentes de
+// transformação e de desenho. Os dois componentes de cada arquétipo são
+// percorridos em ordem, lado a lado.
+void RenderExtractionSystem(EcsWorld* world, DrawList* list, const std::vector<glm::mat4> &world_matrices, JobSystem* jobs){
+
+    EcsMask required = ECS_BIT(COMPONENT_TRANSFORM) | ECS_BIT(COMPONENT_RENDER);
+
+    for(size_t a=0; a<world->archetypes.size(); a++){
+        EcsArchetype* archetype = &world->archetypes[a];
+        if(!Ecs_Matches(*archetype, required))
+            continue;
+
+        // Os itens do arquétipo são reservados de uma vez e preenchidos em
+        // paralelo, cada tarefa em um intervalo de linhas
+        const TransformComponent* transform = Ecs_Column<TransformComponent>(archetype, COMPONENT_TRANSFORM);
+        const RenderComponent* render = Ecs_Column<RenderComponent>(archetype, COMPONENT_RENDER);
+        int first = DrawList_Extend(list, archetype->count);
+        Jobs_ParallelFor(jobs, "Extração da lista", archetype->count, 1024, [&](int begin, int end){
+            for(int e=begin; e<end; e++)
+                DrawList_Set(list, first + e, render[e].object, world_matrices[transform[e].node], render[e].object_id, render[e].layer, render[e].dynamic, render[e].wind);
+        });
+    }
+}
+
+// Raio que parte da câmera e passa pelo cursor do mouse, em coordenadas
+// globais. Enquanto o cursor está capturado pela câmera livre, o raio passa
+// pelo centro da tela (a mira), assim como sem janela (--headless).
+void GetPickingRay(GLFWwindow* window, const glm::mat4 &view, const glm::mat4 &projection, glm::vec3* origin, glm::vec3* direction){
+
+    int width = 1, height = 1;
+    double cursor_x = 0.5;
+    double cursor_y = 0.5;
+    if (window){
+        glfwGetWindowSize(window, &width, &height);
+        cursor_x = width/2.0;
+        cursor_y = height/2.0;
+        if (glfwGetInputMode(window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED)
+            glfwGetCursorPos(window, &cursor_x, &cursor_y);
+    }
+
+    // Coordenadas normalizadas do cursor nos planos near e far, levadas de
+    // volta para o mundo pela inversa de projection*view
+    float ndc_x = 2.0f*cursor_x/width - 1.0f;
+    float ndc_y = 1.0f - 2.0f*cursor_y/height;
+    glm::mat4 inverse = glm::inverse(projection*view);
+    glm::vec4 near_point = inverse*glm::vec4(ndc_x, ndc_y, -1.0f, 1.0f);
+    glm::vec4 far_point  = inverse*glm::vec4(ndc_x, ndc_y,  1.0f, 1.0f);
+
+    *origin = glm::vec3(near_point)/near_point.w;
+    *direction = glm::normalize(glm::vec3(far_point)/far_point.w - *origin);
+}
+
+// Função que carrega uma imagem para ser utilizada como textura
+void LoadTextureImage(const char* filename, int mode_id)
+{
+    printf("Carregando imagem \"%s\"... ", filename);
+
+    // Primeiro fazemos a leitura da imagem do disco
+    stbi_set_flip_vertically_on_load(true);
+    int width;
+    int height;
+    int channels;
+    unsigned char *data = stbi_load(filename, &width, &height, &channels, 3);
+
+    if ( data == NULL )
+    {
+        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename);
+        std::exit(EXIT_FAILURE);
+    }
+
+    printf("OK (%dx%d).\n", width, height);
+
+    // Agora criamos objetos na GPU com OpenGL para armazenar a textura
+    GLuint texture_id;
+    GLuint sampler_id;
+    glGenTextures(1, &texture_id);
+    glGenSamplers(1, &sampler_id);
+
+    // Veja slides 95-96 do documento Aula_20_Mapeamento_de_Texturas.pdf
+    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_S, mode_id);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_T, mode_id);
+
+    // Parâmetros de amostragem da textura.
+    glSamplerParameteri(sampler_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Agora enviamos a imagem lida do disco para a GPU
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    GLuint textureunit = g_NumLoadedTextures;
+    glActiveTexture(GL_TEXTURE0 + textureunit);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindSampler(textureunit, sampler_id);
+
+    stbi_image_free(data);
+
+    g_NumLoadedTextures += 1;
+}
+
+// Função que desenha um objeto armazenado em g_VirtualScene. Veja definição
+// dos objetos na função BuildTrianglesAndAddToVirtualScene().
+void DrawVirtualObject(const char* object_name, int ind_type)
+{
+    // "Ligamos" o VAO. Informamos que queremos utilizar os atributos de
+    // vértices apontados pelo VAO criado pela função BuildTrianglesAndAddToVirtualScene(). Veja
+    // comentários detalhados dentro da definição de BuildTrianglesAndAddToVirtualScene().
+    glBindVertexArray(g_VirtualScene[object_name].vertex_array_object_id);
+
+    // Setamos as variáveis "bbox_min" e "bbox_max" do fragment shader
+    // com os parâmetros da axis-aligned bounding box (AABB) do modelo.
+    glm::vec3 bbox_min = g_VirtualScene[object_name].bbox_min;
+    glm::vec3 bbox_max = g_VirtualScene[object_name].bbox_max;
+    glUniform4f(bbox_min_uniform, bbox_min.x, bbox_min.y, bbox_min.z, 1.0f);
+    glUniform4f(bbox_max_uniform, bbox_max.x, bbox_max.y, bbox_max.z, 1.0f);
+
+    // Pedimos para a GPU rasterizar os vértices dos eixos XYZ
+    // apontados pelo VAO como linhas. Veja a definição de
+    // g_VirtualScene[""] dentro da função BuildTrianglesAndAddToVirtualScene(), e veja
+    // a documentação da função glDrawElements() em
+    // http://docs.gl/gl3/glDrawElements.
+    glDrawElements(
+        g_VirtualScene[object_name].rendering_mode,
+        g_VirtualScene[object_name].num_indices,
+        GL_UNSIGNED_INT,
+        (void*)(g_VirtualScene[object_name].first_index * sizeof(GLuint))
+    );
+
+    // "Desligamos" o VAO, evitando assim que operações posteriores venham a
+    // alterar o mesmo. Isso evita bugs.
+    glBindVertexArray(ind_type);
+}
+
+// Desenha os itens de uma lista de desenho, na ordem em que estão na lista.
+// Com "depth_only", apenas a matriz de modelagem do programa do pré-passo de
+// profundidade é atualizada. O VAO só é trocado quando muda entre dois itens.
+void DrawOpaqueItems(const DrawList &list, bool depth_only)
+{
+    GLint model_location = depth_only ? depth_model_uniform : model_uniform;
+    GLint wind_location = depth_only ? depth_wind_uniform : wind_uniform;
+    GLuint current_vao = 0;
+    bool wind_active = true; // Último "wind" enviado balança (true força o envio do primeiro)
+
+    for (size_t i = 0; i < list.items.size(); ++i)
+    {
+        const DrawItem &item = list.items[i];
+        const SceneObject* object = item.object;
+
+        if (object->vertex_array_object_id != current_vao)
+        {
+            glBindVertexArray(object->vertex_array_object_id);
+            current_vao = object->vertex_array_object_id;
+        }
+
+        glUniformMatrix4fv(model_location, 1 , GL_FALSE , glm::value_ptr(item.model));
+
+        // Objetos parados em sequência não reenviam o vento
+        if (wind_active || item.wind.y != 0.0f)
+        {
+            glUniform3f(wind_location, item.wind.x, item.wind.y, object->bbox_max.y);
+            wind_active = item.wind.y != 0.0f;
+        }
+
+        if (!depth_only)
+        {
+            glUniform1i(object_id_uniform, item.object_id);
+            glUniform4f(bbox_min_uniform, object->bbox_min.x, object->bbox_min.y, object->bbox_min.z, 1.0f);
+            glUniform4f(bbox_max_uniform, object->bbox_max.x, object->bbox_max.y, object->bbox_max.z, 1.0f);
+        }
+
+        glDrawElements(
+            object->rendering_mode,
+            object->num_indices,
+            GL_UNSIGNED_INT,
+            (void*)(object->first_index * sizeof(GLuint))
+        );
+    }
+
+    glBindVertexArray(0);
+}
+
+void getAllObjectsInFile(const char* filename){
+
+    FILE *f = fopen(filename, "r");
+
+    char aux[30];
+
+    while(fscanf(f, "%s ", aux) != EOF){
+        if(strcmp(aux, "o") == 0){
+            fscanf(f, "%[^\n]", obj_names[sizeObjModels]);
+            //printf("%s\n", obj_names[sizeObjModels]);
+            sizeObjModels++;
+        }
+    }
+
+    fclose(f);
+
+    //printf("Carregou %d objetos.", sizeObjModels-1);
+}
+
+// Função que carrega os shaders de vértices e de fragmentos que serão
+// utilizados para renderização. Veja slides 180-200 do documento Aula_03_Rendering_Pipeline_Grafico.pdf.
+//
+void LoadShadersFromFiles()
+{
+    // Note que o caminho para os arquivos "shader_vertex.glsl" e
+    // "shader_fragment.glsl" estão fixados, sendo que assumimos a existência
+    // da seguinte estrutura no sistema de arquivos:
+    //
+    //    + FCG_Lab_01/
+    //    |
+    //    +--+ bin/
+    //    |  |
+    //    |  +--+ Release/  (ou Debug/ ou Linux/)
+    //    |     |
+    //    |     o-- main.exe
+    //    |
+    //    +--+ src/
+    //       |
+    //       o-- shader_vertex.glsl
+    //       |
+    //       o-- shader_fragment.glsl
+    //
+    vertex_shader_id = LoadShader_Vertex("../../src/shader_vertex.glsl");
+    fragment_shader_id = LoadShader_Fragment("../../src/shader_fragment.glsl");
+
+    // Deletamos o programa de GPU anterior, caso ele exista.
+    if ( program_id != 0 )
+        glDeleteProgram(program_id);
+
+    // Criamos um programa de GPU utilizando os shaders carregados acima.
+    program_id = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
+
+    // Buscamos o endereço das variáveis definidas dentro do Vertex Shader.
+    // Utilizaremos estas variáveis para enviar dados para a placa de vídeo
+    // (GPU)! Veja arquivo "shader_vertex.glsl" e "shader_fragment.glsl".
+    model_uniform           = glGetUniformLocation(program_id, "model"); // Variável da matriz "model"
+    view_uniform            = glGetUniformLocation(program_id, "view"); // Variável da matriz "view" em shader_vertex.glsl
+    projection_uniform      = glGetUniformLocation(program_id, "projection"); // Variável da matriz "projection" em shader_vertex.glsl
+    object_id_uniform       = glGetUniformLocation(program_id, "object_id"); // Variável "object_id" em shader_fragment.glsl
+    bbox_min_uniform        = glGetUniformLocation(program_id, "bbox_min");
+    bbox_max_uniform        = glGetUniformLocation(program_id, "bbox_max");
+    time_uniform            = glGetUniformLocation(program_id, "time"); // Vento em shader_vertex.glsl
+    wind_uniform            = glGetUniformLocation(program_id, "wind");
+
+
+    // Variáveis em "shader_fragment.glsl" para acesso das imagens de textura
+    glUseProgram(program_id);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage0"), 0);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage1"), 1);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage2"), 2);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage3"), 3);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage4"), 4);
+    glUniform1i(glGetUniformLocation(program_id, "TextureImage5"), 5);
+
+    // Texture buffers da iluminação "clustered forward". Veja LightClusters_Upload().
+    glUniform1i(glGetUniformLocation(program_id, "cluster_grid"), 6);
+    glUniform1i(glGetUniformLocation(program_id, "cluster_light_indices"), 7);
+    glUniform1i(glGetUniformLocation(program_id, "point_lights"), 8);
+    glUniform3i(glGetUniformLocation(program_id, "cluster_dims"), CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z);
+    cluster_tile_size_uniform    = glGetUniformLocation(program_id, "cluster_tile_size");
+    cluster_slice_params_uniform = glGetUniformLocation(program_id, "cluster_slice_params");
+
+    // Shadow maps em cascata. Veja ShadowCascades_Render().
+    glUniform1i(glGetUniformLocation(program_id, "shadow_map"), 9);
+    light_direction_uniform    = glGetUniformLocation(program_id, "light_direction");
+    shadow_matrices_uniform    = glGetUniformLocation(program_id, "shadow_matrices");
+    cascade_splits_uniform     = glGetUniformLocation(program_id, "cascade_splits");
+    cascade_texel_size_uniform = glGetUniformLocation(program_id, "cascade_texel_size");
+
+    // Mapa de alturas do terreno. Veja Terrain_Upload().
+    glUniform1i(glGetUniformLocation(program_id, "heightmap"), 10);
+    glUseProgram(0);
+
+    // Programa do pré-passo de profundidade
+    GLuint depth_vertex_shader_id = LoadShader_Vertex("../../src/shader_depth_vertex.glsl");
+    GLuint depth_fragment_shader_id = LoadShader_Fragment("../../src/shader_depth_fragment.glsl");
+
+    if ( depth_program_id != 0 )
+        glDeleteProgram(depth_program_id);
+
+    depth_program_id = CreateGpuProgram(depth_vertex_shader_id, depth_fragment_shader_id);
+
+    depth_model_uniform      = glGetUniformLocation(depth_program_id, "model");
+    depth_view_uniform       = glGetUniformLocation(depth_program_id, "view");
+    depth_projection_uniform = glGetUniformLocation(depth_program_id, "projection");
+    depth_time_uniform       = glGetUniformLocation(depth_program_id, "time");
+    depth_wind_uniform       = glGetUniformLocation(depth_program_id, "wind");
+
+    glUseProgram(depth_program_id);
+    glUniform1i(glGetUniformLocation(depth_program_id, "heightmap"), 10);
+    glUseProgram(0);
+}
+
+// Função que computa as normais de um ObjModel, caso elas não tenham sido
+// especificadas dentro do arquivo ".obj"
+void ComputeNormals(ObjModel* model)
+{
+    if ( !model->attrib.normals.empty() )
+        return;
+
+    // Primeiro computamos as normais para todos os TRIÂNGULOS.
+    // Segundo, computamos as normais dos VÉRTICES através do método proposto
+    // por Gouraud, onde a normal de cada vértice vai ser a média das normais de
+    // todas as faces que compartilham este vértice.
+
+    size_t num_vertices = model->attrib.vertices.size() / 3;
+
+    std::vector<int> num_triangles_per_vertex(num_vertices, 0);
+    std::vector<glm::vec4> vertex_normals(num_vertices, glm::vec4(0.0f,0.0f,0.0f,0.0f));
+
+    for (size_t shape = 0; shape < model->shapes.size(); ++shape)
+    {
+        size_t num_triangles = model->shapes[shape].mesh.num_face_vertices.size();
+
+        for (size_t triangle = 0; triangle < num_triangles; ++triangle)
+        {
+            assert(model->shapes[shape].mesh.num_face_vertices[triangle] == 3);
+
+            glm::vec4  vertices[3];
+            for (size_t vertex = 0; vertex < 3; ++vertex)
+            {
+                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
+                const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
+                const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
+                const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
+                vertices[vertex] = glm::vec4(vx,vy,vz,1.0);
+            }
+
+            const glm::vec4  a = vertices[0];
+            const glm::vec4  b = vertices[1];
+            const glm::vec4  c = vertices[2];
+
+            const glm::vec4  n = crossproduct(b-a,c-a);
+
+            for (size_t vertex = 0; vertex < 3; ++vertex)
+            {
+                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
+                num_triangles_per_vertex[idx.vertex_index] += 1;
+                vertex_normals[idx.vertex_index] += n;
+                model->shapes[shape].mesh.indices[3*triangle + vertex].normal_index = idx.vertex_index;
+            }
+        }
+    }
+
+    model->attrib.normals.resize( 3*num_vertices );
+
+    for (size_t i = 0; i < vertex_normals.size(); ++i)
+    {
+        glm::vec4 n = vertex_normals[i] / (float)num_triangles_per_vertex[i];
+        n /= norm(n);
+        model->attrib.normals[3*i + 0] = n.x;
+        model->attrib.normals[3*i + 1] = n.y;
+        model->attrib.normals[3*i + 2] = n.z;
+    }
+}
+
+// Constrói triângulos para futura renderização a partir de um ObjModel.
+void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
+{
+    GLuint vertex_array_object_id;
+    glGenVertexArrays(1, &vertex_array_object_id);
+    glBindVertexArray(vertex_array_object_id);
+
+    std::vector<GLuint> indices;
+    std::vector<float>  model_coefficients;
+    std::vector<float>  normal_coefficients;
+    std::vector<float>  texture_coefficients;
+
+    for (size_t shape = 0; shape < model->shapes.size(); ++shape)
+    {
+        size_t first_index = indices.size();
+        size_t num_triangles = model->shapes[shape].mesh.num_face_vertices.size();
+
+        for (size_t triangle = 0; triangle < num_triangles; ++triangle)
+        {
+            assert(model->shapes[shape].mesh.num_face_vertices[triangle] == 3);
+
+            for (size_t vertex = 0; vertex < 3; ++vertex)
+            {
+                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
+
+                indices.push_back(first_index + 3*triangle + vertex);
+
+                const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
+                const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
+                const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
+                //printf("tri %d vert %d = (%.2f, %.2f, %.2f)\n", (int)triangle, (int)vertex, vx, vy, vz);
+                model_coefficients.push_back( vx ); // X
+                model_coefficients.push_back( vy ); // Y
+                model_coefficients.push_back( vz ); // Z
+                model_coefficients.push_back( 1.0f ); // W
+
+                // Inspecionando o código da tinyobjloader, o aluno Bernardo
+                // Sulzbach (2017/1) apontou que a maneira correta de testar se
+                // existem normais e coordenadas de textura no ObjModel é
+                // comparando se o índice retornado é -1. Fazemos isso abaixo.
+
+                if ( idx.normal_index != -1 )
+                {
+                    const float nx = model->attrib.normals[3*idx.normal_index + 0];
+                    const float ny = model->attrib.normals[3*idx.normal_index + 1];
+                    const float nz = model->attrib.normals[3*idx.normal_index + 2];
+                    normal_coefficients.push_back( nx ); // X
+                    normal_coefficients.push_back( ny ); // Y
+                    normal_coefficients.push_back( nz ); // Z
+                    normal_coefficients.push_back( 0.0f ); // W
+                }
+
+                if ( idx.texcoord_index != -1 )
+                {
+                    const float u = model->attrib.texcoords[2*idx.texcoord_index + 0];
+                    const float v = model->attrib.texcoords[2*idx.texcoord_index + 1];
+                    texture_coefficients.push_back( u );
+                    texture_coefficients.push_back( v );
+                }
+            }
+        }
+
+        size_t last_index = indices.size() - 1;
+
+        SceneObject theobject;
+        theobject.name           = model->shapes[shape].name;
+        theobject.first_index    = first_index; // Primeiro índice
+        theobject.num_indices    = last_index - first_index + 1; // Número de indices
+        theobject.rendering_mode = GL_TRIANGLES;       // Índices correspondem ao tipo de rasterização GL_TRIANGLES.
+        theobject.vertex_array_object_id = vertex_array_object_id;
+
+        // Volumes envolventes (AABB, esfera, caixa orientada e k-DOP) dos
+        // vértices do objeto
+        BoundingVolumes volumes;
+        BoundingVolumes_Compute(&volumes, model_coefficients.data() + 4*first_index, 3*num_triangles, 4);
+        theobject.bbox_min = volumes.aabb_min;
+        theobject.bbox_max = volumes.aabb_max;
+        theobject.bsphere  = volumes.sphere;
+        theobject.obb      = volumes.obb;
+        theobject.kdop     = volumes.kdop;
+
+        g_VirtualScene[model->shapes[shape].name] = theobject;
+
+        // Malha de colisão com os mesmos triângulos, no espaço do modelo
+        CollisionMesh_Build(&g_CollisionMeshes[model->shapes[shape].name],
+                            model_coefficients.data() + 4*first_index, 3*num_triangles, 4);
+    }
+
+    GLuint VBO_model_coefficients_id;
+    glGenBuffers(1, &VBO_model_coefficients_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
+    glBufferData(GL_ARRAY_BUFFER, model_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, model_coefficients.size() * sizeof(float), model_coefficients.data());
+    GLuint location = 0; // "(location = 0)" em "shader_vertex.glsl"
+    GLint  number_of_dimensions = 4; // vec4 em "shader_vertex.glsl"
+    glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(location);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if ( !normal_coefficients.empty() )
+    {
+        GLuint VBO_normal_coefficients_id;
+        glGenBuffers(1, &VBO_normal_coefficients_id);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_normal_coefficients_id);
+        glBufferData(GL_ARRAY_BUFFER, normal_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, normal_coefficients.size() * sizeof(float), normal_coefficients.data());
+        location = 1; // "(location = 1)" em "shader_vertex.glsl"
+        number_of_dimensions = 4; // vec4 em "shader_vertex.glsl"
+        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(location);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    if ( !texture_coefficients.empty() )
+    {
+        GLuint VBO_texture_coefficients_id;
+        glGenBuffers(1, &VBO_texture_coefficients_id);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_texture_coefficients_id);
+        glBufferData(GL_ARRAY_BUFFER, texture_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, texture_coefficients.size() * sizeof(float), texture_coefficients.data());
+        location = 2; // "(location = 1)" em "shader_vertex.glsl"
+        number_of_dimensions = 2; // vec2 em "shader_vertex.glsl"
+        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(location);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    GLuint indices_id;
+    glGenBuffers(1, &indices_id);
+
+    // "Ligamos" o buffer. Note que o tipo agora é GL_ELEMENT_ARRAY_BUFFER.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
+    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // XXX Errado!
+    //
+
+    // "Desligamos" o VAO, evitando assim que operações posteriores venham a
+    // alterar o mesmo. Isso evita bugs.
+    glBindVertexArray(0);
+}
+
+// Carrega um Vertex Shader de um arquivo GLSL. Veja definição de LoadShader() abaixo.
+GLuint LoadShader_Vertex(const char* filename)
+{
+    // Criamos um identificador (ID) para este shader, informando que o mesmo
+    // será aplicado nos vértices.
+    GLuint vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
+
+    // Carregamos e compilamos o shader
+    LoadShader(filename, vertex_shader_id);
+
+    // Retorna o ID gerado acima
+    return vertex_shader_id;
+}
+
+// Carrega um Fragment Shader de um arquivo GLSL . Veja definição de LoadShader() abaixo.
+GLuint LoadShader_Fragment(const char* filename)
+{
+    // Criamos um identificador (ID) para este shader, informando que o mesmo
+    // será aplicado nos fragmentos.
+    GLuint fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+
+    // Carregamos e compilamos o shader
+    LoadShader(filename, fragment_shader_id);
+
+    // Retorna o ID gerado acima
+    return fragment_shader_id;
+}
+
+// Função auxilar, utilizada pelas duas funções acima. Carrega código de GPU de
+// um arquivo GLSL e faz sua compilação.
+void LoadShader(const char* filename, GLuint shader_id)
+{
+    // Lemos o arquivo de texto indicado pela variável "filename"
+    // e colocamos seu conteúdo em memória, apontado pela variável
+    // "shader_string".
+    std::ifstream file;
+    try {
+        file.exceptions(std::ifstream::failbit);
+        file.open(filename);
+    } catch ( std::exception& e ) {
+        fprintf(stderr, "ERROR: Cannot open file \"%s\".\n", filename);
+        std::exit(EXIT_FAILURE);
+    }
+    std::stringstream shader;
+    shader << file.rdbuf();
+    std::string str = shader.str();
+    const GLchar* shader_string = str.c_str();
+    const GLint   shader_string_length = static_cast<GLint>( str.length() );
+
+    // Define o código do shader GLSL, contido na string "shader_string"
+    glShaderSource(shader_id, 1, &shader_string, &shader_string_length);
+
+    // Compila o código do shader GLSL (em tempo de execução)
+    glCompileShader(shader_id);
+
+    // Verificamos se ocorreu algum erro ou "warning" durante a compilação
+    GLint compiled_ok;
+    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &compiled_ok);
+
+    GLint log_length = 0;
+    glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &log_length);
+
+    // Alocamos memória para guardar o log de compilação.
+    // A chamada "new" em C++ é equivalente ao "malloc()" do C.
+    GLchar* log = new GLchar[log_length];
+    glGetShaderInfoLog(shader_id, log_length, &log_length, log);
+
+    // Imprime no terminal qualquer erro ou "warning" de compilação
+    if ( log_length != 0 )
+    {
+        std::string  output;
+
+        if ( !compiled_ok )
+        {
+            output += "ERROR: OpenGL compilation of \"";
+            output += filename;
+            output += "\" failed.\n";
+            output += "== Start of compilation log\n";
+            output += log;
+            output += "== End of compilation log\n";
+        }
+        else
+        {
+            output += "WARNING: OpenGL compilation of \"";
+            output += filename;
+            output += "\".\n";
+            output += "== Start of compilation log\n";
+            output += log;
+            output += "== End of compilation log\n";
+        }
+
+        fprintf(stderr, "%s", output.c_str());
+    }
+
+    // A chamada "delete" em C++ é equivalente ao "free()" do C
+    delete [] log;
+}
+
+// Esta função cria um programa de GPU, o qual contém obrigatoriamente um
+// Vertex Shader e um Fragment Shader.
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id)
+{
+    // Criamos um identificador (ID) para este programa de GPU
+    GLuint program_id = glCreateProgram();
+
+    // Definição dos dois shaders GLSL que devem ser executados pelo programa
+    glAttachShader(program_id, vertex_shader_id);
+    glAttachShader(program_id, fragment_shader_id);
+
+    // Linkagem dos shaders acima ao programa
+    glLinkProgram(program_id);
+
+    // Verificamos se ocorreu algum erro durante a linkagem
+    GLint linked_ok = GL_FALSE;
+    glGetProgramiv(program_id, GL_LINK_STATUS, &linked_ok);
+
+    // Imprime no terminal qualquer erro de linkagem
+    if ( linked_ok == GL_FALSE )
+    {
+        GLint log_length = 0;
+        glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &log_length);
+
+        // Alocamos memória para guardar o log de compilação.
+        // A chamada "new" em C++ é equivalente ao "malloc()" do C.
+        GLchar* log = new GLchar[log_length];
+
+        glGetProgramInfoLog(program_id, log_length, &log_length, log);
+
+        std::string output;
+
+        output += "ERROR: OpenGL linking of program failed.\n";
+        output += "== Start of link log\n";
+        output += log;
+        output += "\n== End of link log\n";
+
+        // A chamada "delete" em C++ é equivalente ao "free()" do C
+        delete [] log;
+
+        fprintf(stderr, "%s", output.c_str());
+    }
+
+    // Os "Shader Objects" podem ser marcados para deleção após serem linkados
+    glDeleteShader(vertex_shader_id);
+    glDeleteShader(fragment_shader_id);
+
+    // Retornamos o ID gerado acima
+    return program_id;
+}
+
+// Definição da função que será chamada sempre que a janela do sistema
+// operacional for redimensionada, por consequência alterando o tamanho do
+// "framebuffer" (região de memória onde são armazenados os pixels da imagem).
+void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    // A região do framebuffer em que renderizamos é definida com glViewport()
+    // pela renderização de cada quadro, com o tamanho do framebuffer lido ao
+    // montar o pacote: este callback roda na thread principal, que não tem o
+    // contexto OpenGL quando a renderização tem uma thread própria. A função
+    // "glViewport" define o mapeamento das "normalized device coordinates"
+    // (NDC) para "pixel coordinates". Essa é a operação de "Screen Mapping"
+    // ou "Viewport Mapping" vista em aula ({+ViewportMapping2+}).
+
+    // Atualizamos também a razão que define a proporção da janela (largura /
+    // altura), a qual será utilizada na definição das matrizes de projeção,
+    // tal que não ocorra distorções durante o processo de "Screen Mapping"
+    // acima, quando NDC é mapeado para coordenadas de pixels. Veja slides 205-215 do documento Aula_09_Projecoes.pdf.
+    //
+    // O cast para float é necessário pois números inteiros são arredondados ao
+    // serem divididos!
+    g_ScreenRatio = (float)width / height;
+}
+
+// Variáveis globais que armazenam a última posição do cursor do mouse, para
+// que possamos calcular quanto que o mouse se movimentou entre dois instantes
+// de tempo. Utilizadas no callback CursorPosCallback() abaixo.
+double g_LastCursorPosX, g_LastCursorPosY;
+
+// Função callback chamada sempre que o usuário movimentar o cursor do mouse em
+// cima da janela OpenGL.
+void CursorPosCallback(GLFWwindow* window, double xpos, double ypos)
+{
+    // Abaixo executamos o seguinte: caso o botão esquerdo do mouse esteja
+    // pressionado, computamos quanto que o mouse se movimento desde o último
+    // instante de tempo, e usamos esta movimentação para atualizar os
+    // parâmetros que definem a posição da câmera dentro da cena virtual.
+    // Assim, temos que o usuário consegue controlar a câmera.
+
+    if (g_LeftMouseButtonPressed)
+    {
+        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
+        float dx = xpos - g_LastCursorPosX;
+        float dy = ypos - g_LastCursorPosY;
+
+        // Atualizamos parâmetros da câmera com os deslocamentos
+        g_CameraTheta -= 0.01f*dx;
+        g_CameraPhi   += 0.01f*dy;
+
+        // Em coordenadas esféricas, o ângulo phi deve ficar entre -pi/2 e +pi/2.
+        float phimax = 3.141592f/2;
+        float phimin = -phimax;
+
+        if (g_CameraPhi > phimax)
+            g_CameraPhi = phimax;
+
+        if (g_CameraPhi < phimin)
+            g_CameraPhi = phimin;
+
+        // Atualizamos as variáveis globais para armazenar a posição atual do
+        // cursor como sendo a última posição conhecida do cursor.
+        g_LastCursorPosX = xpos;
+        g_LastCursorPosY = ypos;
+    }
+
+    if (g_RightMouseButtonPressed)
+    {
+        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
+        //float dx = xpos - g_LastCursorPosX;
+        //float dy = ypos - g_LastCursorPosY;
+
+        // Atualizamos as variáveis globais para armazenar a posição atual do
+        // cursor como sendo a última posição conhecida do cursor.
+        g_LastCursorPosX = xpos;
+        g_LastCursorPosY = ypos;
+    }
+
+    if (g_MiddleMouseButtonPressed)
+    {
+        // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
+        //float dx = xpos - g_LastCursorPosX;
+        //float dy = ypos - g_LastCursorPosY;
+
+        // Atualizamos as variáveis globais para armazenar a posição atual do
+        // cursor como sendo a última posição conhecida do cursor.
+        g_LastCursorPosX = xpos;
+        g_LastCursorPosY = ypos;
+    }
+}
+
+// Definimos o callback para impressão de erros da GLFW no terminal
+void ErrorCallback(int error, const char* description)
+{
+    fprintf(stderr, "ERROR: GLFW: %s\n", description);
+}
+
+// Escrevemos na tela o número de quadros renderizados por segundo (frames per
+// second), como um texto do pacote do quadro.
+void TextRendering_ShowFramesPerSecond(FramePacket* packet)
+{
+
+    // Variáveis estáticas (static) mantém seus valores entre chamadas
+    // subsequentes da função!
+    static double old_seconds = FramePacing_Now()/1000.0;
+    static int   ellapsed_frames = 0;
+    static char  buffer[20] = "?? fps";
+    static int   numchars = 7;
+
+    ellapsed_frames += 1;
+
+    // Recuperamos o tempo atual, em segundos
+    double seconds = FramePacing_Now()/1000.0;
+
+    // Número de segundos desde o último cálculo do fps
+    double ellapsed_seconds = seconds - old_seconds;
+
+    if ( ellapsed_seconds > 1.0 )
+    {
+        numchars = snprintf(buffer, 20, "%.2f fps", ellapsed_frames / ellapsed_seconds);
+
+        old_seconds = seconds;
+        ellapsed_frames = 0;
+    }
+
+    float lineheight = TextRendering_LineHeight(packet->window_width, packet->window_height);
+    float charwidth = TextRendering_CharWidth(packet->window_width, packet->window_height);
+
+    FramePacket_AddText(packet, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-lineheight, 1.0f);
+}
+
+// set makeprg=cd\ ..\ &&\ make\ run\ >/dev/null
+// vim: set spell spelllang=pt_br :
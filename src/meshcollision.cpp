@@ -0,0 +1,337 @@
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "meshcollision.h"
+
+// FONTE: Christer Ericson, "Real-Time Collision Detection", seções 5.1.5,
+// 5.1.9 e 5.3.6 (pontos mais próximos e interseção segmento-triângulo)
+
+#define MESH_COLLISION_EPSILON 1e-8f
+
+// Triângulos cujas caixas tocam [min, max]. Cabendo em "buffer" (de
+// MESH_COLLISION_MAX_CANDIDATES posições), eles ficam nele; senão, a busca é
+// refeita em um vetor da thread, que cresce conforme a necessidade.
+static int MeshCollision_Candidates(const CollisionMesh* mesh, const glm::vec3 &min, const glm::vec3 &max, int* buffer, const int** candidates)
+{
+    static thread_local std::vector<int> t_Candidates;
+
+    int count = Bvh_Overlap(&mesh->bvh, min, max, buffer, MESH_COLLISION_MAX_CANDIDATES);
+    *candidates = buffer;
+    if (count > MESH_COLLISION_MAX_CANDIDATES)
+    {
+        t_Candidates.resize(count);
+        Bvh_Overlap(&mesh->bvh, min, max, t_Candidates.data(), count);
+        *candidates = t_Candidates.data();
+    }
+    return count;
+}
+
+void CollisionMesh_Build(CollisionMesh* mesh, const float* positions, size_t count, int stride)
+{
+    mesh->vertices.clear();
+    Bvh_Clear(&mesh->bvh);
+
+    for (size_t i = 0; i + 2 < count; i += 3)
+    {
+        glm::vec3 a = glm::vec3(positions[stride*(i+0) + 0], positions[stride*(i+0) + 1], positions[stride*(i+0) + 2]);
+        glm::vec3 b = glm::vec3(positions[stride*(i+1) + 0], positions[stride*(i+1) + 1], positions[stride*(i+1) + 2]);
+        glm::vec3 c = glm::vec3(positions[stride*(i+2) + 0], positions[stride*(i+2) + 1], positions[stride*(i+2) + 2]);
+
+        // Triângulos degenerados (sem área) não têm normal e são descartados
+        glm::vec3 n = glm::cross(b - a, c - a);
+        if (glm::dot(n, n) <= MESH_COLLISION_EPSILON * MESH_COLLISION_EPSILON)
+            continue;
+
+        int triangle = (int)mesh->vertices.size() / 3;
+        mesh->vertices.push_back(a);
+        mesh->vertices.push_back(b);
+        mesh->vertices.push_back(c);
+        Bvh_Add(&mesh->bvh, 0, triangle, glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)));
+    }
+
+    Bvh_Build(&mesh->bvh);
+}
+
+void CollisionInstance_Init(CollisionInstance* instance, int type, int index, const CollisionMesh* mesh, const glm::mat4 &model, float scale)
+{
+    instance->type = type;
+    instance->index = index;
+    instance->mesh = mesh;
+    instance->model = model;
+    instance->inverse_model = glm::inverse(model);
+    instance->scale = scale;
+
+    // Caixa no mundo: a que envolve os oito cantos da caixa da malha (a raiz
+    // da BVH) transformados
+    instance->min = glm::vec3(model[3]);
+    instance->max = glm::vec3(model[3]);
+    if (mesh->bvh.nodes.empty())
+        return;
+
+    const BvhNode &root = mesh->bvh.nodes[0];
+    instance->min = glm::vec3(FLT_MAX);
+    instance->max = glm::vec3(-FLT_MAX);
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec4 point = glm::vec4((corner & 1) ? root.max.x : root.min.x,
+                                    (corner & 2) ? root.max.y : root.min.y,
+                                    (corner & 4) ? root.max.z : root.min.z, 1.0f);
+        glm::vec3 world = glm::vec3(model * point);
+        instance->min = glm::min(instance->min, world);
+        instance->max = glm::max(instance->max, world);
+    }
+}
+
+static glm::vec3 ClosestPointTriangle(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+
+    // Regiões de Voronoi dos vértices, das arestas e da face
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    float vc = d1*d4 - d3*d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    float vb = d5*d2 - d1*d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+    float va = d3*d6 - d5*d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+static void ClosestPointsSegmentSegment(const glm::vec3 &p1, const glm::vec3 &q1, const glm::vec3 &p2, const glm::vec3 &q2,
+                                        glm::vec3* c1, glm::vec3* c2)
+{
+    glm::vec3 d1 = q1 - p1;
+    glm::vec3 d2 = q2 - p2;
+    glm::vec3 r = p1 - p2;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+    float s, t;
+
+    if (a <= MESH_COLLISION_EPSILON && e <= MESH_COLLISION_EPSILON)
+    {
+        s = t = 0.0f;
+    }
+    else if (a <= MESH_COLLISION_EPSILON)
+    {
+        s = 0.0f;
+        t = glm::clamp(f / e, 0.0f, 1.0f);
+    }
+    else
+    {
+        float c = glm::dot(d1, r);
+        if (e <= MESH_COLLISION_EPSILON)
+        {
+            t = 0.0f;
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else
+        {
+            float b = glm::dot(d1, d2);
+            float denom = a*e - b*b;
+            s = (denom != 0.0f) ? glm::clamp((b*f - c*e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b*s + f) / e;
+            if (t < 0.0f)
+            {
+                t = 0.0f;
+                s = glm::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else if (t > 1.0f)
+            {
+                t = 1.0f;
+                s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    *c1 = p1 + d1 * s;
+    *c2 = p2 + d2 * t;
+}
+
+// Interseção do segmento de "p" até "q" com o triângulo (Möller-Trumbore, sem
+// descartar as faces de trás). Retorna em "t" a fração do segmento até o ponto.
+static bool SegmentTriangle(const glm::vec3 &p, const glm::vec3 &q, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, float* t)
+{
+    glm::vec3 d = q - p;
+    glm::vec3 e1 = b - a;
+    glm::vec3 e2 = c - a;
+    glm::vec3 h = glm::cross(d, e2);
+    float det = glm::dot(e1, h);
+    if (std::fabs(det) <= MESH_COLLISION_EPSILON)
+        return false; // Segmento paralelo ao plano do triângulo
+
+    float inverse_det = 1.0f / det;
+    glm::vec3 s = p - a;
+    float u = glm::dot(s, h) * inverse_det;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    glm::vec3 k = glm::cross(s, e1);
+    float v = glm::dot(d, k) * inverse_det;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    *t = glm::dot(e2, k) * inverse_det;
+    return *t >= 0.0f && *t <= 1.0f;
+}
+
+static bool CapsuleTriangle(const glm::vec3 &p, const glm::vec3 &q, float radius,
+                            const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c,
+                            glm::vec3* normal, float* depth)
+{
+    glm::vec3 n = glm::normalize(glm::cross(b - a, c - a));
+
+    // Segmento inteiro a mais de "radius" do plano do triângulo, do mesmo lado
+    float dp = glm::dot(p - a, n);
+    float dq = glm::dot(q - a, n);
+    if ((dp >= radius && dq >= radius) || (dp <= -radius && dq <= -radius))
+        return false;
+
+    // Segmento atravessando o triângulo: empurra a cápsula para o lado do
+    // plano em que ela precisa andar menos
+    float t;
+    if (dp * dq <= 0.0f && SegmentTriangle(p, q, a, b, c, &t))
+    {
+        float to_front = radius - std::min(dp, dq);
+        float to_back  = radius + std::max(dp, dq);
+        *normal = (to_front <= to_back) ? n : -n;
+        *depth  = std::min(to_front, to_back);
+        return true;
+    }
+
+    // Caso contrário, o par de pontos mais próximos envolve uma das pontas do
+    // segmento contra a face, ou o segmento contra uma das arestas
+    glm::vec3 on_segment = p;
+    glm::vec3 on_triangle = ClosestPointTriangle(p, a, b, c);
+    float best = glm::dot(on_segment - on_triangle, on_segment - on_triangle);
+
+    glm::vec3 point = ClosestPointTriangle(q, a, b, c);
+    float distance_sq = glm::dot(q - point, q - point);
+    if (distance_sq < best)
+    {
+        best = distance_sq;
+        on_segment = q;
+        on_triangle = point;
+    }
+
+    const glm::vec3* edges[3][2] = {{&a, &b}, {&b, &c}, {&c, &a}};
+    for (int edge = 0; edge < 3; ++edge)
+    {
+        glm::vec3 c1, c2;
+        ClosestPointsSegmentSegment(p, q, *edges[edge][0], *edges[edge][1], &c1, &c2);
+        distance_sq = glm::dot(c1 - c2, c1 - c2);
+        if (distance_sq < best)
+        {
+            best = distance_sq;
+            on_segment = c1;
+            on_triangle = c2;
+        }
+    }
+
+    if (best >= radius * radius)
+        return false;
+
+    float distance = std::sqrt(best);
+    if (distance > MESH_COLLISION_EPSILON)
+    {
+        *normal = (on_segment - on_triangle) / distance;
+    }
+    else
+    {
+        glm::vec3 middle = (p + q) * 0.5f;
+        *normal = (glm::dot(middle - a, n) >= 0.0f) ? n : -n;
+    }
+    *depth = radius - distance;
+    return true;
+}
+
+bool Collision_CapsuleMesh(const CollisionInstance* instance, const CollisionCapsule &capsule, CollisionContact* contact)
+{
+    const CollisionMesh* mesh = instance->mesh;
+
+    // A cápsula é levada para o espaço do modelo, onde estão os triângulos
+    glm::vec3 p = glm::vec3(instance->inverse_model * glm::vec4(capsule.a, 1.0f));
+    glm::vec3 q = glm::vec3(instance->inverse_model * glm::vec4(capsule.b, 1.0f));
+    float radius = capsule.radius / instance->scale;
+
+    int buffer[MESH_COLLISION_MAX_CANDIDATES];
+    const int* candidates;
+    int count = MeshCollision_Candidates(mesh, glm::min(p, q) - radius, glm::max(p, q) + radius, buffer, &candidates);
+
+    float best_depth = 0.0f;
+    glm::vec3 best_normal = glm::vec3(0.0f);
+    for (int i = 0; i < count; ++i)
+    {
+        const glm::vec3* v = &mesh->vertices[3 * mesh->bvh.items[candidates[i]].index];
+        glm::vec3 normal;
+        float depth;
+        if (CapsuleTriangle(p, q, radius, v[0], v[1], v[2], &normal, &depth) && depth > best_depth)
+        {
+            best_depth = depth;
+            best_normal = normal;
+        }
+    }
+
+    if (best_depth <= 0.0f)
+        return false;
+
+    contact->normal = glm::normalize(glm::vec3(instance->model * glm::vec4(best_normal, 0.0f)));
+    contact->depth = best_depth * instance->scale;
+    return true;
+}
+
+bool Collision_SegmentMesh(const CollisionInstance* instance, const glm::vec3 &a, const glm::vec3 &b, float* t)
+{
+    const CollisionMesh* mesh = instance->mesh;
+
+    // Transformações afins preservam a fração do segmento
+    glm::vec3 p = glm::vec3(instance->inverse_model * glm::vec4(a, 1.0f));
+    glm::vec3 q = glm::vec3(instance->inverse_model * glm::vec4(b, 1.0f));
+
+    int buffer[MESH_COLLISION_MAX_CANDIDATES];
+    const int* candidates;
+    int count = MeshCollision_Candidates(mesh, glm::min(p, q), glm::max(p, q), buffer, &candidates);
+
+    float best = 2.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const glm::vec3* v = &mesh->vertices[3 * mesh->bvh.items[candidates[i]].index];
+        float hit;
+        if (SegmentTriangle(p, q, v[0], v[1], v[2], &hit) && hit < best)
+            best = hit;
+    }
+
+    if (best > 1.0f)
+        return false;
+
+    *t = best;
+    return true;
+}
@@ -0,0 +1,217 @@
+#include <cmath>
+#include <algorithm>
+
+#include "placement.h"
+
+#define PLACEMENT_FILL_CANDIDATES 12 // Tentativas em volta de cada objeto no algoritmo de Bridson
+
+void PlacementRandom_Seed(PlacementRandom* random, unsigned int seed)
+{
+    // splitmix64 espalha os bits da semente: sementes vizinhas geram
+    // sequências sem relação, e o estado nunca é zero
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    random->state = (z ^ (z >> 31)) | 1;
+}
+
+unsigned int PlacementRandom_Next(PlacementRandom* random)
+{
+    random->state ^= random->state >> 12;
+    random->state ^= random->state << 25;
+    random->state ^= random->state >> 27;
+    return (unsigned int)((random->state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+float PlacementRandom_Float(PlacementRandom* random, float min, float max)
+{
+    // 24 bits, o que cabe exatamente na mantissa de um float
+    float unit = (PlacementRandom_Next(random) >> 8) * (1.0f / 16777216.0f);
+    return min + (max - min) * unit;
+}
+
+bool PlacementRegion_Contains(const PlacementRegion &region, float x, float z, float radius)
+{
+    float dx = x - region.center.x;
+    float dz = z - region.center.y;
+    float distance2 = dx*dx + dz*dz;
+    if (distance2 < region.inner_radius*region.inner_radius || distance2 > region.outer_radius*region.outer_radius)
+        return false;
+
+    if (region.bounds_max.x > region.bounds_min.x &&
+        (x - radius < region.bounds_min.x || x + radius > region.bounds_max.x ||
+         z - radius < region.bounds_min.y || z + radius > region.bounds_max.y))
+        return false;
+
+    for (int i = 0; i < region.num_exclusions; ++i)
+    {
+        const PlacementExclusion &exclusion = region.exclusions[i];
+        float ex = x - exclusion.center.x;
+        float ez = z - exclusion.center.y;
+        float reach = exclusion.radius + radius;
+        if (ex*ex + ez*ez < reach*reach)
+            return false;
+    }
+
+    return true;
+}
+
+// Ponto uniformemente distribuído na área do anel da região
+static glm::vec2 Placement_RandomInRegion(PlacementRandom* random, const PlacementRegion &region)
+{
+    float angle = PlacementRandom_Float(random, 0.0f, 6.28318531f);
+    float inner2 = region.inner_radius * region.inner_radius;
+    float outer2 = region.outer_radius * region.outer_radius;
+    float distance = sqrtf(PlacementRandom_Float(random, inner2, outer2));
+    return region.center + distance * glm::vec2(cosf(angle), sinf(angle));
+}
+
+void Placement_Init(Placement* placement, const glm::vec2 &min, const glm::vec2 &max, float cell_size)
+{
+    placement->cell_size = cell_size;
+    placement->origin = min;
+    placement->width = std::max(1, (int)ceil((max.x - min.x) / cell_size));
+    placement->height = std::max(1, (int)ceil((max.y - min.y) / cell_size));
+    placement->cell_first.assign(placement->width * placement->height, -1);
+    placement->next.clear();
+    placement->x.clear();
+    placement->z.clear();
+    placement->radius.clear();
+    placement->max_radius = 0.0f;
+}
+
+bool Placement_Fits(const Placement* placement, float x, float z, float radius)
+{
+    float cx = (x - placement->origin.x) / placement->cell_size;
+    float cz = (z - placement->origin.y) / placement->cell_size;
+    if (cx < 0.0f || cz < 0.0f || cx >= placement->width || cz >= placement->height)
+        return false;
+
+    // Células que podem conter o centro de um objeto que encoste neste
+    float reach = (radius + placement->max_radius) / placement->cell_size;
+    int first_x = std::max(0, (int)(cx - reach));
+    int first_z = std::max(0, (int)(cz - reach));
+    int last_x  = std::min(placement->width  - 1, (int)(cx + reach));
+    int last_z  = std::min(placement->height - 1, (int)(cz + reach));
+
+    for (int cell_z = first_z; cell_z <= last_z; ++cell_z)
+        for (int cell_x = first_x; cell_x <= last_x; ++cell_x)
+            for (int i = placement->cell_first[cell_z * placement->width + cell_x]; i >= 0; i = placement->next[i])
+            {
+                float dx = placement->x[i] - x;
+                float dz = placement->z[i] - z;
+                float distance = placement->radius[i] + radius;
+                if (dx*dx + dz*dz < distance*distance)
+                    return false;
+            }
+
+    return true;
+}
+
+int Placement_Insert(Placement* placement, float x, float z, float radius)
+{
+    int index = (int)placement->x.size();
+    int cell_x = std::min(placement->width  - 1, std::max(0, (int)((x - placement->origin.x) / placement->cell_size)));
+    int cell_z = std::min(placement->height - 1, std::max(0, (int)((z - placement->origin.y) / placement->cell_size)));
+    int cell = cell_z * placement->width + cell_x;
+
+    placement->x.push_back(x);
+    placement->z.push_back(z);
+    placement->radius.push_back(radius);
+    placement->next.push_back(placement->cell_first[cell]);
+    placement->cell_first[cell] = index;
+    placement->max_radius = std::max(placement->max_radius, radius);
+
+    return index;
+}
+
+int Placement_Scatter(Placement* placement, PlacementRandom* random, const PlacementRegion &region,
+                      float radius, int count, int max_attempts)
+{
+    int placed = 0;
+    int failures = 0;
+
+    while (placed < count && failures < max_attempts)
+    {
+        glm::vec2 p = Placement_RandomInRegion(random, region);
+        if (PlacementRegion_Contains(region, p.x, p.y, radius) && Placement_Fits(placement, p.x, p.y, radius))
+        {
+            Placement_Insert(placement, p.x, p.y, radius);
+            placed += 1;
+            failures = 0;
+        }
+        else
+            failures += 1;
+    }
+
+    return placed;
+}
+
+int Placement_Fill(Placement* placement, PlacementRandom* random, const PlacementRegion &region,
+                   float radius, int max_count)
+{
+    float min_distance = 2.0f * radius;
+    int placed = 0;
+    int seed_failures = 0;
+    std::vector<int> active; // Objetos em volta dos quais ainda pode caber algum
+
+    while (placed < max_count)
+    {
+        if (active.empty())
+        {
+            // Sem objetos ativos, recomeça de um ponto aleatório: a região
+            // pode ter partes separadas por exclusões ou por objetos de
+            // outras chamadas
+            if (seed_failures >= PLACEMENT_FILL_CANDIDATES)
+                break;
+            glm::vec2 p = Placement_RandomInRegion(random, region);
+            if (!PlacementRegion_Contains(region, p.x, p.y, radius) || !Placement_Fits(placement, p.x, p.y, radius))
+            {
+                seed_failures += 1;
+                continue;
+            }
+            active.push_back(Placement_Insert(placement, p.x, p.y, radius));
+            placed += 1;
+            seed_failures = 0;
+            continue;
+        }
+
+        int slot = PlacementRandom_Next(random) % active.size();
+        int around = active[slot];
+        bool found = false;
+
+        // Candidatos logo além da distância mínima, em ângulos igualmente
+        // espaçados a partir de um ângulo aleatório: o vetor é girado por
+        // uma multiplicação complexa em vez de um seno e um cosseno por
+        // candidato
+        float angle = PlacementRandom_Float(random, 0.0f, 6.28318531f);
+        float distance = min_distance * 1.001f;
+        float dx = distance * cosf(angle);
+        float dz = distance * sinf(angle);
+        const float step_cos = cosf(6.28318531f / PLACEMENT_FILL_CANDIDATES);
+        const float step_sin = sinf(6.28318531f / PLACEMENT_FILL_CANDIDATES);
+        for (int attempt = 0; attempt < PLACEMENT_FILL_CANDIDATES; ++attempt)
+        {
+            float x = placement->x[around] + dx;
+            float z = placement->z[around] + dz;
+            if (PlacementRegion_Contains(region, x, z, radius) && Placement_Fits(placement, x, z, radius))
+            {
+                active.push_back(Placement_Insert(placement, x, z, radius));
+                placed += 1;
+                found = true;
+                break;
+            }
+            float rotated_x = dx * step_cos - dz * step_sin;
+            dz = dx * step_sin + dz * step_cos;
+            dx = rotated_x;
+        }
+
+        if (!found)
+        {
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+
+    return placed;
+}
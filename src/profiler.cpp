@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "profiler.h"
+
+// Peso da amostra mais recente na média móvel dos tempos
+#define PROFILER_SMOOTHING 0.1
+
+static std::vector<ProfilerScope> g_ProfilerScopes;
+static std::mutex                 g_ProfilerScopesMutex; // Trechos abertos pela thread do quadro e pela de renderização
+static thread_local std::vector<int> t_ProfilerStack;   // Trechos abertos pela thread atual (índices em g_ProfilerScopes)
+static std::atomic<int>           g_ProfilerFrame(0);
+static std::thread::id            g_ProfilerGpuThread;   // Thread com o contexto OpenGL
+
+static std::vector<ProfilerJob>   g_ProfilerJobs;
+static std::mutex                 g_ProfilerJobsMutex; // As tarefas são registradas por várias threads
+
+static double Profiler_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int Profiler_FindScope(const char* name)
+{
+    for (size_t i = 0; i < g_ProfilerScopes.size(); ++i)
+        if (strcmp(g_ProfilerScopes[i].name.c_str(), name) == 0)
+            return (int)i;
+
+    ProfilerScope scope;
+    scope.name = name;
+    scope.cpu_ms = scope.gpu_ms = 0.0;
+    scope.last_frame = -1;
+    scope.cpu_start = 0.0;
+    scope.gpu = false;
+    scope.slot = 0;
+    for (int i = 0; i < PROFILER_FRAMES; ++i)
+        scope.issued[i] = false;
+
+    g_ProfilerScopes.push_back(scope);
+    return (int)g_ProfilerScopes.size() - 1;
+}
+
+void Profiler_SetGpuThread()
+{
+    std::lock_guard<std::mutex> lock(g_ProfilerScopesMutex);
+    g_ProfilerGpuThread = std::this_thread::get_id();
+}
+
+void Profiler_BeginFrame()
+{
+    g_ProfilerFrame += 1;
+    t_ProfilerStack.clear();
+
+    // As tarefas que não executaram no último quadro não entram nas médias
+    std::lock_guard<std::mutex> lock(g_ProfilerJobsMutex);
+    for (size_t i = 0; i < g_ProfilerJobs.size(); ++i)
+    {
+        ProfilerJob &job = g_ProfilerJobs[i];
+        if (job.frame_jobs > 0)
+        {
+            job.cpu_ms += (job.frame_ms - job.cpu_ms) * PROFILER_SMOOTHING;
+            job.max_ms += (job.frame_max_ms - job.max_ms) * PROFILER_SMOOTHING;
+            job.jobs += (job.frame_jobs - job.jobs) * PROFILER_SMOOTHING;
+            job.last_frame = g_ProfilerFrame.load() - 1;
+        }
+        job.frame_ms = job.frame_max_ms = 0.0;
+        job.frame_jobs = 0;
+    }
+}
+
+void Profiler_Begin(const char* name)
+{
+    std::lock_guard<std::mutex> lock(g_ProfilerScopesMutex);
+    int index = Profiler_FindScope(name);
+    ProfilerScope &scope = g_ProfilerScopes[index];
+
+    // As queries são criadas na primeira vez que o trecho é aberto na thread
+    // do contexto OpenGL; nas outras threads só o tempo de CPU é medido
+    bool gpu = std::this_thread::get_id() == g_ProfilerGpuThread;
+    if (gpu && !scope.gpu)
+    {
+        glGenQueries(2*PROFILER_FRAMES, &scope.queries[0][0]);
+        scope.gpu = true;
+    }
+
+    // Cada trecho alterna entre os seus PROFILER_FRAMES pares de queries,
+    // independentemente do número do quadro de Profiler_BeginFrame(), que
+    // pode ser incrementado por outra thread enquanto o trecho está aberto
+    scope.slot = (scope.slot + 1) % PROFILER_FRAMES;
+    int slot = scope.slot;
+
+    // Lê o resultado de PROFILER_FRAMES quadros atrás, se a GPU já terminou.
+    // Caso contrário a amostra é descartada, para não bloquear a CPU.
+    if (gpu && scope.issued[slot])
+    {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(scope.queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 start, end;
+            glGetQueryObjectui64v(scope.queries[slot][0], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(scope.queries[slot][1], GL_QUERY_RESULT, &end);
+            double gpu_ms = (end - start) / 1.0e6;
+            scope.gpu_ms += (gpu_ms - scope.gpu_ms) * PROFILER_SMOOTHING;
+        }
+        scope.issued[slot] = false;
+    }
+
+    if (gpu)
+        glQueryCounter(scope.queries[slot][0], GL_TIMESTAMP);
+    scope.cpu_start = Profiler_Now();
+    scope.last_frame = g_ProfilerFrame;
+
+    t_ProfilerStack.push_back(index);
+}
+
+void Profiler_End()
+{
+    if (t_ProfilerStack.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(g_ProfilerScopesMutex);
+    ProfilerScope &scope = g_ProfilerScopes[t_ProfilerStack.back()];
+    t_ProfilerStack.pop_back();
+
+    if (std::this_thread::get_id() == g_ProfilerGpuThread && scope.gpu)
+    {
+        glQueryCounter(scope.queries[scope.slot][1], GL_TIMESTAMP);
+        scope.issued[scope.slot] = true;
+    }
+
+    double cpu_ms = Profiler_Now() - scope.cpu_start;
+    scope.cpu_ms += (cpu_ms - scope.cpu_ms) * PROFILER_SMOOTHING;
+}
+
+void Profiler_CopyScopes(std::vector<ProfilerScope>* scopes)
+{
+    std::lock_guard<std::mutex> lock(g_ProfilerScopesMutex);
+    *scopes = g_ProfilerScopes;
+}
+
+void Profiler_RecordJob(const char* name, double cpu_ms)
+{
+    std::lock_guard<std::mutex> lock(g_ProfilerJobsMutex);
+
+    size_t i = 0;
+    while (i < g_ProfilerJobs.size() && strcmp(g_ProfilerJobs[i].name.c_str(), name) != 0)
+        ++i;
+
+    if (i == g_ProfilerJobs.size())
+    {
+        ProfilerJob job;
+        job.name = name;
+        job.cpu_ms = job.max_ms = job.jobs = 0.0;
+        job.last_frame = -1;
+        job.frame_ms = job.frame_max_ms = 0.0;
+        job.frame_jobs = 0;
+        g_ProfilerJobs.push_back(job);
+    }
+
+    ProfilerJob &job = g_ProfilerJobs[i];
+    job.frame_ms += cpu_ms;
+    job.frame_max_ms = std::max(job.frame_max_ms, cpu_ms);
+    job.frame_jobs += 1;
+}
+
+void Profiler_CopyJobs(std::vector<ProfilerJob>* jobs)
+{
+    std::lock_guard<std::mutex> lock(g_ProfilerJobsMutex);
+    *jobs = g_ProfilerJobs;
+}
+
+int Profiler_Frame()
+{
+    return g_ProfilerFrame;
+}
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "savegame.h"
+
+// Posição do checksum no cabeçalho
+#define SAVEGAME_CHECKSUM_OFFSET 44
+
+static double SaveGame_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SaveGame_Init(SaveGame* save, unsigned int seed, int tree_count)
+{
+    save->seed = seed;
+    save->tree_count = tree_count;
+    save->player_position = glm::vec2(0.0f);
+    save->quest_level = 0;
+    save->quest_felled = 0;
+    save->quest_accepted = false;
+    save->felled.assign((tree_count + 63) / 64, 0);
+    save->trunks.clear();
+}
+
+void SaveGame_SetFelled(SaveGame* save, int tree, const glm::vec2 &trunk)
+{
+    if (tree < 0 || tree >= save->tree_count || SaveGame_IsFelled(save, tree))
+        return;
+    save->felled[tree / 64] |= 1ull << (tree % 64);
+    SaveGameTrunk entry = {tree, trunk};
+    save->trunks.push_back(entry);
+}
+
+bool SaveGame_IsFelled(const SaveGame* save, int tree)
+{
+    return (save->felled[tree / 64] >> (tree % 64)) & 1;
+}
+
+// Escrita e leitura de inteiros little-endian, independente da CPU
+static void SaveGame_PutU32(unsigned char* out, unsigned int value)
+{
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned int SaveGame_GetU32(const unsigned char* in)
+{
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+static unsigned int SaveGame_FloatBits(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+static float SaveGame_BitsFloat(unsigned int bits)
+{
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// Diferenças pequenas (positivas ou negativas) viram números pequenos:
+// 0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...
+static unsigned int SaveGame_ZigZag(int value)
+{
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int SaveGame_UnZigZag(unsigned int value)
+{
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+// 7 bits por byte; o bit mais alto indica que há mais bytes
+static void SaveGame_PutVarint(std::vector<unsigned char>* bytes, unsigned int value)
+{
+    while (value >= 0x80)
+    {
+        bytes->push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    bytes->push_back((unsigned char)value);
+}
+
+static bool SaveGame_GetVarint(const unsigned char** in, const unsigned char* end, unsigned int* value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 35 && *in < end; shift += 7)
+    {
+        unsigned char byte = *(*in)++;
+        *value |= (unsigned int)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// FNV-1a; "hash" continua o checksum de bytes anteriores
+static unsigned int SaveGame_Checksum(const unsigned char* bytes, size_t size, unsigned int hash = 2166136261u)
+{
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Checksum do arquivo inteiro, com o campo do próprio checksum zerado
+static unsigned int SaveGame_FileChecksum(const unsigned char* bytes, size_t size)
+{
+    static const unsigned char zero[4] = {0, 0, 0, 0};
+    unsigned int hash = SaveGame_Checksum(bytes, SAVEGAME_CHECKSUM_OFFSET);
+    hash = SaveGame_Checksum(zero, 4, hash);
+    return SaveGame_Checksum(bytes + SAVEGAME_CHECKSUM_OFFSET + 4, size - SAVEGAME_CHECKSUM_OFFSET - 4, hash);
+}
+
+static int SaveGame_Quantize(float value)
+{
+    return (int)floorf(value * SAVEGAME_POSITION_SCALE + 0.5f);
+}
+
+void SaveGame_Encode(const SaveGame* save, std::vector<unsigned char>* bytes)
+{
+    std::vector<SaveGameTrunk> trunks = save->trunks;
+    std::sort(trunks.begin(), trunks.end(), [](const SaveGameTrunk &a, const SaveGameTrunk &b){ return a.tree < b.tree; });
+
+    bytes->assign(SAVEGAME_HEADER_SIZE, 0);
+    bytes->reserve(SAVEGAME_HEADER_SIZE + save->felled.size() * 8 + trunks.size() * 6);
+
+    for (size_t w = 0; w < save->felled.size(); ++w)
+    {
+        unsigned char word[8];
+        SaveGame_PutU32(word, (unsigned int)save->felled[w]);
+        SaveGame_PutU32(word + 4, (unsigned int)(save->felled[w] >> 32));
+        bytes->insert(bytes->end(), word, word + 8);
+    }
+
+    // Árvores cortadas uma perto da outra (o caso comum) custam poucos bytes
+    int previous_x = 0, previous_z = 0;
+    for (size_t i = 0; i < trunks.size(); ++i)
+    {
+        int x = SaveGame_Quantize(trunks[i].position.x);
+        int z = SaveGame_Quantize(trunks[i].position.y);
+        SaveGame_PutVarint(bytes, SaveGame_ZigZag(x - previous_x));
+        SaveGame_PutVarint(bytes, SaveGame_ZigZag(z - previous_z));
+        previous_x = x;
+        previous_z = z;
+    }
+
+    unsigned char* header = bytes->data();
+    size_t payload = bytes->size() - SAVEGAME_HEADER_SIZE;
+    SaveGame_PutU32(header + 0,  SAVEGAME_MAGIC);
+    SaveGame_PutU32(header + 4,  SAVEGAME_VERSION | (SAVEGAME_HEADER_SIZE << 16));
+    SaveGame_PutU32(header + 8,  save->seed);
+    SaveGame_PutU32(header + 12, (unsigned int)save->tree_count);
+    SaveGame_PutU32(header + 16, SaveGame_FloatBits(save->player_position.x));
+    SaveGame_PutU32(header + 20, SaveGame_FloatBits(save->player_position.y));
+    SaveGame_PutU32(header + 24, (unsigned int)save->quest_level);
+    SaveGame_PutU32(header + 28, (unsigned int)save->quest_felled);
+    SaveGame_PutU32(header + 32, save->quest_accepted ? 1u : 0u);
+    SaveGame_PutU32(header + 36, (unsigned int)trunks.size());
+    SaveGame_PutU32(header + 40, (unsigned int)payload);
+    SaveGame_PutU32(header + SAVEGAME_CHECKSUM_OFFSET, SaveGame_FileChecksum(header, bytes->size()));
+}
+
+bool SaveGame_Decode(SaveGame* save, const unsigned char* bytes, size_t size)
+{
+    if (size < SAVEGAME_HEADER_SIZE || SaveGame_GetU32(bytes) != SAVEGAME_MAGIC)
+        return false;
+
+    unsigned int version = SaveGame_GetU32(bytes + 4) & 0xFFFF;
+    unsigned int header_size = SaveGame_GetU32(bytes + 4) >> 16;
+    if (version == 0 || version > SAVEGAME_VERSION || header_size < SAVEGAME_HEADER_SIZE || header_size > size)
+        return false;
+
+    unsigned int tree_count = SaveGame_GetU32(bytes + 12);
+    unsigned int felled_count = SaveGame_GetU32(bytes + 36);
+    unsigned int payload = SaveGame_GetU32(bytes + 40);
+    unsigned int checksum = version == 1 ? SaveGame_Checksum(bytes + header_size, payload) : SaveGame_FileChecksum(bytes, size);
+    if (payload != size - header_size || SaveGame_GetU32(bytes + SAVEGAME_CHECKSUM_OFFSET) != checksum)
+        return false; // Arquivo cortado ou corrompido
+    if (tree_count > 0x7FFFFFFFu || felled_count > tree_count || payload < (tree_count + 63ull) / 64 * 8)
+        return false;
+
+    SaveGame_Init(save, SaveGame_GetU32(bytes + 8), (int)tree_count);
+    save->player_position = glm::vec2(SaveGame_BitsFloat(SaveGame_GetU32(bytes + 16)), SaveGame_BitsFloat(SaveGame_GetU32(bytes + 20)));
+    save->quest_level = (int)SaveGame_GetU32(bytes + 24);
+    save->quest_felled = (int)SaveGame_GetU32(bytes + 28);
+    save->quest_accepted = SaveGame_GetU32(bytes + 32) & 1;
+    if (!std::isfinite(save->player_position.x) || !std::isfinite(save->player_position.y) ||
+        save->quest_level < 0 || save->quest_level >= SAVEGAME_QUEST_LEVELS || save->quest_felled < 0)
+        return false;
+
+    const unsigned char* in = bytes + header_size;
+    const unsigned char* end = bytes + size;
+    for (size_t w = 0; w < save->felled.size(); ++w, in += 8)
+        save->felled[w] = SaveGame_GetU32(in) | ((unsigned long long)SaveGame_GetU32(in + 4) << 32);
+
+    // Os troncos seguem a ordem dos bits ligados
+    save->trunks.resize(felled_count);
+    int previous_x = 0, previous_z = 0;
+    size_t trunk = 0;
+    for (size_t w = 0; w < save->felled.size(); ++w)
+    {
+        unsigned long long bits = save->felled[w];
+        while (bits)
+        {
+            int tree = (int)(w * 64) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            unsigned int dx, dz;
+            if (tree >= save->tree_count || trunk >= felled_count || !SaveGame_GetVarint(&in, end, &dx) || !SaveGame_GetVarint(&in, end, &dz))
+                return false;
+            previous_x += SaveGame_UnZigZag(dx);
+            previous_z += SaveGame_UnZigZag(dz);
+
+            save->trunks[trunk].tree = tree;
+            save->trunks[trunk].position = glm::vec2(previous_x, previous_z) / SAVEGAME_POSITION_SCALE;
+            trunk += 1;
+        }
+    }
+
+    return trunk == felled_count && in == end;
+}
+
+bool SaveGame_Load(SaveGame* save, const char* filename)
+{
+    bool ok = false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping)
+        {
+            const void* bytes = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (bytes)
+            {
+                ok = SaveGame_Decode(save, (const unsigned char*)bytes, (size_t)size.QuadPart);
+                UnmapViewOfFile(bytes);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(filename, O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        void* bytes = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (bytes != MAP_FAILED)
+        {
+            ok = SaveGame_Decode(save, (const unsigned char*)bytes, (size_t)info.st_size);
+            munmap(bytes, (size_t)info.st_size);
+        }
+    }
+    close(file);
+#endif
+
+    return ok;
+}
+
+bool SaveGame_Write(const SaveGame* save, const char* filename, size_t* written)
+{
+    std::vector<unsigned char> bytes;
+    SaveGame_Encode(save, &bytes);
+    if (written)
+        *written = bytes.size();
+
+    std::string temporary = std::string(filename) + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporary.c_str(), filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temporary.c_str(), filename) == 0;
+#endif
+}
+
+static void SaveWriter_Thread(SaveWriter* writer)
+{
+    SaveGame save;
+    std::unique_lock<std::mutex> lock(writer->mutex);
+    while (true)
+    {
+        writer->wake.wait(lock, [writer]{ return !writer->running || writer->has_pending; });
+        if (!writer->has_pending)
+            break; // Parando, sem nada para gravar
+
+        std::swap(save, writer->pending);
+        writer->has_pending = false;
+
+        lock.unlock();
+        double start = SaveGame_Now();
+        size_t bytes = 0;
+        bool ok = SaveGame_Write(&save, writer->filename.c_str(), &bytes);
+        double ms = SaveGame_Now() - start;
+        lock.lock();
+
+        if (ok)
+        {
+            writer->writes += 1;
+            writer->last_ms = ms;
+            writer->last_bytes = bytes;
+        }
+        else
+        {
+            writer->failures += 1;
+            fprintf(stderr, "Não foi possível gravar o jogo salvo \"%s\"\n", writer->filename.c_str());
+        }
+    }
+}
+
+void SaveWriter_Start(SaveWriter* writer, const char* filename)
+{
+    writer->filename = filename;
+    writer->running = true;
+    writer->has_pending = false;
+    writer->writes = 0;
+    writer->failures = 0;
+    writer->last_bytes = 0;
+    writer->last_ms = 0.0;
+    writer->thread = std::thread(SaveWriter_Thread, writer);
+}
+
+void SaveWriter_Submit(SaveWriter* writer, SaveGame* save)
+{
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        std::swap(writer->pending, *save);
+        writer->has_pending = true;
+    }
+    writer->wake.notify_one();
+}
+
+void SaveWriter_Stop(SaveWriter* writer)
+{
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->running = false;
+    }
+    writer->wake.notify_all();
+    if (writer->thread.joinable())
+        writer->thread.join();
+}
@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "sceneconfig.h"
+
+#define SCENE_OPTION_OK      0
+#define SCENE_OPTION_INVALID 1 // Valor que não é um número válido para a opção
+#define SCENE_OPTION_UNKNOWN 2 // Não existe opção com este nome
+
+void SceneConfig_Defaults(SceneConfig* config)
+{
+    config->trees = 250;
+    config->decorations = 400;
+    config->rocks = 200;
+    config->logs = 10;
+    config->lanterns = 240;
+    config->seed = 2023;
+    config->forest_radius = 150.0f;
+    config->streaming = 0;
+    config->stream_radius = 320.0f;
+    config->chunk_budget_mb = 64;
+}
+
+// Troca uma opção pelo nome
+static int SceneConfig_Set(SceneConfig* config, const std::string &name, const std::string &value)
+{
+    struct IntOption
+    {
+        const char* name;
+        int*        value;
+        int         minimum;
+    };
+    // Com limite de memória zero, os pedaços seriam descartados assim que
+    // ficassem prontos e pedidos de novo a cada quadro
+    IntOption int_options[] = {
+        {"trees",           &config->trees,           0},
+        {"decorations",     &config->decorations,     0},
+        {"rocks",           &config->rocks,           0},
+        {"logs",            &config->logs,            0},
+        {"lanterns",        &config->lanterns,        0},
+        {"streaming",       &config->streaming,       0},
+        {"chunk_budget_mb", &config->chunk_budget_mb, 1},
+    };
+
+    char* end;
+    const char* text = value.c_str();
+
+    for (size_t i = 0; i < sizeof(int_options) / sizeof(int_options[0]); ++i)
+    {
+        if (name != int_options[i].name)
+            continue;
+        long number = strtol(text, &end, 10);
+        if (end == text || *end != '\0' || number < int_options[i].minimum || number > 100000000)
+            return SCENE_OPTION_INVALID;
+        *int_options[i].value = (int)number;
+        return SCENE_OPTION_OK;
+    }
+
+    if (name == "seed")
+    {
+        unsigned long number = strtoul(text, &end, 10);
+        if (end == text || *end != '\0')
+            return SCENE_OPTION_INVALID;
+        config->seed = (unsigned int)number;
+        return SCENE_OPTION_OK;
+    }
+
+    // Raios, em metros. A floresta precisa ir além da clareira em volta do
+    // centro do mapa, de 50 m de raio, onde não há árvores.
+    struct FloatOption
+    {
+        const char* name;
+        float*      value;
+        float       minimum; // O valor deve ser maior do que este
+    };
+    FloatOption float_options[] = {
+        {"forest_radius", &config->forest_radius, 50.0f},
+        {"stream_radius", &config->stream_radius, 10.0f},
+    };
+
+    for (size_t i = 0; i < sizeof(float_options) / sizeof(float_options[0]); ++i)
+    {
+        if (name != float_options[i].name)
+            continue;
+        float number = strtof(text, &end);
+        if (end == text || *end != '\0' || !(number > float_options[i].minimum))
+            return SCENE_OPTION_INVALID;
+        *float_options[i].value = number;
+        return SCENE_OPTION_OK;
+    }
+
+    return SCENE_OPTION_UNKNOWN;
+}
+
+bool SceneConfig_Load(SceneConfig* config, const char* filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+        return false;
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number += 1;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        // "nome = valor"; o "=" é trocado por espaço para que a leitura
+        // aceite também "nome=valor"
+        size_t equals = line.find('=');
+        if (equals != std::string::npos)
+            line[equals] = ' ';
+
+        std::istringstream fields(line);
+        std::string name, value, extra;
+        if (!(fields >> name))
+            continue; // Linha vazia
+        if (equals == std::string::npos || !(fields >> value) || (fields >> extra) || SceneConfig_Set(config, name, value) != SCENE_OPTION_OK)
+            fprintf(stderr, "%s:%d: opção inválida ignorada\n", filename, line_number);
+    }
+
+    return true;
+}
+
+void SceneConfig_ParseArguments(SceneConfig* config, int argc, char* argv[])
+{
+    // O arquivo vem primeiro, para que as opções da linha de comando tenham
+    // prioridade sobre ele
+    for (int arg = 1; arg + 1 < argc; ++arg)
+    {
+        if (strcmp(argv[arg], "--config") == 0)
+        {
+            if (!SceneConfig_Load(config, argv[arg + 1]))
+                fprintf(stderr, "Não foi possível abrir o arquivo de configuração \"%s\"\n", argv[arg + 1]);
+            arg += 1;
+        }
+    }
+
+    for (int arg = 1; arg + 1 < argc; ++arg)
+    {
+        if (strncmp(argv[arg], "--", 2) != 0 || strcmp(argv[arg], "--config") == 0)
+            continue;
+
+        int result = SceneConfig_Set(config, argv[arg] + 2, argv[arg + 1]);
+        if (result == SCENE_OPTION_UNKNOWN)
+            continue; // Não é uma opção do mapa
+        if (result == SCENE_OPTION_INVALID)
+            fprintf(stderr, "Valor inválido para %s: \"%s\"\n", argv[arg], argv[arg + 1]);
+        arg += 1;
+    }
+}
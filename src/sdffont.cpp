@@ -0,0 +1,470 @@
+// Geração de um atlas de campo de distância com sinal (SDF) a partir do atlas
+// bitmap de "dejavufont.h".
+//
+// Cada glifo é amostrado com interpolação bilinear em uma grade de alta
+// resolução, limiarizado em 0.5 e convertido em um campo de distância pela
+// transformada de distância Euclidiana exata de Felzenszwalb e Huttenlocher.
+// FONTE: https://cs.brown.edu/people/pfelzens/papers/dt-final.pdf
+// FONTE: https://steamcdn-a.akamaihd.net/apps/valve/2007/SIGGRAPH2007_AlphaTestedMagnification.pdf
+#include <cmath>
+#include <algorithm>
+
+#include "sdffont.h"
+#include "dejavufont.h"
+
+#define SDF_SPREAD      3 // Margem do campo de distância em pixels da fonte
+#define SDF_SUPERSAMPLE 8 // Resolução da grade de limiarização (por pixel da fonte)
+#define SDF_ATLAS_WIDTH 512
+
+// Bitmap de cobertura [0,1] de um glifo. "left" é a coluna mais à esquerda em
+// relação à origem da caneta e "top" é a linha do topo em relação à baseline
+// (para cima). A linha 0 de px[] é a linha do topo.
+struct GlyphBitmap
+{
+    int                w, h;
+    int                left, top;
+    std::vector<float> px;
+
+    float at(int c, int r) const
+    {
+        if (c < 0 || r < 0 || c >= w || r >= h)
+            return 0.0f;
+        return px[r*w + c];
+    }
+};
+
+enum AccentType { ACCENT_GRAVE, ACCENT_ACUTE, ACCENT_CIRCUMFLEX, ACCENT_TILDE, ACCENT_DIAERESIS, ACCENT_CEDILLA };
+
+struct ComposedGlyph
+{
+    uint32_t   codepoint;
+    char       base;
+    AccentType accent;
+};
+
+// Letras acentuadas do Latin-1 geradas a partir das letras ASCII.
+static const ComposedGlyph composed_glyphs[] = {
+    {0xC0, 'A', ACCENT_GRAVE}, {0xC1, 'A', ACCENT_ACUTE}, {0xC2, 'A', ACCENT_CIRCUMFLEX}, {0xC3, 'A', ACCENT_TILDE}, {0xC4, 'A', ACCENT_DIAERESIS},
+    {0xC7, 'C', ACCENT_CEDILLA},
+    {0xC8, 'E', ACCENT_GRAVE}, {0xC9, 'E', ACCENT_ACUTE}, {0xCA, 'E', ACCENT_CIRCUMFLEX}, {0xCB, 'E', ACCENT_DIAERESIS},
+    {0xCC, 'I', ACCENT_GRAVE}, {0xCD, 'I', ACCENT_ACUTE}, {0xCE, 'I', ACCENT_CIRCUMFLEX}, {0xCF, 'I', ACCENT_DIAERESIS},
+    {0xD1, 'N', ACCENT_TILDE},
+    {0xD2, 'O', ACCENT_GRAVE}, {0xD3, 'O', ACCENT_ACUTE}, {0xD4, 'O', ACCENT_CIRCUMFLEX}, {0xD5, 'O', ACCENT_TILDE}, {0xD6, 'O', ACCENT_DIAERESIS},
+    {0xD9, 'U', ACCENT_GRAVE}, {0xDA, 'U', ACCENT_ACUTE}, {0xDB, 'U', ACCENT_CIRCUMFLEX}, {0xDC, 'U', ACCENT_DIAERESIS},
+    {0xE0, 'a', ACCENT_GRAVE}, {0xE1, 'a', ACCENT_ACUTE}, {0xE2, 'a', ACCENT_CIRCUMFLEX}, {0xE3, 'a', ACCENT_TILDE}, {0xE4, 'a', ACCENT_DIAERESIS},
+    {0xE7, 'c', ACCENT_CEDILLA},
+    {0xE8, 'e', ACCENT_GRAVE}, {0xE9, 'e', ACCENT_ACUTE}, {0xEA, 'e', ACCENT_CIRCUMFLEX}, {0xEB, 'e', ACCENT_DIAERESIS},
+    {0xEC, 'i', ACCENT_GRAVE}, {0xED, 'i', ACCENT_ACUTE}, {0xEE, 'i', ACCENT_CIRCUMFLEX}, {0xEF, 'i', ACCENT_DIAERESIS},
+    {0xF1, 'n', ACCENT_TILDE},
+    {0xF2, 'o', ACCENT_GRAVE}, {0xF3, 'o', ACCENT_ACUTE}, {0xF4, 'o', ACCENT_CIRCUMFLEX}, {0xF5, 'o', ACCENT_TILDE}, {0xF6, 'o', ACCENT_DIAERESIS},
+    {0xF9, 'u', ACCENT_GRAVE}, {0xFA, 'u', ACCENT_ACUTE}, {0xFB, 'u', ACCENT_CIRCUMFLEX}, {0xFC, 'u', ACCENT_DIAERESIS},
+};
+
+static const texture_glyph_t* FindDejavuGlyph(uint32_t codepoint)
+{
+    for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
+        if (dejavufont.glyphs[j].codepoint == codepoint)
+            return &dejavufont.glyphs[j];
+    return NULL;
+}
+
+// Copia a região do glifo do atlas bitmap original.
+static GlyphBitmap ExtractGlyph(const texture_glyph_t* glyph)
+{
+    GlyphBitmap bitmap;
+    bitmap.w = glyph->width;
+    bitmap.h = glyph->height;
+    bitmap.left = glyph->offset_x;
+    bitmap.top = glyph->offset_y;
+    bitmap.px.resize(bitmap.w * bitmap.h);
+
+    int x0 = (int)floor(glyph->s0 * dejavufont.tex_width + 0.5f);
+    int y0 = (int)floor(glyph->t0 * dejavufont.tex_height + 0.5f);
+
+    for (int r = 0; r < bitmap.h; ++r)
+        for (int c = 0; c < bitmap.w; ++c)
+            bitmap.px[r*bitmap.w + c] = dejavufont.tex_data[(y0 + r)*dejavufont.tex_width + (x0 + c)] / 255.0f;
+
+    return bitmap;
+}
+
+// Remove as linhas e colunas vazias ao redor do glifo.
+static GlyphBitmap Trim(const GlyphBitmap &bitmap)
+{
+    int cmin = bitmap.w, cmax = -1, rmin = bitmap.h, rmax = -1;
+    for (int r = 0; r < bitmap.h; ++r)
+        for (int c = 0; c < bitmap.w; ++c)
+            if (bitmap.at(c, r) > 0.0f)
+            {
+                cmin = std::min(cmin, c);
+                cmax = std::max(cmax, c);
+                rmin = std::min(rmin, r);
+                rmax = std::max(rmax, r);
+            }
+
+    GlyphBitmap trimmed;
+    if (cmax < 0)
+    {
+        trimmed.w = trimmed.h = 0;
+        trimmed.left = bitmap.left;
+        trimmed.top = bitmap.top;
+        return trimmed;
+    }
+
+    trimmed.w = cmax - cmin + 1;
+    trimmed.h = rmax - rmin + 1;
+    trimmed.left = bitmap.left + cmin;
+    trimmed.top = bitmap.top - rmin;
+    trimmed.px.resize(trimmed.w * trimmed.h);
+    for (int r = 0; r < trimmed.h; ++r)
+        for (int c = 0; c < trimmed.w; ++c)
+            trimmed.px[r*trimmed.w + c] = bitmap.at(cmin + c, rmin + r);
+
+    return trimmed;
+}
+
+static GlyphBitmap MirrorX(const GlyphBitmap &bitmap)
+{
+    GlyphBitmap mirrored = bitmap;
+    for (int r = 0; r < bitmap.h; ++r)
+        for (int c = 0; c < bitmap.w; ++c)
+            mirrored.px[r*bitmap.w + c] = bitmap.at(bitmap.w - 1 - c, r);
+    return mirrored;
+}
+
+// Combina "src" sobre "dst" (máximo das coberturas), expandindo "dst" caso necessário.
+static void Blit(GlyphBitmap* dst, const GlyphBitmap &src)
+{
+    int left = std::min(dst->left, src.left);
+    int top = std::max(dst->top, src.top);
+    int right = std::max(dst->left + dst->w, src.left + src.w);
+    int bottom = std::min(dst->top - dst->h, src.top - src.h);
+
+    GlyphBitmap out;
+    out.left = left;
+    out.top = top;
+    out.w = right - left;
+    out.h = top - bottom;
+    out.px.assign(out.w * out.h, 0.0f);
+
+    for (int r = 0; r < out.h; ++r)
+        for (int c = 0; c < out.w; ++c)
+        {
+            int x = left + c;
+            int y = top - r;
+            float a = dst->at(x - dst->left, dst->top - y);
+            float b = src.at(x - src.left, src.top - y);
+            out.px[r*out.w + c] = std::max(a, b);
+        }
+
+    *dst = out;
+}
+
+static GlyphBitmap AccentBitmap(AccentType accent)
+{
+    switch (accent)
+    {
+        case ACCENT_GRAVE:      return Trim(ExtractGlyph(FindDejavuGlyph('`')));
+        case ACCENT_ACUTE:      return MirrorX(Trim(ExtractGlyph(FindDejavuGlyph('`'))));
+        case ACCENT_CIRCUMFLEX: return Trim(ExtractGlyph(FindDejavuGlyph('^')));
+        case ACCENT_TILDE:      return Trim(ExtractGlyph(FindDejavuGlyph('~')));
+        case ACCENT_CEDILLA:    return Trim(ExtractGlyph(FindDejavuGlyph(',')));
+        case ACCENT_DIAERESIS:
+        {
+            // Dois pontos lado a lado
+            GlyphBitmap dot = Trim(ExtractGlyph(FindDejavuGlyph('.')));
+            GlyphBitmap second = dot;
+            second.left += dot.w + 2;
+            Blit(&dot, second);
+            return dot;
+        }
+    }
+    return GlyphBitmap();
+}
+
+// Constrói o bitmap de uma letra acentuada.
+static GlyphBitmap ComposeGlyph(const ComposedGlyph &composed)
+{
+    GlyphBitmap base = Trim(ExtractGlyph(FindDejavuGlyph(composed.base)));
+
+    // O "i" minúsculo perde o pingo antes de receber o acento
+    if (composed.base == 'i')
+    {
+        int xheight = FindDejavuGlyph('x')->offset_y;
+        for (int r = 0; r < base.h; ++r)
+            if (base.top - r > xheight)
+                for (int c = 0; c < base.w; ++c)
+                    base.px[r*base.w + c] = 0.0f;
+        base = Trim(base);
+    }
+
+    GlyphBitmap accent = AccentBitmap(composed.accent);
+    accent.left = base.left + (base.w - accent.w) / 2;
+
+    if (composed.accent == ACCENT_CEDILLA)
+        accent.top = 0; // Pendurada abaixo da baseline
+    else
+        accent.top = base.top + 1 + accent.h;
+
+    Blit(&base, accent);
+    return base;
+}
+
+// Transformada de distância 1D (quadrática) de Felzenszwalb e Huttenlocher.
+static void DistanceTransform1D(const float* f, int n, float* d, int* v, float* z)
+{
+    const float INF = 1e20f;
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = +INF;
+    for (int q = 1; q < n; ++q)
+    {
+        float s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+        while (s <= z[k])
+        {
+            --k;
+            s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = +INF;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q)
+    {
+        while (z[k+1] < q)
+            ++k;
+        d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+    }
+}
+
+// Transformada de distância 2D separável. Na entrada, grid[] vale 0 nos
+// pixels de interesse e infinito nos demais; na saída contém o quadrado da
+// distância até o pixel de interesse mais próximo.
+static void DistanceTransform2D(std::vector<float> &grid, int w, int h)
+{
+    int n = std::max(w, h);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for (int x = 0; x < w; ++x)
+    {
+        for (int y = 0; y < h; ++y)
+            f[y] = grid[y*w + x];
+        DistanceTransform1D(f.data(), h, d.data(), v.data(), z.data());
+        for (int y = 0; y < h; ++y)
+            grid[y*w + x] = d[y];
+    }
+    for (int y = 0; y < h; ++y)
+    {
+        DistanceTransform1D(&grid[y*w], w, d.data(), v.data(), z.data());
+        std::copy(d.begin(), d.begin() + w, grid.begin() + y*w);
+    }
+}
+
+// Célula do atlas ainda não posicionada.
+struct SdfCell
+{
+    SdfGlyph                   glyph;
+    int                        w, h; // Em texels do atlas
+    std::vector<unsigned char> data;
+};
+
+static SdfCell BuildCell(uint32_t codepoint, const GlyphBitmap &bitmap, float advance_x, float kerning, int texels_per_pixel)
+{
+    const int P = SDF_SPREAD;
+    const int H = SDF_SUPERSAMPLE;
+    const int R = texels_per_pixel;
+    const float INF = 1e20f;
+
+    int cw = bitmap.w + 2*P;
+    int ch = bitmap.h + 2*P;
+
+    // Limiarização na grade de alta resolução, com interpolação bilinear da cobertura
+    int gw = cw*H;
+    int gh = ch*H;
+    std::vector<bool> inside(gw*gh);
+    for (int gy = 0; gy < gh; ++gy)
+        for (int gx = 0; gx < gw; ++gx)
+        {
+            float bx = (gx + 0.5f)/H - P - 0.5f;
+            float by = (gy + 0.5f)/H - P - 0.5f;
+            int x0 = (int)floor(bx);
+            int y0 = (int)floor(by);
+            float fx = bx - x0;
+            float fy = by - y0;
+            float cov = (1-fx)*(1-fy)*bitmap.at(x0, y0)   + fx*(1-fy)*bitmap.at(x0+1, y0)
+                      + (1-fx)*fy*bitmap.at(x0, y0+1)     + fx*fy*bitmap.at(x0+1, y0+1);
+            inside[gy*gw + gx] = cov >= 0.5f;
+        }
+
+    std::vector<float> to_inside(gw*gh), to_outside(gw*gh);
+    for (int i = 0; i < gw*gh; ++i)
+    {
+        to_inside[i] = inside[i] ? 0.0f : INF;
+        to_outside[i] = inside[i] ? INF : 0.0f;
+    }
+    DistanceTransform2D(to_inside, gw, gh);
+    DistanceTransform2D(to_outside, gw, gh);
+
+    SdfCell cell;
+    cell.w = cw*R;
+    cell.h = ch*R;
+    cell.data.resize(cell.w * cell.h);
+    for (int ty = 0; ty < cell.h; ++ty)
+        for (int tx = 0; tx < cell.w; ++tx)
+        {
+            int gx = std::min(gw - 1, (int)((tx + 0.5f)/R*H));
+            int gy = std::min(gh - 1, (int)((ty + 0.5f)/R*H));
+            int i = gy*gw + gx;
+
+            // Distância com sinal (positiva fora do glifo) em pixels da fonte
+            float sd = inside[i] ? -(sqrtf(to_outside[i]) - 0.5f) : (sqrtf(to_inside[i]) - 0.5f);
+            sd /= H;
+
+            float value = 0.5f - sd / (2.0f*P);
+            value = std::min(1.0f, std::max(0.0f, value));
+            cell.data[ty*cell.w + tx] = (unsigned char)(value*255.0f + 0.5f);
+        }
+
+    cell.glyph.codepoint = codepoint;
+    cell.glyph.offset_x = bitmap.left - P;
+    cell.glyph.offset_y = bitmap.top + P;
+    cell.glyph.width = cw;
+    cell.glyph.height = ch;
+    cell.glyph.advance_x = advance_x;
+    cell.glyph.kerning = kerning;
+    return cell;
+}
+
+void SdfFont_Build(SdfFont* font, int texels_per_pixel)
+{
+    std::vector<SdfCell> cells;
+
+    // Glifos ASCII da fonte original
+    for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
+    {
+        const texture_glyph_t* glyph = &dejavufont.glyphs[j];
+        if (glyph->codepoint == (uint32_t)-1)
+            continue;
+
+        GlyphBitmap bitmap = Trim(ExtractGlyph(glyph));
+        cells.push_back(BuildCell(glyph->codepoint, bitmap, glyph->advance_x, glyph->kerning[0].kerning, texels_per_pixel));
+    }
+
+    // Letras acentuadas compostas
+    for (size_t j = 0; j < sizeof(composed_glyphs)/sizeof(composed_glyphs[0]); ++j)
+    {
+        const texture_glyph_t* base = FindDejavuGlyph(composed_glyphs[j].base);
+        GlyphBitmap bitmap = ComposeGlyph(composed_glyphs[j]);
+        cells.push_back(BuildCell(composed_glyphs[j].codepoint, bitmap, base->advance_x, base->kerning[0].kerning, texels_per_pixel));
+    }
+
+    // Empacotamento em prateleiras ("shelf packing"), da célula mais alta para a mais baixa
+    std::vector<size_t> order(cells.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cells[a].h > cells[b].h; });
+
+    std::vector<int> cell_x(cells.size()), cell_y(cells.size());
+    int x = 0, y = 0, shelf_height = 0;
+    for (size_t k = 0; k < order.size(); ++k)
+    {
+        const SdfCell &cell = cells[order[k]];
+        if (x + cell.w + 1 > SDF_ATLAS_WIDTH)
+        {
+            x = 0;
+            y += shelf_height + 1;
+            shelf_height = 0;
+        }
+        cell_x[order[k]] = x;
+        cell_y[order[k]] = y;
+        x += cell.w + 1;
+        shelf_height = std::max(shelf_height, cell.h);
+    }
+
+    int height = 1;
+    while (height < y + shelf_height)
+        height *= 2;
+
+    font->tex_width = SDF_ATLAS_WIDTH;
+    font->tex_height = height;
+    font->tex_data.assign(font->tex_width * font->tex_height, 0);
+    font->height = dejavufont.height;
+    font->spread = SDF_SPREAD;
+    font->glyphs.clear();
+    std::fill(font->latin1_index, font->latin1_index + 256, -1);
+
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        const SdfCell &cell = cells[i];
+        for (int r = 0; r < cell.h; ++r)
+            std::copy(cell.data.begin() + r*cell.w, cell.data.begin() + (r+1)*cell.w,
+                      font->tex_data.begin() + (cell_y[i] + r)*font->tex_width + cell_x[i]);
+
+        SdfGlyph glyph = cell.glyph;
+        glyph.s0 = (float)cell_x[i] / font->tex_width;
+        glyph.t0 = (float)cell_y[i] / font->tex_height;
+        glyph.s1 = (float)(cell_x[i] + cell.w) / font->tex_width;
+        glyph.t1 = (float)(cell_y[i] + cell.h) / font->tex_height;
+
+        if (glyph.codepoint < 256)
+            font->latin1_index[glyph.codepoint] = (int)font->glyphs.size();
+        font->glyphs.push_back(glyph);
+    }
+}
+
+const SdfGlyph* SdfFont::Find(uint32_t codepoint) const
+{
+    if (codepoint < 256)
+        return latin1_index[codepoint] >= 0 ? &glyphs[latin1_index[codepoint]] : NULL;
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+        if (glyphs[i].codepoint == codepoint)
+            return &glyphs[i];
+    return NULL;
+}
+
+uint32_t UTF8_Decode(const std::string &str, size_t &i)
+{
+    const uint32_t REPLACEMENT = 0xFFFD;
+    unsigned char c = str[i++];
+
+    if (c < 0x80)
+        return c;
+
+    int extra;
+    uint32_t codepoint;
+    if ((c & 0xE0) == 0xC0)      { extra = 1; codepoint = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { extra = 2; codepoint = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { extra = 3; codepoint = c & 0x07; }
+    else
+        return REPLACEMENT;
+
+    for (int k = 0; k < extra; ++k)
+    {
+        if (i >= str.size() || ((unsigned char)str[i] & 0xC0) != 0x80)
+            return REPLACEMENT;
+        codepoint = (codepoint << 6) | ((unsigned char)str[i++] & 0x3F);
+    }
+
+    // Rejeita codificações "overlong" e valores fora do Unicode
+    static const uint32_t min_value[4] = {0, 0x80, 0x800, 0x10000};
+    if (codepoint < min_value[extra] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        return REPLACEMENT;
+
+    return codepoint;
+}
+
+size_t UTF8_Length(const std::string &str)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < str.size(); )
+    {
+        UTF8_Decode(str, i);
+        ++length;
+    }
+    return length;
+}
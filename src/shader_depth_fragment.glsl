@@ -0,0 +1,7 @@
+#version 330 core
+
+// Fragment shader do pré-passo de profundidade. Nenhuma cor é escrita: apenas
+// o Z-buffer é preenchido.
+void main()
+{
+}
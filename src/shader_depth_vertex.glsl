@@ -0,0 +1,66 @@
+#version 330 core
+
+// Vertex shader do pré-passo de profundidade: apenas a posição do vértice é
+// necessária. Veja a função DrawOpaqueItems() em "main.cpp".
+layout (location = 0) in vec4 model_coefficients;
+layout (location = 1) in vec4 normal_coefficients; // Só o "w", que marca os vértices do terreno
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// Vento (veja "shader_vertex.glsl")
+uniform float time;
+uniform vec3 wind;
+
+// Mapa de alturas do terreno (veja "shader_vertex.glsl")
+uniform sampler2D heightmap;
+
+// A posição deve ser calculada exatamente como em "shader_vertex.glsl" para
+// que o passo de shading com glDepthFunc(GL_EQUAL) encontre os mesmos valores
+// de profundidade.
+invariant gl_Position;
+
+// Cópia de WindDisplacement() de "shader_vertex.glsl"
+vec4 WindDisplacement(vec4 p)
+{
+    float height = max(wind.z, 0.001);
+    float bend = clamp(p.y / height, 0.0, 1.0);
+    bend = bend * bend;
+
+    float phase = wind.x;
+    float gust = 0.15 * sin(5.7 * time + 1.7 * phase + 0.5 * p.x);
+    vec2 sway = vec2(0.3 * sin(1.3 * time + phase), sin(2.0 * time + phase)) + gust;
+
+    return vec4(sway.x, 0.0, sway.y, 0.0) * (wind.y * height * bend);
+}
+
+// Cópia de TerrainVertex() de "shader_vertex.glsl"
+vec4 TerrainVertex(vec4 p, out vec4 terrain_normal, out float shade)
+{
+    ivec2 mask = textureSize(heightmap, 0) - 1;
+    ivec2 texel = ivec2(round((model * p).xz / model[0][0]));
+
+    vec2 center = texelFetch(heightmap, texel & mask, 0).rg;
+    float left  = texelFetch(heightmap, (texel + ivec2(-1, 0)) & mask, 0).r;
+    float right = texelFetch(heightmap, (texel + ivec2( 1, 0)) & mask, 0).r;
+    float back  = texelFetch(heightmap, (texel + ivec2(0, -1)) & mask, 0).r;
+    float front = texelFetch(heightmap, (texel + ivec2(0,  1)) & mask, 0).r;
+
+    terrain_normal = vec4(left - right, 2.0, back - front, 0.0);
+    shade = center.g;
+    return vec4(p.x, center.r, p.z, 1.0);
+}
+
+void main()
+{
+    vec4 position = model_coefficients;
+    vec4 terrain_normal;
+    float terrain_shade;
+    if (normal_coefficients.w == 1.0)
+        position = TerrainVertex(model_coefficients, terrain_normal, terrain_shade);
+    else if (wind.y != 0.0)
+        position += WindDisplacement(model_coefficients);
+
+    gl_Position = projection * view * model * position;
+}
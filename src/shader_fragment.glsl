@@ -1,289 +1,382 @@
-#version 330 core
-
-// Atributos de fragmentos recebidos como entrada ("in") pelo Fragment Shader.
-// Neste exemplo, este atributo foi gerado pelo rasterizador como a
-// interpolação da posição global e a normal de cada vértice, definidas em
-// "shader_vertex.glsl" e "main.cpp".
-in vec4 position_world;
-in vec4 normal;
-
-// Posição do vértice atual no sistema de coordenadas local do modelo.
-in vec4 position_model;
-
-// Coordenadas de textura obtidas do arquivo OBJ (se existirem!)
-in vec2 texcoords;
-
-// Matrizes computadas no código C++ e enviadas para a GPU
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-// Identificador que define qual objeto está sendo desenhado no momento
-#define TERRAIN 0
-#define TREES 1
-#define MOUNTAINS 2
-#define CHARACTER 3
-#define CHARACTER_CAPA 4
-#define AXE 5
-#define BIGTREE 6
-#define CHICKEN_LEG 7
-#define CHICKEN_BODY 8
-#define CHICKEN_EYE 9
-#define CHICKEN_COMB 10
-
-uniform int object_id;
-
-// Parâmetros da axis-aligned bounding box (AABB) do modelo
-uniform vec4 bbox_min;
-uniform vec4 bbox_max;
-
-// Variáveis para acesso das imagens de textura
-uniform sampler2D TextureImage0;
-uniform sampler2D TextureImage1;
-uniform sampler2D TextureImage2;
-uniform sampler2D TextureImage3;
-uniform sampler2D TextureImage4;
-uniform sampler2D TextureImage5;
-
-// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
-out vec4 color;
-
-// Constantes
-#define M_PI   3.14159265358979323846
-#define M_PI_2 1.57079632679489661923
-
-void main()
-{
-    // Obtemos a posição da câmera utilizando a inversa da matriz que define o
-    // sistema de coordenadas da câmera.
-    vec4 origin = vec4(0.0, 0.0, 0.0, 1.0);
-    vec4 camera_position = inverse(view) * origin;
-
-    // O fragmento atual é coberto por um ponto que percente à superfície de um
-    // dos objetos virtuais da cena. Este ponto, p, possui uma posição no
-    // sistema de coordenadas global (World coordinates). Esta posição é obtida
-    // através da interpolação, feita pelo rasterizador, da posição de cada
-    // vértice.
-    vec4 p = position_world;
-
-    // Normal do fragmento atual, interpolada pelo rasterizador a partir das
-    // normais de cada vértice.
-    vec4 n = normalize(normal);
-
-    // Vetor que define o sentido da fonte de luz em relação ao ponto atual.
-    vec4 l = normalize(vec4(1.0,1.0,0.0,0.0));
-
-    // Vetor que define o sentido da câmera em relação ao ponto atual.
-    vec4 v = normalize(camera_position - p);
-
-    // Vetor que define o sentido da reflexão especular ideal.
-    vec4 r = -l + 2.0*n*(dot(n,l));
-
-    // Parâmetros que definem as propriedades espectrais da superfície
-    vec3 Kd; // Refletância difusa
-    vec3 Ks; // Refletância especular
-    vec3 Ka; // Refletância ambiente
-    float q; // Expoente especular para o modelo de iluminação de Phong
-
-    // Coordenadas de textura U e V
-    float U = 0.0;
-    float V = 0.0;
-
-    float px = position_model.x;
-    float py = position_model.y;
-    float pz = position_model.z;
-
-    if ( object_id == TERRAIN )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        color.rgb = texture(TextureImage0, vec2(U,V)).rgb;
-        color.rgb = pow(color.rgb, vec3(1.0,1.0,1.0)/2.2);
-
-        return;
-    }
-    else if ( object_id == TREES )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = texture(TextureImage0, vec2(U,V)).rgb;
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == MOUNTAINS )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = texture(TextureImage1, vec2(U,V)).rgb;
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == CHARACTER )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = texture(TextureImage4, vec2(U,V)).rgb;
-        Ks = vec3(1.0,1.0,1.0);
-        Ka = Kd/2.0;
-        q  = 50.0;
-    }
-    else if ( object_id == AXE )
-    {
-        // Projeção planar XZ
-        float minx = bbox_min.x;
-        float maxx = bbox_max.x;
-
-        float miny = bbox_min.y;
-        float maxy = bbox_max.y;
-
-        float minz = bbox_min.z;
-        float maxz = bbox_max.z;
-
-        U = (px-minx)/(maxx-minx);
-        V = (pz-minx)/(maxy-miny);
-
-        Kd = texture(TextureImage2, vec2(U,V)).rgb;
-        Ks = vec3(0.1,0.1,0.1);
-        Ka = Kd/2.0;
-        q  = 15.0;
-    }
-    else if ( object_id == BIGTREE )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = texture(TextureImage3, vec2(U,V)).rgb;
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == CHARACTER_CAPA )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = texture(TextureImage5, vec2(U,V)).rgb;
-        Ks = vec3(1.0,1.0,1.0);
-        Ka = Kd/2.0;
-        q  = 50.0;
-    }
-    else if ( object_id == CHICKEN_LEG )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        Kd = vec3(0.996,0.402,0.0);
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == CHICKEN_BODY )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        Kd = vec3(0.976, 0.972, 0.960);
-        Ks = vec3(0.2,0.2,0.2);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == CHICKEN_EYE )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        Kd = vec3(0.0, 0.0, 0.0);
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else if ( object_id == CHICKEN_COMB )
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        Kd = vec3(0.996, 0.113, 0.093);
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = Kd/2.0;
-        q  = 1.0;
-    }
-    else
-    {
-        // Coordenadas de textura do plano, obtidas do arquivo OBJ
-        U = texcoords.x;
-        V = texcoords.y;
-
-        // Propriedades espectrais
-        Kd = vec3(0.0,0.0,0.0);
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = vec3(0.0,0.0,0.0);
-        q  = 1.0;
-    }
-
-    // Espectro da fonte de iluminação
-    vec3 I = vec3(1.0,1.0,1.0);
-
-    // Espectro da luz ambiente
-    vec3 Ia = vec3(0.2,0.2,0.2);
-
-    // Termo difuso utilizando a lei dos cossenos de Lambert
-    vec3 lambert_diffuse_term = Kd*I*max(0.0,dot(n,l));
-
-    // Termo ambiente
-    vec3 ambient_term = Ka*Ia;
-
-    // Termo especular utilizando o modelo de iluminação de Phong
-    vec3 phong_specular_term  = Ks*I*pow(max(0.0,dot(r,v)), q);
-
-    // Half-vector de Blinn-Phong
-    vec4 half_vector = normalize(l+v);
-
-    // Termo especular utilizando o modelo de iluminação de Blinn-Phong
-    vec3 blinn_phong_specular_term = Ks*I*pow(max(0.0,dot(n,half_vector)), q);
-
-    // NOTE: Se você quiser fazer o rendering de objetos transparentes, é
-    // necessário:
-    // 1) Habilitar a operação de "blending" de OpenGL logo antes de realizar o
-    //    desenho dos objetos transparentes, com os comandos abaixo no código C++:
-    //      glEnable(GL_BLEND);
-    //      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    // 2) Realizar o desenho de todos objetos transparentes *após* ter desenhado
-    //    todos os objetos opacos; e
-    // 3) Realizar o desenho de objetos transparentes ordenados de acordo com
-    //    suas distâncias para a câmera (desenhando primeiro objetos
-    //    transparentes que estão mais longe da câmera).
-    // Alpha default = 1 = 100% opaco = 0% transparente
-    color.a = 1;
-
-    // Cor final do fragmento calculada com uma combinação dos termos difuso,
-    // especular, e ambiente. Veja slide 129 do documento Aula_17_e_18_Modelos_de_Iluminacao.pdf.
-    if ( object_id == AXE || object_id == CHICKEN_BODY )
-        color.rgb = lambert_diffuse_term + ambient_term + blinn_phong_specular_term;
-    else
-        color.rgb = lambert_diffuse_term + ambient_term + phong_specular_term;
-
-    // Cor final com correção gamma, considerando monitor sRGB.
-    // Veja https://en.wikipedia.org/w/index.php?title=Gamma_correction&oldid=751281772#Windows.2C_Mac.2C_sRGB_and_TV.2Fvideo_standard_gammas
-    color.rgb = pow(color.rgb, vec3(1.0,1.0,1.0)/2.2);
-}
+#version 330 core
+
+// Atributos de fragmentos recebidos como entrada ("in") pelo Fragment Shader.
+// Neste exemplo, este atributo foi gerado pelo rasterizador como a
+// interpolação da posição global e a normal de cada vértice, definidas em
+// "shader_vertex.glsl" e "main.cpp".
+in vec4 position_world;
+in vec4 normal;
+
+// Posição do vértice atual no sistema de coordenadas local do modelo.
+in vec4 position_model;
+
+// Coordenadas de textura obtidas do arquivo OBJ (se existirem!)
+in vec2 texcoords;
+
+// Matrizes computadas no código C++ e enviadas para a GPU
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// Identificador que define qual objeto está sendo desenhado no momento
+#define TERRAIN 0
+#define TREES 1
+#define MOUNTAINS 2
+#define CHARACTER 3
+#define CHARACTER_CAPA 4
+#define AXE 5
+#define BIGTREE 6
+#define CHICKEN_LEG 7
+#define CHICKEN_BODY 8
+#define CHICKEN_EYE 9
+#define CHICKEN_COMB 10
+
+uniform int object_id;
+
+// Parâmetros da axis-aligned bounding box (AABB) do modelo
+uniform vec4 bbox_min;
+uniform vec4 bbox_max;
+
+// Variáveis para acesso das imagens de textura
+uniform sampler2D TextureImage0;
+uniform sampler2D TextureImage1;
+uniform sampler2D TextureImage2;
+uniform sampler2D TextureImage3;
+uniform sampler2D TextureImage4;
+uniform sampler2D TextureImage5;
+
+// Iluminação "clustered forward": listas de luzes pontuais por cluster do
+// frustum, montadas na CPU. Veja "lights.h" e "lights.cpp".
+uniform usamplerBuffer cluster_grid;          // (início, quantidade) em cluster_light_indices, por cluster
+uniform usamplerBuffer cluster_light_indices; // Índices das luzes
+uniform samplerBuffer  point_lights;          // 2 texels por luz: (posição, raio), (cor * intensidade, 0)
+uniform ivec3 cluster_dims;                   // Dimensões da grade de clusters
+uniform vec2  cluster_tile_size;              // Tamanho em pixels de cada bloco da tela
+uniform vec2  cluster_slice_params;           // fatia = log(profundidade)*x + y
+
+// Luz direcional (sol) e os seus shadow maps em cascata. Veja "shadows.h".
+uniform vec4 light_direction;                 // Sentido do ponto para o sol
+uniform sampler2DArrayShadow shadow_map;      // Uma camada por cascata
+uniform mat4 shadow_matrices[4];              // Coordenadas globais -> coordenadas do shadow map
+uniform vec4 cascade_splits;                  // Distância final de cada cascata
+uniform vec4 cascade_texel_size;              // Tamanho de um texel de cada cascata
+
+// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
+out vec4 color;
+
+// Constantes
+#define M_PI   3.14159265358979323846
+#define M_PI_2 1.57079632679489661923
+
+// Fração da luz do sol que chega ao ponto p (0 = sombra, 1 = iluminado),
+// com filtragem PCF 3x3 na cascata correspondente à profundidade do ponto.
+float ShadowVisibility(vec4 p, vec4 n)
+{
+    float depth = -(view * p).z;
+    if (depth >= cascade_splits.w)
+        return 1.0;
+
+    int cascade = 3;
+    if (depth < cascade_splits.x)      cascade = 0;
+    else if (depth < cascade_splits.y) cascade = 1;
+    else if (depth < cascade_splits.z) cascade = 2;
+
+    // Desloca o ponto na direção da normal, proporcional ao tamanho do texel,
+    // evitando que a superfície faça sombra sobre si mesma ("shadow acne")
+    float texel = cascade_texel_size[cascade];
+    vec4 shadow_coords = shadow_matrices[cascade] * (p + n*(1.5*texel));
+
+    vec2 texel_uv = 1.0 / vec2(textureSize(shadow_map, 0).xy);
+    float visibility = 0.0;
+    for (int y = -1; y <= 1; ++y)
+        for (int x = -1; x <= 1; ++x)
+            visibility += texture(shadow_map, vec4(shadow_coords.xy + vec2(x,y)*texel_uv, cascade, shadow_coords.z));
+
+    return visibility / 9.0;
+}
+
+// Soma das contribuições (difusa e especular de Blinn-Phong) das luzes
+// pontuais do cluster que contém o fragmento atual.
+vec3 PointLightsTerm(vec4 p, vec4 n, vec4 v, vec3 Kd, vec3 Ks, float q)
+{
+    // Cluster do fragmento: bloco da tela e fatia de profundidade
+    float depth = -(view * p).z;
+    ivec2 tile = ivec2(gl_FragCoord.xy / cluster_tile_size);
+    int slice = int(log(depth) * cluster_slice_params.x + cluster_slice_params.y);
+    tile = clamp(tile, ivec2(0), cluster_dims.xy - 1);
+    slice = clamp(slice, 0, cluster_dims.z - 1);
+    int cluster = tile.x + cluster_dims.x * (tile.y + cluster_dims.y * slice);
+
+    uvec2 range = texelFetch(cluster_grid, cluster).xy;
+
+    vec3 result = vec3(0.0,0.0,0.0);
+    for (uint i = 0u; i < range.y; ++i)
+    {
+        int light = int(texelFetch(cluster_light_indices, int(range.x + i)).r);
+        vec4 position_radius = texelFetch(point_lights, 2*light);
+        vec3 I = texelFetch(point_lights, 2*light + 1).rgb;
+
+        vec4 to_light = vec4(position_radius.xyz, 1.0) - p;
+        float d2 = dot(to_light, to_light);
+        float radius = position_radius.w;
+
+        // Atenuação com o inverso do quadrado da distância, suavizada para
+        // chegar a zero exatamente no raio da luz
+        float x = d2 / (radius*radius);
+        float window = clamp(1.0 - x*x, 0.0, 1.0);
+        float attenuation = window*window / (d2 + 1.0);
+
+        vec4 l = to_light * inversesqrt(d2);
+        vec4 h = normalize(l + v);
+        float diffuse = max(0.0, dot(n,l));
+        float specular = (diffuse > 0.0) ? pow(max(0.0, dot(n,h)), q) : 0.0;
+
+        result += (Kd*diffuse + Ks*specular) * I * attenuation;
+    }
+
+    return result;
+}
+
+void main()
+{
+    // Obtemos a posição da câmera utilizando a inversa da matriz que define o
+    // sistema de coordenadas da câmera.
+    vec4 origin = vec4(0.0, 0.0, 0.0, 1.0);
+    vec4 camera_position = inverse(view) * origin;
+
+    // O fragmento atual é coberto por um ponto que percente à superfície de um
+    // dos objetos virtuais da cena. Este ponto, p, possui uma posição no
+    // sistema de coordenadas global (World coordinates). Esta posição é obtida
+    // através da interpolação, feita pelo rasterizador, da posição de cada
+    // vértice.
+    vec4 p = position_world;
+
+    // Normal do fragmento atual, interpolada pelo rasterizador a partir das
+    // normais de cada vértice.
+    vec4 n = normalize(normal);
+
+    // Vetor que define o sentido da fonte de luz em relação ao ponto atual.
+    vec4 l = normalize(light_direction);
+
+    // Vetor que define o sentido da câmera em relação ao ponto atual.
+    vec4 v = normalize(camera_position - p);
+
+    // Vetor que define o sentido da reflexão especular ideal.
+    vec4 r = -l + 2.0*n*(dot(n,l));
+
+    // Parâmetros que definem as propriedades espectrais da superfície
+    vec3 Kd; // Refletância difusa
+    vec3 Ks; // Refletância especular
+    vec3 Ka; // Refletância ambiente
+    float q; // Expoente especular para o modelo de iluminação de Phong
+
+    // Coordenadas de textura U e V
+    float U = 0.0;
+    float V = 0.0;
+
+    float px = position_model.x;
+    float py = position_model.y;
+    float pz = position_model.z;
+
+    if ( object_id == TERRAIN )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // As encostas viradas para o sol ficam mais claras e as do lado
+        // oposto mais escuras; o chão plano mantém a cor da textura
+        color.rgb = texture(TextureImage0, vec2(U,V)).rgb;
+        color.rgb *= clamp(max(dot(n, l), 0.0) / max(l.y, 0.1), 0.6, 1.15);
+        color.rgb *= mix(0.6, 1.0, ShadowVisibility(p, n));
+        color.rgb += PointLightsTerm(p, n, v, color.rgb, vec3(0.0,0.0,0.0), 1.0);
+        color.rgb = pow(color.rgb, vec3(1.0,1.0,1.0)/2.2);
+
+        return;
+    }
+    else if ( object_id == TREES )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = texture(TextureImage0, vec2(U,V)).rgb;
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == MOUNTAINS )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = texture(TextureImage1, vec2(U,V)).rgb;
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == CHARACTER )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = texture(TextureImage4, vec2(U,V)).rgb;
+        Ks = vec3(1.0,1.0,1.0);
+        Ka = Kd/2.0;
+        q  = 50.0;
+    }
+    else if ( object_id == AXE )
+    {
+        // Projeção planar XZ
+        float minx = bbox_min.x;
+        float maxx = bbox_max.x;
+
+        float miny = bbox_min.y;
+        float maxy = bbox_max.y;
+
+        float minz = bbox_min.z;
+        float maxz = bbox_max.z;
+
+        U = (px-minx)/(maxx-minx);
+        V = (pz-minx)/(maxy-miny);
+
+        Kd = texture(TextureImage2, vec2(U,V)).rgb;
+        Ks = vec3(0.1,0.1,0.1);
+        Ka = Kd/2.0;
+        q  = 15.0;
+    }
+    else if ( object_id == BIGTREE )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = texture(TextureImage3, vec2(U,V)).rgb;
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == CHARACTER_CAPA )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = texture(TextureImage5, vec2(U,V)).rgb;
+        Ks = vec3(1.0,1.0,1.0);
+        Ka = Kd/2.0;
+        q  = 50.0;
+    }
+    else if ( object_id == CHICKEN_LEG )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        Kd = vec3(0.996,0.402,0.0);
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == CHICKEN_BODY )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        Kd = vec3(0.976, 0.972, 0.960);
+        Ks = vec3(0.2,0.2,0.2);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == CHICKEN_EYE )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        Kd = vec3(0.0, 0.0, 0.0);
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else if ( object_id == CHICKEN_COMB )
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        Kd = vec3(0.996, 0.113, 0.093);
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = Kd/2.0;
+        q  = 1.0;
+    }
+    else
+    {
+        // Coordenadas de textura do plano, obtidas do arquivo OBJ
+        U = texcoords.x;
+        V = texcoords.y;
+
+        // Propriedades espectrais
+        Kd = vec3(0.0,0.0,0.0);
+        Ks = vec3(0.0,0.0,0.0);
+        Ka = vec3(0.0,0.0,0.0);
+        q  = 1.0;
+    }
+
+    // Espectro da fonte de iluminação, atenuado pela sombra
+    vec3 I = vec3(1.0,1.0,1.0) * ShadowVisibility(p, n);
+
+    // Espectro da luz ambiente
+    vec3 Ia = vec3(0.2,0.2,0.2);
+
+    // Termo difuso utilizando a lei dos cossenos de Lambert
+    vec3 lambert_diffuse_term = Kd*I*max(0.0,dot(n,l));
+
+    // Termo ambiente
+    vec3 ambient_term = Ka*Ia;
+
+    // Termo especular utilizando o modelo de iluminação de Phong
+    vec3 phong_specular_term  = Ks*I*pow(max(0.0,dot(r,v)), q);
+
+    // Half-vector de Blinn-Phong
+    vec4 half_vector = normalize(l+v);
+
+    // Termo especular utilizando o modelo de iluminação de Blinn-Phong
+    vec3 blinn_phong_specular_term = Ks*I*pow(max(0.0,dot(n,half_vector)), q);
+
+    // NOTE: Se você quiser fazer o rendering de objetos transparentes, é
+    // necessário:
+    // 1) Habilitar a operação de "blending" de OpenGL logo antes de realizar o
+    //    desenho dos objetos transparentes, com os comandos abaixo no código C++:
+    //      glEnable(GL_BLEND);
+    //      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // 2) Realizar o desenho de todos objetos transparentes *após* ter desenhado
+    //    todos os objetos opacos; e
+    // 3) Realizar o desenho de objetos transparentes ordenados de acordo com
+    //    suas distâncias para a câmera (desenhando primeiro objetos
+    //    transparentes que estão mais longe da câmera).
+    // Alpha default = 1 = 100% opaco = 0% transparente
+    color.a = 1;
+
+    // Cor final do fragmento calculada com uma combinação dos termos difuso,
+    // especular, e ambiente. Veja slide 129 do documento Aula_17_e_18_Modelos_de_Iluminacao.pdf.
+    if ( object_id == AXE || object_id == CHICKEN_BODY )
+        color.rgb = lambert_diffuse_term + ambient_term + blinn_phong_specular_term;
+    else
+        color.rgb = lambert_diffuse_term + ambient_term + phong_specular_term;
+
+    // Luzes pontuais (fogueiras, lanternas e tochas)
+    color.rgb += PointLightsTerm(p, n, v, Kd, Ks, q);
+
+    // Cor final com correção gamma, considerando monitor sRGB.
+    // Veja https://en.wikipedia.org/w/index.php?title=Gamma_correction&oldid=751281772#Windows.2C_Mac.2C_sRGB_and_TV.2Fvideo_standard_gammas
+    color.rgb = pow(color.rgb, vec3(1.0,1.0,1.0)/2.2);
+}
@@ -1,67 +1,141 @@
-#version 330 core
-
-// Atributos de vértice recebidos como entrada ("in") pelo Vertex Shader.
-// Veja a função BuildTrianglesAndAddToVirtualScene() em "main.cpp".
-layout (location = 0) in vec4 model_coefficients;
-layout (location = 1) in vec4 normal_coefficients;
-layout (location = 2) in vec2 texture_coefficients;
-
-// Matrizes computadas no código C++ e enviadas para a GPU
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-// Atributos de vértice que serão gerados como saída ("out") pelo Vertex Shader.
-// ** Estes serão interpolados pelo rasterizador! ** gerando, assim, valores
-// para cada fragmento, os quais serão recebidos como entrada pelo Fragment
-// Shader. Veja o arquivo "shader_fragment.glsl".
-out vec4 position_world;
-out vec4 position_model;
-out vec4 normal;
-out vec2 texcoords;
-
-void main()
-{
-    // A variável gl_Position define a posição final de cada vértice
-    // OBRIGATORIAMENTE em "normalized device coordinates" (NDC), onde cada
-    // coeficiente estará entre -1 e 1 após divisão por w.
-    // Veja {+NDC2+}.
-    //
-    // O código em "main.cpp" define os vértices dos modelos em coordenadas
-    // locais de cada modelo (array model_coefficients). Abaixo, utilizamos
-    // operações de modelagem, definição da câmera, e projeção, para computar
-    // as coordenadas finais em NDC (variável gl_Position). Após a execução
-    // deste Vertex Shader, a placa de vídeo (GPU) fará a divisão por W. Veja
-    // slides 41-67 e 69-86 do documento Aula_09_Projecoes.pdf.
-
-    gl_Position = projection * view * model * model_coefficients;
-
-    // Como as variáveis acima  (tipo vec4) são vetores com 4 coeficientes,
-    // também é possível acessar e modificar cada coeficiente de maneira
-    // independente. Esses são indexados pelos nomes x, y, z, e w (nessa
-    // ordem, isto é, 'x' é o primeiro coeficiente, 'y' é o segundo, ...):
-    //
-    //     gl_Position.x = model_coefficients.x;
-    //     gl_Position.y = model_coefficients.y;
-    //     gl_Position.z = model_coefficients.z;
-    //     gl_Position.w = model_coefficients.w;
-    //
-
-    // Agora definimos outros atributos dos vértices que serão interpolados pelo
-    // rasterizador para gerar atributos únicos para cada fragmento gerado.
-
-    // Posição do vértice atual no sistema de coordenadas global (World).
-    position_world = model * model_coefficients;
-
-    // Posição do vértice atual no sistema de coordenadas local do modelo.
-    position_model = model_coefficients;
-
-    // Normal do vértice atual no sistema de coordenadas global (World).
-    // Veja slides 123-151 do documento Aula_07_Transformacoes_Geometricas_3D.pdf.
-    normal = inverse(transpose(model)) * normal_coefficients;
-    normal.w = 0.0;
-
-    // Coordenadas de textura obtidas do arquivo OBJ (se existirem!)
-    texcoords = texture_coefficients;
-}
-
+#version 330 core
+
+// Atributos de vértice recebidos como entrada ("in") pelo Vertex Shader.
+// Veja a função BuildTrianglesAndAddToVirtualScene() em "main.cpp".
+layout (location = 0) in vec4 model_coefficients;
+layout (location = 1) in vec4 normal_coefficients;
+layout (location = 2) in vec2 texture_coefficients;
+
+// Matrizes computadas no código C++ e enviadas para a GPU
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// Vento: tempo em segundos e, para o objeto sendo desenhado, a fase e a
+// amplitude do balanço (amplitude 0 para objetos que não balançam) e a
+// altura do modelo. Veja WindDisplacement() abaixo.
+uniform float time;
+uniform vec3 wind;
+
+// Mapa de alturas do terreno: altura (R) e altura normalizada (G). Veja
+// TerrainVertex() abaixo e "terrain.h".
+uniform sampler2D heightmap;
+
+// Atributos de vértice que serão gerados como saída ("out") pelo Vertex Shader.
+// ** Estes serão interpolados pelo rasterizador! ** gerando, assim, valores
+// para cada fragmento, os quais serão recebidos como entrada pelo Fragment
+// Shader. Veja o arquivo "shader_fragment.glsl".
+out vec4 position_world;
+out vec4 position_model;
+out vec4 normal;
+out vec2 texcoords;
+
+// Garante que gl_Position seja calculada da mesma forma que em
+// "shader_depth_vertex.glsl", requisito do pré-passo de profundidade.
+invariant gl_Position;
+
+// Deslocamento (no sistema de coordenadas do modelo) de um vértice da
+// vegetação balançando com o vento. A base do modelo fica presa ao chão e o
+// peso do balanço cresce com o quadrado da altura, então o topo das árvores
+// e das plantas se move mais que o meio. O balanço principal é em Z; uma
+// oscilação mais lenta em X e uma rajada mais rápida, que varia ao longo do
+// modelo, evitam um movimento rígido.
+//
+// ATENÇÃO: deve ser idêntica à de "shader_depth_vertex.glsl".
+vec4 WindDisplacement(vec4 p)
+{
+    float height = max(wind.z, 0.001);
+    float bend = clamp(p.y / height, 0.0, 1.0);
+    bend = bend * bend;
+
+    float phase = wind.x;
+    float gust = 0.15 * sin(5.7 * time + 1.7 * phase + 0.5 * p.x);
+    vec2 sway = vec2(0.3 * sin(1.3 * time + phase), sin(2.0 * time + phase)) + gust;
+
+    return vec4(sway.x, 0.0, sway.y, 0.0) * (wind.y * height * bend);
+}
+
+// Vértice de um pedaço do terreno: a malha é uma grade plana com
+// coordenadas inteiras, e a matriz de modelagem a desloca até o pedaço e a
+// escala pelo espaçamento entre as amostras do mapa de alturas. A altura vem
+// da amostra sob o vértice e a normal (no sistema de coordenadas do modelo)
+// das amostras vizinhas. O mapa se repete; como o tamanho é potência de 2, o
+// "e" bit a bit dá o resto também para coordenadas negativas.
+//
+// ATENÇÃO: deve ser idêntica à de "shader_depth_vertex.glsl".
+vec4 TerrainVertex(vec4 p, out vec4 terrain_normal, out float shade)
+{
+    ivec2 mask = textureSize(heightmap, 0) - 1;
+    ivec2 texel = ivec2(round((model * p).xz / model[0][0]));
+
+    vec2 center = texelFetch(heightmap, texel & mask, 0).rg;
+    float left  = texelFetch(heightmap, (texel + ivec2(-1, 0)) & mask, 0).r;
+    float right = texelFetch(heightmap, (texel + ivec2( 1, 0)) & mask, 0).r;
+    float back  = texelFetch(heightmap, (texel + ivec2(0, -1)) & mask, 0).r;
+    float front = texelFetch(heightmap, (texel + ivec2(0,  1)) & mask, 0).r;
+
+    terrain_normal = vec4(left - right, 2.0, back - front, 0.0);
+    shade = center.g;
+    return vec4(p.x, center.r, p.z, 1.0);
+}
+
+void main()
+{
+    // A variável gl_Position define a posição final de cada vértice
+    // OBRIGATORIAMENTE em "normalized device coordinates" (NDC), onde cada
+    // coeficiente estará entre -1 e 1 após divisão por w.
+    // Veja {+NDC2+}.
+    //
+    // O código em "main.cpp" define os vértices dos modelos em coordenadas
+    // locais de cada modelo (array model_coefficients). Abaixo, utilizamos
+    // operações de modelagem, definição da câmera, e projeção, para computar
+    // as coordenadas finais em NDC (variável gl_Position). Após a execução
+    // deste Vertex Shader, a placa de vídeo (GPU) fará a divisão por W. Veja
+    // slides 41-67 e 69-86 do documento Aula_09_Projecoes.pdf.
+
+    vec4 position = model_coefficients;
+    vec4 model_normal = normal_coefficients;
+    float terrain_shade = -1.0;
+    if (normal_coefficients.w == 1.0)
+        position = TerrainVertex(model_coefficients, model_normal, terrain_shade);
+    else if (wind.y != 0.0)
+        position += WindDisplacement(model_coefficients);
+
+    gl_Position = projection * view * model * position;
+
+    // Como as variáveis acima  (tipo vec4) são vetores com 4 coeficientes,
+    // também é possível acessar e modificar cada coeficiente de maneira
+    // independente. Esses são indexados pelos nomes x, y, z, e w (nessa
+    // ordem, isto é, 'x' é o primeiro coeficiente, 'y' é o segundo, ...):
+    //
+    //     gl_Position.x = model_coefficients.x;
+    //     gl_Position.y = model_coefficients.y;
+    //     gl_Position.z = model_coefficients.z;
+    //     gl_Position.w = model_coefficients.w;
+    //
+
+    // Agora definimos outros atributos dos vértices que serão interpolados pelo
+    // rasterizador para gerar atributos únicos para cada fragmento gerado.
+
+    // Posição do vértice atual no sistema de coordenadas global (World).
+    position_world = model * position;
+
+    // Posição do vértice atual no sistema de coordenadas local do modelo
+    // (sem o vento, para que as texturas projetadas acompanhem o objeto).
+    position_model = model_coefficients;
+
+    // Normal do vértice atual no sistema de coordenadas global (World).
+    // Veja slides 123-151 do documento Aula_07_Transformacoes_Geometricas_3D.pdf.
+    normal = inverse(transpose(model)) * model_normal;
+    normal.w = 0.0;
+
+    // Coordenadas de textura obtidas do arquivo OBJ (se existirem!)
+    texcoords = texture_coefficients;
+
+    // O terreno usa a faixa do degradê do antigo plano do chão
+    // ("SimpleGround_Plane.024" no OBJ): mais escuro nos vales, mais claro
+    // nos topos
+    if (terrain_shade >= 0.0)
+        texcoords = vec2(0.15, mix(0.75, 0.98, terrain_shade));
+}
+
@@ -0,0 +1,267 @@
+#include <cmath>
+#include <algorithm>
+
+#include <glm/vec4.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "shadows.h"
+#include "profiler.h"
+
+// Quais objetos de uma lista são desenhados em um shadow map
+#define SHADOW_DRAW_ALL     0
+#define SHADOW_DRAW_STATIC  1
+#define SHADOW_DRAW_DYNAMIC 2
+
+static const char* const g_CascadeNames[SHADOW_CASCADES] = {"Sombras: cascata 0", "Sombras: cascata 1",
+                                                            "Sombras: cascata 2", "Sombras: cascata 3"};
+static const char* const g_CacheNames[SHADOW_CASCADES] = {"", "", "Sombras: cache 2", "Sombras: cache 3"};
+
+void ShadowCascades_Init(ShadowCascades* shadows)
+{
+    shadows->light_direction = glm::vec3(0.0f, 0.0f, 0.0f);
+    shadows->static_version = -1;
+    for (int i = 0; i < SHADOW_CASCADES; ++i)
+    {
+        shadows->cache_valid[i] = false;
+        shadows->static_renders[i] = 0;
+        shadows->draws[i] = 0;
+        shadows->radius[i] = 0.0f;
+        shadows->center[i] = glm::vec2(0.0f, 0.0f);
+    }
+
+    // As cascatas são amostradas com comparação de profundidade em
+    // shader_fragment.glsl (sampler2DArrayShadow), com filtragem linear.
+    glGenTextures(1, &shadows->depth_texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadows->depth_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    glGenTextures(1, &shadows->static_texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadows->static_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, SHADOW_CASCADES - SHADOW_CACHED_FIRST, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Framebuffers somente com profundidade
+    glGenFramebuffers(1, &shadows->framebuffer);
+    glGenFramebuffers(1, &shadows->static_framebuffer);
+    GLuint framebuffers[2] = {shadows->framebuffer, shadows->static_framebuffer};
+    for (int i = 0; i < 2; ++i)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowCascades_Update(ShadowCascades* shadows, const glm::vec3 &light_direction, const glm::mat4 &camera_view,
+                           float field_of_view, float aspect, float near_distance, int static_version)
+{
+    // O cache só vale para a mesma luz e o mesmo conjunto de objetos estáticos
+    if (light_direction != shadows->light_direction || static_version != shadows->static_version)
+    {
+        for (int i = 0; i < SHADOW_CASCADES; ++i)
+            shadows->cache_valid[i] = false;
+    }
+    shadows->light_direction = light_direction;
+    shadows->static_version = static_version;
+
+    // Sistema de coordenadas da luz, fixo enquanto a luz não muda
+    glm::vec3 up = (fabs(light_direction.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    shadows->light_view = glm::lookAt(glm::vec3(0.0f), -light_direction, up);
+
+    glm::mat4 inverse_view = glm::inverse(camera_view);
+    glm::vec3 camera_position = glm::vec3(inverse_view[3]);
+
+    float t = tanf(field_of_view / 2.0f);
+    float r = t * aspect;
+
+    // Razão entre a distância de um canto do frustum e a sua profundidade
+    float corner_factor = sqrtf(1.0f + t*t + r*r);
+
+    // Matriz que leva as coordenadas de [-1,1] (NDC) para [0,1] (textura)
+    glm::mat4 bias = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+
+    float previous = near_distance;
+    for (int i = 0; i < SHADOW_CASCADES; ++i)
+    {
+        // Divisão "prática": média entre as divisões logarítmica e uniforme
+        float f = (float)(i + 1) / SHADOW_CASCADES;
+        float log_split = near_distance * powf(SHADOW_DISTANCE / near_distance, f);
+        float uniform_split = near_distance + (SHADOW_DISTANCE - near_distance) * f;
+        float split = 0.75f*log_split + 0.25f*uniform_split;
+        shadows->splits[i] = split;
+
+        glm::vec3 center_world;
+        float radius, step;
+
+        if (i < SHADOW_CACHED_FIRST)
+        {
+            // Esfera que envolve a fatia [previous, split] do frustum. O raio
+            // não depende da orientação da câmera, então o tamanho da cascata
+            // só muda com a projeção.
+            float mid = 0.5f*(previous + split);
+            float far_corner = glm::length(glm::vec3(r*split, t*split, split - mid));
+            float near_corner = glm::length(glm::vec3(r*previous, t*previous, mid - previous));
+            radius = ceilf(std::max(far_corner, near_corner) * 16.0f) / 16.0f;
+            center_world = glm::vec3(inverse_view * glm::vec4(0.0f, 0.0f, -mid, 1.0f));
+
+            // Passo de um texel: evita que as bordas das sombras "tremam"
+            step = 2.0f*radius / SHADOW_MAP_SIZE;
+        }
+        else
+        {
+            // Centrada na câmera, cobre a fatia em qualquer orientação. Move em
+            // passos de um quarto da cascata, invalidando o cache a cada passo.
+            radius = ceilf(split * corner_factor);
+            center_world = camera_position;
+            step = radius * 0.25f;
+        }
+
+        glm::vec3 c = glm::vec3(shadows->light_view * glm::vec4(center_world, 1.0f));
+        c = glm::floor(c / step) * step;
+
+        if (i >= SHADOW_CACHED_FIRST &&
+            (glm::vec2(c) != shadows->center[i] || radius != shadows->radius[i]))
+            shadows->cache_valid[i] = false;
+
+        shadows->center[i] = glm::vec2(c);
+        shadows->radius[i] = radius;
+        shadows->texel_size[i] = 2.0f*radius / SHADOW_MAP_SIZE;
+
+        // A luz olha para -z. O volume se estende SHADOW_DEPTH_RANGE para os
+        // dois lados do centro, para incluir objetos fora da cascata que
+        // projetam sombra dentro dela.
+        shadows->light_projection[i] = glm::ortho(c.x - radius, c.x + radius, c.y - radius, c.y + radius,
+                                                  -(c.z + SHADOW_DEPTH_RANGE), -(c.z - SHADOW_DEPTH_RANGE));
+        shadows->shadow_matrix[i] = bias * shadows->light_projection[i] * shadows->light_view;
+
+        previous = split;
+    }
+}
+
+// Desenha os objetos da lista que interceptam a cascata, conforme "filter".
+static int DrawCasters(const ShadowCascades* shadows, const DrawList &list, int cascade, int filter, GLint model_uniform, GLint wind_uniform)
+{
+    const glm::vec2 &center = shadows->center[cascade];
+    float radius = shadows->radius[cascade];
+    GLuint current_vao = 0;
+    bool wind_active = true; // Último "wind" enviado balança (true força o envio do primeiro)
+    int count = 0;
+
+    for (size_t i = 0; i < list.items.size(); ++i)
+    {
+        const DrawItem &item = list.items[i];
+
+        if (item.layer == DRAW_LAYER_BACKGROUND)
+            continue;
+        if ((filter == SHADOW_DRAW_STATIC && item.dynamic) || (filter == SHADOW_DRAW_DYNAMIC && !item.dynamic))
+            continue;
+
+        const glm::vec4 &sphere = shadows->caster_spheres[i];
+        if (fabs(sphere.x - center.x) > radius + sphere.w || fabs(sphere.y - center.y) > radius + sphere.w)
+            continue;
+
+        const SceneObject* object = item.object;
+        if (object->vertex_array_object_id != current_vao)
+        {
+            glBindVertexArray(object->vertex_array_object_id);
+            current_vao = object->vertex_array_object_id;
+        }
+
+        glUniformMatrix4fv(model_uniform, 1, GL_FALSE, glm::value_ptr(item.model));
+
+        // O cache é desenhado na posição de repouso: o balanço das árvores e
+        // plantas é de poucos centímetros, da ordem de um texel das cascatas
+        // distantes
+        glm::vec2 wind = filter == SHADOW_DRAW_STATIC ? glm::vec2(0.0f) : item.wind;
+
+        // Objetos parados em sequência não reenviam o vento
+        if (wind_active || wind.y != 0.0f)
+        {
+            glUniform3f(wind_uniform, wind.x, wind.y, object->bbox_max.y);
+            wind_active = wind.y != 0.0f;
+        }
+        glDrawElements(object->rendering_mode, object->num_indices, GL_UNSIGNED_INT,
+                       (void*)(object->first_index * sizeof(GLuint)));
+        count += 1;
+    }
+
+    glBindVertexArray(0);
+    return count;
+}
+
+void ShadowCascades_Render(ShadowCascades* shadows, const DrawList &list,
+                           GLint model_uniform, GLint wind_uniform, GLint view_uniform, GLint projection_uniform)
+{
+    // Esferas envolventes de cada objeto, no sistema de coordenadas da luz
+    shadows->caster_spheres.resize(list.items.size());
+    for (size_t i = 0; i < list.items.size(); ++i)
+    {
+        const DrawItem &item = list.items[i];
+        BoundingSphere sphere = BoundingSphere_Transform(item.object->bsphere, item.model);
+
+        glm::vec4 c = shadows->light_view * glm::vec4(sphere.center, 1.0f);
+        shadows->caster_spheres[i] = glm::vec4(c.x, c.y, c.z, sphere.radius);
+    }
+
+    glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+    glUniformMatrix4fv(view_uniform, 1, GL_FALSE, glm::value_ptr(shadows->light_view));
+
+    for (int i = 0; i < SHADOW_CASCADES; ++i)
+    {
+        Profiler_Begin(g_CascadeNames[i]);
+        glUniformMatrix4fv(projection_uniform, 1, GL_FALSE, glm::value_ptr(shadows->light_projection[i]));
+
+        if (i < SHADOW_CACHED_FIRST)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, shadows->framebuffer);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadows->depth_texture, 0, i);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            shadows->draws[i] = DrawCasters(shadows, list, i, SHADOW_DRAW_ALL, model_uniform, wind_uniform);
+        }
+        else
+        {
+            int layer = i - SHADOW_CACHED_FIRST;
+
+            // Redesenha a parte estática somente quando o cache foi invalidado
+            glBindFramebuffer(GL_FRAMEBUFFER, shadows->static_framebuffer);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadows->static_texture, 0, layer);
+            if (!shadows->cache_valid[i])
+            {
+                Profiler_Begin(g_CacheNames[i]);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                DrawCasters(shadows, list, i, SHADOW_DRAW_STATIC, model_uniform, wind_uniform);
+                shadows->cache_valid[i] = true;
+                shadows->static_renders[i] += 1;
+                Profiler_End();
+            }
+
+            // Copia o cache para a cascata e desenha por cima os objetos dinâmicos
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, shadows->static_framebuffer);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, shadows->framebuffer);
+            glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadows->depth_texture, 0, i);
+            glBlitFramebuffer(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE,
+                              GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, shadows->framebuffer);
+            shadows->draws[i] = DrawCasters(shadows, list, i, SHADOW_DRAW_DYNAMIC, model_uniform, wind_uniform);
+        }
+
+        Profiler_End();
+    }
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
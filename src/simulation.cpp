@@ -0,0 +1,101 @@
+#include <chrono>
+#include <algorithm>
+
+#include "simulation.h"
+
+static double Simulation_Now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Simulation_Init(Simulation* simulation, double rate, const std::function<void(float)> &update)
+{
+    simulation->step = 1.0 / rate;
+    simulation->accumulator = 0.0;
+    simulation->steps = 0;
+    simulation->update = update;
+    simulation->threaded = false;
+    simulation->last_step_time = 0.0;
+    simulation->running = false;
+}
+
+static void Simulation_Step(Simulation* simulation)
+{
+    std::lock_guard<std::mutex> lock(simulation->mutex);
+    simulation->update((float)simulation->step);
+    simulation->steps += 1;
+    simulation->last_step_time = Simulation_Now();
+}
+
+static void Simulation_Thread(Simulation* simulation)
+{
+    double next_step = Simulation_Now();
+
+    while (simulation->running)
+    {
+        Simulation_Step(simulation);
+
+        // Se a simulação atrasou mais do que SIMULATION_MAX_STEPS passos (ex.:
+        // o processo ficou parado), recomeça a contagem em vez de tentar
+        // recuperar o tempo perdido de uma vez
+        next_step += simulation->step;
+        double now = Simulation_Now();
+        if (now - next_step > SIMULATION_MAX_STEPS * simulation->step)
+            next_step = now;
+
+        if (next_step > now)
+            std::this_thread::sleep_for(std::chrono::duration<double>(next_step - now));
+    }
+}
+
+void Simulation_Start(Simulation* simulation, bool threaded)
+{
+    simulation->threaded = threaded;
+    simulation->last_step_time = Simulation_Now();
+
+    if (threaded)
+    {
+        simulation->running = true;
+        simulation->thread = std::thread(Simulation_Thread, simulation);
+    }
+}
+
+void Simulation_Stop(Simulation* simulation)
+{
+    if (simulation->threaded && simulation->running)
+    {
+        simulation->running = false;
+        simulation->thread.join();
+    }
+}
+
+void Simulation_Advance(Simulation* simulation, double frame_time)
+{
+    if (simulation->threaded)
+        return;
+
+    simulation->accumulator = std::min(simulation->accumulator + frame_time, SIMULATION_MAX_STEPS * simulation->step);
+    while (simulation->accumulator >= simulation->step)
+    {
+        Simulation_Step(simulation);
+        simulation->accumulator -= simulation->step;
+    }
+}
+
+double Simulation_Alpha(Simulation* simulation)
+{
+    double elapsed = simulation->threaded ? Simulation_Now() - simulation->last_step_time
+                                          : simulation->accumulator;
+    return std::max(0.0, std::min(1.0, elapsed / simulation->step));
+}
+
+void Simulation_Lock(Simulation* simulation)
+{
+    simulation->mutex.lock();
+}
+
+void Simulation_Unlock(Simulation* simulation)
+{
+    simulation->mutex.unlock();
+}
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "spatialgrid.h"
+
+void SpatialGrid_Init(SpatialGrid* grid, float cell_size)
+{
+    grid->cell_size = cell_size;
+    grid->origin = glm::vec2(0.0f, 0.0f);
+    grid->width = 0;
+    grid->height = 0;
+    grid->items.clear();
+    grid->cell_start.clear();
+    grid->cell_items.clear();
+}
+
+int SpatialGrid_Add(SpatialGrid* grid, int type, int index, const glm::vec2 &min, const glm::vec2 &max)
+{
+    GridItem item;
+    item.type = type;
+    item.index = index;
+    item.min = min;
+    item.max = max;
+    grid->items.push_back(item);
+    return (int)grid->items.size() - 1;
+}
+
+// Intervalo de células [first, last] tocado pelo retângulo de um item
+static void SpatialGrid_CellRange(const SpatialGrid* grid, const GridItem &item, int* first_x, int* first_z, int* last_x, int* last_z)
+{
+    *first_x = std::max(0, (int)floor((item.min.x - grid->origin.x) / grid->cell_size));
+    *first_z = std::max(0, (int)floor((item.min.y - grid->origin.y) / grid->cell_size));
+    *last_x  = std::min(grid->width  - 1, (int)floor((item.max.x - grid->origin.x) / grid->cell_size));
+    *last_z  = std::min(grid->height - 1, (int)floor((item.max.y - grid->origin.y) / grid->cell_size));
+}
+
+void SpatialGrid_Build(SpatialGrid* grid)
+{
+    grid->cell_start.clear();
+    grid->cell_items.clear();
+    grid->width = grid->height = 0;
+
+    if (grid->items.empty())
+        return;
+
+    // Limites da grade: o retângulo que envolve todos os itens
+    glm::vec2 bounds_min = grid->items[0].min;
+    glm::vec2 bounds_max = grid->items[0].max;
+    for (size_t i = 1; i < grid->items.size(); ++i)
+    {
+        bounds_min = glm::min(bounds_min, grid->items[i].min);
+        bounds_max = glm::max(bounds_max, grid->items[i].max);
+    }
+
+    glm::vec2 extent = bounds_max - bounds_min;
+    float min_cell_size = sqrt(extent.x * extent.y / SPATIAL_GRID_MAX_CELLS);
+    grid->cell_size = std::max(grid->cell_size, min_cell_size);
+
+    grid->origin = bounds_min;
+    grid->width  = (int)floor(extent.x / grid->cell_size) + 1;
+    grid->height = (int)floor(extent.y / grid->cell_size) + 1;
+
+    int num_cells = grid->width * grid->height;
+    grid->cell_start.assign(num_cells + 1, 0);
+
+    // Primeira passada: conta os itens de cada célula
+    for (size_t i = 0; i < grid->items.size(); ++i)
+    {
+        int first_x, first_z, last_x, last_z;
+        SpatialGrid_CellRange(grid, grid->items[i], &first_x, &first_z, &last_x, &last_z);
+        for (int z = first_z; z <= last_z; ++z)
+            for (int x = first_x; x <= last_x; ++x)
+                grid->cell_start[z * grid->width + x + 1] += 1;
+    }
+
+    for (int c = 0; c < num_cells; ++c)
+        grid->cell_start[c + 1] += grid->cell_start[c];
+
+    // Segunda passada: preenche as listas de cada célula
+    std::vector<int> cursor(grid->cell_start.begin(), grid->cell_start.end() - 1);
+    grid->cell_items.resize(grid->cell_start[num_cells]);
+    for (size_t i = 0; i < grid->items.size(); ++i)
+    {
+        int first_x, first_z, last_x, last_z;
+        SpatialGrid_CellRange(grid, grid->items[i], &first_x, &first_z, &last_x, &last_z);
+        for (int z = first_z; z <= last_z; ++z)
+            for (int x = first_x; x <= last_x; ++x)
+                grid->cell_items[cursor[z * grid->width + x]++] = (int)i;
+    }
+}
+
+const int* SpatialGrid_Query(const SpatialGrid* grid, float x, float z, int* count)
+{
+    *count = 0;
+    if (grid->width == 0)
+        return NULL;
+
+    int cell_x = (int)floor((x - grid->origin.x) / grid->cell_size);
+    int cell_z = (int)floor((z - grid->origin.y) / grid->cell_size);
+    if (cell_x < 0 || cell_x >= grid->width || cell_z < 0 || cell_z >= grid->height)
+        return NULL;
+
+    int cell = cell_z * grid->width + cell_x;
+    *count = grid->cell_start[cell + 1] - grid->cell_start[cell];
+    return grid->cell_items.data() + grid->cell_start[cell];
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPLINES_SSE
+#endif
+
+#include <glm/glm.hpp>
+
+#include "splines.h"
+
+// Coeficientes de um segmento na base de potências
+static void Spline_AddSegment(SplinePath* path, const glm::vec3 &c0, const glm::vec3 &c1, const glm::vec3 &c2, const glm::vec3 &c3)
+{
+    const glm::vec3* c[4] = {&c0, &c1, &c2, &c3};
+    for (int k = 0; k < 4; ++k)
+    {
+        path->cx.push_back(c[k]->x);
+        path->cy.push_back(c[k]->y);
+        path->cz.push_back(c[k]->z);
+    }
+    path->num_segments += 1;
+}
+
+void SplinePath_Build(SplinePath* path, int type, const glm::vec3* points, int count, bool closed)
+{
+    path->type = type;
+    path->num_segments = 0;
+    path->cx.clear();
+    path->cy.clear();
+    path->cz.clear();
+    path->table_parameter.clear();
+    path->length = 0.0f;
+
+    if (type == SPLINE_BEZIER)
+    {
+        for (int i = 0; i + 3 < count; i += 3)
+        {
+            const glm::vec3 &p0 = points[i];
+            const glm::vec3 &p1 = points[i + 1];
+            const glm::vec3 &p2 = points[i + 2];
+            const glm::vec3 &p3 = points[i + 3];
+            Spline_AddSegment(path, p0, 3.0f * (p1 - p0), 3.0f * (p0 - 2.0f * p1 + p2), -p0 + 3.0f * p1 - 3.0f * p2 + p3);
+        }
+    }
+    else
+    {
+        // Catmull-Rom uniforme: o segmento de P1 a P2 usa também os vizinhos
+        // P0 e P3. Nas pontas de um caminho aberto o vizinho que falta é o
+        // próprio ponto da ponta.
+        int num_segments = closed ? count : count - 1;
+        for (int i = 0; i < num_segments; ++i)
+        {
+            const glm::vec3 &p0 = closed ? points[(i + count - 1) % count] : points[std::max(i - 1, 0)];
+            const glm::vec3 &p1 = points[i];
+            const glm::vec3 &p2 = points[(i + 1) % count];
+            const glm::vec3 &p3 = closed ? points[(i + 2) % count] : points[std::min(i + 2, count - 1)];
+            Spline_AddSegment(path, p1, 0.5f * (p2 - p0), 0.5f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3),
+                              0.5f * (-p0 + 3.0f * p1 - 3.0f * p2 + p3));
+        }
+    }
+
+    if (path->num_segments == 0)
+        return;
+
+    // Comprimento acumulado em amostras densas do parâmetro (quatro vezes
+    // mais que a tabela final, para que a aproximação por segmentos de reta
+    // fique próxima do comprimento real)
+    int num_dense = path->num_segments * SPLINE_SAMPLES_PER_SEGMENT * 4;
+    std::vector<float> dense_length(num_dense + 1);
+    glm::vec3 previous = SplinePath_Evaluate(path, 0.0f);
+    dense_length[0] = 0.0f;
+    for (int i = 1; i <= num_dense; ++i)
+    {
+        glm::vec3 current = SplinePath_Evaluate(path, (float)path->num_segments * i / num_dense);
+        dense_length[i] = dense_length[i - 1] + glm::length(current - previous);
+        previous = current;
+    }
+    path->length = dense_length[num_dense];
+
+    // Inverte a relação: parâmetro em distâncias igualmente espaçadas
+    int table_size = path->num_segments * SPLINE_SAMPLES_PER_SEGMENT + 1;
+    path->table_parameter.resize(table_size);
+    int dense = 0;
+    for (int i = 0; i < table_size; ++i)
+    {
+        float distance = path->length * i / (table_size - 1);
+        while (dense < num_dense - 1 && dense_length[dense + 1] < distance)
+            dense += 1;
+
+        float span = dense_length[dense + 1] - dense_length[dense];
+        float fraction = span > 0.0f ? glm::clamp((distance - dense_length[dense]) / span, 0.0f, 1.0f) : 0.0f;
+        path->table_parameter[i] = (float)path->num_segments * (dense + fraction) / num_dense;
+    }
+}
+
+glm::vec3 SplinePath_Evaluate(const SplinePath* path, float parameter, glm::vec3* tangent)
+{
+    // Pontos de controle insuficientes: não há segmento para ler
+    if (path->num_segments == 0)
+    {
+        if (tangent)
+            *tangent = glm::vec3(0.0f);
+        return glm::vec3(0.0f);
+    }
+
+    int segment = std::min(std::max((int)parameter, 0), path->num_segments - 1);
+    float u = parameter - segment;
+
+    const float* cx = &path->cx[4 * segment];
+    const float* cy = &path->cy[4 * segment];
+    const float* cz = &path->cz[4 * segment];
+
+    if (tangent)
+        *tangent = glm::vec3(cx[1] + u * (2.0f * cx[2] + 3.0f * u * cx[3]),
+                             cy[1] + u * (2.0f * cy[2] + 3.0f * u * cy[3]),
+                             cz[1] + u * (2.0f * cz[2] + 3.0f * u * cz[3]));
+
+    return glm::vec3(cx[0] + u * (cx[1] + u * (cx[2] + u * cx[3])),
+                     cy[0] + u * (cy[1] + u * (cy[2] + u * cy[3])),
+                     cz[0] + u * (cz[1] + u * (cz[2] + u * cz[3])));
+}
+
+// Parâmetro global a uma distância do início, interpolado na tabela
+static float SplinePath_ParameterAt(const SplinePath* path, float distance)
+{
+    int last = (int)path->table_parameter.size() - 1;
+    if (path->length <= 0.0f)
+        return 0.0f;
+
+    float position = glm::clamp(distance, 0.0f, path->length) * (last / path->length);
+    float index = std::min(floorf(position), (float)(last - 1));
+    float fraction = position - index;
+
+    int i = (int)index;
+    return path->table_parameter[i] + fraction * (path->table_parameter[i + 1] - path->table_parameter[i]);
+}
+
+glm::vec3 SplinePath_PositionAt(const SplinePath* path, float distance, glm::vec3* tangent)
+{
+    return SplinePath_Evaluate(path, SplinePath_ParameterAt(path, distance), tangent);
+}
+
+void SplineAgents_Init(SplineAgents* agents, const SplinePath* path, int mode)
+{
+    agents->path = path;
+    agents->mode = mode;
+    agents->distance.clear();
+    agents->speed.clear();
+    agents->x.clear();
+    agents->y.clear();
+    agents->z.clear();
+    agents->heading_x.clear();
+    agents->heading_z.clear();
+}
+
+int SplineAgents_Add(SplineAgents* agents, float distance, float speed)
+{
+    glm::vec3 tangent;
+    glm::vec3 position = SplinePath_PositionAt(agents->path, distance, &tangent);
+    float sign = speed < 0.0f ? -1.0f : 1.0f;
+
+    agents->distance.push_back(distance);
+    agents->speed.push_back(speed);
+    agents->x.push_back(position.x);
+    agents->y.push_back(position.y);
+    agents->z.push_back(position.z);
+    agents->heading_x.push_back(sign * tangent.x);
+    agents->heading_z.push_back(sign * tangent.z);
+
+    return (int)agents->distance.size() - 1;
+}
+
+// Avança um agente: a versão escalar, usada para os agentes que sobram
+// depois dos grupos de quatro
+static void SplineAgents_AdvanceOne(SplineAgents* agents, size_t i, float dt)
+{
+    const SplinePath* path = agents->path;
+    float length = path->length;
+    float distance = agents->distance[i] + agents->speed[i] * dt;
+    float speed = agents->speed[i];
+
+    if (agents->mode == SPLINE_LOOP)
+        distance -= length * floorf(distance / length);
+    else if (agents->mode == SPLINE_PING_PONG)
+    {
+        // Reflete a parte que passou da ponta e inverte o sentido
+        if (distance > length)
+        {
+            distance = 2.0f * length - distance;
+            speed = -speed;
+        }
+        if (distance < 0.0f)
+        {
+            distance = -distance;
+            speed = -speed;
+        }
+    }
+    distance = glm::clamp(distance, 0.0f, length);
+
+    glm::vec3 tangent;
+    glm::vec3 position = SplinePath_PositionAt(path, distance, &tangent);
+    float sign = speed < 0.0f ? -1.0f : 1.0f;
+
+    agents->distance[i] = distance;
+    agents->speed[i] = speed;
+    agents->x[i] = position.x;
+    agents->y[i] = position.y;
+    agents->z[i] = position.z;
+    agents->heading_x[i] = sign * tangent.x;
+    agents->heading_z[i] = sign * tangent.z;
+}
+
+#if defined(SPLINES_SSE)
+// Escolhe "a" onde a máscara é verdadeira e "b" no restante
+static inline __m128 Splines_Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Parte inteira de valores não negativos (o truncamento é o piso)
+static inline __m128 Splines_Truncate(__m128 v)
+{
+    return _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+}
+
+// Lê os quatro coeficientes do segmento de cada agente e os transpõe: c[k]
+// fica com o coeficiente k dos quatro agentes
+static inline void Splines_Gather(const float* coefficients, const int* segment, __m128 c[4])
+{
+    c[0] = _mm_loadu_ps(coefficients + 4 * segment[0]);
+    c[1] = _mm_loadu_ps(coefficients + 4 * segment[1]);
+    c[2] = _mm_loadu_ps(coefficients + 4 * segment[2]);
+    c[3] = _mm_loadu_ps(coefficients + 4 * segment[3]);
+    _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+}
+#endif
+
+void SplineAgents_Advance(SplineAgents* agents, float dt)
+{
+    const SplinePath* path = agents->path;
+    size_t count = agents->distance.size();
+    size_t i = 0;
+
+    if (path->num_segments == 0 || path->length <= 0.0f)
+        return;
+
+#if defined(SPLINES_SSE)
+    int last = (int)path->table_parameter.size() - 1;
+    const float* table = path->table_parameter.data();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    const __m128 length = _mm_set1_ps(path->length);
+    const __m128 inverse_length = _mm_set1_ps(1.0f / path->length);
+    const __m128 table_scale = _mm_set1_ps(last / path->length);
+    const __m128 last_index = _mm_set1_ps((float)(last - 1));
+    const __m128 last_segment = _mm_set1_ps((float)(path->num_segments - 1));
+    const __m128 step = _mm_set1_ps(dt);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 speed = _mm_loadu_ps(&agents->speed[i]);
+        __m128 distance = _mm_add_ps(_mm_loadu_ps(&agents->distance[i]), _mm_mul_ps(speed, step));
+
+        if (agents->mode == SPLINE_LOOP)
+        {
+            // distance - length*floor(distance/length), com o piso a partir do truncamento
+            __m128 quotient = _mm_mul_ps(distance, inverse_length);
+            __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(quotient));
+            whole = _mm_sub_ps(whole, _mm_and_ps(_mm_cmpgt_ps(whole, quotient), _mm_set1_ps(1.0f)));
+            distance = _mm_sub_ps(distance, _mm_mul_ps(length, whole));
+        }
+        else if (agents->mode == SPLINE_PING_PONG)
+        {
+            __m128 over = _mm_cmpgt_ps(distance, length);
+            distance = Splines_Select(over, _mm_sub_ps(_mm_add_ps(length, length), distance), distance);
+            speed = _mm_xor_ps(speed, _mm_and_ps(over, sign_mask));
+
+            __m128 under = _mm_cmplt_ps(distance, zero);
+            distance = Splines_Select(under, _mm_xor_ps(distance, sign_mask), distance);
+            speed = _mm_xor_ps(speed, _mm_and_ps(under, sign_mask));
+        }
+        distance = _mm_min_ps(_mm_max_ps(distance, zero), length);
+
+        // Parâmetro interpolado na tabela de comprimento de arco
+        __m128 position = _mm_mul_ps(distance, table_scale);
+        __m128 index = _mm_min_ps(Splines_Truncate(position), last_index);
+        __m128 fraction = _mm_sub_ps(position, index);
+
+        alignas(16) int lane[4];
+        _mm_store_si128((__m128i*)lane, _mm_cvttps_epi32(index));
+        __m128 parameter0 = _mm_setr_ps(table[lane[0]],     table[lane[1]],     table[lane[2]],     table[lane[3]]);
+        __m128 parameter1 = _mm_setr_ps(table[lane[0] + 1], table[lane[1] + 1], table[lane[2] + 1], table[lane[3] + 1]);
+        __m128 parameter = _mm_add_ps(parameter0, _mm_mul_ps(fraction, _mm_sub_ps(parameter1, parameter0)));
+
+        // Segmento e posição "u" dentro dele
+        __m128 segment = _mm_min_ps(Splines_Truncate(parameter), last_segment);
+        __m128 u = _mm_sub_ps(parameter, segment);
+        _mm_store_si128((__m128i*)lane, _mm_cvttps_epi32(segment));
+
+        // Regra de Horner para a posição e para a derivada
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 three = _mm_set1_ps(3.0f);
+        __m128 heading_sign = _mm_and_ps(speed, sign_mask);
+        __m128 c[4];
+
+        Splines_Gather(path->cx.data(), lane, c);
+        __m128 x = _mm_add_ps(c[0], _mm_mul_ps(u, _mm_add_ps(c[1], _mm_mul_ps(u, _mm_add_ps(c[2], _mm_mul_ps(u, c[3]))))));
+        __m128 dx = _mm_add_ps(c[1], _mm_mul_ps(u, _mm_add_ps(_mm_mul_ps(two, c[2]), _mm_mul_ps(_mm_mul_ps(three, u), c[3]))));
+
+        Splines_Gather(path->cy.data(), lane, c);
+        __m128 y = _mm_add_ps(c[0], _mm_mul_ps(u, _mm_add_ps(c[1], _mm_mul_ps(u, _mm_add_ps(c[2], _mm_mul_ps(u, c[3]))))));
+
+        Splines_Gather(path->cz.data(), lane, c);
+        __m128 z = _mm_add_ps(c[0], _mm_mul_ps(u, _mm_add_ps(c[1], _mm_mul_ps(u, _mm_add_ps(c[2], _mm_mul_ps(u, c[3]))))));
+        __m128 dz = _mm_add_ps(c[1], _mm_mul_ps(u, _mm_add_ps(_mm_mul_ps(two, c[2]), _mm_mul_ps(_mm_mul_ps(three, u), c[3]))));
+
+        _mm_storeu_ps(&agents->distance[i], distance);
+        _mm_storeu_ps(&agents->speed[i], speed);
+        _mm_storeu_ps(&agents->x[i], x);
+        _mm_storeu_ps(&agents->y[i], y);
+        _mm_storeu_ps(&agents->z[i], z);
+        _mm_storeu_ps(&agents->heading_x[i], _mm_xor_ps(dx, heading_sign));
+        _mm_storeu_ps(&agents->heading_z[i], _mm_xor_ps(dz, heading_sign));
+    }
+#endif
+
+    for (; i < count; ++i)
+        SplineAgents_AdvanceOne(agents, i, dt);
+}
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+
+#include "terrain.h"
+#include "boundingvolumes.h"
+
+#define TERRAIN_OCTAVES 5 // Oitavas do ruído; a primeira tem 4 ondulações por repetição do mapa
+
+// Valor pseudoaleatório em [-1, 1] de um ponto da grade do ruído
+static float Terrain_Lattice(unsigned int seed, int x, int z)
+{
+    unsigned int h = seed ^ ((unsigned int)x * 0x8DA6B343u) ^ ((unsigned int)z * 0xD8163841u);
+    h ^= h >> 13;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 16;
+    return (h & 0xFFFFFF) * (2.0f / 16777215.0f) - 1.0f;
+}
+
+// Ruído de valor no ponto (u, v) de uma grade que se repete a cada "period"
+// pontos, com interpolação suave entre eles
+static float Terrain_ValueNoise(unsigned int seed, float u, float v, int period)
+{
+    int x0 = (int)floor(u);
+    int z0 = (int)floor(v);
+    float tx = u - x0;
+    float tz = v - z0;
+    tx = tx*tx*(3.0f - 2.0f*tx);
+    tz = tz*tz*(3.0f - 2.0f*tz);
+
+    int x1 = (x0 + 1) % period;
+    int z1 = (z0 + 1) % period;
+    x0 %= period;
+    z0 %= period;
+
+    float a = Terrain_Lattice(seed, x0, z0) + (Terrain_Lattice(seed, x1, z0) - Terrain_Lattice(seed, x0, z0))*tx;
+    float b = Terrain_Lattice(seed, x0, z1) + (Terrain_Lattice(seed, x1, z1) - Terrain_Lattice(seed, x0, z1))*tx;
+    return a + (b - a)*tz;
+}
+
+void Terrain_Generate(Terrain* terrain, int size, float spacing, float amplitude, float flat_radius, float falloff, unsigned int seed)
+{
+    terrain->size = size;
+    terrain->spacing = spacing;
+    terrain->heights.resize(size*size);
+    terrain->min_height = 0.0f;
+    terrain->max_height = 0.0f;
+
+    for (int j = 0; j < size; ++j)
+        for (int i = 0; i < size; ++i)
+        {
+            float noise = 0.0f;
+            float weight = 1.0f;
+            float total_weight = 0.0f;
+            for (int octave = 0; octave < TERRAIN_OCTAVES; ++octave)
+            {
+                int period = 4 << octave;
+                float scale = (float)period / size;
+                noise += weight * Terrain_ValueNoise(seed + octave, i*scale, j*scale, period);
+                total_weight += weight;
+                weight *= 0.5f;
+            }
+
+            // Distância até a origem mais próxima, já que o mapa se repete
+            float dx = std::min(i, size - i) * spacing;
+            float dz = std::min(j, size - j) * spacing;
+            float t = std::min(std::max((sqrtf(dx*dx + dz*dz) - flat_radius) / falloff, 0.0f), 1.0f);
+
+            float height = amplitude * noise / total_weight * t*t*(3.0f - 2.0f*t);
+            terrain->heights[j*size + i] = height;
+            terrain->min_height = std::min(terrain->min_height, height);
+            terrain->max_height = std::max(terrain->max_height, height);
+        }
+}
+
+float Terrain_Height(const Terrain* terrain, float x, float z)
+{
+    float fx = x / terrain->spacing;
+    float fz = z / terrain->spacing;
+    int x0 = (int)floor(fx);
+    int z0 = (int)floor(fz);
+    float tx = fx - x0;
+    float tz = fz - z0;
+
+    // O tamanho é potência de 2, então o "e" bit a bit faz a repetição
+    // também para coordenadas negativas
+    int mask = terrain->size - 1;
+    int x1 = (x0 + 1) & mask;
+    int z1 = (z0 + 1) & mask;
+    x0 &= mask;
+    z0 &= mask;
+
+    const float* h = terrain->heights.data();
+    int size = terrain->size;
+    float a = h[z0*size + x0] + (h[z0*size + x1] - h[z0*size + x0])*tx;
+    float b = h[z1*size + x0] + (h[z1*size + x1] - h[z1*size + x0])*tx;
+    return a + (b - a)*tz;
+}
+
+// Índice do vértice (i, j) da malha de um pedaço. Nos lados costurados, os
+// vértices ímpares do nível são puxados para o par anterior.
+static GLuint Terrain_StitchedVertex(int i, int j, int step, int stitch)
+{
+    const int last = TERRAIN_PATCH_QUADS;
+    if (((stitch & TERRAIN_STITCH_MIN_X) && i == 0) || ((stitch & TERRAIN_STITCH_MAX_X) && i == last))
+        j -= j % (2*step);
+    if (((stitch & TERRAIN_STITCH_MIN_Z) && j == 0) || ((stitch & TERRAIN_STITCH_MAX_Z) && j == last))
+        i -= i % (2*step);
+    return (GLuint)(j*(last + 1) + i);
+}
+
+void Terrain_Upload(Terrain* terrain, GLuint texture_unit)
+{
+    const int n = TERRAIN_PATCH_QUADS + 1;
+
+    // Textura com a altura (R) e a altura normalizada entre a mínima e a
+    // máxima (G), usada para a cor do chão
+    std::vector<float> texels(terrain->heights.size()*2);
+    float range = std::max(terrain->max_height - terrain->min_height, 0.001f);
+    for (size_t i = 0; i < terrain->heights.size(); ++i)
+    {
+        texels[2*i + 0] = terrain->heights[i];
+        texels[2*i + 1] = (terrain->heights[i] - terrain->min_height) / range;
+    }
+
+    glGenTextures(1, &terrain->heightmap_texture);
+    glActiveTexture(GL_TEXTURE0 + texture_unit);
+    glBindTexture(GL_TEXTURE_2D, terrain->heightmap_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, terrain->size, terrain->size, 0, GL_RG, GL_FLOAT, texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Grade plana de n x n vértices. A normal com w = 1 marca o vértice como
+    // do terreno para o vertex shader, que busca a altura e calcula a normal
+    // verdadeira (as normais dos modelos têm w = 0).
+    std::vector<float> positions, normals, texcoords;
+    for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+            float position[4] = {(float)i, 0.0f, (float)j, 1.0f};
+            float normal[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+            positions.insert(positions.end(), position, position + 4);
+            normals.insert(normals.end(), normal, normal + 4);
+            texcoords.push_back(0.0f);
+            texcoords.push_back(0.0f);
+        }
+
+    // Volumes envolventes comuns a todos os pedaços: a grade inteira entre a
+    // menor e a maior altura do terreno
+    float corners[8*4];
+    for (int c = 0; c < 8; ++c)
+    {
+        corners[4*c + 0] = (c & 1) ? (float)TERRAIN_PATCH_QUADS : 0.0f;
+        corners[4*c + 1] = (c & 2) ? terrain->max_height : terrain->min_height;
+        corners[4*c + 2] = (c & 4) ? (float)TERRAIN_PATCH_QUADS : 0.0f;
+        corners[4*c + 3] = 1.0f;
+    }
+    BoundingVolumes volumes;
+    BoundingVolumes_Compute(&volumes, corners, 8, 4);
+
+    GLuint vertex_array_object_id;
+    glGenVertexArrays(1, &vertex_array_object_id);
+    glBindVertexArray(vertex_array_object_id);
+
+    // Dois triângulos por quadrado do nível, no sentido anti-horário visto de
+    // cima. Os triângulos que a costura degenera são descartados.
+    std::vector<GLuint> indices;
+    for (int lod = 0; lod < TERRAIN_LODS; ++lod)
+        for (int stitch = 0; stitch < TERRAIN_STITCHES; ++stitch)
+        {
+            size_t first_index = indices.size();
+            int step = 1 << lod;
+            for (int j = 0; j < TERRAIN_PATCH_QUADS; j += step)
+                for (int i = 0; i < TERRAIN_PATCH_QUADS; i += step)
+                {
+                    GLuint a = Terrain_StitchedVertex(i,        j,        step, stitch);
+                    GLuint b = Terrain_StitchedVertex(i + step, j,        step, stitch);
+                    GLuint c = Terrain_StitchedVertex(i,        j + step, step, stitch);
+                    GLuint d = Terrain_StitchedVertex(i + step, j + step, step, stitch);
+                    GLuint triangles[6] = {a, c, b, b, c, d};
+                    for (int t = 0; t < 6; t += 3)
+                    {
+                        if (triangles[t] == triangles[t + 1] || triangles[t + 1] == triangles[t + 2] || triangles[t] == triangles[t + 2])
+                            continue;
+                        indices.insert(indices.end(), triangles + t, triangles + t + 3);
+                    }
+                }
+
+            SceneObject &object = terrain->patch_objects[lod][stitch];
+            object.name           = "terrain";
+            object.first_index    = first_index;
+            object.num_indices    = indices.size() - first_index;
+            object.rendering_mode = GL_TRIANGLES;
+            object.vertex_array_object_id = vertex_array_object_id;
+            object.bbox_min = volumes.aabb_min;
+            object.bbox_max = volumes.aabb_max;
+            object.bsphere  = volumes.sphere;
+            object.obb      = volumes.obb;
+            object.kdop     = volumes.kdop;
+        }
+
+    const std::vector<float>* attributes[3] = {&positions, &normals, &texcoords};
+    const GLint dimensions[3] = {4, 4, 2}; // "(location = 0, 1, 2)" em "shader_vertex.glsl"
+    for (GLuint location = 0; location < 3; ++location)
+    {
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, attributes[location]->size() * sizeof(float), attributes[location]->data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(location, dimensions[location], GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(location);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLuint indices_id;
+    glGenBuffers(1, &indices_id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+int Terrain_SelectPatches(const Terrain* terrain, float x, float z, float view_radius, float lod_distance,
+                          std::vector<TerrainPatch>* patches, int* lod_counts)
+{
+    float patch_size = TERRAIN_PATCH_QUADS * terrain->spacing;
+    int first_x = (int)floor((x - view_radius) / patch_size);
+    int first_z = (int)floor((z - view_radius) / patch_size);
+    int width  = (int)floor((x + view_radius) / patch_size) - first_x + 1;
+    int height = (int)floor((z + view_radius) / patch_size) - first_z + 1;
+
+    // Nível de cada pedaço da janela em volta do ponto, ou -1 se o pedaço
+    // está fora do raio
+    std::vector<int> lods(width*height, -1);
+    for (int j = 0; j < height; ++j)
+        for (int i = 0; i < width; ++i)
+        {
+            float min_x = (first_x + i) * patch_size;
+            float min_z = (first_z + j) * patch_size;
+            float dx = std::max(0.0f, std::max(min_x - x, x - (min_x + patch_size)));
+            float dz = std::max(0.0f, std::max(min_z - z, z - (min_z + patch_size)));
+            float distance = sqrtf(dx*dx + dz*dz);
+            if (distance > view_radius)
+                continue;
+
+            int lod = 0;
+            for (float limit = lod_distance; distance >= limit && lod < TERRAIN_LODS - 1; limit *= 2.0f)
+                lod += 1;
+            lods[j*width + i] = lod;
+        }
+
+    // Vizinhos com mais de um nível de diferença não podem ser costurados:
+    // o mais grosso fica mais fino até que a diferença seja no máximo um
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int j = 0; j < height; ++j)
+            for (int i = 0; i < width; ++i)
+            {
+                int &lod = lods[j*width + i];
+                if (lod < 0)
+                    continue;
+                const int neighbors[4][2] = {{i - 1, j}, {i + 1, j}, {i, j - 1}, {i, j + 1}};
+                for (int k = 0; k < 4; ++k)
+                {
+                    int ni = neighbors[k][0], nj = neighbors[k][1];
+                    if (ni < 0 || nj < 0 || ni >= width || nj >= height || lods[nj*width + ni] < 0)
+                        continue;
+                    if (lod > lods[nj*width + ni] + 1)
+                    {
+                        lod = lods[nj*width + ni] + 1;
+                        changed = true;
+                    }
+                }
+            }
+    }
+
+    if (lod_counts)
+        std::fill(lod_counts, lod_counts + TERRAIN_LODS, 0);
+
+    patches->clear();
+    for (int j = 0; j < height; ++j)
+        for (int i = 0; i < width; ++i)
+        {
+            int lod = lods[j*width + i];
+            if (lod < 0)
+                continue;
+
+            // Lados cujo vizinho é mais grosso
+            const int neighbors[4][3] = {{i - 1, j, TERRAIN_STITCH_MIN_X}, {i + 1, j, TERRAIN_STITCH_MAX_X},
+                                         {i, j - 1, TERRAIN_STITCH_MIN_Z}, {i, j + 1, TERRAIN_STITCH_MAX_Z}};
+            int stitch = 0;
+            for (int k = 0; k < 4; ++k)
+            {
+                int ni = neighbors[k][0], nj = neighbors[k][1];
+                if (ni >= 0 && nj >= 0 && ni < width && nj < height && lods[nj*width + ni] > lod)
+                    stitch |= neighbors[k][2];
+            }
+
+            TerrainPatch patch;
+            patch.px = first_x + i;
+            patch.pz = first_z + j;
+            patch.lod = lod;
+            patch.stitch = stitch;
+            patch.model = glm::mat4(terrain->spacing, 0.0f, 0.0f, 0.0f,
+                                    0.0f, 1.0f, 0.0f, 0.0f,
+                                    0.0f, 0.0f, terrain->spacing, 0.0f,
+                                    patch.px * patch_size, 0.0f, patch.pz * patch_size, 1.0f);
+            patches->push_back(patch);
+
+            if (lod_counts)
+                lod_counts[lod] += 1;
+        }
+
+    return (int)patches->size();
+}
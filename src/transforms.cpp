@@ -0,0 +1,71 @@
+#include <cstring>
+
+#include "transforms.h"
+
+void Transforms_Clear(TransformTree* tree)
+{
+    tree->parent.clear();
+    tree->local.clear();
+    tree->world.clear();
+    tree->world_matrix.clear();
+    tree->dirty.clear();
+    tree->changed.clear();
+    tree->first_dirty = 0;
+}
+
+int Transforms_Add(TransformTree* tree, int parent, const Affine &local)
+{
+    int node = (int)tree->parent.size();
+
+    tree->parent.push_back(parent);
+    tree->local.push_back(local);
+    tree->world.push_back(local);
+    tree->world_matrix.push_back(glm::mat4(1.0f));
+    tree->dirty.push_back(1);
+    tree->changed.push_back(0);
+    if (tree->first_dirty > node)
+        tree->first_dirty = node;
+
+    return node;
+}
+
+void Transforms_SetLocal(TransformTree* tree, int node, const Affine &local)
+{
+    if (memcmp(&tree->local[node], &local, sizeof(Affine)) == 0)
+        return;
+
+    tree->local[node] = local;
+    tree->dirty[node] = 1;
+    if (tree->first_dirty > node)
+        tree->first_dirty = node;
+}
+
+int Transforms_Update(TransformTree* tree)
+{
+    int num_nodes = (int)tree->parent.size();
+    int first = tree->first_dirty;
+    int updated = 0;
+
+    // Os nós antes de "first" não mudaram, e os valores de "changed" deles
+    // são de atualizações anteriores: só contam os pais a partir de "first"
+    for (int node = first; node < num_nodes; ++node)
+    {
+        int parent = tree->parent[node];
+        bool parent_changed = parent >= first && tree->changed[parent];
+
+        tree->changed[node] = tree->dirty[node] || parent_changed;
+        if (!tree->changed[node])
+            continue;
+
+        if (parent == TRANSFORM_ROOT)
+            tree->world[node] = tree->local[node];
+        else
+            tree->world[node] = Affine_Multiply(tree->world[parent], tree->local[node]);
+        tree->world_matrix[node] = Affine_ToMat4(tree->world[node]);
+        tree->dirty[node] = 0;
+        updated += 1;
+    }
+
+    tree->first_dirty = num_nodes;
+    return updated;
+}
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "worldstream.h"
+
+static double WorldStream_Now()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+long long WorldStream_Key(int cx, int cz)
+{
+    return (long long)(((unsigned long long)(unsigned int)cx << 32) | (unsigned int)cz);
+}
+
+unsigned int WorldStream_ChunkSeed(unsigned int seed, int cx, int cz)
+{
+    // Mistura de inteiros (constantes do murmur3): pedaços vizinhos recebem
+    // sementes sem relação entre si
+    unsigned int h = seed;
+    h ^= (unsigned int)cx * 0xCC9E2D51u;
+    h = (h << 13) | (h >> 19);
+    h ^= (unsigned int)cz * 0x1B873593u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Distância de (x, z) até o ponto mais próximo do pedaço
+static float WorldStream_Distance(const WorldStream* stream, int cx, int cz, float x, float z)
+{
+    float min_x = cx * stream->chunk_size;
+    float min_z = cz * stream->chunk_size;
+    float dx = std::max(0.0f, std::max(min_x - x, x - (min_x + stream->chunk_size)));
+    float dz = std::max(0.0f, std::max(min_z - z, z - (min_z + stream->chunk_size)));
+    return sqrtf(dx*dx + dz*dz);
+}
+
+static size_t WorldChunk_Bytes(const WorldChunk* chunk)
+{
+    const EntityArrays* arrays[2] = {&chunk->trees, &chunk->decorations};
+    size_t bytes = sizeof(WorldChunk);
+    for (int i = 0; i < 2; ++i)
+        bytes += (arrays[i]->x.capacity() + arrays[i]->y.capacity() + arrays[i]->z.capacity() + arrays[i]->scale.capacity()) * sizeof(float)
+               + (arrays[i]->type.capacity() + arrays[i]->node.capacity()) * sizeof(int);
+    bytes += chunk->decoration_matrices.capacity() * sizeof(glm::mat4);
+    bytes += chunk->colliders.capacity() * sizeof(CollisionInstance);
+    bytes += chunk->collision_grid.items.capacity() * sizeof(GridItem);
+    bytes += (chunk->collision_grid.cell_start.capacity() + chunk->collision_grid.cell_items.capacity()) * sizeof(int);
+    return bytes;
+}
+
+static void WorldStream_Thread(WorldStream* stream)
+{
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    while (true)
+    {
+        stream->wake.wait(lock, [stream]{ return !stream->running || !stream->requests.empty(); });
+        if (!stream->running)
+            break;
+
+        WorldChunk* chunk = stream->requests.front();
+        stream->requests.pop_front();
+
+        lock.unlock();
+        stream->generate(chunk);
+        chunk->bytes = WorldChunk_Bytes(chunk);
+        lock.lock();
+
+        stream->completed.push_back(chunk);
+    }
+}
+
+void WorldStream_Start(WorldStream* stream, float chunk_size, float load_radius, size_t budget_bytes,
+                       unsigned int seed, const std::function<void(WorldChunk*)> &generate)
+{
+    stream->chunk_size = chunk_size;
+    stream->load_radius = load_radius;
+    stream->unload_radius = load_radius + chunk_size; // Folga para que um pedaço não vá e volte na borda
+    stream->budget_bytes = budget_bytes;
+    stream->seed = seed;
+    stream->generate = generate;
+    stream->resident_bytes = 0;
+    stream->last_chunk_bytes = 0;
+    stream->loads = 0;
+    stream->evictions = 0;
+    stream->total_load_ms = 0.0;
+    stream->max_load_ms = 0.0;
+    stream->running = true;
+    stream->thread = std::thread(WorldStream_Thread, stream);
+}
+
+void WorldStream_Stop(WorldStream* stream)
+{
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->running = false;
+    }
+    stream->wake.notify_all();
+    if (stream->thread.joinable())
+        stream->thread.join();
+
+    // Os pedidos na fila e os prontos ainda não recebidos estão todos em "pending"
+    for (std::map<long long, WorldChunk*>::iterator it = stream->pending.begin(); it != stream->pending.end(); ++it)
+        delete it->second;
+    for (std::map<long long, WorldChunk*>::iterator it = stream->resident.begin(); it != stream->resident.end(); ++it)
+        delete it->second;
+    stream->pending.clear();
+    stream->resident.clear();
+    stream->requests.clear();
+    stream->completed.clear();
+    stream->resident_bytes = 0;
+}
+
+bool WorldStream_Update(WorldStream* stream, float x, float z)
+{
+    bool changed = false;
+    double now = WorldStream_Now();
+
+    // Recebe os pedaços prontos. Os pedidos que ficaram longe enquanto
+    // esperavam na fila são cancelados.
+    std::vector<WorldChunk*> ready;
+    std::vector<WorldChunk*> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        ready.swap(stream->completed);
+
+        for (size_t i = 0; i < stream->requests.size(); )
+        {
+            WorldChunk* chunk = stream->requests[i];
+            if (WorldStream_Distance(stream, chunk->cx, chunk->cz, x, z) > stream->unload_radius)
+            {
+                cancelled.push_back(chunk);
+                stream->requests.erase(stream->requests.begin() + i);
+            }
+            else
+                i += 1;
+        }
+    }
+
+    for (size_t i = 0; i < cancelled.size(); ++i)
+    {
+        stream->pending.erase(WorldStream_Key(cancelled[i]->cx, cancelled[i]->cz));
+        delete cancelled[i];
+    }
+
+    for (size_t i = 0; i < ready.size(); ++i)
+    {
+        WorldChunk* chunk = ready[i];
+        long long key = WorldStream_Key(chunk->cx, chunk->cz);
+        stream->pending.erase(key);
+
+        chunk->load_ms = now - chunk->request_time;
+        stream->loads += 1;
+        stream->total_load_ms += chunk->load_ms;
+        stream->max_load_ms = std::max(stream->max_load_ms, chunk->load_ms);
+
+        stream->resident[key] = chunk;
+        stream->resident_bytes += chunk->bytes;
+        stream->last_chunk_bytes = chunk->bytes;
+        changed = true;
+    }
+
+    // Descarta os pedaços distantes e, se a memória passar do limite, os
+    // mais distantes até caber
+    while (!stream->resident.empty())
+    {
+        std::map<long long, WorldChunk*>::iterator farthest = stream->resident.end();
+        float farthest_distance = -1.0f;
+        for (std::map<long long, WorldChunk*>::iterator it = stream->resident.begin(); it != stream->resident.end(); ++it)
+        {
+            float distance = WorldStream_Distance(stream, it->second->cx, it->second->cz, x, z);
+            if (distance > farthest_distance)
+            {
+                farthest = it;
+                farthest_distance = distance;
+            }
+        }
+
+        if (farthest_distance <= stream->unload_radius && stream->resident_bytes <= stream->budget_bytes)
+            break;
+
+        stream->resident_bytes -= farthest->second->bytes;
+        delete farthest->second;
+        stream->resident.erase(farthest);
+        stream->evictions += 1;
+        changed = true;
+    }
+
+    // Pedaços que faltam dentro do raio, do mais próximo para o mais distante
+    int first_x = (int)floor((x - stream->load_radius) / stream->chunk_size);
+    int first_z = (int)floor((z - stream->load_radius) / stream->chunk_size);
+    int last_x  = (int)floor((x + stream->load_radius) / stream->chunk_size);
+    int last_z  = (int)floor((z + stream->load_radius) / stream->chunk_size);
+
+    std::vector<std::pair<float, long long> > missing;
+    for (int cz = first_z; cz <= last_z; ++cz)
+        for (int cx = first_x; cx <= last_x; ++cx)
+        {
+            float distance = WorldStream_Distance(stream, cx, cz, x, z);
+            long long key = WorldStream_Key(cx, cz);
+            if (distance <= stream->load_radius && !stream->resident.count(key) && !stream->pending.count(key))
+                missing.push_back(std::make_pair(distance, key));
+        }
+    std::sort(missing.begin(), missing.end());
+
+    // Novos pedidos só enquanto os pedaços pedidos, com o tamanho médio dos
+    // que já estão na memória, ainda cabem no limite. Sem pedaços na memória
+    // vale o tamanho do último que ficou pronto; antes do primeiro, em que o
+    // tamanho ainda é desconhecido, apenas um pedido por vez.
+    size_t average_bytes = stream->resident.empty() ? stream->last_chunk_bytes : stream->resident_bytes / stream->resident.size();
+    std::vector<WorldChunk*> requested;
+    for (size_t i = 0; i < missing.size(); ++i)
+    {
+        if (average_bytes == 0 && !stream->pending.empty())
+            break;
+        if (stream->resident_bytes + average_bytes * (stream->pending.size() + 1) > stream->budget_bytes)
+            break;
+
+        WorldChunk* chunk = new WorldChunk();
+        chunk->cx = (int)(unsigned int)((unsigned long long)missing[i].second >> 32);
+        chunk->cz = (int)(unsigned int)missing[i].second;
+        chunk->bytes = 0;
+        chunk->request_time = now;
+        chunk->load_ms = 0.0;
+        stream->pending[missing[i].second] = chunk;
+        requested.push_back(chunk);
+    }
+
+    if (!requested.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            stream->requests.insert(stream->requests.end(), requested.begin(), requested.end());
+
+            // O jogador pode ter andado desde os pedidos anteriores
+            std::vector<std::pair<float, WorldChunk*> > order;
+            for (size_t i = 0; i < stream->requests.size(); ++i)
+                order.push_back(std::make_pair(WorldStream_Distance(stream, stream->requests[i]->cx, stream->requests[i]->cz, x, z), stream->requests[i]));
+            std::stable_sort(order.begin(), order.end(),
+                             [](const std::pair<float, WorldChunk*> &a, const std::pair<float, WorldChunk*> &b){ return a.first < b.first; });
+            for (size_t i = 0; i < order.size(); ++i)
+                stream->requests[i] = order[i].second;
+        }
+        stream->wake.notify_one();
+    }
+
+    return changed;
+}
+
+const WorldChunk* WorldStream_Find(const WorldStream* stream, float x, float z, int dx, int dz)
+{
+    int cx = (int)floor(x / stream->chunk_size) + dx;
+    int cz = (int)floor(z / stream->chunk_size) + dz;
+    std::map<long long, WorldChunk*>::const_iterator it = stream->resident.find(WorldStream_Key(cx, cz));
+    return it == stream->resident.end() ? NULL : it->second;
+}